@@ -0,0 +1,568 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* Render benchmark
+ *
+ * Renders a fixed number of samples of XML scenes and of generated synthetic scenes on the CPU,
+ * and writes the time spent loading, updating and rendering each of them as JSON. The update
+ * time is split per manager with the scene update statistics, and with --profile the render time
+ * is split per kernel with the profiler, so that regressions can be tracked down to a stage. */
+
+#include <cstdio>
+#include <functional>
+
+#include "device/device.h"
+#include "scene/camera.h"
+#include "scene/light.h"
+#include "scene/mesh.h"
+#include "scene/object.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/stats.h"
+#include "session/buffers.h"
+#include "session/session.h"
+
+#include "util/algorithm.h"
+#include "util/args.h"
+#include "util/log.h"
+#include "util/path.h"
+#include "util/string.h"
+#include "util/time.h"
+#include "util/transform.h"
+#include "util/unique_ptr.h"
+#include "util/vector.h"
+#include "util/version.h"
+
+#include "app/cycles_xml_bin.h"
+
+CCL_NAMESPACE_BEGIN
+
+struct BenchOptions {
+  vector<string> filepaths;
+  int synthetic_size = 0;
+  int samples = 16;
+  int width = 0;
+  int height = 0;
+  int threads = 0;
+  int repeat = 1;
+  bool profile = false;
+  string output_filepath;
+};
+
+/* Minimal JSON writer, values are written in the order they are added. */
+class BenchJSON {
+ public:
+  void begin_object(const char *key = nullptr)
+  {
+    begin_value(key);
+    text_ += "{";
+    first_ = true;
+    depth_++;
+  }
+
+  void end_object()
+  {
+    depth_--;
+    newline();
+    text_ += "}";
+    first_ = false;
+  }
+
+  void begin_array(const char *key)
+  {
+    begin_value(key);
+    text_ += "[";
+    first_ = true;
+    depth_++;
+  }
+
+  void end_array()
+  {
+    end_object();
+    text_.back() = ']';
+  }
+
+  void value(const char *key, const double value)
+  {
+    begin_value(key);
+    text_ += string_printf("%.6g", value);
+  }
+
+  void value(const char *key, const uint64_t value)
+  {
+    begin_value(key);
+    text_ += string_printf("%llu", (unsigned long long)value);
+  }
+
+  void value(const char *key, const int value)
+  {
+    begin_value(key);
+    text_ += string_printf("%d", value);
+  }
+
+  void value(const char *key, const string &value)
+  {
+    begin_value(key);
+    text_ += quote(value);
+  }
+
+  const string &text() const
+  {
+    return text_;
+  }
+
+ protected:
+  void newline()
+  {
+    text_ += "\n" + string(depth_ * 2, ' ');
+  }
+
+  void begin_value(const char *key)
+  {
+    if (!first_) {
+      text_ += ",";
+    }
+    if (depth_ > 0) {
+      newline();
+    }
+    if (key) {
+      text_ += quote(key) + ": ";
+    }
+    first_ = false;
+  }
+
+  static string quote(const string &str)
+  {
+    string result = "\"";
+    for (const char c : str) {
+      if (c == '"' || c == '\\') {
+        result += '\\';
+        result += c;
+      }
+      else if ((unsigned char)c < 0x20) {
+        result += string_printf("\\u%04x", c);
+      }
+      else {
+        result += c;
+      }
+    }
+    return result + "\"";
+  }
+
+  string text_;
+  int depth_ = 0;
+  bool first_ = true;
+};
+
+/* --------------------------------------------------------------------
+ * Synthetic scenes.
+ */
+
+static Mesh *bench_add_mesh(Scene *scene, const vector<float3> &verts, const vector<int> &tris)
+{
+  Mesh *mesh = scene->create_node<Mesh>();
+
+  array<Node *> used_shaders;
+  used_shaders.push_back_slow(scene->default_surface);
+  mesh->set_used_shaders(used_shaders);
+
+  array<float3> P_array;
+  P_array = verts;
+  mesh->set_verts(P_array);
+  mesh->resize_mesh(verts.size(), tris.size() / 3);
+  std::copy(tris.begin(), tris.end(), mesh->get_triangles().data());
+  std::ranges::fill(mesh->get_smooth(), false);
+  std::ranges::fill(mesh->get_shader(), 0);
+
+  mesh->tag_triangles_modified();
+  mesh->tag_shader_modified();
+  mesh->tag_smooth_modified();
+
+  return mesh;
+}
+
+static void bench_add_object(Scene *scene, Geometry *geom, const Transform &tfm)
+{
+  Object *object = scene->create_node<Object>();
+  object->set_geometry(geom);
+  object->set_tfm(tfm);
+}
+
+/* Point light and camera looking at the origin from the given distance. */
+static void bench_add_light_and_camera(Scene *scene, const float distance)
+{
+  PointLight *light = scene->create_node<PointLight>();
+  array<Node *> used_shaders;
+  used_shaders.push_back_slow(scene->default_light);
+  light->set_used_shaders(used_shaders);
+  light->set_strength(make_float3(100.0f * distance * distance));
+  light->set_radius(0.1f * distance);
+
+  Object *object = scene->create_node<Object>();
+  object->set_geometry(light);
+  object->set_tfm(transform_translate(make_float3(distance, distance, -distance)));
+  object->set_visibility(PATH_RAY_ALL_VISIBILITY & ~PATH_RAY_CAMERA);
+
+  scene->camera->set_matrix(transform_translate(make_float3(0.0f, 0.0f, -2.0f * distance)));
+}
+
+/* Many instances of a single cube, on a grid of size^3. */
+static void bench_synthetic_instances(Scene *scene, const int size)
+{
+  const vector<float3> verts = {make_float3(-1, -1, -1),
+                                make_float3(1, -1, -1),
+                                make_float3(1, 1, -1),
+                                make_float3(-1, 1, -1),
+                                make_float3(-1, -1, 1),
+                                make_float3(1, -1, 1),
+                                make_float3(1, 1, 1),
+                                make_float3(-1, 1, 1)};
+  const vector<int> tris = {0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+                            2, 3, 7, 2, 7, 6, 1, 2, 6, 1, 6, 5, 0, 4, 7, 0, 7, 3};
+  Mesh *mesh = bench_add_mesh(scene, verts, tris);
+
+  const float offset = 1.5f * (size - 1);
+  for (int z = 0; z < size; z++) {
+    for (int y = 0; y < size; y++) {
+      for (int x = 0; x < size; x++) {
+        const float3 position = make_float3(x * 3.0f, y * 3.0f, z * 3.0f) - make_float3(offset);
+        const Transform tfm = transform_translate(position) * transform_scale(make_float3(0.5f));
+        bench_add_object(scene, mesh, tfm);
+      }
+    }
+  }
+
+  bench_add_light_and_camera(scene, 3.0f * size);
+}
+
+/* A single dense mesh, a displaced grid of (size * 16)^2 quads. */
+static void bench_synthetic_mesh(Scene *scene, const int size)
+{
+  const int resolution = size * 16;
+
+  vector<float3> verts;
+  for (int y = 0; y <= resolution; y++) {
+    for (int x = 0; x <= resolution; x++) {
+      const float u = float(x) / resolution * 2.0f - 1.0f;
+      const float v = float(y) / resolution * 2.0f - 1.0f;
+      const float height = 0.1f * sinf(u * 20.0f) * cosf(v * 20.0f);
+      verts.push_back(make_float3(u, v, height));
+    }
+  }
+
+  vector<int> tris;
+  for (int y = 0; y < resolution; y++) {
+    for (int x = 0; x < resolution; x++) {
+      const int v0 = y * (resolution + 1) + x;
+      const int v1 = v0 + 1;
+      const int v2 = v0 + resolution + 1;
+      const int v3 = v2 + 1;
+      tris.insert(tris.end(), {v0, v1, v3, v0, v3, v2});
+    }
+  }
+
+  bench_add_object(scene, bench_add_mesh(scene, verts, tris), transform_identity());
+  bench_add_light_and_camera(scene, 2.0f);
+}
+
+/* --------------------------------------------------------------------
+ * Benchmark.
+ */
+
+static void bench_write_update_stats(BenchJSON &json, const char *key, UpdateTimeStats &stats)
+{
+  json.begin_object(key);
+  json.value("total", stats.times.total_time);
+  for (const NamedTimeEntry &entry : stats.times.entries) {
+    json.value(entry.name.c_str(), entry.time);
+  }
+  json.end_object();
+}
+
+static double bench_bvh_time(const SceneUpdateStats &stats)
+{
+  double time = 0.0;
+  for (const NamedTimeEntry &entry : stats.geometry.times.entries) {
+    if (entry.name.find("BVH") != string::npos) {
+      time += entry.time;
+    }
+  }
+  return time;
+}
+
+static void bench_write_kernel_stats(BenchJSON &json, const NamedNestedSampleStats &stats)
+{
+  if (stats.entries.empty()) {
+    json.value(stats.name.c_str(), stats.sum_samples);
+    return;
+  }
+
+  json.begin_object(stats.name.c_str());
+  json.value("samples", stats.sum_samples);
+  for (const NamedNestedSampleStats &entry : stats.entries) {
+    bench_write_kernel_stats(json, entry);
+  }
+  json.end_object();
+}
+
+static void bench_scene(const BenchOptions &options,
+                        const SessionParams &session_params,
+                        const string &name,
+                        const std::function<void(Scene *)> &load,
+                        BenchJSON &json)
+{
+  const SceneParams scene_params;
+  const unique_ptr<Session> session = make_unique<Session>(session_params, scene_params);
+  Scene *scene = session->scene.get();
+  scene->enable_update_stats();
+
+  /* Load. */
+  const double load_start = time_dt();
+  load(scene);
+
+  if (options.width > 0 && options.height > 0) {
+    scene->camera->set_full_width(options.width);
+    scene->camera->set_full_height(options.height);
+  }
+  scene->camera->compute_auto_viewplane();
+
+  Pass *pass = scene->create_node<Pass>();
+  pass->set_name(ustring("combined"));
+  pass->set_type(PASS_COMBINED);
+
+  const double load_time = time_dt() - load_start;
+
+  BufferParams buffer_params;
+  buffer_params.width = scene->camera->get_full_width();
+  buffer_params.height = scene->camera->get_full_height();
+  buffer_params.full_width = buffer_params.width;
+  buffer_params.full_height = buffer_params.height;
+
+  json.begin_object();
+  json.value("name", name);
+  json.value("width", buffer_params.width);
+  json.value("height", buffer_params.height);
+  json.value("samples", options.samples);
+  json.value("load_time", load_time);
+
+  /* Render, the first render includes the scene update. */
+  vector<double> render_times;
+  for (int i = 0; i < options.repeat; i++) {
+    const double start_time = time_dt();
+    session->reset(session_params, buffer_params);
+    session->start();
+    session->wait();
+    const double total_time = time_dt() - start_time;
+
+    double progress_total_time;
+    double render_time;
+    session->progress.get_time(progress_total_time, render_time);
+    render_times.push_back(render_time);
+
+    if (session->progress.get_error()) {
+      json.value("error", session->progress.get_error_message());
+      break;
+    }
+
+    if (i == 0) {
+      json.value("first_render_time", total_time);
+      json.value("update_time", total_time - render_time);
+      json.value("bvh_build_time", bench_bvh_time(*scene->update_stats));
+
+      SceneUpdateStats &stats = *scene->update_stats;
+      json.begin_object("update");
+      bench_write_update_stats(json, "scene", stats.scene);
+      bench_write_update_stats(json, "geometry", stats.geometry);
+      bench_write_update_stats(json, "image", stats.image);
+      bench_write_update_stats(json, "light", stats.light);
+      bench_write_update_stats(json, "object", stats.object);
+      bench_write_update_stats(json, "background", stats.background);
+      bench_write_update_stats(json, "camera", stats.camera);
+      bench_write_update_stats(json, "film", stats.film);
+      bench_write_update_stats(json, "integrator", stats.integrator);
+      bench_write_update_stats(json, "osl", stats.osl);
+      bench_write_update_stats(json, "particles", stats.particles);
+      bench_write_update_stats(json, "svm", stats.svm);
+      bench_write_update_stats(json, "tables", stats.tables);
+      bench_write_update_stats(json, "procedurals", stats.procedurals);
+      json.end_object();
+    }
+  }
+
+  if (!render_times.empty()) {
+    std::sort(render_times.begin(), render_times.end());
+    const double render_time = render_times[render_times.size() / 2];
+    const double pixels = double(buffer_params.width) * buffer_params.height;
+
+    json.value("render_time", render_time);
+    json.value("render_time_min", render_times.front());
+    json.value("samples_per_second", options.samples / render_time);
+    json.value("pixel_samples_per_second", options.samples * pixels / render_time);
+  }
+
+  RenderStats stats;
+  session->collect_statistics(&stats);
+  json.begin_object("memory");
+  json.value("geometry", uint64_t(stats.mesh.geometry.total_size));
+  json.value("textures", uint64_t(stats.image.textures.total_size));
+  json.end_object();
+
+  if (stats.has_profiling) {
+    bench_write_kernel_stats(json, stats.kernel);
+  }
+
+  json.end_object();
+}
+
+static void bench_run(const BenchOptions &options, const SessionParams &session_params)
+{
+  BenchJSON json;
+  json.begin_object();
+  json.value("version", string(CYCLES_VERSION_STRING));
+  json.value("device", session_params.device.description);
+  json.value("threads", session_params.threads);
+  json.begin_array("scenes");
+
+  for (const string &filepath : options.filepaths) {
+    bench_scene(
+        options,
+        session_params,
+        path_filename(filepath),
+        [&](Scene *scene) { xml_read_file(scene, filepath.c_str()); },
+        json);
+  }
+
+  if (options.synthetic_size > 0) {
+    const int size = options.synthetic_size;
+    bench_scene(
+        options,
+        session_params,
+        string_printf("synthetic_instances_%d", size),
+        [&](Scene *scene) { bench_synthetic_instances(scene, size); },
+        json);
+    bench_scene(
+        options,
+        session_params,
+        string_printf("synthetic_mesh_%d", size),
+        [&](Scene *scene) { bench_synthetic_mesh(scene, size); },
+        json);
+  }
+
+  json.end_array();
+  json.end_object();
+
+  if (options.output_filepath.empty()) {
+    printf("%s\n", json.text().c_str());
+  }
+  else {
+    FILE *f = path_fopen(options.output_filepath, "wb");
+    if (!f) {
+      fprintf(stderr, "Failed to write %s\n", options.output_filepath.c_str());
+      exit(EXIT_FAILURE);
+    }
+    fprintf(f, "%s\n", json.text().c_str());
+    fclose(f);
+  }
+}
+
+static void parse_int(OIIO::cspan<const char *> argv, int *i)
+{
+  assert(argv.size() == 2);
+  *i = atoi(argv[1]);
+}
+
+static void parse_string(OIIO::cspan<const char *> argv, std::string *s)
+{
+  assert(argv.size() == 2);
+  *s = argv[1];
+}
+
+static void bench_options_parse(const int argc,
+                                const char **argv,
+                                BenchOptions &options,
+                                SessionParams &session_params)
+{
+  ArgParse ap;
+  bool help = false;
+  string log_level;
+
+  ap.usage("cycles_bench [options] [file.xml ...]");
+  ap.arg("filename").hidden().action([&](auto argv) { options.filepaths.push_back(argv[0]); });
+  ap.arg("--synthetic %d:SIZE")
+      .help("Add generated scenes with SIZE^3 instances and a (SIZE * 16)^2 grid mesh")
+      .action([&](auto argv) { parse_int(argv, &options.synthetic_size); });
+  ap.arg("--samples %d:SAMPLES").help("Number of samples to render").action([&](auto argv) {
+    parse_int(argv, &options.samples);
+  });
+  ap.arg("--width %d:WIDTH").help("Override image width in pixels").action([&](auto argv) {
+    parse_int(argv, &options.width);
+  });
+  ap.arg("--height %d:HEIGHT").help("Override image height in pixels").action([&](auto argv) {
+    parse_int(argv, &options.height);
+  });
+  ap.arg("--threads %d:THREADS").help("CPU rendering threads").action([&](auto argv) {
+    parse_int(argv, &options.threads);
+  });
+  ap.arg("--repeat %d:REPEAT")
+      .help("Number of renders of every scene, the median render time is reported")
+      .action([&](auto argv) { parse_int(argv, &options.repeat); });
+  ap.arg("--profile", &options.profile).help("Report kernel time with the profiler");
+  ap.arg("--output %s:OUTPUT")
+      .help("File path to write JSON to, standard output if not given")
+      .action([&](auto argv) { parse_string(argv, &options.output_filepath); });
+  ap.arg("--log-level %s:LEVEL")
+      .help("Log verbosity: fatal, error, warning, info, stats, debug")
+      .action([&](auto argv) { parse_string(argv, &log_level); });
+  ap.arg("--help", &help).help("Print help message");
+
+  if (ap.parse_args(argc, argv) < 0) {
+    fprintf(stderr, "%s\n", ap.geterror().c_str());
+    ap.print_help();
+    exit(EXIT_FAILURE);
+  }
+
+  if (!log_level.empty()) {
+    log_level_set(log_level);
+  }
+
+  if (help || (options.filepaths.empty() && options.synthetic_size <= 0)) {
+    ap.print_help();
+    exit(EXIT_SUCCESS);
+  }
+
+  if (options.samples <= 0 || options.repeat <= 0) {
+    fprintf(stderr, "Number of samples and repeats must be positive\n");
+    exit(EXIT_FAILURE);
+  }
+
+  const vector<DeviceInfo> devices = Device::available_devices(DEVICE_MASK_CPU);
+  if (devices.empty()) {
+    fprintf(stderr, "No CPU device available\n");
+    exit(EXIT_FAILURE);
+  }
+
+  session_params.device = devices.front();
+  session_params.background = true;
+  session_params.samples = options.samples;
+  session_params.threads = options.threads;
+  session_params.use_profiling = options.profile;
+  session_params.use_auto_tile = false;
+}
+
+CCL_NAMESPACE_END
+
+using namespace ccl;
+
+int main(const int argc, const char **argv)
+{
+  log_init(nullptr);
+  path_init();
+
+  BenchOptions options;
+  SessionParams session_params;
+  bench_options_parse(argc, argv, options, session_params);
+  bench_run(options, session_params);
+
+  return 0;
+}
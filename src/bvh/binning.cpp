@@ -13,7 +13,9 @@
 
 #include "util/algorithm.h"
 #include "util/boundbox.h"
+#include "util/tbb.h"
 #include "util/types.h"
+#include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -52,16 +54,103 @@ __forceinline int get_best_dimension(const float4 &bestSAH)
 
 /* BVH Object Binning */
 
+void BVHObjectBinning::Bins::reset(const size_t num_bins)
+{
+  for (size_t i = 0; i < num_bins; i++) {
+    count[i] = make_int4(0);
+    bounds[i][0] = bounds[i][1] = bounds[i][2] = BoundBox::empty;
+  }
+}
+
+void BVHObjectBinning::Bins::merge(const Bins &other, const size_t num_bins)
+{
+  for (size_t i = 0; i < num_bins; i++) {
+    count[i] = count[i] + other.count[i];
+    bounds[i][0].grow(other.bounds[i][0]);
+    bounds[i][1].grow(other.bounds[i][1]);
+    bounds[i][2].grow(other.bounds[i][2]);
+  }
+}
+
+void BVHObjectBinning::bin_prims(const BVHReference *prims,
+                                 const int begin,
+                                 const int end,
+                                 Bins &bins) const
+{
+  BoundBox(*bin_bounds)[4] = bins.bounds;
+  int4 *bin_count = bins.count;
+
+  /* map geometry to bins, unrolled once */
+  int64_t i;
+
+  for (i = begin; i < int64_t(end) - 1; i += 2) {
+    prefetch_L2(&prims[i + 8]);
+
+    /* map even and odd primitive to bin */
+    const BVHReference &prim0 = prims[i + 0];
+    const BVHReference &prim1 = prims[i + 1];
+
+    const BoundBox bounds0 = get_prim_bounds(prim0);
+    const BoundBox bounds1 = get_prim_bounds(prim1);
+
+    const int4 bin0 = get_bin(bounds0);
+    const int4 bin1 = get_bin(bounds1);
+
+    /* increase bounds for bins for even primitive */
+    const int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    const int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    const int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+
+    /* increase bounds of bins for odd primitive */
+    const int b10 = (int)extract<0>(bin1);
+    bin_count[b10][0]++;
+    bin_bounds[b10][0].grow(bounds1);
+    const int b11 = (int)extract<1>(bin1);
+    bin_count[b11][1]++;
+    bin_bounds[b11][1].grow(bounds1);
+    const int b12 = (int)extract<2>(bin1);
+    bin_count[b12][2]++;
+    bin_bounds[b12][2].grow(bounds1);
+  }
+
+  /* for uneven number of primitives */
+  if (i < int64_t(end)) {
+    /* map primitive to bin */
+    const BVHReference &prim0 = prims[i];
+    const BoundBox bounds0 = get_prim_bounds(prim0);
+    const int4 bin0 = get_bin(bounds0);
+
+    /* increase bounds of bins */
+    const int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    const int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    const int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+  }
+}
+
 BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
                                    BVHReference *prims,
                                    const BVHUnaligned *unaligned_heuristic,
-                                   const Transform *aligned_space)
+                                   const Transform *aligned_space,
+                                   const bool use_parallel)
     : BVHRange(job),
       splitSAH(FLT_MAX),
       dim(0),
       pos(0),
       unaligned_heuristic_(unaligned_heuristic),
-      aligned_space_(aligned_space)
+      aligned_space_(aligned_space),
+      use_parallel_(use_parallel)
 {
   if (aligned_space_ == nullptr) {
     bounds_ = bounds();
@@ -79,74 +168,33 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   num_bins = min(size_t(MAX_BINS), size_t(4.0f + 0.05f * size()));
   scale = safe_divide(make_float3((float)num_bins), cent_bounds_.size());
 
-  /* initialize binning counter and bounds */
-  BoundBox bin_bounds[MAX_BINS][4]; /* bounds for every bin in every dimension */
-  int4 bin_count[MAX_BINS];         /* number of primitives mapped to bin */
-
-  for (size_t i = 0; i < num_bins; i++) {
-    bin_count[i] = make_int4(0);
-    bin_bounds[i][0] = bin_bounds[i][1] = bin_bounds[i][2] = BoundBox::empty;
-  }
-
-  /* map geometry to bins, unrolled once */
-  {
-    int64_t i;
-
-    for (i = 0; i < int64_t(size()) - 1; i += 2) {
-      prefetch_L2(&prims[start() + i + 8]);
-
-      /* map even and odd primitive to bin */
-      const BVHReference &prim0 = prims[start() + i + 0];
-      const BVHReference &prim1 = prims[start() + i + 1];
-
-      const BoundBox bounds0 = get_prim_bounds(prim0);
-      const BoundBox bounds1 = get_prim_bounds(prim1);
-
-      const int4 bin0 = get_bin(bounds0);
-      const int4 bin1 = get_bin(bounds1);
-
-      /* increase bounds for bins for even primitive */
-      const int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      const int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      const int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
-
-      /* increase bounds of bins for odd primitive */
-      const int b10 = (int)extract<0>(bin1);
-      bin_count[b10][0]++;
-      bin_bounds[b10][0].grow(bounds1);
-      const int b11 = (int)extract<1>(bin1);
-      bin_count[b11][1]++;
-      bin_bounds[b11][1].grow(bounds1);
-      const int b12 = (int)extract<2>(bin1);
-      bin_count[b12][2]++;
-      bin_bounds[b12][2].grow(bounds1);
-    }
-
-    /* for uneven number of primitives */
-    if (i < int64_t(size())) {
-      /* map primitive to bin */
-      const BVHReference &prim0 = prims[start() + i];
-      const BoundBox bounds0 = get_prim_bounds(prim0);
-      const int4 bin0 = get_bin(bounds0);
-
-      /* increase bounds of bins */
-      const int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      const int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      const int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
+  /* map geometry to bins */
+  Bins bins;
+  bins.reset(num_bins);
+
+  if (use_parallel_ && size() >= PARALLEL_MIN_SIZE) {
+    /* Every thread bins into its own storage, merged when all blocks are done. */
+    enumerable_thread_specific<Bins> thread_bins([this]() {
+      Bins local_bins;
+      local_bins.reset(num_bins);
+      return local_bins;
+    });
+
+    parallel_for(blocked_range<int>(start(), end(), PARALLEL_BLOCK_SIZE),
+                 [&](const blocked_range<int> &r) {
+                   bin_prims(prims, r.begin(), r.end(), thread_bins.local());
+                 });
+
+    for (const Bins &local_bins : thread_bins) {
+      bins.merge(local_bins, num_bins);
     }
   }
+  else {
+    bin_prims(prims, start(), end(), bins);
+  }
+
+  const BoundBox(*bin_bounds)[4] = bins.bounds;
+  const int4 *bin_count = bins.count;
 
   /* sweep from right to left and compute parallel prefix of merged bounds */
   float4 r_area[MAX_BINS];  /* area of bounds of primitives on the right */
@@ -215,6 +263,10 @@ void BVHObjectBinning::split(BVHReference *prims,
 {
   const size_t N = size();
 
+  if (use_parallel_ && N >= PARALLEL_MIN_SIZE && parallel_split(prims, left_o, right_o)) {
+    return;
+  }
+
   BoundBox lgeom_bounds = BoundBox::empty;
   BoundBox rgeom_bounds = BoundBox::empty;
   BoundBox lcent_bounds = BoundBox::empty;
@@ -228,11 +280,9 @@ void BVHObjectBinning::split(BVHReference *prims,
     prefetch_L2(&prims[start() + r - 8]);
 
     const BVHReference prim = prims[start() + l];
-    const BoundBox unaligned_bounds = get_prim_bounds(prim);
-    const float3 unaligned_center = unaligned_bounds.center2();
     const float3 center = prim.bounds().center2();
 
-    if (get_bin(unaligned_center)[dim] < pos) {
+    if (is_left(prim)) {
       lgeom_bounds.grow(prim.bounds());
       lcent_bounds.grow(center);
       l++;
@@ -247,8 +297,12 @@ void BVHObjectBinning::split(BVHReference *prims,
   /* finish */
   if (l != 0 && N - 1 - r != 0) {
     right_o = BVHObjectBinning(BVHRange(rgeom_bounds, rcent_bounds, start() + l, N - 1 - r),
-                               prims);
-    left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), l), prims);
+                               prims,
+                               nullptr,
+                               nullptr,
+                               use_parallel_);
+    left_o = BVHObjectBinning(
+        BVHRange(lgeom_bounds, lcent_bounds, start(), l), prims, nullptr, nullptr, use_parallel_);
     return;
   }
 
@@ -270,8 +324,102 @@ void BVHObjectBinning::split(BVHReference *prims,
   }
 
   right_o = BVHObjectBinning(BVHRange(rgeom_bounds, rcent_bounds, start() + N / 2, N / 2 + N % 2),
-                             prims);
-  left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), N / 2), prims);
+                             prims,
+                             nullptr,
+                             nullptr,
+                             use_parallel_);
+  left_o = BVHObjectBinning(
+      BVHRange(lgeom_bounds, lcent_bounds, start(), N / 2), prims, nullptr, nullptr, use_parallel_);
+}
+
+bool BVHObjectBinning::parallel_split(BVHReference *prims,
+                                      BVHObjectBinning &left_o,
+                                      BVHObjectBinning &right_o) const
+{
+  const size_t N = size();
+  const size_t num_blocks = divide_up(N, PARALLEL_BLOCK_SIZE);
+
+  struct PartitionBlock {
+    size_t num_left;
+    size_t left_offset;
+    BoundBox lgeom_bounds;
+    BoundBox rgeom_bounds;
+    BoundBox lcent_bounds;
+    BoundBox rcent_bounds;
+  };
+  vector<PartitionBlock> partition_blocks(num_blocks);
+
+  /* Count primitives going to the left and their bounds, per block. */
+  parallel_for(blocked_range<size_t>(0, num_blocks, 1), [&](const blocked_range<size_t> &r) {
+    for (size_t b = r.begin(); b != r.end(); b++) {
+      PartitionBlock &block = partition_blocks[b];
+      block.num_left = 0;
+      block.lgeom_bounds = block.rgeom_bounds = BoundBox::empty;
+      block.lcent_bounds = block.rcent_bounds = BoundBox::empty;
+
+      const size_t block_end = min(N, (b + 1) * PARALLEL_BLOCK_SIZE);
+      for (size_t i = b * PARALLEL_BLOCK_SIZE; i < block_end; i++) {
+        const BVHReference &prim = prims[start() + i];
+        if (is_left(prim)) {
+          block.lgeom_bounds.grow(prim.bounds());
+          block.lcent_bounds.grow(prim.bounds().center2());
+          block.num_left++;
+        }
+        else {
+          block.rgeom_bounds.grow(prim.bounds());
+          block.rcent_bounds.grow(prim.bounds().center2());
+        }
+      }
+    }
+  });
+
+  /* Prefix sum of the left side sizes gives where every block writes to. */
+  size_t num_left = 0;
+  BoundBox lgeom_bounds = BoundBox::empty;
+  BoundBox rgeom_bounds = BoundBox::empty;
+  BoundBox lcent_bounds = BoundBox::empty;
+  BoundBox rcent_bounds = BoundBox::empty;
+  for (PartitionBlock &block : partition_blocks) {
+    block.left_offset = num_left;
+    num_left += block.num_left;
+    lgeom_bounds.grow(block.lgeom_bounds);
+    rgeom_bounds.grow(block.rgeom_bounds);
+    lcent_bounds.grow(block.lcent_bounds);
+    rcent_bounds.grow(block.rcent_bounds);
+  }
+
+  /* Leave degenerate splits to the object median fallback of the serial split. */
+  if (num_left == 0 || num_left == N) {
+    return false;
+  }
+
+  /* Scatter into a temporary array and copy back, keeping the order within each side. */
+  vector<BVHReference> partitioned(N);
+  parallel_for(blocked_range<size_t>(0, num_blocks, 1), [&](const blocked_range<size_t> &r) {
+    for (size_t b = r.begin(); b != r.end(); b++) {
+      const PartitionBlock &block = partition_blocks[b];
+      const size_t block_begin = b * PARALLEL_BLOCK_SIZE;
+      const size_t block_end = min(N, block_begin + PARALLEL_BLOCK_SIZE);
+      size_t left_index = block.left_offset;
+      size_t right_index = num_left + (block_begin - block.left_offset);
+      for (size_t i = block_begin; i < block_end; i++) {
+        const BVHReference &prim = prims[start() + i];
+        partitioned[is_left(prim) ? left_index++ : right_index++] = prim;
+      }
+    }
+  });
+
+  parallel_for(blocked_range<size_t>(0, N, PARALLEL_BLOCK_SIZE),
+               [&](const blocked_range<size_t> &r) {
+                 std::copy(partitioned.begin() + r.begin(),
+                           partitioned.begin() + r.end(),
+                           prims + start() + r.begin());
+               });
+
+  right_o = BVHObjectBinning(
+      BVHRange(rgeom_bounds, rcent_bounds, start() + num_left, N - num_left), prims);
+  left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), num_left), prims);
+  return true;
 }
 
 CCL_NAMESPACE_END
@@ -16,21 +16,27 @@ CCL_NAMESPACE_BEGIN
 
 class BVHBuild;
 
-/* Single threaded object binner. Finds the split with the best SAH heuristic
+/* Object binner. Finds the split with the best SAH heuristic
  * by testing for each dimension multiple partitionings for regular spaced
  * partition locations. A partitioning for a partition location is computed,
  * by putting primitives whose centroid is on the left and right of the split
  * location to different sets. The SAH is evaluated by computing the number of
- * blocks occupied by the primitives in the partitions. */
+ * blocks occupied by the primitives in the partitions.
+ *
+ * Large ranges, typically the top levels of the tree, are binned and partitioned
+ * in parallel: every thread fills its own bins which are merged afterwards, and
+ * the split scatters blocks of references to offsets found by a prefix sum. Both give the
+ * same split as the serial code, use_parallel = false forces the serial code for comparison. */
 
 class BVHObjectBinning : public BVHRange {
  public:
-  __forceinline BVHObjectBinning() : leafSAH(FLT_MAX) {}
+  __forceinline BVHObjectBinning() : leafSAH(FLT_MAX), use_parallel_(true) {}
 
   BVHObjectBinning(const BVHRange &job,
                    BVHReference *prims,
                    const BVHUnaligned *unaligned_heuristic = nullptr,
-                   const Transform *aligned_space = nullptr);
+                   const Transform *aligned_space = nullptr,
+                   const bool use_parallel = true);
 
   void split(BVHReference *prims, BVHObjectBinning &left_o, BVHObjectBinning &right_o) const;
 
@@ -55,9 +61,37 @@ class BVHObjectBinning : public BVHRange {
   const BVHUnaligned *unaligned_heuristic_;
   const Transform *aligned_space_;
 
+  bool use_parallel_;
+
   enum { MAX_BINS = 32 };
   enum { LOG_BLOCK_SIZE = 2 };
 
+  /* Ranges with at least this many references are binned and split in parallel,
+   * in blocks of PARALLEL_BLOCK_SIZE references. */
+  enum { PARALLEL_MIN_SIZE = 65536 };
+  enum { PARALLEL_BLOCK_SIZE = 8192 };
+
+  /* Bounds and number of primitives of every bin, in every dimension. */
+  struct Bins {
+    BoundBox bounds[MAX_BINS][4];
+    int4 count[MAX_BINS];
+
+    void reset(const size_t num_bins);
+    void merge(const Bins &other, const size_t num_bins);
+  };
+
+  void bin_prims(const BVHReference *prims, const int begin, const int end, Bins &bins) const;
+
+  bool parallel_split(BVHReference *prims,
+                      BVHObjectBinning &left_o,
+                      BVHObjectBinning &right_o) const;
+
+  /* Test whether a primitive goes to the left side of the best split. */
+  __forceinline bool is_left(const BVHReference &prim) const
+  {
+    return get_bin(get_prim_bounds(prim).center2())[dim] < pos;
+  }
+
   /* computes the bin numbers for each dimension for a box. */
   __forceinline int4 get_bin(const BoundBox &box) const
   {
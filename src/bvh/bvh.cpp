@@ -36,6 +36,8 @@ const char *bvh_layout_name(BVHLayout layout)
       return "NONE";
     case BVH_LAYOUT_BVH2:
       return "BVH2";
+    case BVH_LAYOUT_BVH4:
+      return "BVH4";
     case BVH_LAYOUT_EMBREE:
       return "EMBREE";
     case BVH_LAYOUT_OPTIX:
@@ -82,7 +84,13 @@ BVHLayout BVHParams::best_bvh_layout(BVHLayout requested_layout, BVHLayoutMask s
   }
   /* We get widest from allowed ones and convert mask to actual layout. */
   const BVHLayoutMask widest_allowed_layout_mask = __bsr((uint32_t)allowed_layouts_mask);
-  return (BVHLayout)(1 << widest_allowed_layout_mask);
+  const BVHLayout widest_allowed_layout = (BVHLayout)(1 << widest_allowed_layout_mask);
+  /* BVH4 is the wide native layout of the CPU. Its bit comes after the others for compatibility,
+   * so prefer it over BVH2 explicitly when it is supported and BVH2 was not asked for. */
+  if (widest_allowed_layout == BVH_LAYOUT_BVH2 && (supported_layouts & BVH_LAYOUT_BVH4)) {
+    return BVH_LAYOUT_BVH4;
+  }
+  return widest_allowed_layout;
 }
 
 /* BVH */
@@ -101,6 +109,7 @@ unique_ptr<BVH> BVH::create(const BVHParams &params,
 {
   switch (params.bvh_layout) {
     case BVH_LAYOUT_BVH2:
+    case BVH_LAYOUT_BVH4:
       return make_unique<BVH2>(params, geometry, objects);
     case BVH_LAYOUT_EMBREE:
     case BVH_LAYOUT_EMBREEGPU:
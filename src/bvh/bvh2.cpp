@@ -18,6 +18,7 @@
 #include "bvh/node.h"
 #include "bvh/unaligned.h"
 
+#include "util/log.h"
 #include "util/progress.h"
 
 CCL_NAMESPACE_BEGIN
@@ -34,6 +35,13 @@ BVH2::BVH2(const BVHParams &params_,
            const vector<Object *> &objects_)
     : BVH(params_, geometry_, objects_)
 {
+  /* Wide nodes only store axis aligned boxes, and are the only ones that can be quantized. */
+  if (params.bvh_layout == BVH_LAYOUT_BVH4) {
+    params.use_unaligned_nodes = false;
+  }
+  else {
+    params.use_quantized_nodes = false;
+  }
 }
 
 void BVH2::build(Progress &progress, Stats * /*unused*/)
@@ -62,6 +70,9 @@ void BVH2::build(Progress &progress, Stats * /*unused*/)
     return;
   }
 
+  /* Remember the quality of the new tree, to detect when refitting degraded it. */
+  build_sah_cost = refit_sah_cost = (root) ? root->computeSubtreeSAHCost(params) : 0.0f;
+
   /* pack triangles */
   progress.set_substatus("Packing BVH triangles and strands");
   pack_primitives();
@@ -78,7 +89,16 @@ void BVH2::build(Progress &progress, Stats * /*unused*/)
 void BVH2::refit(Progress &progress)
 {
   progress.set_substatus("Packing BVH primitives");
-  pack_primitives();
+  if (params.top_level) {
+    /* Only the top level part of the tree is refit, instance BVHs are merged again as they
+     * may have been refit or rebuilt themselves. */
+    unpack_instances();
+    pack_primitives();
+    pack_instances(top_level_nodes_size, top_level_leaf_nodes_size);
+  }
+  else {
+    pack_primitives();
+  }
 
   if (progress.get_cancel()) {
     return;
@@ -86,10 +106,92 @@ void BVH2::refit(Progress &progress)
 
   progress.set_substatus("Refitting BVH nodes");
   refit_nodes();
+
+  /* Refitting keeps the topology of the tree, which gets worse the further primitives move
+   * from where they were when it was built. Rebuild once traversal got too expensive. */
+  if (refit_sah_cost > build_sah_cost * params.refit_sah_threshold) {
+    LOG_DEBUG << "BVH SAH cost increased from " << build_sah_cost << " to " << refit_sah_cost
+              << " by refitting, rebuilding.";
+    build(progress, nullptr);
+  }
+}
+
+template<typename T> static void copy_prefix(const array<T> &from, array<T> &to, const size_t size)
+{
+  assert(from.size() >= size);
+  to.resize(size);
+  std::copy_n(from.data(), size, to.data());
+}
+
+PackedBVH BVH2::take_pack(const bool keep_top_level)
+{
+  PackedBVH taken = std::move(pack);
+  pack = PackedBVH();
+
+  if (keep_top_level && params.top_level) {
+    copy_prefix(taken.nodes, pack.nodes, top_level_nodes_size);
+    copy_prefix(taken.leaf_nodes, pack.leaf_nodes, top_level_leaf_nodes_size);
+    copy_prefix(taken.prim_type, pack.prim_type, top_level_prims_size);
+    copy_prefix(taken.prim_index, pack.prim_index, top_level_prims_size);
+    copy_prefix(taken.prim_object, pack.prim_object, top_level_prims_size);
+    if (taken.prim_time.size()) {
+      copy_prefix(taken.prim_time, pack.prim_time, top_level_prims_size);
+    }
+    pack.root_index = taken.root_index;
+  }
+
+  return taken;
+}
+
+/* Collapse binary inner nodes into their parent, always opening the child with the largest
+ * surface area first, until the node has the requested number of children. */
+static unique_ptr<BVHNode> collapse_children_nodes(unique_ptr<BVHNode> &&node, const int width)
+{
+  if (node == nullptr || node->is_leaf()) {
+    return std::move(node);
+  }
+
+  InnerNode *inner = static_cast<InnerNode *>(node.get());
+  while (inner->num_children_ < width) {
+    int best_child = -1;
+    float best_area = -FLT_MAX;
+    for (int i = 0; i < inner->num_children_; i++) {
+      const BVHNode *child = inner->children[i].get();
+      if (child == nullptr || child->is_leaf() ||
+          inner->num_children_ - 1 + child->num_children() > width)
+      {
+        continue;
+      }
+      const float area = child->bounds.safe_area();
+      if (area > best_area) {
+        best_child = i;
+        best_area = area;
+      }
+    }
+    if (best_child == -1) {
+      break;
+    }
+
+    const unique_ptr<BVHNode> child = std::move(inner->children[best_child]);
+    InnerNode *child_inner = static_cast<InnerNode *>(child.get());
+    inner->children[best_child] = std::move(child_inner->children[0]);
+    for (int i = 1; i < child_inner->num_children_; i++) {
+      inner->children[inner->num_children_++] = std::move(child_inner->children[i]);
+    }
+  }
+
+  for (int i = 0; i < inner->num_children_; i++) {
+    inner->children[i] = collapse_children_nodes(std::move(inner->children[i]), width);
+  }
+
+  return std::move(node);
 }
 
 unique_ptr<BVHNode> BVH2::widen_children_nodes(unique_ptr<BVHNode> &&root)
 {
+  if (params.bvh_layout == BVH_LAYOUT_BVH4) {
+    return collapse_children_nodes(std::move(root), BVH4_NODE_CHILDREN);
+  }
   return std::move(root);
 }
 
@@ -171,6 +273,122 @@ void BVH2::pack_aligned_node(const int idx,
   std::copy_n(data, BVH_NODE_SIZE, &pack.nodes[idx]);
 }
 
+void BVH2::pack_wide_inner(const BVHStackEntry &e, const BVHStackEntry *children, const int num)
+{
+  BoundBox bounds[BVH4_NODE_CHILDREN];
+  int child[BVH4_NODE_CHILDREN];
+  uint visibility[BVH4_NODE_CHILDREN];
+  for (int i = 0; i < num; i++) {
+    bounds[i] = children[i].node->bounds;
+    child[i] = children[i].encodeIdx();
+    visibility[i] = children[i].node->visibility;
+  }
+  pack_wide_node(e.idx, bounds, child, visibility, num);
+}
+
+/* Quantize child bounds along one axis to 8 bits relative to the node bounds. Rounding is
+ * conservative, with a margin of one ulp so the decoded bounds still enclose the child when
+ * the kernel evaluates them with fused multiply-add. */
+static void quantize_bounds(const float lo,
+                            const float hi,
+                            const float origin,
+                            const float scale,
+                            int &qlo,
+                            int &qhi)
+{
+  const float lo_limit = nextafterf(lo, -FLT_MAX);
+  const float hi_limit = nextafterf(hi, FLT_MAX);
+
+  qlo = clamp((int)floorf((lo - origin) / scale), 0, 255);
+  while (qlo > 0 && origin + (float)qlo * scale > lo_limit) {
+    qlo--;
+  }
+  qhi = clamp((int)ceilf((hi - origin) / scale), 0, 255);
+  while (qhi < 255 && origin + (float)qhi * scale < hi_limit) {
+    qhi++;
+  }
+}
+
+void BVH2::pack_wide_node(const int idx,
+                          const BoundBox *bounds,
+                          const int *child,
+                          const uint *visibility,
+                          const int num)
+{
+  assert(idx + wide_node_size() <= pack.nodes.size());
+  assert(num <= BVH4_NODE_CHILDREN);
+
+  /* Both layouts start with one row of visibility and one row of child indices. Unused slots
+   * have zero visibility and are never traversed, a child index of zero marks them as unused
+   * for refitting. */
+  int4 data[BVH4_NODE_SIZE];
+  for (int i = 0; i < BVH4_NODE_CHILDREN; i++) {
+    const bool valid = i < num;
+    assert(!valid || child[i] < 0 || child[i] < pack.nodes.size());
+    data[0][i] = valid ? (visibility[i] & ~PATH_RAY_NODE_UNALIGNED) : 0;
+    data[1][i] = valid ? child[i] : 0;
+  }
+
+  if (params.use_quantized_nodes) {
+    /* Node bounds as origin and scale of the 8 bit grid, followed by the quantized child bounds
+     * with one byte per child, packed as min.x, max.x, min.y, max.y, min.z, max.z. */
+    BoundBox node_bounds = BoundBox::empty;
+    for (int i = 0; i < num; i++) {
+      node_bounds.grow(bounds[i]);
+    }
+
+    float origin[3];
+    float scale[3];
+    uint quantized[6] = {0, 0, 0, 0, 0, 0};
+    for (int axis = 0; axis < 3; axis++) {
+      const float node_min = (num) ? node_bounds.min[axis] : 0.0f;
+      const float node_max = (num) ? node_bounds.max[axis] : 0.0f;
+      origin[axis] = nextafterf(node_min, -FLT_MAX);
+      scale[axis] = max((node_max - origin[axis]) / 255.0f, FLT_MIN);
+      while (origin[axis] + 255.0f * scale[axis] < nextafterf(node_max, FLT_MAX)) {
+        scale[axis] = nextafterf(scale[axis], FLT_MAX);
+      }
+
+      for (int i = 0; i < BVH4_NODE_CHILDREN; i++) {
+        /* Unused slots get an inverted box. */
+        int qlo = 255;
+        int qhi = 0;
+        if (i < num) {
+          quantize_bounds(
+              bounds[i].min[axis], bounds[i].max[axis], origin[axis], scale[axis], qlo, qhi);
+        }
+        quantized[axis * 2 + 0] |= (uint)qlo << (i * 8);
+        quantized[axis * 2 + 1] |= (uint)qhi << (i * 8);
+      }
+    }
+
+    data[2] = make_int4(__float_as_int(origin[0]),
+                        __float_as_int(origin[1]),
+                        __float_as_int(origin[2]),
+                        __float_as_int(scale[0]));
+    data[3] = make_int4(
+        __float_as_int(scale[1]), __float_as_int(scale[2]), quantized[0], quantized[1]);
+    data[4] = make_int4(quantized[2], quantized[3], quantized[4], quantized[5]);
+
+    std::copy_n(data, BVH4_QUANTIZED_NODE_SIZE, &pack.nodes[idx]);
+    return;
+  }
+
+  /* Six rows of child bounds, in the order min.x, max.x, min.y, max.y, min.z, max.z. Unused
+   * slots get an empty box. */
+  for (int i = 0; i < BVH4_NODE_CHILDREN; i++) {
+    const BoundBox &b = (i < num) ? bounds[i] : BoundBox::empty;
+    data[2][i] = __float_as_int(b.min.x);
+    data[3][i] = __float_as_int(b.max.x);
+    data[4][i] = __float_as_int(b.min.y);
+    data[5][i] = __float_as_int(b.max.y);
+    data[6][i] = __float_as_int(b.min.z);
+    data[7][i] = __float_as_int(b.max.z);
+  }
+
+  std::copy_n(data, BVH4_NODE_SIZE, &pack.nodes[idx]);
+}
+
 void BVH2::pack_unaligned_inner(const BVHStackEntry &e,
                                 const BVHStackEntry &e0,
                                 const BVHStackEntry &e1)
@@ -222,8 +440,12 @@ void BVH2::pack_nodes(const BVHNode *root)
   const size_t num_leaf_nodes = root->getSubtreeSize(BVH_STAT_LEAF_COUNT);
   assert(num_leaf_nodes <= num_nodes);
   const size_t num_inner_nodes = num_nodes - num_leaf_nodes;
+  const bool use_wide_nodes = (params.bvh_layout == BVH_LAYOUT_BVH4);
   size_t node_size;
-  if (params.use_unaligned_nodes) {
+  if (use_wide_nodes) {
+    node_size = num_inner_nodes * wide_node_size();
+  }
+  else if (params.use_unaligned_nodes) {
     const size_t num_unaligned_nodes = root->getSubtreeSize(BVH_STAT_UNALIGNED_INNER_COUNT);
     node_size = (num_unaligned_nodes * BVH_UNALIGNED_NODE_SIZE) +
                 (num_inner_nodes - num_unaligned_nodes) * BVH_NODE_SIZE;
@@ -236,7 +458,10 @@ void BVH2::pack_nodes(const BVHNode *root)
   pack.leaf_nodes.clear();
   /* For top level BVH, first merge existing BVH's so we know the offsets. */
   if (params.top_level) {
-    pack_instances(node_size, num_leaf_nodes * BVH_NODE_LEAF_SIZE);
+    top_level_nodes_size = node_size;
+    top_level_leaf_nodes_size = num_leaf_nodes * BVH_NODE_LEAF_SIZE;
+    top_level_prims_size = pack.prim_index.size();
+    pack_instances(top_level_nodes_size, top_level_leaf_nodes_size);
   }
   else {
     pack.nodes.resize(node_size);
@@ -246,14 +471,21 @@ void BVH2::pack_nodes(const BVHNode *root)
   int nextNodeIdx = 0;
   int nextLeafNodeIdx = 0;
 
+  auto inner_node_size = [this, use_wide_nodes](const BVHNode *node) {
+    if (use_wide_nodes) {
+      return wide_node_size();
+    }
+    return node->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE : BVH_NODE_SIZE;
+  };
+
   vector<BVHStackEntry> stack;
-  stack.reserve(BVHParams::MAX_DEPTH * 2);
+  stack.reserve(BVHParams::MAX_DEPTH * InnerNode::kNumMaxChildren);
   if (root->is_leaf()) {
     stack.push_back(BVHStackEntry(root, nextLeafNodeIdx++));
   }
   else {
     stack.push_back(BVHStackEntry(root, nextNodeIdx));
-    nextNodeIdx += root->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE : BVH_NODE_SIZE;
+    nextNodeIdx += inner_node_size(root);
   }
 
   while (!stack.empty()) {
@@ -267,22 +499,24 @@ void BVH2::pack_nodes(const BVHNode *root)
     }
     else {
       /* inner node */
-      int idx[2];
-      for (int i = 0; i < 2; ++i) {
-        if (e.node->get_child(i)->is_leaf()) {
-          idx[i] = nextLeafNodeIdx++;
+      const int num_children = e.node->num_children();
+      for (int i = 0; i < num_children; ++i) {
+        const BVHNode *child = e.node->get_child(i);
+        if (child->is_leaf()) {
+          stack.push_back(BVHStackEntry(child, nextLeafNodeIdx++));
         }
         else {
-          idx[i] = nextNodeIdx;
-          nextNodeIdx += e.node->get_child(i)->has_unaligned() ? BVH_UNALIGNED_NODE_SIZE :
-                                                                 BVH_NODE_SIZE;
+          stack.push_back(BVHStackEntry(child, nextNodeIdx));
+          nextNodeIdx += inner_node_size(child);
         }
       }
 
-      stack.push_back(BVHStackEntry(e.node->get_child(0), idx[0]));
-      stack.push_back(BVHStackEntry(e.node->get_child(1), idx[1]));
-
-      pack_inner(e, stack[stack.size() - 2], stack[stack.size() - 1]);
+      if (use_wide_nodes) {
+        pack_wide_inner(e, &stack[stack.size() - num_children], num_children);
+      }
+      else {
+        pack_inner(e, stack[stack.size() - 2], stack[stack.size() - 1]);
+      }
     }
   }
   assert(node_size == nextNodeIdx);
@@ -292,11 +526,13 @@ void BVH2::pack_nodes(const BVHNode *root)
 
 void BVH2::refit_nodes()
 {
-  assert(!params.top_level);
-
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
+  refit_area_cost = 0.0;
   refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+
+  const float root_area = bbox.safe_area();
+  refit_sah_cost = (root_area > 0.0f) ? (float)(refit_area_cost / root_area) : 0.0f;
 }
 
 void BVH2::refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility)
@@ -308,7 +544,15 @@ void BVH2::refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility
     const int c0 = data[0].x;
     const int c1 = data[0].y;
 
-    refit_primitives(c0, c1, bbox, visibility);
+    if (c0 < 0) {
+      /* Object instance in the top level. */
+      refit_primitives(~c0, ~c0 + 1, bbox, visibility);
+      refit_area_cost += bbox.safe_area() * params.cost(0, 1);
+    }
+    else {
+      refit_primitives(c0, c1, bbox, visibility);
+      refit_area_cost += bbox.safe_area() * params.cost(0, c1 - c0);
+    }
 
     /* TODO(sergey): De-duplicate with pack_leaf(). */
     int4 leaf_data[BVH_NODE_LEAF_SIZE];
@@ -318,6 +562,9 @@ void BVH2::refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility
     leaf_data[0].w = data[0].w;
     std::copy_n(leaf_data, BVH_NODE_LEAF_SIZE, &pack.leaf_nodes[idx]);
   }
+  else if (params.bvh_layout == BVH_LAYOUT_BVH4) {
+    refit_wide_node(idx, bbox, visibility);
+  }
   else {
     assert(idx + BVH_NODE_SIZE <= pack.nodes.size());
 
@@ -346,9 +593,36 @@ void BVH2::refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility
     bbox.grow(bbox0);
     bbox.grow(bbox1);
     visibility = visibility0 | visibility1;
+    refit_area_cost += bbox.safe_area() * params.cost(2, 0);
   }
 }
 
+void BVH2::refit_wide_node(const int idx, BoundBox &bbox, uint &visibility)
+{
+  assert(idx + wide_node_size() <= pack.nodes.size());
+
+  /* Children are packed first, an index of zero (the root) marks an unused slot. */
+  const int4 children = pack.nodes[idx + 1];
+  BoundBox child_bbox[BVH4_NODE_CHILDREN];
+  int child[BVH4_NODE_CHILDREN];
+  uint child_visibility[BVH4_NODE_CHILDREN];
+  int num = 0;
+
+  for (; num < BVH4_NODE_CHILDREN && children[num] != 0; num++) {
+    const int c = children[num];
+    child[num] = c;
+    child_bbox[num] = BoundBox::empty;
+    child_visibility[num] = 0;
+    refit_node((c < 0) ? -c - 1 : c, (c < 0), child_bbox[num], child_visibility[num]);
+
+    bbox.grow(child_bbox[num]);
+    visibility |= child_visibility[num];
+  }
+
+  pack_wide_node(idx, child_bbox, child, child_visibility, num);
+  refit_area_cost += bbox.safe_area() * params.cost(num, 0);
+}
+
 /* Refitting */
 
 void BVH2::refit_primitives(const int start, const int end, BoundBox &bbox, uint &visibility)
@@ -467,6 +741,24 @@ void BVH2::pack_primitives()
 
 /* Pack Instances */
 
+void BVH2::unpack_instances()
+{
+  /* Remove primitives merged from instance BVHs, and make primitive indices of the top level
+   * local to their geometry again as pack_instances() offsets them. */
+  pack.prim_index.resize(top_level_prims_size);
+  pack.prim_type.resize(top_level_prims_size);
+  pack.prim_object.resize(top_level_prims_size);
+  if (pack.prim_time.size()) {
+    pack.prim_time.resize(top_level_prims_size);
+  }
+
+  for (size_t i = 0; i < top_level_prims_size; i++) {
+    if (pack.prim_index[i] != -1) {
+      pack.prim_index[i] -= objects[pack.prim_object[i]]->get_geometry()->prim_offset;
+    }
+  }
+}
+
 void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 {
   /* Adjust primitive index to point to the triangle in the global array, for
@@ -610,7 +902,12 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
       for (size_t i = 0; i < bvh_nodes_size;) {
         size_t nsize;
         size_t nsize_bbox;
-        if (bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
+        if (params.bvh_layout == BVH_LAYOUT_BVH4) {
+          /* Child indices are in the second row of wide nodes. */
+          nsize = wide_node_size();
+          nsize_bbox = 1;
+        }
+        else if (bvh_nodes[i].x & PATH_RAY_NODE_UNALIGNED) {
           nsize = BVH_UNALIGNED_NODE_SIZE;
           nsize_bbox = 0;
         }
@@ -623,6 +920,10 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 
         /* Modify offsets into arrays */
         int4 data = bvh_nodes[i + nsize_bbox];
+        if (params.bvh_layout == BVH_LAYOUT_BVH4) {
+          data.x += (data.x < 0) ? -noffset_leaf : noffset;
+          data.y += (data.y < 0) ? -noffset_leaf : noffset;
+        }
         data.z += (data.z < 0) ? -noffset_leaf : noffset;
         data.w += (data.w < 0) ? -noffset_leaf : noffset;
         pack_nodes[pack_nodes_offset + nsize_bbox] = data;
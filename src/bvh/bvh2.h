@@ -20,6 +20,9 @@ CCL_NAMESPACE_BEGIN
 #define BVH_NODE_SIZE 4
 #define BVH_NODE_LEAF_SIZE 1
 #define BVH_UNALIGNED_NODE_SIZE 7
+#define BVH4_NODE_SIZE 8
+#define BVH4_QUANTIZED_NODE_SIZE 5
+#define BVH4_NODE_CHILDREN 4
 // NOLINTEND
 
 /* Pack Utility */
@@ -34,7 +37,10 @@ struct BVHStackEntry {
 /* BVH2
  *
  * Typical BVH with each node having two children.
- */
+ *
+ * With BVH_LAYOUT_BVH4 the binary tree is collapsed into nodes with up to four children,
+ * stored as structure of arrays so all child boxes are tested at once on the CPU. Their child
+ * bounds can optionally be quantized to 8 bits, reducing node size from 128 to 80 bytes. */
 class BVH2 : public BVH {
  public:
   BVH2(const BVHParams &params,
@@ -44,8 +50,17 @@ class BVH2 : public BVH {
   void build(Progress &progress, Stats *stats);
   void refit(Progress &progress);
 
+  /* Move the packed data out, to be stolen by the device arrays. When keeping the top level
+   * part, only the nodes and primitives of the top level are copied, which is all refit() needs
+   * to merge the instance BVHs in again. */
+  PackedBVH take_pack(const bool keep_top_level);
+
   PackedBVH pack;
 
+  /* SAH cost of the tree when it was last built, and after the last refit. */
+  float build_sah_cost = 0.0f;
+  float refit_sah_cost = 0.0f;
+
  protected:
   /* Building process. */
   virtual unique_ptr<BVHNode> widen_children_nodes(unique_ptr<BVHNode> &&root);
@@ -67,6 +82,17 @@ class BVH2 : public BVH {
                          uint visibility0,
                          uint visibility1);
 
+  int wide_node_size() const
+  {
+    return params.use_quantized_nodes ? BVH4_QUANTIZED_NODE_SIZE : BVH4_NODE_SIZE;
+  }
+  void pack_wide_inner(const BVHStackEntry &e, const BVHStackEntry *children, const int num);
+  void pack_wide_node(const int idx,
+                      const BoundBox *bounds,
+                      const int *child,
+                      const uint *visibility,
+                      const int num);
+
   void pack_unaligned_inner(const BVHStackEntry &e,
                             const BVHStackEntry &e0,
                             const BVHStackEntry &e1);
@@ -83,6 +109,7 @@ class BVH2 : public BVH {
   /* refit */
   void refit_nodes();
   void refit_node(const int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  void refit_wide_node(const int idx, BoundBox &bbox, uint &visibility);
 
   /* Refit range of primitives. */
   void refit_primitives(const int start, const int end, BoundBox &bbox, uint &visibility);
@@ -92,6 +119,15 @@ class BVH2 : public BVH {
 
   /* merge instance BVH's */
   void pack_instances(const size_t nodes_size, const size_t leaf_nodes_size);
+  void unpack_instances();
+
+  /* Size of the top level arrays before instance BVHs are merged into them. */
+  size_t top_level_nodes_size = 0;
+  size_t top_level_leaf_nodes_size = 0;
+  size_t top_level_prims_size = 0;
+
+  /* Sum of node areas weighted by their cost, accumulated while refitting. */
+  double refit_area_cost = 0.0;
 };
 
 CCL_NAMESPACE_END
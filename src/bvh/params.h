@@ -87,6 +87,11 @@ class BVHParams {
    */
   bool use_unaligned_nodes;
 
+  /* Store child bounds quantized to 8 bits relative to the node bounds.
+   * Only used for BVH4 layout.
+   */
+  bool use_quantized_nodes;
+
   /* Use compact acceleration structure (Embree)*/
   bool use_compact_structure;
 
@@ -104,6 +109,10 @@ class BVHParams {
   /* Same as in SceneParams. */
   int bvh_type;
 
+  /* Rebuild a refitted BVH once its SAH cost grew past this factor of the cost it had
+   * when it was built. */
+  float refit_sah_threshold;
+
   /* These are needed for Embree. */
   int curve_subdivisions;
 
@@ -134,12 +143,14 @@ class BVHParams {
     bvh_layout = BVH_LAYOUT_BVH2;
     use_compact_structure = false;
     use_unaligned_nodes = false;
+    use_quantized_nodes = false;
 
     num_motion_curve_steps = 0;
     num_motion_triangle_steps = 0;
     num_motion_point_steps = 0;
 
     bvh_type = 0;
+    refit_sah_threshold = 1.5f;
 
     curve_subdivisions = 4;
   }
@@ -40,6 +40,7 @@
 #include "util/types.h"
 
 #include "util/args.h"
+#include "util/debug.h"
 #include "util/image.h"
 #include "util/log.h"
 #include "util/path.h"
@@ -177,7 +178,12 @@ void scene_init(Options& options)
 	/* Calculate Viewplane */
 	options.scene->camera->compute_auto_viewplane();
 
-	options.scene->integrator->set_use_adaptive_sampling(false);
+	options.scene->integrator->set_use_adaptive_sampling(options.adaptive_sampling);
+	options.scene->integrator->set_volume_fast(options.volume_fast);
+
+	if (options.blue_noise) {
+		options.scene->integrator->set_sampling_pattern(ccl::SAMPLING_PATTERN_BLUE_NOISE_TILED);
+	}
 
 	//options.scene->integrator->set_volume_step_rate(0.1f);
 	//options.scene->integrator->set_volume_max_steps(64);
@@ -247,11 +253,62 @@ void session_init(FromCL& fromCL, Options& options, int session_id)
 	options.session_params.use_resolution_divider = false;
 	options.session_params.samples = 1;
 
+#ifdef WITH_CLIENT_GPUJPEG
+	// GPUJPEG encodes the pixels straight from the device buffer of the display
+	const bool use_device_buffer = (options.session_params.device.type != ccl::DEVICE_CPU);
+#else
+	const bool use_device_buffer = false;
+#endif
+
+	// lower resolution after every reset to keep the frame time, the display driver upsamples
+	// the host pixels, the device buffer is sent as rendered so it must have the full resolution
+	if (fromCL.frame_budget > 0.0f) {
+		if (use_device_buffer) {
+			printf("The frame budget is not supported with GPUJPEG on GPU, rendering at full resolution.\n");
+		}
+		else {
+			options.session_params.use_resolution_divider = true;
+			options.session_params.navigation_time_budget = fromCL.frame_budget / 1000.0;
+		}
+	}
+
 	//TODO
 	options.session_params.threads = fromCL.threads;
 
+	if (fromCL.use_numa) {
+		ccl::DebugFlags().cpu.numa = true;
+	}
+
+	// identical images, meshes and BVHs of the --anim frames are stored once
+	if (fromCL.use_share_scene_data) {
+		ccl::DebugFlags().cpu.share_scene_data = true;
+	}
+
+	// profile shading for a few samples, then compile code for the hottest shaders
+	if (fromCL.svm_specialize > 0 && options.session_params.device.type == ccl::DEVICE_CPU) {
+		options.session_params.use_profiling = true;
+		options.svm_specialize_samples = 16;
+		options.svm_specialize_shaders = fromCL.svm_specialize;
+	}
+
+	options.async_reset = fromCL.use_async_reset;
+
+	// volume-only preview, the GPU devices keep the full path tracer
+	options.volume_fast = fromCL.use_volume_fast;
+
+	// converged pixels stop changing, so only the changed tiles are sent
+	options.adaptive_sampling = fromCL.use_adaptive_sampling;
+
+	// small camera moves keep part of the previous samples, needs the depth pass
+	options.temporal_reprojection = fromCL.use_temporal_reprojection;
+
+	// blue-noise error at any sample count, which is unknown while rendering progressively
+	options.blue_noise = fromCL.use_blue_noise;
+
 	options.output_pass = "combined";
 
+	options.scene_params.use_bvh_quantized_nodes = fromCL.use_bvh_quantized;
+
 	options.session = new ccl::Session(options.session_params, options.scene_params);
 
 	// if (!options.output_filepath.empty()) {
@@ -266,12 +323,32 @@ void session_init(FromCL& fromCL, Options& options, int session_id)
 	options.display_driver = display_driver.get();
 	options.session->set_display_driver(std::move(display_driver));
 #ifdef WITH_CLIENT_GPUJPEG
-	if (options.session_params.device.type != ccl::DEVICE_CPU) {
+	if (use_device_buffer) {
 		options.display_driver->use_device_buffer = true;
 		options.display_driver->use_linear2srgb = true;
 	}
+#else
+	// The film is converted straight into the send buffer in the requested format
+	if (fromCL.pixel_format == "srgb8") {
+		options.display_driver->use_linear2srgb = true;
+	}
+	else if (fromCL.pixel_format == "yuv420") {
+		if (options.session_params.device.type == ccl::DEVICE_CPU) {
+			options.display_driver->use_yuv420 = true;
+		}
+		else {
+			printf("YUV 4:2:0 pixels are only supported on CPU, sending srgb8 instead.\n");
+			options.display_driver->use_linear2srgb = true;
+		}
+	}
 #endif
 
+	if (options.adaptive_sampling) {
+		auto convergence_driver = std::make_unique<ccl::TileConvergenceDriver>();
+		options.convergence_driver = convergence_driver.get();
+		options.session->set_output_driver(std::move(convergence_driver));
+	}
+
 	//	}
 	//	else 
 	//#endif
@@ -295,6 +372,20 @@ void session_init(FromCL& fromCL, Options& options, int session_id)
 	pass->set_name(ccl::ustring(options.output_pass.c_str()));
 	pass->set_type(ccl::PASS_COMBINED);
 
+	/* convergence of the pixels for the tile stream */
+	if (options.adaptive_sampling) {
+		ccl::Pass* aux_pass = options.scene->create_node<ccl::Pass>();
+		aux_pass->set_name(ccl::ustring(TILE_STREAM_ADAPTIVE_PASS));
+		aux_pass->set_type(ccl::PASS_ADAPTIVE_AUX_BUFFER);
+	}
+
+	/* depth of the pixels to reproject them into the next camera */
+	if (options.temporal_reprojection) {
+		ccl::Pass* depth_pass = options.scene->create_node<ccl::Pass>();
+		depth_pass->set_name(ccl::ustring("Depth"));
+		depth_pass->set_type(ccl::PASS_DEPTH);
+	}
+
 	///////////////////////////////////////////
 	//auto* shader = options.scene->default_background;
 	//auto* graph = new ccl::ShaderGraph();
@@ -331,12 +422,61 @@ void session_exit(FromCL& fromCL, Options& options)
 	}
 }
 
-void renderFrame(Options* options)
+// Time to wait for a frame before checking if the session is still updating the scene
+static const double async_reset_poll_time = 0.01;
+
+// Copies the pixels of the last finished frame, under the lock the render thread holds while
+// writing them, so they can be sent while the next frame is written
+static void copy_previous_frame(ccl::FrameDisplayDriver* display_driver, ccl::vector<ccl::half4>& dst)
 {
+	ccl::thread_scoped_lock pixels_lock(display_driver->pixels_mutex);
+
+	const size_t size = display_driver->pixels_size();
+	dst.resize(ccl::divide_up(size, sizeof(ccl::half4)));
+
+#ifdef WITH_CLIENT_GPUJPEG
+	// the pixels are only in the device buffer of the render device, encoded from a host copy
+	if (display_driver->d_pixels) {
+		CUcontext context = NULL;
+		cuda_assert(cuPointerGetAttribute(&context, CU_POINTER_ATTRIBUTE_CONTEXT, (CUdeviceptr)display_driver->d_pixels));
+		cuda_assert(cuCtxPushCurrent(context));
+		cuda_assert(cuMemcpyDtoH(dst.data(), (CUdeviceptr)display_driver->d_pixels, size));
+		cuda_assert(cuCtxPopCurrent(NULL));
+		return;
+	}
+#endif
+
+	memcpy(dst.data(), display_driver->pixels.data(), size);
+}
+
+// Returns false if the frame was not rendered because the scene is still being updated, the
+// pixels of the display driver are those of the previous frame then
+bool renderFrame(Options* options)
+{
+	// all pixels converged, more samples would not render anything and the display would not be
+	// updated, so keep the current image
+	if (options->adaptive_sampling && options->session_samples > 0 && options->session->is_render_converged()) {
+		return true;
+	}
+
 	if (options->display_driver)
 		options->display_driver->renderBegin();
 
 	if (options->session_samples == 0) { // reset
+		const CyclesphiFoveation& foveation = options->foveation;
+		if (foveation.enabled) {
+			options->session_params.sample_density.set_focus(ccl::make_int2(options->width, options->height),
+				ccl::make_float4(foveation.region[0], foveation.region[1], foveation.region[2], foveation.region[3]),
+				foveation.radius, foveation.falloff, foveation.min_density);
+		}
+		else {
+			options->session_params.sample_density.clear();
+		}
+
+		options->session_params.temporal_reprojection.use = options->temporal_reprojection;
+		options->session_params.temporal_reprojection.scene_modified = options->scene_modified;
+		options->scene_modified = false;
+
 		options->session->reset(options->session_params, session_buffer_params(*options));
 	}
 
@@ -353,9 +493,27 @@ void renderFrame(Options* options)
 	//	options->output_driver->wait();		
 
 	//if (options->display_driver->use_device_buffer)
-	options->display_driver->wait();
+	if (options->async_reset) {
+		while (!options->display_driver->wait_for(async_reset_poll_time)) {
+			if (options->session->is_updating_scene()) {
+				return false;
+			}
+		}
+	}
+	else {
+		options->display_driver->wait();
+	}
 	//else
 	//	options->session->wait();
+
+	if (options->svm_specialize_samples > 0 && options->session_samples >= options->svm_specialize_samples) {
+		options->session->specialize_hot_shaders(options->svm_specialize_shaders);
+		options->svm_specialize_samples = 0;
+		// the scene update restarts rendering, so reset on the next frame
+		options->session_samples = 0;
+	}
+
+	return true;
 }
 
 struct CyclesphiDataRenderAux {
@@ -388,7 +546,11 @@ int cyclesphi(int ac, char** av, TcpConnection* blenderClientTcp, FromCL& fromCL
 	//#endif
 
 	std::vector<char> pixels_buf_empty;
+	ccl::vector<ccl::half4> previous_pixels;
+	ccl::vector<char> tile_message;
+	ccl::vector<ccl::uchar> tile_converged;
 	CyclesphiDataRenderAux data_render_aux_rcv;
+	CyclesphiFoveation foveation_rcv = {};
 	std::vector<CyclesphiDataRenderAux> data_render_aux;
 
 	//TransferFunction xf;
@@ -471,6 +633,11 @@ int cyclesphi(int ac, char** av, TcpConnection* blenderClientTcp, FromCL& fromCL
 
 		// check animation
 		if (options.size() > 1 && blenderClientTcp->get_frame() >= 0 && blenderClientTcp->get_frame() < options.size()) {
+			// keep the render buffers of the frame we leave compact until it is shown again
+			if (fromCL.use_pack_idle_buffers && main_options != &options[blenderClientTcp->get_frame()] && main_options->session) {
+				main_options->session->pack_render_buffers();
+			}
+
 			main_options = &options[blenderClientTcp->get_frame()];
 			main_renderengine_data = &g_renderengine_datas[blenderClientTcp->get_frame()];
 			main_data_render_aux = &data_render_aux[blenderClientTcp->get_frame()];
@@ -490,6 +657,10 @@ int cyclesphi(int ac, char** av, TcpConnection* blenderClientTcp, FromCL& fromCL
 			data_render_aux_rcv.data.push_back('\0');
 		}
 
+		if (fromCL.use_foveation) {
+			blenderClientTcp->recv_data_data((char*)&foveation_rcv, sizeof(CyclesphiFoveation));
+		}
+
 		if (blenderClientTcp->is_error()) {
 			//throw std::runtime_error("TCP Error!");
 			break;
@@ -502,8 +673,19 @@ int cyclesphi(int ac, char** av, TcpConnection* blenderClientTcp, FromCL& fromCL
 		DEBUG_END_TIME(receive);
 
 		try {
+			// while the session updates the scene for the last edit, keep sending the previous image
+			// and leave new edits for when the update is done
+			bool serve_previous = main_options->async_reset && main_options->session->is_updating_scene();
+
+			// the session thread may start updating the scene at any time, lock it while editing,
+			// if it already holds the lock the update started and the previous image is sent
+			ccl::thread_scoped_lock scene_lock(main_options->scene->mutex, std::defer_lock);
+			if (main_options->async_reset && !serve_previous && !scene_lock.try_lock()) {
+				serve_previous = true;
+			}
+
 			// cam_change
-			if (/*renderer == NULL || */ memcmp(main_renderengine_data, &g_renderengine_data_rcv, sizeof(renderengine_data))) {
+			if (!serve_previous && /*renderer == NULL || */ memcmp(main_renderengine_data, &g_renderengine_data_rcv, sizeof(renderengine_data))) {
 				DEBUG_START_TIME(camera);
 				memcpy(main_renderengine_data, &g_renderengine_data_rcv, sizeof(renderengine_data));
 
@@ -634,7 +816,7 @@ int cyclesphi(int ac, char** av, TcpConnection* blenderClientTcp, FromCL& fromCL
 				DEBUG_END_TIME(resize_rcv_data);
 			}
 
-			if (data_render_aux_rcv.data.size() > 0 && memcmp(main_data_render_aux->data.data(), data_render_aux_rcv.data.data(), data_render_aux_rcv.data.size())) {
+			if (!serve_previous && data_render_aux_rcv.data.size() > 0 && memcmp(main_data_render_aux->data.data(), data_render_aux_rcv.data.data(), data_render_aux_rcv.data.size())) {
 				DEBUG_START_TIME(material);
 				memcpy(main_data_render_aux->data.data(), data_render_aux_rcv.data.data(), data_render_aux_rcv.data.size());
 
@@ -645,6 +827,7 @@ int cyclesphi(int ac, char** av, TcpConnection* blenderClientTcp, FromCL& fromCL
 				//Camera cam = renderer->getCamera();
 				//renderer->resetAccumulation();
 				main_options->session_samples = 0;
+				main_options->scene_modified = true;
 				//total_samples = 0;
 				render_time = 0;
 				render_time_accu = 0;
@@ -667,21 +850,46 @@ int cyclesphi(int ac, char** av, TcpConnection* blenderClientTcp, FromCL& fromCL
 				DEBUG_END_TIME(material);
 			}
 
+			// new focus region, the sample density is rebuilt on reset
+			if (!serve_previous && memcmp(&main_options->foveation, &foveation_rcv, sizeof(CyclesphiFoveation))) {
+				memcpy(&main_options->foveation, &foveation_rcv, sizeof(CyclesphiFoveation));
+				main_options->session_samples = 0;
+				render_time = 0;
+				render_time_accu = 0;
+			}
+
+			if (scene_lock.owns_lock()) {
+				scene_lock.unlock();
+			}
+
 			/////////////////////////////////////////////////
 			DEBUG_START_TIME(render);
-			renderFrame(main_options);
+			const bool frame_ready = !serve_previous && renderFrame(main_options);
 			DEBUG_END_TIME(render);
 
+			// the render thread writes the pixels of the new frame as soon as the update is done,
+			// send a copy of the previous frame so the render thread does not wait for the network
+			const ccl::half4* send_pixels = nullptr;
+			if (main_options->display_driver) {
+				if (frame_ready) {
+					send_pixels = main_options->display_driver->pixels.data();
+				}
+				else {
+					copy_previous_frame(main_options->display_driver, previous_pixels);
+					send_pixels = previous_pixels.data();
+				}
+			}
+
 #ifdef WITH_CLIENT_GPUJPEG     
 			if (main_options->display_driver) {
 				DEBUG_START_TIME(send_gpujpeg_display);
 				int format = main_options->display_driver->use_linear2srgb ? 8 : 16;
-				if (main_options->display_driver->d_pixels) {
+				if (frame_ready && main_options->display_driver->d_pixels) {
 					blenderClientTcp->send_gpujpeg((char*)main_options->display_driver->d_pixels, pixels_buf_empty.data(), main_options->width, main_options->height, format);
 				}
 				else {
 					// TODO
-					blenderClientTcp->send_gpujpeg((char*)main_options->display_driver->pixels.data(), pixels_buf_empty.data(), main_options->width, main_options->height, format);
+					blenderClientTcp->send_gpujpeg((char*)send_pixels, pixels_buf_empty.data(), main_options->width, main_options->height, format);
 				}
 				//blenderClientTcp->send_gpujpeg((char*)main_options->display_driver->pixels.data(), pixels_buf_empty.data(), main_options->width, main_options->height, 0);
 				DEBUG_END_TIME(send_gpujpeg_display);
@@ -700,9 +908,21 @@ int cyclesphi(int ac, char** av, TcpConnection* blenderClientTcp, FromCL& fromCL
 			//blenderClientTcp->send_data_data((char*)main_options->output_driver->pixels.data(), pixels_buf_empty.size());
 			//DEBUG_END_TIME(send_output);
 
-			if (main_options->display_driver) {
+			if (main_options->display_driver && main_options->adaptive_sampling) {
+				DEBUG_START_TIME(send_tile_stream);
+				ccl::FrameDisplayDriver* display_driver = main_options->display_driver;
+				const int bytes_per_pixel = display_driver->use_linear2srgb ? 4 : sizeof(ccl::half4);
+				main_options->convergence_driver->get_converged(display_driver->width, display_driver->height, tile_converged);
+				main_options->tile_stream.pack((const char*)send_pixels, display_driver->width, display_driver->height, bytes_per_pixel, display_driver->use_yuv420, tile_converged, tile_message);
+
+				const int message_size = tile_message.size();
+				blenderClientTcp->send_data_data((char*)&message_size, sizeof(int));
+				blenderClientTcp->send_data_data(tile_message.data(), tile_message.size());
+				DEBUG_END_TIME(send_tile_stream);
+			}
+			else if (main_options->display_driver) {
 				DEBUG_START_TIME(send_gpujpeg_display);
-				blenderClientTcp->send_data_data((char*)main_options->display_driver->pixels.data(), pixels_buf_empty.size());
+				blenderClientTcp->send_data_data((char*)send_pixels, main_options->display_driver->pixels_size());
 				DEBUG_END_TIME(send_gpujpeg_display);
 			}
 			//else if (main_options->output_driver) {
@@ -788,6 +1008,19 @@ void FromCL::usage()
 	std::cout << "\t--port X" << std::endl;
 	std::cout << "\t--anim X" << std::endl;
     std::cout << "\t--threads X" << std::endl;
+	std::cout << "\t--bvh-quantized" << std::endl;
+	std::cout << "\t--numa" << std::endl;
+	std::cout << "\t--pixel-format half4|srgb8|yuv420" << std::endl;
+	std::cout << "\t--pack-idle-buffers" << std::endl;
+	std::cout << "\t--share-scene-data" << std::endl;
+	std::cout << "\t--svm-specialize X" << std::endl;
+	std::cout << "\t--async-reset" << std::endl;
+	std::cout << "\t--volume-fast" << std::endl;
+	std::cout << "\t--adaptive-sampling" << std::endl;
+	std::cout << "\t--foveation" << std::endl;
+	std::cout << "\t--temporal-reprojection" << std::endl;
+	std::cout << "\t--frame-budget MS" << std::endl;
+	std::cout << "\t--blue-noise" << std::endl;
 
 	const ccl::vector<ccl::DeviceInfo> devices = ccl::Device::available_devices();
 	printf("Devices:\n");
@@ -820,6 +1053,45 @@ void FromCL::parse_args(int argc, char** argv)
 		else if (arg == "--threads") {
 			threads = std::stoi(argv[++i]);
 		}
+		else if (arg == "--bvh-quantized") {
+			use_bvh_quantized = true;
+		}
+		else if (arg == "--numa") {
+			use_numa = true;
+		}
+		else if (arg == "--pixel-format") {
+			pixel_format = argv[++i];
+		}
+		else if (arg == "--pack-idle-buffers") {
+			use_pack_idle_buffers = true;
+		}
+		else if (arg == "--share-scene-data") {
+			use_share_scene_data = true;
+		}
+		else if (arg == "--svm-specialize") {
+			svm_specialize = std::stoi(argv[++i]);
+		}
+		else if (arg == "--async-reset") {
+			use_async_reset = true;
+		}
+		else if (arg == "--volume-fast") {
+			use_volume_fast = true;
+		}
+		else if (arg == "--adaptive-sampling") {
+			use_adaptive_sampling = true;
+		}
+		else if (arg == "--foveation") {
+			use_foveation = true;
+		}
+		else if (arg == "--temporal-reprojection") {
+			use_temporal_reprojection = true;
+		}
+		else if (arg == "--frame-budget") {
+			frame_budget = std::stof(argv[++i]);
+		}
+		else if (arg == "--blue-noise") {
+			use_blue_noise = true;
+		}
 		else if (arg == "--scene") {
 			filepath = argv[++i];
 		}
@@ -26,6 +26,7 @@
 
 //#include "frame_output_driver.h"
 #include "frame_display_driver.h"
+#include "tile_stream.h"
 
 #include "renderengine_tcp.h"
 
@@ -35,6 +36,19 @@ public:
 		port(7000), 
 		anim(-1), 
 		threads(0),
+		use_bvh_quantized(false),
+		use_numa(false),
+		pixel_format("half4"),
+		use_pack_idle_buffers(false),
+		use_share_scene_data(false),
+		svm_specialize(0),
+		use_async_reset(false),
+		use_volume_fast(false),
+		use_adaptive_sampling(false),
+		use_foveation(false),
+		use_temporal_reprojection(false),
+		frame_budget(0.0f),
+		use_blue_noise(false),
 		use_anim(false), 
 		used_device("CPU"), 		
 		use_mpi(false),    
@@ -56,6 +70,46 @@ public:
 
 	int threads;
 
+	// Use 8 bit quantized wide BVH nodes on the CPU
+	bool use_bvh_quantized;
+
+	// Pin CPU render threads to NUMA nodes with node local scene data
+	bool use_numa;
+
+	// Format of the pixels sent to the client: half4, srgb8 or yuv420
+	std::string pixel_format;
+
+	// Pack render buffers of --anim frames which are not displayed
+	bool use_pack_idle_buffers;
+
+	// Share identical scene data between the sessions of --anim frames on the CPU
+	bool use_share_scene_data;
+
+	// Number of hot shaders to compile specialized SVM code for on the CPU, 0 disables it
+	int svm_specialize;
+
+	// Keep sending the previous image while the scene is updated after an edit
+	bool use_async_reset;
+
+	// Render volumes only with emission, absorption and single scattering on the CPU
+	bool use_volume_fast;
+
+	// Stop sampling converged pixels and send only the tiles which changed, see tile_stream.h
+	bool use_adaptive_sampling;
+
+	// Receive a CyclesphiFoveation after the render data of every frame
+	bool use_foveation;
+
+	// Seed the samples after camera moves with the reprojected previous image
+	bool use_temporal_reprojection;
+
+	// Milliseconds a frame may take while the camera moves, rendered at a lower resolution to fit
+	// it and refined to full resolution once the camera is still, 0 disables
+	float frame_budget;
+
+	// Distribute the noise of the few samples of interactive frames as blue noise
+	bool use_blue_noise;
+
 	// Atomic flag to control the infinite loops
 	std::atomic<bool> render_running;
 
@@ -63,6 +117,16 @@ public:
 	virtual void usage();
 };
 
+// Focus region of the viewer, full sampling density around it falling off to min_density in the
+// periphery. In pixels of the requested image, with the rows in the order of the sent pixels
+struct CyclesphiFoveation {
+	int enabled;
+	float region[4]; // min x, min y, max x, max y, a point for a circular fovea
+	float radius;
+	float falloff;
+	float min_density;
+};
+
 struct Options {
 	int id = 0;
 
@@ -78,6 +142,31 @@ struct Options {
 	std::string output_pass;
 	int session_samples = 0;
 
+	// Hot shaders are specialized once after this many samples, 0 when done or disabled
+	int svm_specialize_samples = 0;
+	int svm_specialize_shaders = 0;
+
+	// Send the previous image instead of waiting for scene updates
+	bool async_reset = false;
+
+	// Use the fast volume-only integrator instead of the full path tracer
+	bool volume_fast = false;
+
+	// Adaptive sampling, with the changed tiles sent in the tile stream format
+	bool adaptive_sampling = false;
+	ccl::TileConvergenceDriver* convergence_driver = nullptr;
+	ccl::TileStream tile_stream;
+
+	// Focus region received from the client, applied on reset
+	CyclesphiFoveation foveation = {};
+
+	// Reuse the samples of the previous camera on reset, unless the materials changed
+	bool temporal_reprojection = false;
+	bool scene_modified = false;
+
+	// Use the tiled blue-noise sampling pattern
+	bool blue_noise = false;
+
 	//ccl::FrameOutputDriver* output_driver = nullptr;
 	ccl::FrameDisplayDriver* display_driver = nullptr;
 };
@@ -9,6 +9,7 @@
 
 #include "util/log.h"
 #include "util/string.h"
+#include "util/tbb.h"
 
 //#include <SDL.h>
 //#include <epoxy/gl.h>
@@ -39,8 +40,12 @@ void FrameDisplayDriver::next_tile_begin()
 
 bool FrameDisplayDriver::update_begin(const Params& params, int texture_width, int texture_height)
 {
-	width = texture_width;
-	height = texture_height;
+	pixels_mutex.lock();
+
+	width = params.size.x;
+	height = params.size.y;
+	this->texture_width = texture_width;
+	this->texture_height = texture_height;
 
 	///* Note that it's the responsibility of FrameDisplayDriver to ensure updating and drawing
 	// * the texture does not happen at the same time. This is achieved indirectly.
@@ -111,6 +116,12 @@ void FrameDisplayDriver::update_end()
 
   //gl_context_disable_();
 
+	if (texture_width != width || texture_height != height) {
+		upsample_texture();
+	}
+
+	pixels_mutex.unlock();
+
 //#ifndef WITH_CLIENT_GPUJPEG
 	renderEnd();
 //#endif
@@ -159,6 +170,12 @@ void FrameDisplayDriver::wait()
 	}
 }
 
+bool FrameDisplayDriver::wait_for(const double seconds)
+{
+	thread_scoped_lock lock(mutex);
+	return cv.wait_for(lock, std::chrono::duration<double>(seconds), [this] { return render_finished; });
+}
+
 bool FrameDisplayDriver::ready() const
 {
 	return render_finished;
@@ -167,6 +184,7 @@ bool FrameDisplayDriver::ready() const
 
 void FrameDisplayDriver::copy_texture_buffer(const half4* rgba_pixels, int texture_x, int texture_y, int pixels_width, int pixels_height)
 {
+	// sent as it is, so the resolution divider is not used with device buffers
 	d_pixels = (void*)rgba_pixels;
 
 //#ifdef WITH_CLIENT_GPUJPEG
@@ -197,6 +215,12 @@ half4* FrameDisplayDriver::map_texture_buffer()
 		pixels.resize(width * height);
 	}
 
+	// lower resolution during navigation, rendered into a separate buffer to be upsampled
+	if (texture_width != width || texture_height != height) {
+		texture_pixels.resize(size_t(texture_width) * texture_height);
+		return texture_pixels.data();
+	}
+
 	half4* mapped_rgba_pixels = pixels.data();// reinterpret_cast<half4*>(glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
 	/*if (!mapped_rgba_pixels) {
 	  LOG(ERROR) << "Error mapping FrameDisplayDriver pixel buffer object.";
@@ -214,6 +238,70 @@ half4* FrameDisplayDriver::map_texture_buffer()
 	return mapped_rgba_pixels;
 }
 
+size_t FrameDisplayDriver::pixels_size() const
+{
+	const size_t num_pixels = size_t(width) * height;
+	if (use_yuv420) {
+		return num_pixels + 2 * size_t((width + 1) / 2) * ((height + 1) / 2);
+	}
+	if (use_linear2srgb) {
+		return num_pixels * sizeof(uchar4);
+	}
+	return num_pixels * sizeof(half4);
+}
+
+/* Nearest neighbor upsampling of a plane of pixels, like the viewport draws the texture with a
+ * resolution divider. */
+template<typename T>
+static void upsample_plane(const T* src, const int src_width, const int src_height, T* dst, const int dst_width, const int dst_height)
+{
+	vector<int> src_x(dst_width);
+	for (int x = 0; x < dst_width; x++) {
+		src_x[x] = x * src_width / dst_width;
+	}
+
+	parallel_for(0, dst_height, [&](const int y) {
+		const T* src_row = src + size_t(y * src_height / dst_height) * src_width;
+		T* dst_row = dst + size_t(y) * dst_width;
+		for (int x = 0; x < dst_width; x++) {
+			dst_row[x] = src_row[src_x[x]];
+		}
+	});
+}
+
+void FrameDisplayDriver::upsample_texture()
+{
+	if (texture_width == 0 || texture_height == 0 || texture_pixels.empty()) {
+		return;
+	}
+
+	if (use_yuv420) {
+		const uchar* src = (const uchar*)texture_pixels.data();
+		uchar* dst = (uchar*)pixels.data();
+		const int src_chroma_width = (texture_width + 1) / 2;
+		const int src_chroma_height = (texture_height + 1) / 2;
+		const int dst_chroma_width = (width + 1) / 2;
+		const int dst_chroma_height = (height + 1) / 2;
+		const size_t src_chroma_size = size_t(src_chroma_width) * src_chroma_height;
+		const size_t dst_chroma_size = size_t(dst_chroma_width) * dst_chroma_height;
+
+		upsample_plane(src, texture_width, texture_height, dst, width, height);
+		src += size_t(texture_width) * texture_height;
+		dst += size_t(width) * height;
+		for (int plane = 0; plane < 2; plane++) {
+			upsample_plane(src, src_chroma_width, src_chroma_height, dst, dst_chroma_width, dst_chroma_height);
+			src += src_chroma_size;
+			dst += dst_chroma_size;
+		}
+	}
+	else if (use_linear2srgb) {
+		upsample_plane((const uchar4*)texture_pixels.data(), texture_width, texture_height, (uchar4*)pixels.data(), width, height);
+	}
+	else {
+		upsample_plane(texture_pixels.data(), texture_width, texture_height, pixels.data(), width, height);
+	}
+}
+
 void FrameDisplayDriver::unmap_texture_buffer()
 {
   //glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
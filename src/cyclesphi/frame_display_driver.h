@@ -57,6 +57,17 @@ class FrameDisplayDriver : public DisplayDriver {
 	  return use_linear2srgb;
   };
 
+  virtual bool buffer_yuv420() override
+  {
+	  return use_yuv420;
+  };
+
+  /* Size in bytes of the pixels in the current format. */
+  size_t pixels_size() const;
+
+  /* Scale the texture rendered with a resolution divider up to the full size of the pixels. */
+  void upsample_texture();
+
   ///* Make sure texture is allocated and its initial configuration is performed. */
   //bool gl_texture_resources_ensure();
 
@@ -132,6 +143,8 @@ class FrameDisplayDriver : public DisplayDriver {
   void renderEnd();
 
   void wait();
+  /* Wait at most the given time, returns true if the render finished. */
+  bool wait_for(const double seconds);
   bool ready() const;
 
 public:
@@ -141,14 +154,24 @@ public:
 	//std::atomic<bool> render_finished;
 	thread_mutex mutex;
 	thread_condition_variable cv;
+	// held by the render thread from update_begin() to update_end(), lock it to send pixels
+	// while rendering may write them
+	thread_mutex pixels_mutex;
 	std::chrono::time_point<std::chrono::steady_clock> start;
 	float duration;
 
 	bool use_device_buffer = false;
 	bool use_linear2srgb = false;
+	bool use_yuv420 = false;
 
+	// size of the sent pixels, the render resolution without the resolution divider
 	int width = 0;
 	int height = 0;
+
+	// pixels rendered with a resolution divider, upsampled into pixels in update_end()
+	vector<half4> texture_pixels;
+	int texture_width = 0;
+	int texture_height = 0;
 };
 
 CCL_NAMESPACE_END
@@ -0,0 +1,195 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "tile_stream.h"
+
+#include <string.h>
+
+CCL_NAMESPACE_BEGIN
+
+/* --------------------------------------------------------------------
+ * TileConvergenceDriver.
+ */
+
+void TileConvergenceDriver::write_render_tile(const Tile& tile)
+{
+	update_render_tile(tile);
+}
+
+bool TileConvergenceDriver::update_render_tile(const Tile& tile)
+{
+	/* Only the full buffer, no intermediate tiles. */
+	if (!(tile.size == tile.full_size)) {
+		return false;
+	}
+
+	const int width = tile.size.x;
+	const int height = tile.size.y;
+
+	aux_pixels_.resize(size_t(width) * height);
+	if (!tile.get_pass_pixels(TILE_STREAM_ADAPTIVE_PASS, 4, (float*)aux_pixels_.data())) {
+		return false;
+	}
+
+	/* A tile has converged when all of its pixels have, the alpha of the pass is zero for pixels
+	 * which still need samples. */
+	const int tiles_x = divide_up(width, TILE_STREAM_SIZE);
+	const int tiles_y = divide_up(height, TILE_STREAM_SIZE);
+	vector<uchar> converged(size_t(tiles_x) * tiles_y, 1);
+
+	for (int y = 0; y < height; y++) {
+		const float4* row = aux_pixels_.data() + size_t(y) * width;
+		uchar* tile_row = converged.data() + size_t(y / TILE_STREAM_SIZE) * tiles_x;
+		for (int x = 0; x < width; x++) {
+			if (row[x].w == 0.0f) {
+				tile_row[x / TILE_STREAM_SIZE] = 0;
+			}
+		}
+	}
+
+	thread_scoped_lock lock(mutex_);
+	converged_ = std::move(converged);
+	width_ = width;
+	height_ = height;
+
+	return true;
+}
+
+void TileConvergenceDriver::get_converged(const int width, const int height, vector<uchar>& converged)
+{
+	thread_scoped_lock lock(mutex_);
+	if (width == width_ && height == height_) {
+		converged = converged_;
+	}
+	else {
+		converged.clear();
+	}
+}
+
+/* --------------------------------------------------------------------
+ * TileStream.
+ */
+
+/* Plane of the pixels, chroma planes of YUV 4:2:0 have half the resolution. */
+struct TileStreamPlane {
+	size_t offset;
+	int width;
+	int height;
+	int bytes_per_pixel;
+	int shift;
+};
+
+/* Call func for the bytes of every row of the tile in every plane. */
+template<typename Func>
+static void tile_stream_foreach_row(const vector<TileStreamPlane>& planes,
+	const int tile_x,
+	const int tile_y,
+	const Func& func)
+{
+	for (const TileStreamPlane& plane : planes) {
+		const int x0 = (tile_x * TILE_STREAM_SIZE) >> plane.shift;
+		const int y0 = (tile_y * TILE_STREAM_SIZE) >> plane.shift;
+		const int x1 = min(((tile_x + 1) * TILE_STREAM_SIZE) >> plane.shift, plane.width);
+		const int y1 = min(((tile_y + 1) * TILE_STREAM_SIZE) >> plane.shift, plane.height);
+		const size_t row_size = size_t(x1 - x0) * plane.bytes_per_pixel;
+
+		for (int y = y0; y < y1; y++) {
+			func(plane.offset + (size_t(y) * plane.width + x0) * plane.bytes_per_pixel, row_size);
+		}
+	}
+}
+
+void TileStream::pack(const char* pixels,
+	const int width,
+	const int height,
+	const int bytes_per_pixel,
+	const bool yuv420,
+	const vector<uchar>& converged,
+	vector<char>& message)
+{
+	vector<TileStreamPlane> planes;
+	if (yuv420) {
+		const int chroma_width = (width + 1) / 2;
+		const int chroma_height = (height + 1) / 2;
+		const size_t luma_size = size_t(width) * height;
+		const size_t chroma_size = size_t(chroma_width) * chroma_height;
+		planes.push_back({0, width, height, 1, 0});
+		planes.push_back({luma_size, chroma_width, chroma_height, 1, 1});
+		planes.push_back({luma_size + chroma_size, chroma_width, chroma_height, 1, 1});
+	}
+	else {
+		planes.push_back({0, width, height, bytes_per_pixel, 0});
+	}
+
+	size_t size = 0;
+	for (const TileStreamPlane& plane : planes) {
+		size += size_t(plane.width) * plane.height * plane.bytes_per_pixel;
+	}
+
+	/* Send everything after the size or format changed. */
+	const bool send_all = (sent_.size() != size || width != width_ || height != height_);
+	if (send_all) {
+		sent_.resize(size);
+		width_ = width;
+		height_ = height;
+	}
+
+	const int tiles_x = divide_up(width, TILE_STREAM_SIZE);
+	const int tiles_y = divide_up(height, TILE_STREAM_SIZE);
+	const int num_tiles = tiles_x * tiles_y;
+
+	/* Find the changed tiles, and remember their pixels as sent. */
+	vector<int> changed_tiles;
+	size_t pixels_size = 0;
+	for (int tile_y = 0; tile_y < tiles_y; tile_y++) {
+		for (int tile_x = 0; tile_x < tiles_x; tile_x++) {
+			bool changed = send_all;
+			size_t tile_size = 0;
+			tile_stream_foreach_row(planes, tile_x, tile_y, [&](const size_t offset, const size_t row_size) {
+				if (send_all || memcmp(sent_.data() + offset, pixels + offset, row_size) != 0) {
+					memcpy(sent_.data() + offset, pixels + offset, row_size);
+					changed = true;
+				}
+				tile_size += row_size;
+			});
+
+			if (changed) {
+				changed_tiles.push_back(tile_y * tiles_x + tile_x);
+				pixels_size += tile_size;
+			}
+		}
+	}
+	num_changed_tiles_ = changed_tiles.size();
+
+	/* Header, bitmap and indices of the changed tiles. */
+	const size_t bitmap_size = divide_up(num_tiles, 8);
+	message.resize(sizeof(int) + bitmap_size + changed_tiles.size() * sizeof(int) + pixels_size);
+
+	char* data = message.data();
+	memcpy(data, &num_changed_tiles_, sizeof(int));
+	data += sizeof(int);
+
+	memset(data, 0, bitmap_size);
+	if (converged.size() == size_t(num_tiles)) {
+		for (int i = 0; i < num_tiles; i++) {
+			if (converged[i]) {
+				data[i / 8] |= char(1 << (i % 8));
+			}
+		}
+	}
+	data += bitmap_size;
+
+	memcpy(data, changed_tiles.data(), changed_tiles.size() * sizeof(int));
+	data += changed_tiles.size() * sizeof(int);
+
+	/* Pixels of the changed tiles. */
+	for (const int tile : changed_tiles) {
+		tile_stream_foreach_row(planes, tile % tiles_x, tile / tiles_x, [&](const size_t offset, const size_t row_size) {
+			memcpy(data, pixels + offset, row_size);
+			data += row_size;
+		});
+	}
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,77 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "session/output_driver.h"
+
+#include "util/thread.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Tile Stream
+ *
+ * With adaptive sampling, converged parts of the image stop changing. Instead of the whole image
+ * only the tiles of TILE_STREAM_SIZE x TILE_STREAM_SIZE pixels which changed since the previous
+ * frame are sent to the client, in row major order of the tiles. The message is preceded by its
+ * size as an int:
+ *
+ *   int   number of changed tiles
+ *   uchar convergence bitmap, bit (i % 8) of byte (i / 8) is set if tile i has converged
+ *   int   index of every changed tile
+ *   pixels of every changed tile, row by row in the pixel format. For YUV 4:2:0 the rows of the
+ *         Y plane of the tile are followed by the rows of the U and then the V plane.
+ *
+ * The first frame after a change of the image size contains all the tiles. */
+
+#define TILE_STREAM_SIZE 32
+
+/* Name of the adaptive sampling pass read for the convergence of the tiles. */
+#define TILE_STREAM_ADAPTIVE_PASS "Adaptive Aux Buffer"
+
+/* Reads the convergence of the pixels from the adaptive sampling pass while rendering. */
+class TileConvergenceDriver : public OutputDriver {
+ public:
+	void write_render_tile(const Tile& tile) override;
+	bool update_render_tile(const Tile& tile) override;
+
+	/* Copy the bitmap of converged tiles of the last update, empty if it does not match the
+	 * image size. */
+	void get_converged(const int width, const int height, vector<uchar>& converged);
+
+ protected:
+	thread_mutex mutex_;
+	vector<float4> aux_pixels_;
+	vector<uchar> converged_;
+	int width_ = 0;
+	int height_ = 0;
+};
+
+class TileStream {
+ public:
+	/* Pack the tiles of the pixels which changed since the previous call. */
+	void pack(const char* pixels,
+		const int width,
+		const int height,
+		const int bytes_per_pixel,
+		const bool yuv420,
+		const vector<uchar>& converged,
+		vector<char>& message);
+
+	int num_changed_tiles() const
+	{
+		return num_changed_tiles_;
+	}
+
+ protected:
+	/* Pixels as sent to the client. */
+	vector<char> sent_;
+	int width_ = 0;
+	int height_ = 0;
+	int num_changed_tiles_ = 0;
+};
+
+CCL_NAMESPACE_END
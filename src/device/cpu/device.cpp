@@ -48,6 +48,9 @@ void device_cpu_info(vector<DeviceInfo> &devices)
 
 string device_cpu_capabilities()
 {
+  if (system_cpu_support_avx512()) {
+    return "AVX512 AVX2";
+  }
   return system_cpu_support_avx2() ? "AVX2" : "";
 }
 
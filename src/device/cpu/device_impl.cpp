@@ -20,7 +20,12 @@
 #  include <embree4/rtcore.h>
 #endif
 
+#ifndef _WIN32
+#  include <dlfcn.h>
+#endif
+
 #include "device/cpu/kernel.h"
+#include "device/cpu/scene_store.h"
 
 #include "device/device.h"
 
@@ -32,10 +37,14 @@
 
 #include "session/buffers.h"
 
+#include "util/debug.h"
 #include "util/guiding.h"
 #include "util/log.h"
+#include "util/md5.h"
+#include "util/path.h"
 #include "util/progress.h"
 #include "util/task.h"
+#include "util/time.h"
 #include "util/types_image.h"
 
 CCL_NAMESPACE_BEGIN
@@ -56,6 +65,8 @@ CPUDevice::CPUDevice(const DeviceInfo &info_, Stats &stats_, Profiler &profiler_
   embree_device = rtcNewDevice("verbose=0");
 #endif
   need_image_info = false;
+
+  numa_init();
 }
 
 CPUDevice::~CPUDevice()
@@ -65,11 +76,13 @@ CPUDevice::~CPUDevice()
 #endif
 
   image_info.free();
+  svm_specialized_free();
+  numa_free();
 }
 
 BVHLayoutMask CPUDevice::get_bvh_layout_mask(uint /*kernel_features*/) const
 {
-  BVHLayoutMask bvh_layout_mask = BVH_LAYOUT_BVH2;
+  BVHLayoutMask bvh_layout_mask = BVH_LAYOUT_BVH2 | BVH_LAYOUT_BVH4;
 #ifdef WITH_EMBREE
   bvh_layout_mask |= BVH_LAYOUT_EMBREE;
 #endif /* WITH_EMBREE */
@@ -88,6 +101,96 @@ bool CPUDevice::load_image_info()
   return true;
 }
 
+void *CPUDevice::host_alloc(const MemoryType type, const size_t size)
+{
+  /* Scene arrays and images are read at random by rays, use huge pages to reduce TLB misses. */
+  if (!((type == MEM_GLOBAL || type == MEM_IMAGE_TEXTURE) && DebugFlags().cpu.huge_pages)) {
+    return Device::host_alloc(type, size);
+  }
+
+  bool use_huge_pages = false;
+  void *ptr = util_aligned_malloc_huge(size, MIN_ALIGNMENT_DEVICE_MEMORY, &use_huge_pages);
+  if (ptr && use_huge_pages) {
+    const thread_scoped_lock lock(huge_pages_mutex);
+    huge_pages[ptr].size = size;
+  }
+  return ptr;
+}
+
+void CPUDevice::host_free(const MemoryType type, void *host_pointer, const size_t size)
+{
+  if (type == MEM_GLOBAL || type == MEM_IMAGE_TEXTURE) {
+    {
+      const thread_scoped_lock lock(huge_pages_mutex);
+      huge_pages.erase(host_pointer);
+    }
+    if (CPUSceneStore::instance().release(host_pointer) == CPUSceneStore::Release::SHARED) {
+      return;
+    }
+  }
+  Device::host_free(type, host_pointer, size);
+}
+
+void CPUDevice::huge_pages_tag(const device_memory &mem)
+{
+  const thread_scoped_lock lock(huge_pages_mutex);
+  auto it = huge_pages.find(mem.host_pointer);
+  if (it != huge_pages.end()) {
+    it->second.name = mem.log_name();
+  }
+}
+
+/* Images and static geometry and BVH arrays. These are only written through alloc(), which
+ * copies shared memory first. Arrays which are updated in place, like objects, are not shared. */
+static bool scene_store_supported(const device_memory &mem)
+{
+  if (mem.type == MEM_IMAGE_TEXTURE) {
+    return true;
+  }
+
+  static const char *names[] = {"bvh_nodes",         "bvh_leaf_nodes",    "prim_type",
+                                "prim_visibility",   "prim_index",        "prim_object",
+                                "prim_time",         "object_node",       "tri_shader",
+                                "tri_vindex",        "tri_verts",         "curves",
+                                "curve_keys",        "curve_segments",    "points",
+                                "points_shader",     "attributes_float",  "attributes_float2",
+                                "attributes_float3", "attributes_float4", "attributes_uchar4",
+                                "attributes_normal"};
+  for (const char *name : names) {
+    if (strcmp(mem.global_name(), name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CPUDevice::scene_store_acquire(device_memory &mem)
+{
+  if (!DebugFlags().cpu.share_scene_data || mem.host_pointer_shared || !mem.host_pointer ||
+      !scene_store_supported(mem))
+  {
+    return;
+  }
+
+  const size_t size = mem.memory_size();
+  void *host_pointer = CPUSceneStore::instance().acquire(mem.host_pointer, size);
+  if (host_pointer != mem.host_pointer) {
+    host_free(mem.type, mem.host_pointer, size);
+    mem.host_pointer = host_pointer;
+  }
+  mem.host_pointer_shared = true;
+}
+
+vector<DeviceMemoryEntry> CPUDevice::get_huge_page_allocations() const
+{
+  const thread_scoped_lock lock(huge_pages_mutex);
+  vector<DeviceMemoryEntry> entries;
+  for (const auto &it : huge_pages) {
+    entries.push_back(it.second);
+  }
+  return entries;
+}
+
 void CPUDevice::mem_alloc(device_memory &mem)
 {
   if (mem.type == MEM_IMAGE_TEXTURE) {
@@ -194,6 +297,9 @@ void CPUDevice::const_copy_to(const char *name, void *host, const size_t size)
   }
 #endif
   kernel_const_copy(&kernel_globals, name, host, size);
+  for (unique_ptr<NUMANode> &node : numa_nodes) {
+    kernel_const_copy(&node->kernel_globals, name, host, size);
+  }
 }
 
 void CPUDevice::global_alloc(device_memory &mem)
@@ -202,16 +308,22 @@ void CPUDevice::global_alloc(device_memory &mem)
             << string_human_readable_number(mem.memory_size()) << " bytes. ("
             << string_human_readable_size(mem.memory_size()) << ")";
 
+  scene_store_acquire(mem);
+
   kernel_global_memory_copy(&kernel_globals, mem.global_name(), mem.host_pointer, mem.data_size);
 
   mem.device_pointer = (device_ptr)mem.host_pointer;
   mem.device_size = mem.memory_size();
   stats.mem_alloc(mem.device_size);
+
+  huge_pages_tag(mem);
+  numa_global_alloc(mem);
 }
 
 void CPUDevice::global_free(device_memory &mem)
 {
   if (mem.device_pointer) {
+    numa_global_free(mem);
     mem.device_pointer = 0;
     stats.mem_free(mem.device_size);
     mem.device_size = 0;
@@ -224,6 +336,8 @@ void CPUDevice::image_alloc(device_image &mem)
             << string_human_readable_number(mem.memory_size()) << " bytes. ("
             << string_human_readable_size(mem.memory_size()) << ")";
 
+  scene_store_acquire(mem);
+
   mem.device_pointer = (device_ptr)mem.host_pointer;
   mem.device_size = mem.memory_size();
   stats.mem_alloc(mem.device_size);
@@ -237,11 +351,15 @@ void CPUDevice::image_alloc(device_image &mem)
   image_info[slot] = mem.info;
   image_info[slot].data = (uint64_t)mem.host_pointer;
   need_image_info = true;
+
+  huge_pages_tag(mem);
+  numa_image_alloc(mem);
 }
 
 void CPUDevice::image_free(device_image &mem)
 {
   if (mem.device_pointer) {
+    numa_image_free(mem);
     mem.device_pointer = 0;
     stats.mem_free(mem.device_size);
     mem.device_size = 0;
@@ -306,6 +424,19 @@ void CPUDevice::get_cpu_kernel_thread_globals(
 
   kernel_thread_globals.clear();
   OSLGlobals *osl_globals = get_cpu_osl_memory();
+
+  if (!numa_nodes.empty()) {
+    /* Threads of every node use the scene data local to it. */
+    numa_update_image_info();
+    for (const unique_ptr<NUMANode> &node : numa_nodes) {
+      for (int i = 0; i < node->info.num_threads; i++) {
+        kernel_thread_globals.emplace_back(
+            node->kernel_globals, osl_globals, profiler, kernel_thread_globals.size());
+      }
+    }
+    return;
+  }
+
   for (int i = 0; i < info.cpu_threads; i++) {
     kernel_thread_globals.emplace_back(kernel_globals, osl_globals, profiler, i);
   }
@@ -320,9 +451,318 @@ OSLGlobals *CPUDevice::get_cpu_osl_memory()
 #endif
 }
 
-bool CPUDevice::load_kernels(const uint /*kernel_features*/)
+vector<DeviceNUMANode> CPUDevice::get_cpu_numa_nodes() const
+{
+  vector<DeviceNUMANode> nodes;
+  for (const unique_ptr<NUMANode> &node : numa_nodes) {
+    nodes.push_back(node->info);
+  }
+  return nodes;
+}
+
+bool CPUDevice::load_kernels(const uint kernel_features)
 {
+  /* The kernels are all built in, only remember the features to select the megakernel. Loading
+   * for denoising alone does not change the features of the scene being path traced. */
+  if (kernel_features & KERNEL_FEATURE_PATH_TRACING) {
+    this->kernel_features = kernel_features;
+  }
   return true;
 }
 
+uint CPUDevice::get_cpu_kernel_features() const
+{
+  return kernel_features;
+}
+
+/* Specialized SVM Programs
+ *
+ * The generated source is compiled with the host compiler against the kernel sources installed
+ * with Cycles, into a library cached like runtime compiled GPU kernels. */
+
+string CPUDevice::svm_specialized_compile(const string &source)
+{
+#ifdef _WIN32
+  (void)source;
+  LOG_WARNING << "Specialized SVM programs are not supported on this platform.";
+  return string();
+#else
+  const char *compiler = getenv("CYCLES_SVM_SPECIALIZE_CXX");
+  if (compiler == nullptr) {
+    compiler = "c++";
+  }
+
+  const string source_path = path_get("source");
+  const string cflags = string_printf(
+      "-std=c++17 -O2 -march=native -fPIC -shared -w -I\"%s\" -I\"%s\" "
+      "\"-DCCL_NAMESPACE_BEGIN=namespace ccl {\" \"-DCCL_NAMESPACE_END=}\"",
+      source_path.c_str(),
+      path_join(source_path, "third_party/atomic").c_str());
+
+  /* Include kernel sources and flags into md5 so changes to either rebuild the library. */
+  const string md5 = util_md5_string(path_files_md5_hash(source_path) + cflags + compiler +
+                                     source);
+  const string library = path_cache_get(
+      path_join("kernels", string_printf("cycles_svm_specialized_%s.so", md5.c_str())));
+  LOG_INFO << "Testing for locally compiled specialized SVM programs " << library << ".";
+  if (path_exists(library)) {
+    LOG_INFO << "Using locally compiled specialized SVM programs.";
+    return library;
+  }
+
+  const double starttime = time_dt();
+
+  path_create_directories(library);
+
+  const string generated = library.substr(0, library.size() - 3) + ".cpp";
+  if (!path_write_text(generated, source)) {
+    LOG_ERROR << "Failed to write specialized SVM programs to " << generated << ".";
+    return string();
+  }
+
+  const string command = string_printf("\"%s\" %s \"%s\" -o \"%s\"",
+                                       compiler,
+                                       cflags.c_str(),
+                                       generated.c_str(),
+                                       library.c_str());
+
+  LOG_INFO_IMPORTANT << "Compiling specialized SVM programs ...";
+  LOG_INFO_IMPORTANT << command;
+
+  const int result = system(command.c_str());
+  path_remove(generated);
+
+  if (result != 0 || !path_exists(library)) {
+    LOG_ERROR << "Specialized SVM program compilation failed, see console for details.";
+    return string();
+  }
+
+  LOG_INFO_IMPORTANT << "Specialized SVM programs compiled in " << time_dt() - starttime
+                     << " seconds.";
+
+  return library;
+#endif
+}
+
+bool CPUDevice::load_cpu_svm_specialized(const string &source, const vector<int> &shaders)
+{
+  svm_specialized_free();
+
+  if (source.empty()) {
+    svm_specialized_update_globals();
+    return true;
+  }
+
+#ifdef _WIN32
+  (void)shaders;
+  return false;
+#else
+  const string library = svm_specialized_compile(source);
+  if (library.empty()) {
+    return false;
+  }
+
+  svm_specialized_library = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (svm_specialized_library == nullptr) {
+    LOG_ERROR << "Failed to load specialized SVM programs: " << dlerror();
+    return false;
+  }
+
+  using FunctionsGetter = const SVMSpecializedFunction *(*)(int *);
+  const FunctionsGetter get_functions = (FunctionsGetter)dlsym(
+      svm_specialized_library, "cycles_svm_specialized_functions");
+  int num_functions = 0;
+  const SVMSpecializedFunction *functions = (get_functions) ? get_functions(&num_functions) :
+                                                              nullptr;
+  if (functions == nullptr || num_functions != int(shaders.size())) {
+    LOG_ERROR << "Invalid specialized SVM programs library " << library << ".";
+    svm_specialized_free();
+    return false;
+  }
+
+  for (int i = 0; i < num_functions; i++) {
+    if (shaders[i] >= int(svm_specialized.size())) {
+      svm_specialized.resize(shaders[i] + 1, nullptr);
+    }
+    svm_specialized[shaders[i]] = functions[i];
+  }
+
+  LOG_INFO << "Using specialized SVM programs for " << num_functions << " shader(s).";
+
+  svm_specialized_update_globals();
+  return true;
+#endif
+}
+
+void CPUDevice::svm_specialized_free()
+{
+  svm_specialized.clear();
+#ifndef _WIN32
+  if (svm_specialized_library) {
+    dlclose(svm_specialized_library);
+    svm_specialized_library = nullptr;
+  }
+#endif
+}
+
+void CPUDevice::svm_specialized_update_globals()
+{
+  /* Thread globals pick these up when render threads are initialized for the next render. */
+  kernel_globals.svm_specialized = svm_specialized.data();
+  kernel_globals.svm_specialized_size = svm_specialized.size();
+  for (unique_ptr<NUMANode> &node : numa_nodes) {
+    node->kernel_globals.svm_specialized = svm_specialized.data();
+    node->kernel_globals.svm_specialized_size = svm_specialized.size();
+  }
+}
+
+/* NUMA
+ *
+ * On systems with multiple NUMA nodes render threads are pinned to nodes, and read-only scene
+ * data is copied to every node. Pages are placed on the node of the thread that first touches
+ * them, so the copies are made by threads of the node. Small arrays are shared, as they stay in
+ * the caches anyway. */
+
+static constexpr size_t NUMA_REPLICA_MIN_SIZE = 64 * 1024;
+
+void CPUDevice::numa_init()
+{
+  if (!DebugFlags().cpu.numa) {
+    return;
+  }
+
+  const vector<int> nodes = TaskScheduler::numa_nodes();
+  if (nodes.size() < 2) {
+    LOG_INFO << "NUMA topology not available or single node, not pinning render threads.";
+    return;
+  }
+
+  /* Distribute render threads over the nodes, proportional to their concurrency. */
+  int total_concurrency = 0;
+  for (const int node : nodes) {
+    total_concurrency += TaskScheduler::numa_node_concurrency(node);
+  }
+
+  int remaining_threads = info.cpu_threads;
+  for (size_t i = 0; i < nodes.size() && remaining_threads > 0; i++) {
+    const int concurrency = TaskScheduler::numa_node_concurrency(nodes[i]);
+    const int num_threads = (i == nodes.size() - 1) ?
+                                remaining_threads :
+                                min(remaining_threads,
+                                    max(1, concurrency * info.cpu_threads / total_concurrency));
+    remaining_threads -= num_threads;
+
+    unique_ptr<NUMANode> node = make_unique<NUMANode>();
+    node->info.id = nodes[i];
+    node->info.num_threads = num_threads;
+    node->arena = make_unique<tbb::task_arena>(
+        tbb::task_arena::constraints(nodes[i], num_threads));
+    node->kernel_globals = kernel_globals;
+
+    LOG_INFO << "Pinning " << num_threads << " render threads to NUMA node " << nodes[i] << ".";
+    numa_nodes.push_back(std::move(node));
+  }
+}
+
+void CPUDevice::numa_free()
+{
+  for (unique_ptr<NUMANode> &node : numa_nodes) {
+    for (auto &it : node->globals) {
+      util_aligned_free(it.second.data, it.second.size);
+    }
+    for (auto &it : node->images) {
+      util_aligned_free(it.second.data, it.second.size);
+    }
+  }
+  numa_nodes.clear();
+}
+
+void *CPUDevice::numa_replica_alloc(NUMANode &node, const void *data, const size_t size)
+{
+  char *replica = (char *)(DebugFlags().cpu.huge_pages ?
+                               util_aligned_malloc_huge(size, MIN_ALIGNMENT_DEVICE_MEMORY) :
+                               util_aligned_malloc(size, MIN_ALIGNMENT_DEVICE_MEMORY));
+  const char *src = (const char *)data;
+
+  node.arena->execute([&]() {
+    parallel_for(blocked_range<size_t>(0, size, 1 << 20), [&](const blocked_range<size_t> &r) {
+      memcpy(replica + r.begin(), src + r.begin(), r.size());
+    });
+  });
+
+  return replica;
+}
+
+void CPUDevice::numa_global_alloc(device_memory &mem)
+{
+  if (numa_nodes.empty()) {
+    return;
+  }
+
+  const char *name = mem.global_name();
+  const size_t size = mem.memory_size();
+  for (unique_ptr<NUMANode> &node : numa_nodes) {
+    void *data = mem.host_pointer;
+    /* Image info points to image data, it is copied with replaced pointers for every node. */
+    if (size >= NUMA_REPLICA_MIN_SIZE && strcmp(name, "image_info") != 0) {
+      data = numa_replica_alloc(*node, mem.host_pointer, size);
+      node->globals[name] = {data, size};
+    }
+    kernel_global_memory_copy(&node->kernel_globals, name, data, mem.data_size);
+  }
+}
+
+void CPUDevice::numa_global_free(device_memory &mem)
+{
+  for (unique_ptr<NUMANode> &node : numa_nodes) {
+    auto it = node->globals.find(mem.global_name());
+    if (it != node->globals.end()) {
+      util_aligned_free(it->second.data, it->second.size);
+      node->globals.erase(it);
+    }
+  }
+}
+
+void CPUDevice::numa_image_alloc(device_image &mem)
+{
+  const size_t size = mem.memory_size();
+  if (numa_nodes.empty() || size < NUMA_REPLICA_MIN_SIZE) {
+    return;
+  }
+
+  for (unique_ptr<NUMANode> &node : numa_nodes) {
+    void *data = numa_replica_alloc(*node, mem.host_pointer, size);
+    node->images[mem.image_info_id] = {data, size};
+  }
+}
+
+void CPUDevice::numa_image_free(device_image &mem)
+{
+  for (unique_ptr<NUMANode> &node : numa_nodes) {
+    auto it = node->images.find(mem.image_info_id);
+    if (it != node->images.end()) {
+      util_aligned_free(it->second.data, it->second.size);
+      node->images.erase(it);
+    }
+  }
+}
+
+void CPUDevice::numa_update_image_info()
+{
+  for (unique_ptr<NUMANode> &node : numa_nodes) {
+    node->image_info.resize(image_info.size());
+    for (size_t slot = 0; slot < image_info.size(); slot++) {
+      node->image_info[slot] = image_info[slot];
+      auto it = node->images.find(slot);
+      if (it != node->images.end()) {
+        node->image_info[slot].data = (uint64_t)it->second.data;
+      }
+    }
+    kernel_global_memory_copy(&node->kernel_globals,
+                              "image_info",
+                              node->image_info.data(),
+                              node->image_info.size());
+  }
+}
+
 CCL_NAMESPACE_END
@@ -30,6 +30,9 @@
 // clang-format on
 
 #include "util/guiding.h"  // IWYU pragma: keep
+#include "util/map.h"
+#include "util/tbb.h"
+#include "util/thread.h"
 #include "util/unique_ptr.h"
 
 CCL_NAMESPACE_BEGIN
@@ -56,6 +59,39 @@ class CPUDevice : public Device {
   mutable unique_ptr<openpgl::cpp::Device> guiding_device;
 #endif
 
+  /* NUMA node that render threads are pinned to, with its own copy of read-only scene data
+   * so the threads read from local memory. */
+  struct NUMANode {
+    struct Replica {
+      void *data = nullptr;
+      size_t size = 0;
+    };
+
+    DeviceNUMANode info;
+    unique_ptr<tbb::task_arena> arena;
+    KernelGlobalsCPU kernel_globals;
+
+    /* Replicas of global arrays by name, and of image data by image info slot. */
+    map<string, Replica> globals;
+    map<uint, Replica> images;
+    vector<KernelImageInfo> image_info;
+  };
+  vector<unique_ptr<NUMANode>> numa_nodes;
+
+  /* Host allocations backed by huge pages, with the name of the array once allocated on the
+   * device. */
+  map<void *, DeviceMemoryEntry> huge_pages;
+  mutable thread_mutex huge_pages_mutex;
+
+  /* Specialized SVM programs of hot shaders, indexed by shader, from a library compiled at
+   * runtime. */
+  void *svm_specialized_library = nullptr;
+  vector<SVMSpecializedFunction> svm_specialized;
+
+  /* Features of the scene the path tracing kernels were last loaded for, all features until
+   * then. */
+  uint kernel_features = ~0U;
+
   CPUDevice(const DeviceInfo &info_, Stats &stats_, Profiler &profiler_, bool headless_);
   ~CPUDevice() override;
 
@@ -65,6 +101,9 @@ class CPUDevice : public Device {
    * re-initialization might be needed). */
   bool load_image_info();
 
+  void *host_alloc(const MemoryType type, const size_t size) override;
+  void host_free(const MemoryType type, void *host_pointer, const size_t size) override;
+
   void mem_alloc(device_memory &mem) override;
   void mem_copy_to(device_memory &mem) override;
   void mem_move_to_host(device_memory &mem) override;
@@ -89,9 +128,34 @@ class CPUDevice : public Device {
   void get_cpu_kernel_thread_globals(
       vector<ThreadKernelGlobalsCPU> &kernel_thread_globals) override;
   OSLGlobals *get_cpu_osl_memory() override;
+  vector<DeviceNUMANode> get_cpu_numa_nodes() const override;
+  uint get_cpu_kernel_features() const override;
+  vector<DeviceMemoryEntry> get_huge_page_allocations() const override;
+  bool load_cpu_svm_specialized(const string &source, const vector<int> &shaders) override;
 
  protected:
-  bool load_kernels(uint /*kernel_features*/) override;
+  bool load_kernels(uint kernel_features) override;
+
+  /* NUMA replication of read-only scene data. */
+  void numa_init();
+  void numa_free();
+  void *numa_replica_alloc(NUMANode &node, const void *data, const size_t size);
+  void numa_global_alloc(device_memory &mem);
+  void numa_global_free(device_memory &mem);
+  void numa_image_alloc(device_image &mem);
+  void numa_image_free(device_image &mem);
+  void numa_update_image_info();
+
+  /* Name huge page backed host memory after the array it was allocated for. */
+  void huge_pages_tag(const device_memory &mem);
+
+  /* Share static scene data with other CPU devices which uploaded identical data. */
+  void scene_store_acquire(device_memory &mem);
+
+  /* Compile specialized SVM programs into a library, returns its path or empty on failure. */
+  string svm_specialized_compile(const string &source);
+  void svm_specialized_free();
+  void svm_specialized_update_globals();
 };
 
 CCL_NAMESPACE_END
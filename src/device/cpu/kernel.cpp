@@ -6,21 +6,28 @@
 
 #include "kernel/device/cpu/kernel.h"
 
+#include "util/debug.h"
+
 CCL_NAMESPACE_BEGIN
 
-#define KERNEL_FUNCTIONS(name) KERNEL_NAME_EVAL(cpu, name), KERNEL_NAME_EVAL(cpu_avx2, name)
+#define KERNEL_FUNCTIONS(name) \
+  KERNEL_NAME_EVAL(cpu, name), KERNEL_NAME_EVAL(cpu_avx2, name), \
+      KERNEL_NAME_EVAL(cpu_avx512, name)
 
 #define REGISTER_KERNEL(name) name(KERNEL_FUNCTIONS(name))
 #define REGISTER_KERNEL_FILM_CONVERT(name) \
   film_convert_##name(KERNEL_FUNCTIONS(film_convert_##name)), \
       film_convert_half_rgba_##name(KERNEL_FUNCTIONS(film_convert_half_rgba_##name)), \
-      film_convert_byte_rgba_##name(KERNEL_FUNCTIONS(film_convert_byte_rgba_##name))
+      film_convert_byte_rgba_##name(KERNEL_FUNCTIONS(film_convert_byte_rgba_##name)), \
+      film_convert_yuv420_##name(KERNEL_FUNCTIONS(film_convert_yuv420_##name))
 
 CPUKernels::CPUKernels()
     : /* Integrator. */
       REGISTER_KERNEL(integrator_init_from_camera),
       REGISTER_KERNEL(integrator_init_from_bake),
       REGISTER_KERNEL(integrator_megakernel),
+      REGISTER_KERNEL(integrator_megakernel_surface),
+      REGISTER_KERNEL(integrator_megakernel_volume),
       /* Shader evaluation. */
       REGISTER_KERNEL(shader_eval_displace),
       REGISTER_KERNEL(shader_eval_background),
@@ -57,4 +64,21 @@ CPUKernels::CPUKernels()
 #undef REGISTER_KERNEL_FILM_CONVERT
 #undef KERNEL_FUNCTIONS
 
+const CPUKernels::IntegratorShadeFunction &CPUKernels::integrator_megakernel_for_features(
+    const uint kernel_features) const
+{
+  if (!DebugFlags().cpu.specialized_megakernels) {
+    return integrator_megakernel;
+  }
+
+  const uint specialized_features = kernel_features & KERNEL_FEATURE_CPU_SPECIALIZED;
+  if ((specialized_features & ~uint(KERNEL_FEATURES_CPU_SURFACE)) == 0) {
+    return integrator_megakernel_surface;
+  }
+  if ((specialized_features & ~uint(KERNEL_FEATURES_CPU_VOLUME)) == 0) {
+    return integrator_megakernel_volume;
+  }
+  return integrator_megakernel;
+}
+
 CCL_NAMESPACE_END
@@ -32,6 +32,14 @@ class CPUKernels {
   IntegratorInitFunction integrator_init_from_bake;
   IntegratorShadeFunction integrator_megakernel;
 
+  /* Megakernels with features compiled out, see KERNEL_FEATURE_CPU_SPECIALIZED. */
+  IntegratorShadeFunction integrator_megakernel_surface;
+  IntegratorShadeFunction integrator_megakernel_volume;
+
+  /* Megakernel with the fewest features compiled in that supports all the given features. */
+  const IntegratorShadeFunction &integrator_megakernel_for_features(
+      const uint kernel_features) const;
+
   /* Shader evaluation. */
 
   using ShaderEvalFunction = CPUKernelFunction<void (*)(
@@ -115,10 +123,22 @@ class CPUKernels {
           const int width,
           const int buffer_stride)>;
 
+  using FilmConvertYUV420Function =
+      CPUKernelFunction<void (*)(const KernelFilmConvert *kfilm_convert,
+                                 const float *buffer,
+                                 const float *buffer_next_row,
+                                 uchar *luma,
+                                 uchar *luma_next_row,
+                                 uchar *chroma_u,
+                                 uchar *chroma_v,
+                                 const int width,
+                                 const int buffer_stride)>;
+
 #define KERNEL_FILM_CONVERT_FUNCTION(name) \
   FilmConvertFunction film_convert_##name; \
   FilmConvertHalfRGBAFunction film_convert_half_rgba_##name; \
-  FilmConvertByteRGBAFunction film_convert_byte_rgba_##name;
+  FilmConvertByteRGBAFunction film_convert_byte_rgba_##name; \
+  FilmConvertYUV420Function film_convert_yuv420_##name;
 
   KERNEL_FILM_CONVERT_FUNCTION(depth)
   KERNEL_FILM_CONVERT_FUNCTION(mist)
@@ -0,0 +1,105 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "device/cpu/scene_store.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "util/log.h"
+#include "util/murmurhash.h"
+#include "util/string.h"
+
+CCL_NAMESPACE_BEGIN
+
+CPUSceneStore &CPUSceneStore::instance()
+{
+  static CPUSceneStore store;
+  return store;
+}
+
+uint64_t CPUSceneStore::hash(const void *data, const size_t size)
+{
+  /* Hash in chunks since the hash function takes an int length. Two seeds make collisions
+   * unlikely enough that the full comparison on lookup rarely fails. */
+  const size_t chunk_size = 1 << 30;
+  uint32_t hash_lo = 0;
+  uint32_t hash_hi = 1;
+  for (size_t offset = 0; offset < size; offset += chunk_size) {
+    const int len = int(std::min(chunk_size, size - offset));
+    hash_lo = util_murmur_hash3((const char *)data + offset, len, hash_lo);
+    hash_hi = util_murmur_hash3((const char *)data + offset, len, hash_hi);
+  }
+  return (uint64_t(hash_hi) << 32) | hash_lo;
+}
+
+void *CPUSceneStore::acquire(void *host_pointer, const size_t size)
+{
+  const uint64_t key = hash(host_pointer, size);
+
+  const thread_scoped_lock lock(mutex_);
+
+  auto range = entries_by_hash_.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    Entry &entry = entries_[it->second];
+    if (entry.size == size && memcmp(it->second, host_pointer, size) == 0) {
+      entry.users++;
+      LOG_DEBUG << "Sharing " << string_human_readable_size(size) << " of scene data with "
+                << entry.users - 1 << " other device(s).";
+      return it->second;
+    }
+  }
+
+  Entry &entry = entries_[host_pointer];
+  entry.size = size;
+  entry.hash = key;
+  entry.users = 1;
+  entries_by_hash_.emplace(key, host_pointer);
+
+  return host_pointer;
+}
+
+CPUSceneStore::Release CPUSceneStore::release(void *host_pointer)
+{
+  const thread_scoped_lock lock(mutex_);
+
+  auto it = entries_.find(host_pointer);
+  if (it == entries_.end()) {
+    return Release::NOT_SHARED;
+  }
+
+  if (--it->second.users > 0) {
+    return Release::SHARED;
+  }
+
+  auto range = entries_by_hash_.equal_range(it->second.hash);
+  for (auto hash_it = range.first; hash_it != range.second; ++hash_it) {
+    if (hash_it->second == host_pointer) {
+      entries_by_hash_.erase(hash_it);
+      break;
+    }
+  }
+  entries_.erase(it);
+
+  return Release::LAST_USER;
+}
+
+size_t CPUSceneStore::saved_size() const
+{
+  const thread_scoped_lock lock(mutex_);
+
+  size_t size = 0;
+  for (const auto &it : entries_) {
+    size += it.second.size * (it.second.users - 1);
+  }
+  return size;
+}
+
+size_t CPUSceneStore::num_allocations() const
+{
+  const thread_scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,61 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "util/map.h"
+#include "util/thread.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Scene Store
+ *
+ * Process wide store of read-only scene data, shared between CPU devices of sessions which load
+ * identical geometry, BVHs or images, such as the frames of an animation with mostly static
+ * content. Memory is identified by its content and reference counted, the last device releasing
+ * it frees it. */
+class CPUSceneStore {
+ public:
+  enum class Release {
+    /* Memory is not in the store and is owned by the caller. */
+    NOT_SHARED,
+    /* Memory is still used by another device. */
+    SHARED,
+    /* Last reference was released, the caller frees the memory. */
+    LAST_USER,
+  };
+
+  static CPUSceneStore &instance();
+
+  /* Add host memory to the store. If memory with the same content is already there, its
+   * reference count is increased and it is returned, and the caller frees its own copy. */
+  void *acquire(void *host_pointer, const size_t size);
+
+  /* Release a reference to memory previously returned by acquire(). */
+  Release release(void *host_pointer);
+
+  /* Number of bytes which are not allocated thanks to sharing. */
+  size_t saved_size() const;
+
+  /* Number of distinct allocations in the store. */
+  size_t num_allocations() const;
+
+ protected:
+  struct Entry {
+    size_t size = 0;
+    uint64_t hash = 0;
+    int users = 0;
+  };
+
+  static uint64_t hash(const void *data, const size_t size);
+
+  mutable thread_mutex mutex_;
+  unordered_map<void *, Entry> entries_;
+  unordered_multimap<uint64_t, void *> entries_by_hash_;
+};
+
+CCL_NAMESPACE_END
@@ -87,7 +87,7 @@ void Device::set_error(const string &error)
 
 void Device::build_bvh(BVH *bvh, Progress &progress, bool refit)
 {
-  assert(bvh->params.bvh_layout == BVH_LAYOUT_BVH2);
+  assert(bvh->params.bvh_layout == BVH_LAYOUT_BVH2 || bvh->params.bvh_layout == BVH_LAYOUT_BVH4);
 
   BVH2 *const bvh2 = static_cast<BVH2 *>(bvh);
   if (refit) {
@@ -530,6 +530,21 @@ OSLGlobals *Device::get_cpu_osl_memory()
   return nullptr;
 }
 
+vector<DeviceNUMANode> Device::get_cpu_numa_nodes() const
+{
+  return vector<DeviceNUMANode>();
+}
+
+uint Device::get_cpu_kernel_features() const
+{
+  return ~0U;
+}
+
+vector<DeviceMemoryEntry> Device::get_huge_page_allocations() const
+{
+  return vector<DeviceMemoryEntry>();
+}
+
 void *Device::get_guiding_device() const
 {
   LOG_ERROR << "Request guiding field from a device which does not support it.";
@@ -121,6 +121,20 @@ class DeviceInfo {
   }
 };
 
+/* NUMA node that CPU render threads are pinned to. */
+struct DeviceNUMANode {
+  /* Node identifier to constrain task arenas to. */
+  int id = 0;
+  /* Number of render threads running on the node. */
+  int num_threads = 0;
+};
+
+/* Named device memory allocation, for statistics. */
+struct DeviceMemoryEntry {
+  string name;
+  size_t size = 0;
+};
+
 /* Device */
 
 class Device {
@@ -164,6 +178,9 @@ class Device {
   Profiler &profiler;
   bool headless = true;
 
+  /* Memory allocations backed by huge pages. */
+  virtual vector<DeviceMemoryEntry> get_huge_page_allocations() const;
+
   /* constant memory */
   virtual void const_copy_to(const char *name, void *host, const size_t size) = 0;
 
@@ -203,6 +220,17 @@ class Device {
       vector<ThreadKernelGlobalsCPU> & /*kernel_thread_globals*/);
   /* Get OpenShadingLanguage memory buffer. */
   virtual OSLGlobals *get_cpu_osl_memory();
+  /* Get NUMA nodes that render threads are pinned to. Kernel thread globals are ordered by node,
+   * and use scene data local to the node. Empty when threads are not pinned. */
+  virtual vector<DeviceNUMANode> get_cpu_numa_nodes() const;
+  /* Get features the CPU kernels were loaded for, to select a megakernel without the others. */
+  virtual uint get_cpu_kernel_features() const;
+  /* Compile and load specialized SVM programs of the given shaders, generated with
+   * svm_specialize_source(). Empty source unloads them. Returns false if not supported. */
+  virtual bool load_cpu_svm_specialized(const string & /*source*/, const vector<int> & /*shaders*/)
+  {
+    return false;
+  }
 
   /* Acceleration structure building. */
   virtual void build_bvh(BVH *bvh, Progress &progress, bool refit);
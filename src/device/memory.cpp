@@ -5,6 +5,8 @@
 #include "device/memory.h"
 #include "device/device.h"
 
+#include <cstring>
+
 CCL_NAMESPACE_BEGIN
 
 static const char *name_from_type(ImageDataType type)
@@ -120,6 +122,7 @@ void device_memory::host_and_device_free()
       device->host_free(type, host_pointer, memory_size());
     }
     host_pointer = nullptr;
+    host_pointer_shared = false;
   }
 
   if (device_pointer) {
@@ -131,6 +134,25 @@ void device_memory::host_and_device_free()
   data_height = 0;
 }
 
+void device_memory::host_copy_on_write()
+{
+  const size_t size = memory_size();
+  const size_t width = data_width;
+  const size_t height = data_height;
+  const size_t num_elements = data_size;
+
+  void *new_ptr = host_alloc(size);
+  memcpy(new_ptr, host_pointer, size);
+
+  host_and_device_free();
+
+  host_pointer = new_ptr;
+  data_size = num_elements;
+  data_width = width;
+  data_height = height;
+  modified = true;
+}
+
 void device_memory::device_alloc()
 {
   assert(!device_pointer && type != MEM_IMAGE_TEXTURE && type != MEM_GLOBAL);
@@ -300,6 +322,9 @@ void *device_image::alloc(const size_t width, const size_t height)
     host_pointer = host_alloc(data_elements * datatype_size(data_type) * new_size);
     assert(device_pointer == 0);
   }
+  else if (host_pointer_shared) {
+    host_copy_on_write();
+  }
 
   data_size = new_size;
   data_width = width;
@@ -248,6 +248,9 @@ class device_memory {
   /* reference counter for shared_pointer */
   int shared_counter;
   bool move_to_host = false;
+  /* Host memory is shared with other device memory of identical content, and is copied before
+   * it is written to. */
+  bool host_pointer_shared = false;
 
   virtual ~device_memory();
 
@@ -296,6 +299,9 @@ class device_memory {
   /* Memory can only be freed on host and device together. */
   void host_and_device_free();
 
+  /* Replace shared host memory with a private copy. */
+  void host_copy_on_write();
+
   bool device_is_cpu();
 
   const char *name_;
@@ -398,6 +404,10 @@ template<typename T> class device_vector : public device_memory {
       modified = true;
       assert(device_pointer == 0);
     }
+    else if (host_pointer_shared) {
+      /* Keep the content since callers may only update part of it. */
+      host_copy_on_write();
+    }
 
     data_size = new_size;
     data_width = width;
@@ -431,6 +441,9 @@ template<typename T> class device_vector : public device_memory {
       modified = true;
       assert(device_pointer == 0);
     }
+    else if (host_pointer_shared) {
+      host_copy_on_write();
+    }
 
     data_size = new_size;
     data_width = width;
@@ -197,7 +197,9 @@ class MultiDevice : public Device {
   void build_bvh(BVH *bvh, Progress &progress, bool refit) override
   {
     /* Try to build and share a single acceleration structure, if possible */
-    if (bvh->params.bvh_layout == BVH_LAYOUT_BVH2 || bvh->params.bvh_layout == BVH_LAYOUT_EMBREE) {
+    if (bvh->params.bvh_layout == BVH_LAYOUT_BVH2 || bvh->params.bvh_layout == BVH_LAYOUT_BVH4 ||
+        bvh->params.bvh_layout == BVH_LAYOUT_EMBREE)
+    {
       devices.back().device->build_bvh(bvh, progress, refit);
       return;
     }
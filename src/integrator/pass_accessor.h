@@ -55,6 +55,12 @@ class PassAccessor {
     half4 *pixels_half_rgba = nullptr;
     uchar4* pixels_uchar_srgba = nullptr;
 
+    /* Planar 8-bit YUV 4:2:0 destination for video encoders. Chroma planes have half the
+     * resolution of the luma plane, rounded up, and offset and stride refer to the luma plane. */
+    uchar *pixels_yuv420_y = nullptr;
+    uchar *pixels_yuv420_u = nullptr;
+    uchar *pixels_yuv420_v = nullptr;
+
     /* Device-side pointers. */
     device_ptr d_pixels = 0;
     device_ptr d_pixels_half_rgba = 0;
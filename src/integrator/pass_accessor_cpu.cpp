@@ -73,27 +73,71 @@ inline void PassAccessorCPU::run_get_pass_kernel_processor_half_rgba(
 }
 
 inline void PassAccessorCPU::run_get_pass_kernel_processor_byte_rgba(
-    const KernelFilmConvert* kfilm_convert,
-    const RenderBuffers* render_buffers,
-    const BufferParams& buffer_params,
-    const Destination& destination,
+    const KernelFilmConvert *kfilm_convert,
+    const RenderBuffers *render_buffers,
+    const BufferParams &buffer_params,
+    const Destination &destination,
     const CPUKernels::FilmConvertByteRGBAFunction func) const
 {
-    const int64_t pass_stride = buffer_params.pass_stride;
-    const int64_t buffer_row_stride = buffer_params.stride * buffer_params.pass_stride;
+  const int64_t pass_stride = buffer_params.pass_stride;
+  const int64_t buffer_row_stride = buffer_params.stride * buffer_params.pass_stride;
 
-    const float* window_data = render_buffers->buffer.data() + buffer_params.window_x * pass_stride +
-        buffer_params.window_y * buffer_row_stride;
+  const float *window_data = render_buffers->buffer.data() + buffer_params.window_x * pass_stride +
+                             buffer_params.window_y * buffer_row_stride;
 
-    uchar4* dst_start = destination.pixels_uchar_srgba + destination.offset;
-    const int destination_stride = destination.stride != 0 ? destination.stride :
-        buffer_params.width;
+  uchar4 *dst_start = destination.pixels_uchar_srgba + destination.offset;
+  const int destination_stride = destination.stride != 0 ? destination.stride :
+                                                           buffer_params.window_width;
 
-    tbb::parallel_for(0, buffer_params.window_height, [&](int64_t y) {
-        const float* buffer = window_data + y * buffer_row_stride;
-        uchar4* pixel = dst_start + y * destination_stride;
-        func(kfilm_convert, buffer, pixel, buffer_params.window_width, pass_stride);
-    });
+  parallel_for(0, buffer_params.window_height, [&](int64_t y) {
+    const float *buffer = window_data + y * buffer_row_stride;
+    uchar4 *pixel = dst_start + y * destination_stride;
+    func(kfilm_convert, buffer, pixel, buffer_params.window_width, pass_stride);
+  });
+}
+
+inline void PassAccessorCPU::run_get_pass_kernel_processor_yuv420(
+    const KernelFilmConvert *kfilm_convert,
+    const RenderBuffers *render_buffers,
+    const BufferParams &buffer_params,
+    const Destination &destination,
+    const CPUKernels::FilmConvertYUV420Function func) const
+{
+  const int64_t pass_stride = buffer_params.pass_stride;
+  const int64_t buffer_row_stride = buffer_params.stride * buffer_params.pass_stride;
+
+  const float *window_data = render_buffers->buffer.data() + buffer_params.window_x * pass_stride +
+                             buffer_params.window_y * buffer_row_stride;
+
+  /* Chroma is subsampled in 2x2 blocks, so the destination offset must be at an even pixel. */
+  const int luma_stride = destination.stride != 0 ? destination.stride :
+                                                    buffer_params.window_width;
+  const int chroma_stride = (luma_stride + 1) / 2;
+  const int offset_x = destination.offset % luma_stride;
+  const int offset_y = destination.offset / luma_stride;
+  DCHECK(offset_x % 2 == 0 && offset_y % 2 == 0);
+
+  uchar *luma_start = destination.pixels_yuv420_y + destination.offset;
+  const int64_t chroma_offset = int64_t(offset_y / 2) * chroma_stride + offset_x / 2;
+  uchar *chroma_u_start = destination.pixels_yuv420_u + chroma_offset;
+  uchar *chroma_v_start = destination.pixels_yuv420_v + chroma_offset;
+
+  const int height = buffer_params.window_height;
+  parallel_for(0, (height + 1) / 2, [&](int64_t chroma_y) {
+    const int64_t y = chroma_y * 2;
+    const bool has_next_row = (y + 1 < height);
+    const float *buffer = window_data + y * buffer_row_stride;
+    uchar *luma = luma_start + y * luma_stride;
+    func(kfilm_convert,
+         buffer,
+         has_next_row ? buffer + buffer_row_stride : nullptr,
+         luma,
+         has_next_row ? luma + luma_stride : nullptr,
+         chroma_u_start + chroma_y * chroma_stride,
+         chroma_v_start + chroma_y * chroma_stride,
+         buffer_params.window_width,
+         pass_stride);
+  });
 }
 
 /* --------------------------------------------------------------------
@@ -132,6 +176,14 @@ inline void PassAccessorCPU::run_get_pass_kernel_processor_byte_rgba(
                                               destination, \
                                               kernels.film_convert_byte_rgba_##pass); \
     } \
+\
+    if (destination.pixels_yuv420_y) { \
+      run_get_pass_kernel_processor_yuv420(&kfilm_convert, \
+                                           render_buffers, \
+                                           buffer_params, \
+                                           destination, \
+                                           kernels.film_convert_yuv420_##pass); \
+    } \
   }
 
 /* Float (scalar) passes. */
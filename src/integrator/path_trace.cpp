@@ -169,6 +169,7 @@ void PathTrace::render(const RenderWork &render_work)
     render_cancel_.is_rendering = true;
   }
 
+  unpack_render_buffers();
   render_pipeline(render_work);
 
   /* Indicate that rendering has finished, making it so thread which requested `cancel()` can carry
@@ -391,6 +392,25 @@ void PathTrace::init_render_buffers(const RenderWork &render_work)
     });
 
     tile_buffer_read();
+
+    if (temporal_reprojection_.has_history()) {
+      reproject_render_buffers();
+    }
+  }
+}
+
+void PathTrace::reproject_render_buffers()
+{
+  RenderBuffers big_tile_cpu_buffers(cpu_device_.get());
+  big_tile_cpu_buffers.reset(render_state_.effective_big_tile_params);
+  big_tile_cpu_buffers.zero();
+
+  if (temporal_reprojection_.reproject(big_tile_cpu_buffers.params,
+                                       big_tile_cpu_buffers.buffer.data(),
+                                       device_scene_->data.cam,
+                                       temporal_reprojection_params_))
+  {
+    copy_from_render_buffers(&big_tile_cpu_buffers);
   }
 }
 
@@ -585,6 +605,44 @@ void PathTrace::set_adaptive_sampling(const AdaptiveSampling &adaptive_sampling)
   render_scheduler_.set_adaptive_sampling(adaptive_sampling);
 }
 
+void PathTrace::set_sample_density(const SampleDensityMap &sample_density)
+{
+  render_scheduler_.set_sample_density(sample_density);
+
+  for (auto &&path_trace_work : path_trace_works_) {
+    path_trace_work->set_sample_density(&render_scheduler_.get_sample_density());
+  }
+}
+
+void PathTrace::update_temporal_reprojection(const TemporalReprojectionParams &params)
+{
+  temporal_reprojection_params_ = params;
+
+  if (!params.use || params.scene_modified) {
+    temporal_reprojection_.clear();
+    return;
+  }
+
+  /* Nothing rendered since the last reset, or at a lower resolution than the stored buffers which
+   * are still valid for the static scene. */
+  const int resolution_divider = render_state_.resolution_divider;
+  if (render_scheduler_.get_num_rendered_samples() == 0 ||
+      (temporal_reprojection_.has_history() &&
+       resolution_divider > temporal_reprojection_.get_resolution_divider()))
+  {
+    return;
+  }
+
+  RenderBuffers big_tile_cpu_buffers(cpu_device_.get());
+  big_tile_cpu_buffers.reset(render_state_.effective_big_tile_params);
+  copy_to_render_buffers(&big_tile_cpu_buffers);
+
+  temporal_reprojection_.store(big_tile_cpu_buffers.params,
+                               big_tile_cpu_buffers.buffer.data(),
+                               device_scene_->data.cam,
+                               resolution_divider);
+}
+
 void PathTrace::cryptomatte_postprocess(const RenderWork &render_work)
 {
   if (!render_work.cryptomatte.postprocess) {
@@ -1004,8 +1062,23 @@ void PathTrace::progress_set_status(const string &status, const string &substatu
   }
 }
 
+void PathTrace::pack_render_buffers()
+{
+  parallel_for_each(path_trace_works_, [](unique_ptr<PathTraceWork> &path_trace_work) {
+    path_trace_work->get_render_buffers()->pack();
+  });
+}
+
+void PathTrace::unpack_render_buffers()
+{
+  parallel_for_each(path_trace_works_, [](unique_ptr<PathTraceWork> &path_trace_work) {
+    path_trace_work->get_render_buffers()->unpack();
+  });
+}
+
 void PathTrace::copy_to_render_buffers(RenderBuffers *render_buffers)
 {
+  unpack_render_buffers();
   parallel_for_each(path_trace_works_,
                     [&render_buffers](unique_ptr<PathTraceWork> &path_trace_work) {
                       path_trace_work->copy_to_render_buffers(render_buffers);
@@ -1015,6 +1088,7 @@ void PathTrace::copy_to_render_buffers(RenderBuffers *render_buffers)
 
 void PathTrace::copy_from_render_buffers(RenderBuffers *render_buffers)
 {
+  unpack_render_buffers();
   render_buffers->copy_from_device();
   parallel_for_each(path_trace_works_,
                     [&render_buffers](unique_ptr<PathTraceWork> &path_trace_work) {
@@ -1024,6 +1098,8 @@ void PathTrace::copy_from_render_buffers(RenderBuffers *render_buffers)
 
 bool PathTrace::copy_render_tile_from_device()
 {
+  unpack_render_buffers();
+
   if (full_frame_state_.render_buffers) {
     /* Full-frame buffer is always allocated on CPU. */
     return true;
@@ -1133,6 +1209,8 @@ int PathTrace::get_num_render_tile_samples() const
 bool PathTrace::get_render_tile_pixels(const PassAccessor &pass_accessor,
                                        const PassAccessor::Destination &destination)
 {
+  unpack_render_buffers();
+
   if (full_frame_state_.render_buffers) {
     return pass_accessor.get_render_tile_pixels(full_frame_state_.render_buffers, destination);
   }
@@ -1163,6 +1241,8 @@ bool PathTrace::get_render_tile_pixels(const PassAccessor &pass_accessor,
 bool PathTrace::set_render_tile_pixels(PassAccessor &pass_accessor,
                                        const PassAccessor::Source &source)
 {
+  unpack_render_buffers();
+
   bool success = true;
 
   parallel_for_each(path_trace_works_, [&](unique_ptr<PathTraceWork> &path_trace_work) {
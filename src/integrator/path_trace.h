@@ -10,6 +10,7 @@
 #include "integrator/guiding.h"
 #include "integrator/pass_accessor.h"
 #include "integrator/path_trace_work.h"
+#include "integrator/temporal_reprojection.h"
 #include "integrator/work_balancer.h"
 
 #include "session/buffers.h"
@@ -96,6 +97,14 @@ class PathTrace {
    * Use this to configure the adaptive sampler before rendering any samples. */
   void set_adaptive_sampling(const AdaptiveSampling &adaptive_sampling);
 
+  /* Set the fraction of the samples rendered in the regions of the image.
+   * Use this to configure the path tracing before rendering any samples. */
+  void set_sample_density(const SampleDensityMap &sample_density);
+
+  /* Keep the render buffers of the previous camera to seed the next accumulation with, or discard
+   * them. Is to be called on reset, before the scene update replaces the camera. */
+  void update_temporal_reprojection(const TemporalReprojectionParams &params);
+
   /* Set the parameters for guiding.
    * Use to setup the guiding structures before each rendering iteration. */
   void set_guiding_params(const GuidingParams &params, const bool reset);
@@ -122,6 +131,10 @@ class PathTrace {
    */
   void cancel();
 
+  /* Pack render buffers of all works into compact host storage while the path trace is idle,
+   * see `RenderBuffers::pack()`. They are unpacked on the next render or buffer access. */
+  void pack_render_buffers();
+
   /* Copy an entire render buffer to/from the path trace. */
 
   /* Copy happens via CPU side buffer: data will be copied from every device of the path trace, and
@@ -192,6 +205,9 @@ class PathTrace {
    * `render_cancel_` in the consistent state. */
   void render_pipeline(RenderWork render_work);
 
+  /* Restore render buffers packed by `pack_render_buffers()`. */
+  void unpack_render_buffers();
+
   /* Initialize kernel execution on all integrator queues. */
   void render_init_kernel_execution();
 
@@ -207,6 +223,7 @@ class PathTrace {
    * Note that some steps might modify the work, forcing some steps to happen within this iteration
    * of rendering. */
   void init_render_buffers(const RenderWork &render_work);
+  void reproject_render_buffers();
   void path_trace(RenderWork &render_work);
   void adaptive_sample(RenderWork &render_work);
   void denoise(const RenderWork &render_work);
@@ -261,6 +278,10 @@ class PathTrace {
   /* CPU device for creating temporary render buffers on the CPU side. */
   unique_ptr<Device> cpu_device_;
 
+  /* Render buffers of the previous camera. */
+  TemporalReprojection temporal_reprojection_;
+  TemporalReprojectionParams temporal_reprojection_params_;
+
   Film *film_;
   DeviceScene *device_scene_;
 
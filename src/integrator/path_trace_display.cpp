@@ -276,4 +276,9 @@ bool PathTraceDisplay::buffer_linear2srgb()
     return driver_->buffer_linear2srgb();
 }
 
+bool PathTraceDisplay::buffer_yuv420()
+{
+  return driver_->buffer_yuv420();
+}
+
 CCL_NAMESPACE_END
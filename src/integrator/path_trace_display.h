@@ -150,6 +150,7 @@ class PathTraceDisplay {
 
   bool only_device_buffer();
   bool buffer_linear2srgb();  
+  bool buffer_yuv420();
 
  private:
   /* Display driver implemented by the host application. */
@@ -73,6 +73,11 @@ bool PathTraceWork::has_multiple_works() const
            effective_big_tile_params_.full_y == effective_buffer_params_.full_y);
 }
 
+void PathTraceWork::set_sample_density(const SampleDensityMap *sample_density)
+{
+  sample_density_ = sample_density;
+}
+
 void PathTraceWork::copy_to_render_buffers(RenderBuffers *render_buffers)
 {
   copy_render_buffers_from_device();
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "integrator/pass_accessor.h"
+#include "integrator/sample_density.h"
 #include "scene/pass.h"
 #include "session/buffers.h"
 #include "util/unique_ptr.h"
@@ -50,6 +51,10 @@ class PathTraceWork {
   /* Check whether the big tile is being worked on by multiple path trace works. */
   bool has_multiple_works() const;
 
+  /* Fraction of the samples to render in the regions of the image, owned by the render
+   * scheduler. Null or uniform renders all samples everywhere. */
+  void set_sample_density(const SampleDensityMap *sample_density);
+
   /* Allocate working memory for execution. Must be called before init_execution(). */
   virtual void alloc_work_memory() {};
 
@@ -192,6 +197,8 @@ class PathTraceWork {
   BufferParams effective_buffer_params_;
 
   const bool *cancel_requested_flag_ = nullptr;
+
+  const SampleDensityMap *sample_density_ = nullptr;
 };
 
 CCL_NAMESPACE_END
@@ -4,6 +4,8 @@
 
 #include "integrator/path_trace_work_cpu.h"
 
+#include <atomic>
+
 #include "device/cpu/kernel.h"
 #include "device/device.h"
 
@@ -33,13 +35,12 @@ static inline tbb::task_arena local_tbb_arena_create(const Device *device)
   return tbb::task_arena(device->info.cpu_threads);
 }
 
-/* Get ThreadKernelGlobalsCPU for the current thread. */
+/* Get ThreadKernelGlobalsCPU for the thread index given by PathTraceWorkCPU::parallel_for_work. */
 static inline ThreadKernelGlobalsCPU *kernel_thread_globals_get(
-    vector<ThreadKernelGlobalsCPU> &kernel_thread_globals)
+    vector<ThreadKernelGlobalsCPU> &kernel_thread_globals, const int thread_index)
 {
-  const int thread_index = tbb::this_task_arena::current_thread_index();
   DCHECK_GE(thread_index, 0);
-  DCHECK_LE(thread_index, kernel_thread_globals.size());
+  DCHECK_LT(thread_index, kernel_thread_globals.size());
 
   return &kernel_thread_globals[thread_index];
 }
@@ -49,7 +50,8 @@ PathTraceWorkCPU::PathTraceWorkCPU(Device *device,
                                    DeviceScene *device_scene,
                                    const bool *cancel_requested_flag)
     : PathTraceWork(device, film, device_scene, cancel_requested_flag),
-      kernels_(Device::get_cpu_kernels())
+      kernels_(Device::get_cpu_kernels()),
+      megakernel_(&kernels_.integrator_megakernel)
 {
   DCHECK_EQ(device->info.type, DEVICE_CPU);
 }
@@ -58,6 +60,8 @@ void PathTraceWorkCPU::init_execution()
 {
   /* Cache per-thread kernel globals. */
   device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+
+  megakernel_ = &kernels_.integrator_megakernel_for_features(device_->get_cpu_kernel_features());
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
@@ -69,38 +73,53 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
   const int64_t image_height = effective_buffer_params_.height;
   const int64_t total_pixels_num = image_width * image_height;
 
+  const bool use_sample_density = sample_density_ && !sample_density_->is_uniform();
+  const int2 full_size = make_int2(effective_full_params_.full_width,
+                                   effective_full_params_.full_height);
+
   if (device_->profiler.active()) {
     for (ThreadKernelGlobalsCPU &kernel_globals : kernel_thread_globals_) {
       kernel_globals.start_profiling();
     }
   }
 
-  tbb::task_arena local_arena = local_tbb_arena_create(device_);
-  local_arena.execute([&]() {
-    parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
-      if (is_cancel_requested()) {
+  auto render_pixel = [&](const int64_t work_index, ThreadKernelGlobalsCPU *kernel_globals) {
+    if (is_cancel_requested()) {
+      return;
+    }
+
+    const int y = work_index / image_width;
+    const int x = work_index - y * image_width;
+
+    KernelWorkTile work_tile;
+    work_tile.x = effective_buffer_params_.full_x + x;
+    work_tile.y = effective_buffer_params_.full_y + y;
+    work_tile.w = 1;
+    work_tile.h = 1;
+    work_tile.start_sample = start_sample;
+    work_tile.sample_offset = sample_offset;
+    work_tile.num_samples = 1;
+    work_tile.offset = effective_buffer_params_.offset;
+    work_tile.stride = effective_buffer_params_.stride;
+
+    int pixel_samples_num = samples_num;
+    if (use_sample_density) {
+      const float density = sample_density_->get_density(full_size, work_tile.x, work_tile.y);
+      const int2 range = sample_density_range(density, start_sample, samples_num);
+      work_tile.start_sample = range.x;
+      pixel_samples_num = range.y;
+      if (pixel_samples_num == 0) {
         return;
       }
+    }
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
-
-      KernelWorkTile work_tile;
-      work_tile.x = effective_buffer_params_.full_x + x;
-      work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.sample_offset = sample_offset;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
-
-      ThreadKernelGlobalsCPU *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+    render_samples_full_pipeline(kernel_globals, work_tile, pixel_samples_num);
+  };
 
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
-    });
+  parallel_for_work(device_, total_pixels_num, [&](const int64_t work_index, const int thread) {
+    render_pixel(work_index, kernel_thread_globals_get(kernel_thread_globals_, thread));
   });
+
   if (device_->profiler.active()) {
     for (ThreadKernelGlobalsCPU &kernel_globals : kernel_thread_globals_) {
       kernel_globals.stop_profiling();
@@ -110,11 +129,74 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
   statistics.occupancy = 1.0f;
 }
 
+void PathTraceWorkCPU::parallel_for_work(
+    const Device *device,
+    const int64_t num_work,
+    const std::function<void(int64_t work_index, int thread)> &function)
+{
+  const vector<DeviceNUMANode> numa_nodes = device->get_cpu_numa_nodes();
+  if (numa_nodes.empty()) {
+    tbb::task_arena local_arena = local_tbb_arena_create(device);
+    local_arena.execute([&]() {
+      parallel_for(int64_t(0), num_work, [&](int64_t work_index) {
+        function(work_index, tbb::this_task_arena::current_thread_index());
+      });
+    });
+    return;
+  }
+
+  /* One arena pinned to every NUMA node. Threads take chunks of work from a shared counter, so
+   * nodes stay balanced when some work takes longer. */
+  const int64_t chunk_size = 16;
+  std::atomic<int64_t> next_work_index = 0;
+
+  vector<unique_ptr<tbb::task_arena>> arenas;
+  vector<unique_ptr<tbb::task_group>> task_groups;
+  int thread_offset = 0;
+
+  for (const DeviceNUMANode &node : numa_nodes) {
+    /* No slot is reserved for the calling thread, which only waits for the arenas one after
+     * another. Otherwise every arena would run one thread short until it is waited on. */
+    arenas.push_back(make_unique<tbb::task_arena>(
+        tbb::task_arena::constraints(node.id, node.num_threads), 0));
+    task_groups.push_back(make_unique<tbb::task_group>());
+
+    tbb::task_group &task_group = *task_groups.back();
+    const int num_threads = node.num_threads;
+    arenas.back()->execute([&, thread_offset, num_threads]() {
+      task_group.run([&, thread_offset, num_threads]() {
+        parallel_for(
+            0,
+            num_threads,
+            [&](int /*thread*/) {
+              const int thread = thread_offset + tbb::this_task_arena::current_thread_index();
+              for (int64_t start = next_work_index.fetch_add(chunk_size); start < num_work;
+                   start = next_work_index.fetch_add(chunk_size))
+              {
+                const int64_t end = std::min(start + chunk_size, num_work);
+                for (int64_t work_index = start; work_index < end; work_index++) {
+                  function(work_index, thread);
+                }
+              }
+            },
+            tbb::simple_partitioner());
+      });
+    });
+
+    thread_offset += node.num_threads;
+  }
+
+  for (size_t i = 0; i < arenas.size(); i++) {
+    arenas[i]->execute([&]() { task_groups[i]->wait(); });
+  }
+}
+
 void PathTraceWorkCPU::render_samples_full_pipeline(ThreadKernelGlobalsCPU *kernel_globals,
                                                     const KernelWorkTile &work_tile,
                                                     const int samples_num)
 {
   const bool has_bake = device_scene_->data.bake.use;
+  const CPUKernels::IntegratorShadeFunction &megakernel = *megakernel_;
 
   IntegratorStateCPU integrator_states[2];
 
@@ -156,7 +238,7 @@ void PathTraceWorkCPU::render_samples_full_pipeline(ThreadKernelGlobalsCPU *kern
       assert(kernel_globals->opgl_path_segment_storage);
       assert(kernel_globals->opgl_path_segment_storage->GetNumSegments() == 0);
 
-      kernels_.integrator_megakernel(kernel_globals, state, render_buffer);
+      megakernel(kernel_globals, state, render_buffer);
 
       /* Push the generated sample data to the global sample data storage. */
       guiding_push_sample_data_to_global_storage(kernel_globals, state, render_buffer);
@@ -164,16 +246,16 @@ void PathTraceWorkCPU::render_samples_full_pipeline(ThreadKernelGlobalsCPU *kern
       /* No training for shadow catcher paths. */
       if (shadow_catcher_state) {
         kernel_globals->data.integrator.train_guiding = false;
-        kernels_.integrator_megakernel(kernel_globals, shadow_catcher_state, render_buffer);
+        megakernel(kernel_globals, shadow_catcher_state, render_buffer);
         kernel_globals->data.integrator.train_guiding = true;
       }
     }
     else
 #endif
     {
-      kernels_.integrator_megakernel(kernel_globals, state, render_buffer);
+      megakernel(kernel_globals, state, render_buffer);
       if (shadow_catcher_state) {
-        kernels_.integrator_megakernel(kernel_globals, shadow_catcher_state, render_buffer);
+        megakernel(kernel_globals, shadow_catcher_state, render_buffer);
       }
     }
 
@@ -211,7 +293,16 @@ void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
 
   PassAccessor::Destination destination = get_display_destination_template(display, pass_mode);
   
-  if (display->buffer_linear2srgb()) {
+  if (display->buffer_yuv420()) {
+    /* Planes are stored one after another in the texture buffer. */
+    const int2 texture_size = display->get_texture_size();
+    const int64_t luma_size = int64_t(texture_size.x) * texture_size.y;
+    const int64_t chroma_size = int64_t((texture_size.x + 1) / 2) * ((texture_size.y + 1) / 2);
+    destination.pixels_yuv420_y = (uchar *)rgba_half;
+    destination.pixels_yuv420_u = destination.pixels_yuv420_y + luma_size;
+    destination.pixels_yuv420_v = destination.pixels_yuv420_u + chroma_size;
+  }
+  else if (display->buffer_linear2srgb()) {
     destination.pixels_uchar_srgba = (uchar4*)rgba_half;
   }else{
     destination.pixels_half_rgba = rgba_half;
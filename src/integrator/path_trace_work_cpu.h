@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <functional>
+
 #include "kernel/device/cpu/globals.h"
 #include "kernel/integrator/state.h"
 
+#include "device/cpu/kernel.h"
 #include "device/queue.h"
 
 #include "integrator/path_trace_work.h"
@@ -19,8 +22,6 @@ struct KernelWorkTile;
 struct ThreadKernelGlobalsCPU;
 struct IntegratorStateCPU;
 
-class CPUKernels;
-
 /* Implementation of PathTraceWork which schedules work on to queues pixel-by-pixel,
  * for CPU devices.
  *
@@ -40,6 +41,13 @@ class PathTraceWorkCPU : public PathTraceWork {
                       const int samples_num,
                       const int sample_offset) override;
 
+  /* Run the function for every work index on the render threads of the device, pinned to its
+   * NUMA nodes if it has them. The thread is the index of the thread kernel globals to use. */
+  static void parallel_for_work(
+      const Device *device,
+      const int64_t num_work,
+      const std::function<void(int64_t work_index, int thread)> &function);
+
   void copy_to_display(PathTraceDisplay *display,
                        PassMode pass_mode,
                        const int num_samples) override;
@@ -78,6 +86,9 @@ class PathTraceWorkCPU : public PathTraceWork {
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
+  /* Megakernel for the features used by the scene. */
+  const CPUKernels::IntegratorShadeFunction *megakernel_;
+
   /* Copy of kernel globals which is suitable for concurrent access from multiple threads.
    *
    * More specifically, the `kernel_globals_` is local to each threads and nobody else is
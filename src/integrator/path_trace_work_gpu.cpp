@@ -345,6 +345,7 @@ void PathTraceWorkGPU::render_samples(RenderStatistics &statistics,
   work_tile_scheduler_.set_max_num_path_states(max_num_paths_ / 8);
   work_tile_scheduler_.set_accelerated_rt(
       (device_->get_bvh_layout_mask(device_scene_->data.kernel_features) & BVH_LAYOUT_OPTIX) != 0);
+  work_tile_scheduler_.set_sample_density(sample_density_);
   work_tile_scheduler_.reset(effective_buffer_params_,
                              start_sample,
                              samples_num,
@@ -73,6 +73,21 @@ bool RenderScheduler::is_adaptive_sampling_used() const
   return adaptive_sampling_.use;
 }
 
+void RenderScheduler::set_sample_density(const SampleDensityMap &sample_density)
+{
+  sample_density_ = sample_density;
+}
+
+const SampleDensityMap &RenderScheduler::get_sample_density() const
+{
+  return sample_density_;
+}
+
+bool RenderScheduler::is_converged() const
+{
+  return state_.path_trace_finished;
+}
+
 void RenderScheduler::set_sample_params(const int num_samples,
                                         const bool use_sample_subset,
                                         const int sample_subset_offset,
@@ -108,6 +123,11 @@ double RenderScheduler::get_time_limit() const
   return time_limit_;
 }
 
+void RenderScheduler::set_navigation_time_budget(const double time_budget)
+{
+  navigation_time_budget_ = time_budget;
+}
+
 int RenderScheduler::get_rendered_sample() const
 {
   DCHECK_GT(get_num_rendered_samples(), 0);
@@ -651,6 +671,12 @@ string RenderScheduler::full_report() const
     result += "  Threshold: " + to_string(adaptive_sampling_.threshold) + "\n";
   }
 
+  result += "\nSample density:\n";
+  result += "  Uniform: " + string_from_bool(sample_density_.is_uniform()) + "\n";
+  if (!sample_density_.is_uniform()) {
+    result += "  Average: " + to_string(sample_density_.get_average_density()) + "\n";
+  }
+
   result += "\nDenoiser:\n";
   result += "  Use: " + string_from_bool(denoiser_params_.use) + "\n";
   if (denoiser_params_.use) {
@@ -1163,9 +1189,10 @@ void RenderScheduler::update_start_resolution_divider()
 
   /* Allow some percent of tolerance, so that if the render time is close enough to the higher
    * resolution we prefer to use it instead of going way lower resolution and time way below the
-   * desired one. */
+   * desired one. An explicit budget is a limit, so no tolerance is used for it. */
+  const double tolerance = (navigation_time_budget_ > 0.0) ? 1.0 : 1.4;
   const int resolution_divider_for_update = calculate_resolution_divider_for_time(
-      desired_update_interval_in_seconds * 1.4, actual_time_per_update);
+      desired_update_interval_in_seconds * tolerance, actual_time_per_update);
 
   /* TODO(sergey): Need to add hysteresis to avoid resolution divider bouncing around when actual
    * render time is somewhere on a boundary between two resolutions. */
@@ -1179,6 +1206,10 @@ void RenderScheduler::update_start_resolution_divider()
 
 double RenderScheduler::guess_viewport_navigation_update_interval_in_seconds() const
 {
+  if (navigation_time_budget_ > 0.0) {
+    return navigation_time_budget_;
+  }
+
   if (is_denoise_active_during_update()) {
     /* Use lower value than the non-denoised case to allow having more pixels to reconstruct the
      * image from. With the faster updates and extra compute required the resolution becomes too
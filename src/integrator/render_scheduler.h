@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "integrator/adaptive_sampling.h"
 #include "integrator/denoiser.h"
+#include "integrator/sample_density.h"
 
 #include "session/buffers.h"
 
@@ -109,6 +112,10 @@ class RenderScheduler {
   void set_adaptive_sampling(const AdaptiveSampling &adaptive_sampling);
   bool is_adaptive_sampling_used() const;
 
+  /* Fraction of the samples to render in the regions of the image, see SampleDensityMap. */
+  void set_sample_density(const SampleDensityMap &sample_density);
+  const SampleDensityMap &get_sample_density() const;
+
   /* Setup parameters defining the sampling range.
    *
    * It is a single function setting up multiple parameters because there are inter-dependencies
@@ -145,6 +152,10 @@ class RenderScheduler {
   void set_time_limit(const double time_limit);
   double get_time_limit() const;
 
+  /* Time in seconds to fit a viewport update into while navigating, by choosing the resolution
+   * divider. Zero uses the default interval. */
+  void set_navigation_time_budget(const double time_budget);
+
   /* Get sample up to which rendering has been done.
    * This is an absolute 0-based value.
    *
@@ -163,6 +174,10 @@ class RenderScheduler {
    * requested for work to render the scheduler considers the work done. */
   int get_num_rendered_samples() const;
 
+  /* Check whether adaptive sampling found all pixels to be converged, so no more samples will be
+   * rendered until the next reset. */
+  bool is_converged() const;
+
   /* Reset scheduler, indicating that rendering will happen from scratch.
    * Resets current rendered state, as well as scheduling information. */
   void reset(const BufferParams &buffer_params);
@@ -410,7 +425,8 @@ class RenderScheduler {
     bool full_frame_work_scheduled = false;
     bool full_frame_was_written = false;
 
-    bool path_trace_finished = false;
+    /* Atomic as it is also read by the host of the session through is_converged(). */
+    std::atomic<bool> path_trace_finished = false;
     bool time_limit_reached = false;
 
     /* Time at which rendering started and finished. */
@@ -459,6 +475,9 @@ class RenderScheduler {
    * Zero means no limit is applied. */
   double time_limit_ = 0.0;
 
+  /* Desired time of a viewport update while navigating, zero for the default. */
+  double navigation_time_budget_ = 0.0;
+
   /* Headless rendering without interface. */
   bool headless_;
 
@@ -476,6 +495,8 @@ class RenderScheduler {
 
   AdaptiveSampling adaptive_sampling_;
 
+  SampleDensityMap sample_density_;
+
   /* Progressively lower adaptive sampling threshold level, keeping the image at a uniform noise
    * level. */
   bool use_progressive_noise_floor_ = false;
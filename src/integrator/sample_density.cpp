@@ -0,0 +1,72 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "integrator/sample_density.h"
+
+CCL_NAMESPACE_BEGIN
+
+void SampleDensityMap::set_focus(const int2 image_size,
+                                 const float4 region,
+                                 const float radius,
+                                 const float falloff,
+                                 const float min_density)
+{
+  image_size_ = make_int2(max(image_size.x, 1), max(image_size.y, 1));
+  size_ = make_int2(divide_up(image_size_.x, CELL_SIZE), divide_up(image_size_.y, CELL_SIZE));
+  densities_.resize(size_t(size_.x) * size_.y);
+
+  /* Every pixel still renders its first sample, so the image has no holes. */
+  const float density_min = clamp(min_density, 1e-3f, 1.0f);
+
+  for (int y = 0; y < size_.y; y++) {
+    for (int x = 0; x < size_.x; x++) {
+      /* Distance of the cell center to the region. */
+      const float2 P = make_float2((x + 0.5f) * CELL_SIZE, (y + 0.5f) * CELL_SIZE);
+      const float dx = max(max(region.x - P.x, P.x - region.z), 0.0f);
+      const float dy = max(max(region.y - P.y, P.y - region.w), 0.0f);
+      const float distance = sqrtf(dx * dx + dy * dy);
+
+      const float t = (falloff > 0.0f) ? smoothstep(radius, radius + falloff, distance) :
+                                         float(distance > radius);
+      densities_[size_t(y) * size_.x + x] = mix(1.0f, density_min, t);
+    }
+  }
+}
+
+void SampleDensityMap::clear()
+{
+  image_size_ = make_int2(0, 0);
+  size_ = make_int2(0, 0);
+  densities_.clear();
+}
+
+float SampleDensityMap::get_density(const int2 image_size, const int x, const int y) const
+{
+  if (densities_.empty()) {
+    return 1.0f;
+  }
+
+  const int cell_x = clamp(int(int64_t(x) * image_size_.x / max(image_size.x, 1)) / CELL_SIZE,
+                           0,
+                           size_.x - 1);
+  const int cell_y = clamp(int(int64_t(y) * image_size_.y / max(image_size.y, 1)) / CELL_SIZE,
+                           0,
+                           size_.y - 1);
+  return densities_[size_t(cell_y) * size_.x + cell_x];
+}
+
+float SampleDensityMap::get_average_density() const
+{
+  if (densities_.empty()) {
+    return 1.0f;
+  }
+
+  double sum = 0.0;
+  for (const float density : densities_) {
+    sum += density;
+  }
+  return float(sum / densities_.size());
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,82 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/math.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Fraction of the samples which are rendered in the different regions of the image, so that a
+ * focus region converges first while the periphery gets fewer samples.
+ *
+ * The densities are stored in cells of CELL_SIZE x CELL_SIZE pixels of the image the map was
+ * created for, and looked up relative to the size of the image being rendered so the map also
+ * applies with a resolution divider. Pixels with density d render ceil(n * d) of the first n
+ * samples, which requires the sample count pass to normalize the result. */
+class SampleDensityMap {
+ public:
+  static constexpr int CELL_SIZE = 16;
+
+  /* Uniform map, all samples are rendered everywhere. */
+  SampleDensityMap() = default;
+
+  /* Full density within `radius` pixels of the focus region, given as (min_x, min_y, max_x,
+   * max_y) in pixels of an image of `image_size`, smoothly falling off to `min_density` over
+   * `falloff` pixels further out.
+   *
+   * A region of a single point is a circular fovea, a radius of zero a rectangular region of
+   * interest. */
+  void set_focus(const int2 image_size,
+                 const float4 region,
+                 const float radius,
+                 const float falloff,
+                 const float min_density);
+
+  /* Return to the uniform density. */
+  void clear();
+
+  bool is_uniform() const
+  {
+    return densities_.empty();
+  }
+
+  /* Density of the pixel (x, y) of an image of `image_size` pixels, 1 for a uniform map. */
+  float get_density(const int2 image_size, const int x, const int y) const;
+
+  /* Average density over the image, the fraction of the uniform work which is rendered. */
+  float get_average_density() const;
+
+  bool operator==(const SampleDensityMap &other) const
+  {
+    return size_ == other.size_ && image_size_ == other.image_size_ &&
+           densities_ == other.densities_;
+  }
+
+ protected:
+  /* Size of the image the map was created for, and its number of cells. */
+  int2 image_size_ = make_int2(0, 0);
+  int2 size_ = make_int2(0, 0);
+
+  vector<float> densities_;
+};
+
+/* Range of the samples [start, start + num) of a pixel with the given density to render when
+ * rendering the samples [start_sample, start_sample + num_samples) of the image. Returns it as
+ * (start, num), where num is zero when the pixel skips these samples. */
+inline int2 sample_density_range(const float density,
+                                 const int start_sample,
+                                 const int num_samples)
+{
+  if (density >= 1.0f) {
+    return make_int2(start_sample, num_samples);
+  }
+
+  const int start = int(ceilf(float(start_sample) * density));
+  const int end = int(ceilf(float(start_sample + num_samples) * density));
+  return make_int2(start, end - start);
+}
+
+CCL_NAMESPACE_END
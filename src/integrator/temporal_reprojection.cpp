@@ -0,0 +1,205 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "integrator/temporal_reprojection.h"
+
+#include "util/log.h"
+#include "util/math.h"
+#include "util/transform.h"
+
+CCL_NAMESPACE_BEGIN
+
+void TemporalReprojection::store(const BufferParams &buffer_params,
+                                 const float *buffer,
+                                 const KernelCamera &camera,
+                                 const int resolution_divider)
+{
+  if (!camera_supported(camera) ||
+      buffer_params.get_pass_offset(PASS_DEPTH) == PASS_UNUSED ||
+      buffer_params.get_pass_offset(PASS_SAMPLE_COUNT) == PASS_UNUSED)
+  {
+    clear();
+    return;
+  }
+
+  buffer_params_ = buffer_params;
+  history_.assign(buffer,
+                  buffer + size_t(buffer_params.width) * buffer_params.height *
+                               buffer_params.pass_stride);
+  camera_ = camera;
+  resolution_divider_ = resolution_divider;
+}
+
+void TemporalReprojection::clear()
+{
+  history_.clear();
+  history_.shrink_to_fit();
+  resolution_divider_ = 0;
+}
+
+bool TemporalReprojection::camera_supported(const KernelCamera &camera)
+{
+  return camera.type == CAMERA_PERSPECTIVE || camera.type == CAMERA_ORTHOGRAPHIC;
+}
+
+/* World position of the surface seen through the raster position at the camera z depth. */
+static float3 reprojection_world_position(const KernelCamera &camera,
+                                          const float2 raster,
+                                          const float depth)
+{
+  const float3 P = transform_perspective(&camera.rastertocamera,
+                                         make_float3(raster.x, raster.y, 0.0f));
+  const float3 Pcamera = (camera.type == CAMERA_ORTHOGRAPHIC) ?
+                             make_float3(P.x, P.y, depth) :
+                             P * (depth / P.z);
+  return transform_point(&camera.cameratoworld, Pcamera);
+}
+
+/* Seeded value of the channels of a pass, with the previous samples scaled to the new count. */
+static void reprojection_seed_pass(const BufferPass &pass,
+                                   const float *src,
+                                   float *dst,
+                                   const uint num_samples,
+                                   const float scale,
+                                   const float depth)
+{
+  const PassInfo info = pass.get_info();
+
+  switch (pass.type) {
+    case PASS_SAMPLE_COUNT:
+      *(uint *)dst = num_samples;
+      return;
+    case PASS_DEPTH:
+      *dst = depth;
+      return;
+    case PASS_SHADOW_CATCHER_SAMPLE_COUNT:
+      dst[0] = src[0] * scale;
+      return;
+    case PASS_ADAPTIVE_AUX_BUFFER:
+      /* Not converged in the new view. */
+      dst[0] = src[0] * scale;
+      dst[1] = src[1] * scale;
+      dst[2] = src[2] * scale;
+      dst[3] = 0.0f;
+      return;
+    case PASS_CRYPTOMATTE:
+    case PASS_RENDER_TIME:
+      return;
+    default:
+      break;
+  }
+
+  /* Values of the first sample like the object ID and position are kept, accumulated values
+   * are scaled. */
+  const float pass_scale = info.use_filter ? scale : 1.0f;
+  for (int i = 0; i < info.num_components; i++) {
+    dst[i] = src[i] * pass_scale;
+  }
+}
+
+int TemporalReprojection::reproject(const BufferParams &buffer_params,
+                                    float *buffer,
+                                    const KernelCamera &camera,
+                                    const TemporalReprojectionParams &params) const
+{
+  if (history_.empty() || !camera_supported(camera)) {
+    return 0;
+  }
+
+  const int src_depth_offset = buffer_params_.get_pass_offset(PASS_DEPTH);
+  const int src_sample_count_offset = buffer_params_.get_pass_offset(PASS_SAMPLE_COUNT);
+  const int dst_sample_count_offset = buffer_params.get_pass_offset(PASS_SAMPLE_COUNT);
+  if (dst_sample_count_offset == PASS_UNUSED) {
+    return 0;
+  }
+
+  /* Splat the previous pixels into the new view, keeping the nearest surface. */
+  const int width = buffer_params.width;
+  const int height = buffer_params.height;
+  vector<int> src_index(size_t(width) * height, -1);
+  vector<float> dst_depth(size_t(width) * height, FLT_MAX);
+
+  for (int y = 0; y < buffer_params_.height; y++) {
+    for (int x = 0; x < buffer_params_.width; x++) {
+      const int index = y * buffer_params_.width + x;
+      const float *src = history_.data() + size_t(index) * buffer_params_.pass_stride;
+
+      /* Background and pixels without samples. */
+      const float depth = src[src_depth_offset];
+      if (!(depth > 0.0f) || *(const uint *)(src + src_sample_count_offset) == 0) {
+        continue;
+      }
+
+      const float2 raster = make_float2(buffer_params_.full_x + x + 0.5f,
+                                        buffer_params_.full_y + y + 0.5f);
+      const float3 P = reprojection_world_position(camera_, raster, depth);
+
+      const float new_depth = transform_point(&camera.worldtocamera, P).z;
+      if (!(new_depth > camera.nearclip)) {
+        continue;
+      }
+
+      const float3 new_raster = transform_perspective(&camera.worldtoraster, P);
+      const int dst_x = int(floorf(new_raster.x)) - buffer_params.full_x;
+      const int dst_y = int(floorf(new_raster.y)) - buffer_params.full_y;
+      if (dst_x < 0 || dst_y < 0 || dst_x >= width || dst_y >= height) {
+        continue;
+      }
+
+      const int dst_index = dst_y * width + dst_x;
+      if (new_depth < dst_depth[dst_index]) {
+        dst_depth[dst_index] = new_depth;
+        src_index[dst_index] = index;
+      }
+    }
+  }
+
+  /* Seed the pixels with a fraction of the previous samples. */
+  int num_seeded = 0;
+
+  for (int dst_index = 0; dst_index < width * height; dst_index++) {
+    if (src_index[dst_index] == -1) {
+      continue;
+    }
+
+    const float *src = history_.data() + size_t(src_index[dst_index]) * buffer_params_.pass_stride;
+    float *dst = buffer + size_t(dst_index) * buffer_params.pass_stride;
+
+    const uint src_num_samples = *(const uint *)(src + src_sample_count_offset);
+    const uint num_samples = uint(float(min(src_num_samples, uint(params.max_samples))) *
+                                  params.confidence);
+    if (num_samples == 0) {
+      continue;
+    }
+    const float scale = float(num_samples) / float(src_num_samples);
+
+    for (const BufferPass &pass : buffer_params.passes) {
+      if (pass.offset == PASS_UNUSED || pass.mode != PassMode::NOISY) {
+        continue;
+      }
+      for (const BufferPass &src_pass : buffer_params_.passes) {
+        if (src_pass.offset != PASS_UNUSED && src_pass.type == pass.type &&
+            src_pass.mode == pass.mode && src_pass.name == pass.name)
+        {
+          reprojection_seed_pass(pass,
+                                 src + src_pass.offset,
+                                 dst + pass.offset,
+                                 num_samples,
+                                 scale,
+                                 dst_depth[dst_index]);
+          break;
+        }
+      }
+    }
+
+    num_seeded++;
+  }
+
+  LOG_DEBUG << "Reprojected " << num_seeded << " of " << width * height
+            << " pixels from the previous camera.";
+
+  return num_seeded;
+}
+
+CCL_NAMESPACE_END
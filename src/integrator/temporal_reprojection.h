@@ -0,0 +1,78 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "kernel/types.h"
+
+#include "session/buffers.h"
+
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class TemporalReprojectionParams {
+ public:
+  /* Seed the accumulation after a reset with the samples rendered for the previous camera.
+   * Requires the depth pass, the sample count pass is enabled by the session. */
+  bool use = false;
+
+  /* Set for resets which changed more than the camera, the previous samples do not match the
+   * scene anymore then and are discarded. */
+  bool scene_modified = false;
+
+  /* Fraction of the previous samples of a pixel which are reused. */
+  float confidence = 0.5f;
+
+  /* Maximum number of previous samples reused per pixel, so the reprojection error fades out
+   * quickly as new samples are added. */
+  int max_samples = 64;
+};
+
+/* Temporal Reprojection
+ *
+ * Keeps the render buffer of the last camera, and warps it into the view of the next camera so
+ * the accumulation continues from the previous samples instead of from zero. The scene is assumed
+ * to be static: the pixels are moved to world space using their depth and the previous camera,
+ * and splatted into the new view, keeping the nearest surface. Pixels which were not visible
+ * before (disocclusions and the background) receive no samples.
+ *
+ * Only perspective and orthographic cameras are supported. */
+class TemporalReprojection {
+ public:
+  /* Keep the buffer rendered with the camera at the resolution divider. */
+  void store(const BufferParams &buffer_params,
+             const float *buffer,
+             const KernelCamera &camera,
+             const int resolution_divider);
+
+  void clear();
+
+  bool has_history() const
+  {
+    return !history_.empty();
+  }
+
+  int get_resolution_divider() const
+  {
+    return resolution_divider_;
+  }
+
+  /* Add the stored samples as seen from the camera to the zeroed buffer.
+   * Returns the number of pixels which received samples. */
+  int reproject(const BufferParams &buffer_params,
+                float *buffer,
+                const KernelCamera &camera,
+                const TemporalReprojectionParams &params) const;
+
+  static bool camera_supported(const KernelCamera &camera);
+
+ protected:
+  BufferParams buffer_params_;
+  vector<float> history_;
+  KernelCamera camera_;
+  int resolution_divider_ = 0;
+};
+
+CCL_NAMESPACE_END
@@ -5,6 +5,7 @@
 #include "integrator/work_tile_scheduler.h"
 
 #include "device/queue.h"
+#include "integrator/sample_density.h"
 #include "integrator/tile.h"
 #include "session/buffers.h"
 #include "util/log.h"
@@ -23,6 +24,11 @@ void WorkTileScheduler::set_max_num_path_states(const int max_num_path_states)
   max_num_path_states_ = max_num_path_states;
 }
 
+void WorkTileScheduler::set_sample_density(const SampleDensityMap *sample_density)
+{
+  sample_density_ = sample_density;
+}
+
 void WorkTileScheduler::reset(const BufferParams &buffer_params,
                               const int sample_start,
                               const int samples_num,
@@ -34,6 +40,7 @@ void WorkTileScheduler::reset(const BufferParams &buffer_params,
   image_full_offset_px_.y = buffer_params.full_y;
 
   image_size_px_ = make_int2(buffer_params.width, buffer_params.height);
+  image_full_size_px_ = make_int2(buffer_params.full_width, buffer_params.full_height);
   scrambling_distance_ = scrambling_distance;
 
   offset_ = buffer_params.offset;
@@ -53,6 +60,13 @@ void WorkTileScheduler::reset_scheduler_state()
   tile_size_ = tile_calculate_best_size(
       accelerated_rt_, image_size_px_, samples_num_, max_num_path_states_, scrambling_distance_);
 
+  /* Tiles within a cell of the density map, the greedy scheduling of multiple tiles still keeps
+   * the device busy. */
+  if (sample_density_ && !sample_density_->is_uniform()) {
+    tile_size_.width = min(tile_size_.width, SampleDensityMap::CELL_SIZE);
+    tile_size_.height = min(tile_size_.height, SampleDensityMap::CELL_SIZE);
+  }
+
   const int num_path_states_in_tile = tile_size_.width * tile_size_.height *
                                       tile_size_.num_samples;
 
@@ -92,33 +106,48 @@ bool WorkTileScheduler::get_work(KernelWorkTile *work_tile_, const int max_work_
 
   DCHECK_NE(max_num_path_states_, 0);
 
-  const int work_index = next_work_index_++;
-  if (work_index >= total_work_size_) {
-    return false;
-  }
-
-  const int sample_range_index = work_index % num_tiles_per_sample_range_;
-  const int start_sample = sample_range_index * tile_size_.num_samples;
-  const int tile_index = work_index / num_tiles_per_sample_range_;
-  const int tile_y = tile_index / num_tiles_x_;
-  const int tile_x = tile_index - tile_y * num_tiles_x_;
-
   KernelWorkTile work_tile;
-  work_tile.x = tile_x * tile_size_.width;
-  work_tile.y = tile_y * tile_size_.height;
-  work_tile.w = tile_size_.width;
-  work_tile.h = tile_size_.height;
-  work_tile.start_sample = sample_start_ + start_sample;
-  work_tile.num_samples = min(tile_size_.num_samples, samples_num_ - start_sample);
-  work_tile.sample_offset = sample_offset_;
-  work_tile.offset = offset_;
-  work_tile.stride = stride_;
-
-  work_tile.w = min(work_tile.w, image_size_px_.x - work_tile.x);
-  work_tile.h = min(work_tile.h, image_size_px_.y - work_tile.y);
-
-  work_tile.x += image_full_offset_px_.x;
-  work_tile.y += image_full_offset_px_.y;
+  int work_index;
+
+  /* Skip the work of tiles which render none of these samples at their density. */
+  do {
+    work_index = next_work_index_++;
+    if (work_index >= total_work_size_) {
+      return false;
+    }
+
+    const int sample_range_index = work_index % num_tiles_per_sample_range_;
+    const int start_sample = sample_range_index * tile_size_.num_samples;
+    const int tile_index = work_index / num_tiles_per_sample_range_;
+    const int tile_y = tile_index / num_tiles_x_;
+    const int tile_x = tile_index - tile_y * num_tiles_x_;
+
+    work_tile.x = tile_x * tile_size_.width;
+    work_tile.y = tile_y * tile_size_.height;
+    work_tile.w = tile_size_.width;
+    work_tile.h = tile_size_.height;
+    work_tile.start_sample = sample_start_ + start_sample;
+    work_tile.num_samples = min(tile_size_.num_samples, samples_num_ - start_sample);
+    work_tile.sample_offset = sample_offset_;
+    work_tile.offset = offset_;
+    work_tile.stride = stride_;
+
+    work_tile.w = min(work_tile.w, image_size_px_.x - work_tile.x);
+    work_tile.h = min(work_tile.h, image_size_px_.y - work_tile.y);
+
+    work_tile.x += image_full_offset_px_.x;
+    work_tile.y += image_full_offset_px_.y;
+
+    if (sample_density_ && !sample_density_->is_uniform()) {
+      const float density = sample_density_->get_density(image_full_size_px_,
+                                                         work_tile.x + work_tile.w / 2,
+                                                         work_tile.y + work_tile.h / 2);
+      const int2 range = sample_density_range(
+          density, work_tile.start_sample, work_tile.num_samples);
+      work_tile.start_sample = range.x;
+      work_tile.num_samples = range.y;
+    }
+  } while (work_tile.num_samples == 0);
 
   const int tile_work_size = work_tile.w * work_tile.h * work_tile.num_samples;
 
@@ -127,7 +156,7 @@ bool WorkTileScheduler::get_work(KernelWorkTile *work_tile_, const int max_work_
   if (max_work_size && tile_work_size > max_work_size) {
     /* The work did not fit into the requested limit of the work size. Unschedule the tile,
      * so it can be picked up again later. */
-    next_work_index_--;
+    next_work_index_ = work_index;
     return false;
   }
 
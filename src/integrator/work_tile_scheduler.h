@@ -11,6 +11,7 @@
 CCL_NAMESPACE_BEGIN
 
 class BufferParams;
+class SampleDensityMap;
 
 struct KernelWorkTile;
 
@@ -29,6 +30,10 @@ class WorkTileScheduler {
    * this number of states. */
   void set_max_num_path_states(const int max_num_path_states);
 
+  /* Fraction of the samples to render in the regions of the image. Tiles only get the samples of
+   * their density, and are kept small enough to follow the map. Null renders all samples. */
+  void set_sample_density(const SampleDensityMap *sample_density);
+
   /* Scheduling will happen for pixels within a big tile denotes by its parameters. */
   void reset(const BufferParams &buffer_params,
              const int sample_start,
@@ -57,12 +62,17 @@ class WorkTileScheduler {
    * point of view? */
   int max_num_path_states_ = 0;
 
+  const SampleDensityMap *sample_density_ = nullptr;
+
   /* Offset in pixels within a global buffer. */
   int2 image_full_offset_px_ = make_int2(0, 0);
 
   /* dimensions of the currently rendering image in pixels. */
   int2 image_size_px_ = make_int2(0, 0);
 
+  /* Dimensions of the full image in pixels, to look up the sample density. */
+  int2 image_full_size_px_ = make_int2(0, 0);
+
   /* Offset and stride of the buffer within which scheduling is happening.
    * Will be passed over to the KernelWorkTile. */
   int offset_, stride_;
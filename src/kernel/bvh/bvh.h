@@ -274,6 +274,57 @@ ccl_device_intersect bool scene_intersect_shadow(KernelGlobals kg,
   return scene_intersect(kg, ray, visibility, &isect);
 }
 
+/* Shadow ray stream BVH traversal, for coherent opaque shadow rays. */
+
+#  ifdef __BVH_STREAM__
+
+#    define BVH_FUNCTION_NAME bvh_intersect_shadow_stream
+#    define BVH_FUNCTION_FEATURES BVH_POINTCLOUD
+#    include "kernel/bvh/shadow_stream.h"
+
+#    if defined(__HAIR__)
+#      define BVH_FUNCTION_NAME bvh_intersect_shadow_stream_hair
+#      define BVH_FUNCTION_FEATURES BVH_HAIR | BVH_POINTCLOUD
+#      include "kernel/bvh/shadow_stream.h"
+#    endif
+
+#    if defined(__OBJECT_MOTION__)
+#      define BVH_FUNCTION_NAME bvh_intersect_shadow_stream_motion
+#      define BVH_FUNCTION_FEATURES BVH_MOTION | BVH_POINTCLOUD
+#      include "kernel/bvh/shadow_stream.h"
+#    endif
+
+#    if defined(__HAIR__) && defined(__OBJECT_MOTION__)
+#      define BVH_FUNCTION_NAME bvh_intersect_shadow_stream_hair_motion
+#      define BVH_FUNCTION_FEATURES BVH_HAIR | BVH_MOTION | BVH_POINTCLOUD
+#      include "kernel/bvh/shadow_stream.h"
+#    endif
+
+ccl_device_inline uint scene_intersect_shadow_stream_bvh2(KernelGlobals kg,
+                                                          const ccl_private RayStream *stream,
+                                                          const uint visibility)
+{
+#    ifdef __OBJECT_MOTION__
+  if (kernel_data.bvh.have_motion) {
+#      ifdef __HAIR__
+    if (kernel_data.bvh.have_curves) {
+      return bvh_intersect_shadow_stream_hair_motion(kg, stream, visibility);
+    }
+#      endif /* __HAIR__ */
+    return bvh_intersect_shadow_stream_motion(kg, stream, visibility);
+  }
+#    endif /* __OBJECT_MOTION__ */
+
+#    ifdef __HAIR__
+  if (kernel_data.bvh.have_curves) {
+    return bvh_intersect_shadow_stream_hair(kg, stream, visibility);
+  }
+#    endif /* __HAIR__ */
+  return bvh_intersect_shadow_stream(kg, stream, visibility);
+}
+
+#  endif /* __BVH_STREAM__ */
+
 /* Single object BVH traversal, for SSS/AO/bevel. */
 
 #  ifdef __BVH_LOCAL__
@@ -434,4 +485,30 @@ ccl_device_intersect uint scene_intersect_volume(KernelGlobals kg,
 
 #endif /* __BVH2__ */
 
+/* Intersect a stream of opaque shadow rays, returning a bit mask of the occluded rays.
+ *
+ * Rays are traversed together through the BVH2 on the CPU. Embree filter functions and the
+ * GPU backends trace one ray at a time, so there the rays are intersected one by one. */
+
+ccl_device_intersect uint scene_intersect_shadow_stream(KernelGlobals kg,
+                                                        const ccl_private RayStream *stream,
+                                                        const uint visibility)
+{
+#ifdef __BVH_STREAM__
+  if (!kernel_data.device_bvh) {
+    return scene_intersect_shadow_stream_bvh2(kg, stream, visibility);
+  }
+#endif
+
+  uint occluded = 0;
+  for (int i = 0; i < stream->num_rays; i++) {
+    Ray ray;
+    ray_stream_get(stream, i, &ray);
+    if (scene_intersect_shadow(kg, &ray, visibility)) {
+      occluded |= 1u << i;
+    }
+  }
+  return occluded;
+}
+
 CCL_NAMESPACE_END
@@ -51,6 +51,9 @@ ccl_device_inline
   float3 P = ray->P;
   float3 dir = bvh_clamp_direction(ray->D);
   float3 idir = bvh_inverse_direction(dir);
+#ifdef __BVH4__
+  const bool use_bvh4 = (kernel_data.bvh.bvh_layout == BVH_LAYOUT_BVH4);
+#endif
   float tmin = ray->tmin;
   int object = OBJECT_NONE;
   float isect_t = ray->tmax;
@@ -75,6 +78,21 @@ ccl_device_inline
     do {
       /* traverse internal nodes */
       while (node_addr >= 0 && node_addr != ENTRYPOINT_SENTINEL) {
+#ifdef __BVH4__
+        if (use_bvh4) {
+          node_addr = bvh4_node_traverse(kg,
+                                         P,
+                                         idir,
+                                         tmin,
+                                         isect_t,
+                                         node_addr,
+                                         PATH_RAY_ALL_VISIBILITY,
+                                         traversal_stack,
+                                         stack_ptr);
+          continue;
+        }
+#endif
+
         int node_addr_child1, traverse_mask;
         float dist[2];
         float4 cnodes = kernel_data_fetch(bvh_nodes, node_addr + 0);
@@ -2,6 +2,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0 */
 
+#include "kernel/bvh/types.h"
 #include "kernel/geom/object.h"
 #include "kernel/globals.h"
 
@@ -146,4 +147,210 @@ ccl_device_forceinline int bvh_node_intersect(KernelGlobals kg,
   return bvh_aligned_node_intersect(kg, P, idir, tmin, tmax, node_addr, visibility, dist);
 }
 
+#ifdef __BVH4__
+/* Wide BVH4 nodes, see BVH2::pack_wide_node() for the layouts with full precision and quantized
+ * child bounds. All four child boxes are tested at once, with the result returned as a bit mask
+ * of children that were hit. */
+
+ccl_device_forceinline int bvh4_movemask(const int4 mask)
+{
+#  ifdef __KERNEL_SSE__
+  return _mm_movemask_ps(_mm_castsi128_ps(mask.m128));
+#  else
+  return (mask.x ? 1 : 0) | (mask.y ? 2 : 0) | (mask.z ? 4 : 0) | (mask.w ? 8 : 0);
+#  endif
+}
+
+/* Slab test of the ray against the child boxes, given as distances to their planes. */
+ccl_device_forceinline int bvh4_node_intersect_planes(KernelGlobals kg,
+                                                      const float4 lo_x,
+                                                      const float4 hi_x,
+                                                      const float4 lo_y,
+                                                      const float4 hi_y,
+                                                      const float4 lo_z,
+                                                      const float4 hi_z,
+                                                      const float tmin,
+                                                      const float tmax,
+                                                      const int node_addr,
+                                                      const uint visibility,
+                                                      ccl_private float4 *dist)
+{
+  const float4 t_near = max(max(min(lo_x, hi_x), min(lo_y, hi_y)),
+                            max(min(lo_z, hi_z), make_float4(tmin)));
+  const float4 t_far = min(min(max(lo_x, hi_x), max(lo_y, hi_y)),
+                           min(max(lo_z, hi_z), make_float4(tmax)));
+  *dist = t_near;
+
+  /* Unused child slots have zero visibility, so the mask is applied even without
+   * __VISIBILITY_FLAG__. */
+  const int4 cnodes = __float4_as_int4(kernel_data_fetch(bvh_nodes, node_addr + 0));
+  const int4 invisible = (cnodes & make_int4(visibility)) == 0;
+  return bvh4_movemask(t_near <= t_far) & ~bvh4_movemask(invisible);
+}
+
+ccl_device_forceinline int bvh4_aligned_node_intersect(KernelGlobals kg,
+                                                       const float3 P,
+                                                       const float3 idir,
+                                                       const float tmin,
+                                                       const float tmax,
+                                                       const int node_addr,
+                                                       const uint visibility,
+                                                       ccl_private float4 *dist)
+{
+#  ifdef __KERNEL_AVX512__
+  /* Distances to the x and y planes of all children with one 16 wide operation, and to the z
+   * planes with an 8 wide one. */
+  const vfloat16 P_xy = make_vfloat16(make_vfloat8(P.x), make_vfloat8(P.y));
+  const vfloat16 idir_xy = make_vfloat16(make_vfloat8(idir.x), make_vfloat8(idir.y));
+  const vfloat16 t_xy = (load_vfloat16(&kernel_data_fetch(bvh_nodes, node_addr + 2).x) - P_xy) *
+                        idir_xy;
+  const vfloat8 t_z = (make_vfloat8(kernel_data_fetch(bvh_nodes, node_addr + 6),
+                                    kernel_data_fetch(bvh_nodes, node_addr + 7)) -
+                       make_vfloat8(P.z)) *
+                      make_vfloat8(idir.z);
+
+  return bvh4_node_intersect_planes(kg,
+                                    extract_float4<0>(t_xy),
+                                    extract_float4<1>(t_xy),
+                                    extract_float4<2>(t_xy),
+                                    extract_float4<3>(t_xy),
+                                    low(t_z),
+                                    high(t_z),
+                                    tmin,
+                                    tmax,
+                                    node_addr,
+                                    visibility,
+                                    dist);
+#  else
+  const float4 P_x = make_float4(P.x);
+  const float4 P_y = make_float4(P.y);
+  const float4 P_z = make_float4(P.z);
+  const float4 idir_x = make_float4(idir.x);
+  const float4 idir_y = make_float4(idir.y);
+  const float4 idir_z = make_float4(idir.z);
+
+  const float4 lo_x = (kernel_data_fetch(bvh_nodes, node_addr + 2) - P_x) * idir_x;
+  const float4 hi_x = (kernel_data_fetch(bvh_nodes, node_addr + 3) - P_x) * idir_x;
+  const float4 lo_y = (kernel_data_fetch(bvh_nodes, node_addr + 4) - P_y) * idir_y;
+  const float4 hi_y = (kernel_data_fetch(bvh_nodes, node_addr + 5) - P_y) * idir_y;
+  const float4 lo_z = (kernel_data_fetch(bvh_nodes, node_addr + 6) - P_z) * idir_z;
+  const float4 hi_z = (kernel_data_fetch(bvh_nodes, node_addr + 7) - P_z) * idir_z;
+
+  return bvh4_node_intersect_planes(
+      kg, lo_x, hi_x, lo_y, hi_y, lo_z, hi_z, tmin, tmax, node_addr, visibility, dist);
+#  endif
+}
+
+/* Decode four 8 bit child bounds packed into one word. */
+ccl_device_forceinline float4 bvh4_dequantize(const float packed,
+                                              const float origin,
+                                              const float scale)
+{
+  const uint q = __float_as_uint(packed);
+  const float4 qf = make_float4(
+      (float)(q & 0xff), (float)((q >> 8) & 0xff), (float)((q >> 16) & 0xff), (float)(q >> 24));
+  return make_float4(origin) + qf * make_float4(scale);
+}
+
+ccl_device_forceinline int bvh4_quantized_node_intersect(KernelGlobals kg,
+                                                         const float3 P,
+                                                         const float3 idir,
+                                                         const float tmin,
+                                                         const float tmax,
+                                                         const int node_addr,
+                                                         const uint visibility,
+                                                         ccl_private float4 *dist)
+{
+  /* Origin and scale of the quantization grid, then quantized child bounds. */
+  const float4 node2 = kernel_data_fetch(bvh_nodes, node_addr + 2);
+  const float4 node3 = kernel_data_fetch(bvh_nodes, node_addr + 3);
+  const float4 node4 = kernel_data_fetch(bvh_nodes, node_addr + 4);
+
+  const float4 P_x = make_float4(P.x);
+  const float4 P_y = make_float4(P.y);
+  const float4 P_z = make_float4(P.z);
+  const float4 idir_x = make_float4(idir.x);
+  const float4 idir_y = make_float4(idir.y);
+  const float4 idir_z = make_float4(idir.z);
+
+  const float4 lo_x = (bvh4_dequantize(node3.z, node2.x, node2.w) - P_x) * idir_x;
+  const float4 hi_x = (bvh4_dequantize(node3.w, node2.x, node2.w) - P_x) * idir_x;
+  const float4 lo_y = (bvh4_dequantize(node4.x, node2.y, node3.x) - P_y) * idir_y;
+  const float4 hi_y = (bvh4_dequantize(node4.y, node2.y, node3.x) - P_y) * idir_y;
+  const float4 lo_z = (bvh4_dequantize(node4.z, node2.z, node3.y) - P_z) * idir_z;
+  const float4 hi_z = (bvh4_dequantize(node4.w, node2.z, node3.y) - P_z) * idir_z;
+
+  return bvh4_node_intersect_planes(
+      kg, lo_x, hi_x, lo_y, hi_y, lo_z, hi_z, tmin, tmax, node_addr, visibility, dist);
+}
+
+ccl_device_forceinline int bvh4_node_intersect(KernelGlobals kg,
+                                               const float3 P,
+                                               const float3 idir,
+                                               const float tmin,
+                                               const float tmax,
+                                               const int node_addr,
+                                               const uint visibility,
+                                               ccl_private float4 *dist)
+{
+  if (kernel_data.bvh.use_quantized_nodes) {
+    return bvh4_quantized_node_intersect(kg, P, idir, tmin, tmax, node_addr, visibility, dist);
+  }
+  return bvh4_aligned_node_intersect(kg, P, idir, tmin, tmax, node_addr, visibility, dist);
+}
+
+/* Intersect a wide node, push all intersected children except the closest one on the traversal
+ * stack farthest first, and return the closest child to continue with. When no children are
+ * intersected the next node is popped from the stack. */
+ccl_device_forceinline int bvh4_node_traverse(KernelGlobals kg,
+                                              const float3 P,
+                                              const float3 idir,
+                                              const float tmin,
+                                              const float tmax,
+                                              const int node_addr,
+                                              const uint visibility,
+                                              ccl_private int *traversal_stack,
+                                              ccl_private int &stack_ptr)
+{
+  float4 dist;
+  const int traverse_mask = bvh4_node_intersect(
+      kg, P, idir, tmin, tmax, node_addr, visibility, &dist);
+
+  if (traverse_mask == 0) {
+    const int next_addr = traversal_stack[stack_ptr];
+    --stack_ptr;
+    return next_addr;
+  }
+
+  const float4 children = kernel_data_fetch(bvh_nodes, node_addr + 1);
+
+  /* Insertion sort of the intersected children by decreasing distance. */
+  int hit_addr[4];
+  float hit_dist[4];
+  int num_hits = 0;
+  for (int i = 0; i < 4; i++) {
+    if ((traverse_mask & (1 << i)) == 0) {
+      continue;
+    }
+    const int child_addr = __float_as_int(children[i]);
+    const float child_dist = dist[i];
+    int j = num_hits++;
+    for (; j > 0 && hit_dist[j - 1] < child_dist; j--) {
+      hit_addr[j] = hit_addr[j - 1];
+      hit_dist[j] = hit_dist[j - 1];
+    }
+    hit_addr[j] = child_addr;
+    hit_dist[j] = child_dist;
+  }
+
+  for (int i = 0; i < num_hits - 1; i++) {
+    ++stack_ptr;
+    kernel_assert(stack_ptr < BVH_STACK_SIZE);
+    traversal_stack[stack_ptr] = hit_addr[i];
+  }
+
+  return hit_addr[num_hits - 1];
+}
+#endif /* __BVH4__ */
+
 CCL_NAMESPACE_END
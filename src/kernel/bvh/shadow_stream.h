@@ -0,0 +1,363 @@
+/* SPDX-FileCopyrightText: 2009-2010 NVIDIA Corporation
+ * SPDX-FileCopyrightText: 2009-2012 Intel Corporation
+ * SPDX-FileCopyrightText: 2011-2022 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Adapted code from NVIDIA Corporation. */
+
+#if BVH_FEATURE(BVH_HAIR)
+#  define NODE_INTERSECT bvh_node_intersect
+#else
+#  define NODE_INTERSECT bvh_aligned_node_intersect
+#endif
+
+/* This is a template BVH traversal function for streams of shadow rays, where
+ * various features can be enabled/disabled. This way we can compile optimized
+ * versions for each case without new features slowing things down.
+ *
+ * All rays of the stream traverse the BVH together. Every stack entry holds the
+ * mask of rays that still have to visit the node, so nodes and primitives are
+ * fetched once for all rays. Rays are removed from the stream as soon as they
+ * are occluded.
+ *
+ * BVH_HAIR: hair curve rendering
+ * BVH_POINTCLOUD: point cloud rendering
+ * BVH_MOTION: motion blur rendering
+ */
+
+ccl_device_noinline uint BVH_FUNCTION_FULL_NAME(BVH)(KernelGlobals kg,
+                                                     const ccl_private RayStream *stream,
+                                                     const uint visibility)
+{
+  /* traversal stack, with the mask of rays visiting each node */
+  int traversal_stack[BVH_STACK_SIZE];
+  uint traversal_mask[BVH_STACK_SIZE];
+  traversal_stack[0] = ENTRYPOINT_SENTINEL;
+  traversal_mask[0] = 0;
+
+  /* traversal variables */
+  int stack_ptr = 0;
+  int node_addr = kernel_data.bvh.root;
+  int object = OBJECT_NONE;
+#ifdef __BVH4__
+  const bool use_bvh4 = (kernel_data.bvh.bvh_layout == BVH_LAYOUT_BVH4);
+#endif
+
+  /* ray parameters, in the space of the current instance */
+  float3 P[RAY_STREAM_SIZE];
+  float3 dir[RAY_STREAM_SIZE];
+  float3 idir[RAY_STREAM_SIZE];
+
+  uint active = 0;
+  for (int i = 0; i < stream->num_rays; i++) {
+    Ray ray;
+    ray_stream_get(stream, i, &ray);
+    if (!intersection_ray_valid(&ray)) {
+      continue;
+    }
+    bvh_instance_pop(&ray, &P[i], &dir[i], &idir[i]);
+    active |= 1u << i;
+  }
+
+  uint occluded = 0;
+  uint node_mask = active;
+
+  /* traversal loop */
+  do {
+    do {
+      /* traverse internal nodes */
+      while (node_addr >= 0 && node_addr != ENTRYPOINT_SENTINEL) {
+        /* Rays occluded since the node was pushed don't visit it anymore. */
+        node_mask &= ~occluded;
+        if (node_mask == 0) {
+          node_addr = traversal_stack[stack_ptr];
+          node_mask = traversal_mask[stack_ptr];
+          --stack_ptr;
+          continue;
+        }
+
+        uint child_mask[4] = {0, 0, 0, 0};
+        int child_addr[4];
+        int num_children;
+
+#ifdef __BVH4__
+        if (use_bvh4) {
+          for (uint lanes = node_mask; lanes != 0; lanes &= lanes - 1) {
+            const int i = count_trailing_zeros(lanes);
+            float4 dist;
+            const int traverse_mask = bvh4_node_intersect(kg,
+                                                          P[i],
+                                                          idir[i],
+                                                          stream->tmin[i],
+                                                          stream->tmax[i],
+                                                          node_addr,
+                                                          visibility,
+                                                          &dist);
+            for (int c = 0; c < 4; c++) {
+              child_mask[c] |= (traverse_mask & (1 << c)) ? (1u << i) : 0u;
+            }
+          }
+
+          const float4 children = kernel_data_fetch(bvh_nodes, node_addr + 1);
+          for (int c = 0; c < 4; c++) {
+            child_addr[c] = __float_as_int(children[c]);
+          }
+          num_children = 4;
+        }
+        else
+#endif
+        {
+          for (uint lanes = node_mask; lanes != 0; lanes &= lanes - 1) {
+            const int i = count_trailing_zeros(lanes);
+            float dist[2];
+            const int traverse_mask = NODE_INTERSECT(kg,
+                                                     P[i],
+#if BVH_FEATURE(BVH_HAIR)
+                                                     dir[i],
+#endif
+                                                     idir[i],
+                                                     stream->tmin[i],
+                                                     stream->tmax[i],
+                                                     node_addr,
+                                                     visibility,
+                                                     dist);
+            child_mask[0] |= (traverse_mask & 1) ? (1u << i) : 0u;
+            child_mask[1] |= (traverse_mask & 2) ? (1u << i) : 0u;
+          }
+
+          const float4 cnodes = kernel_data_fetch(bvh_nodes, node_addr + 0);
+          child_addr[0] = __float_as_int(cnodes.z);
+          child_addr[1] = __float_as_int(cnodes.w);
+          num_children = 2;
+        }
+
+        /* Continue with the first child visited by any ray, push the others. */
+        int next_addr = ENTRYPOINT_SENTINEL;
+        uint next_mask = 0;
+        for (int c = num_children - 1; c >= 0; c--) {
+          if (child_mask[c] == 0) {
+            continue;
+          }
+          if (next_mask != 0) {
+            ++stack_ptr;
+            kernel_assert(stack_ptr < BVH_STACK_SIZE);
+            traversal_stack[stack_ptr] = next_addr;
+            traversal_mask[stack_ptr] = next_mask;
+          }
+          next_addr = child_addr[c];
+          next_mask = child_mask[c];
+        }
+
+        if (next_mask == 0) {
+          /* No child was intersected by any ray. */
+          node_addr = traversal_stack[stack_ptr];
+          node_mask = traversal_mask[stack_ptr];
+          --stack_ptr;
+        }
+        else {
+          node_addr = next_addr;
+          node_mask = next_mask;
+        }
+      }
+
+      /* if node is leaf, fetch triangle list */
+      if (node_addr < 0) {
+        float4 leaf = kernel_data_fetch(bvh_leaf_nodes, (-node_addr - 1));
+        int prim_addr = __float_as_int(leaf.x);
+
+        if (prim_addr >= 0) {
+          const int prim_addr2 = __float_as_int(leaf.y);
+          const uint type = __float_as_int(leaf.w);
+          uint leaf_mask = node_mask & ~occluded;
+
+          /* pop */
+          node_addr = traversal_stack[stack_ptr];
+          node_mask = traversal_mask[stack_ptr];
+          --stack_ptr;
+
+          /* primitive intersection */
+          for (; prim_addr < prim_addr2 && leaf_mask != 0; prim_addr++) {
+            kernel_assert(kernel_data_fetch(prim_type, prim_addr) == type);
+
+            const int prim_object = (object == OBJECT_NONE) ?
+                                        kernel_data_fetch(prim_object, prim_addr) :
+                                        object;
+            const int prim = kernel_data_fetch(prim_index, prim_addr);
+
+            for (uint lanes = leaf_mask; lanes != 0; lanes &= lanes - 1) {
+              const int i = count_trailing_zeros(lanes);
+              if (intersection_skip_self_shadow(stream->self[i], prim_object, prim)) {
+                continue;
+              }
+
+#ifdef __SHADOW_LINKING__
+              if (intersection_skip_shadow_link(kg, stream->self[i], prim_object)) {
+                continue;
+              }
+#endif
+
+              Intersection isect;
+              bool hit = false;
+
+              switch (type & PRIMITIVE_ALL) {
+                case PRIMITIVE_TRIANGLE: {
+                  hit = triangle_intersect(kg,
+                                           &isect,
+                                           P[i],
+                                           dir[i],
+                                           stream->tmin[i],
+                                           stream->tmax[i],
+                                           visibility,
+                                           prim_object,
+                                           prim,
+                                           prim_addr);
+                  break;
+                }
+#if BVH_FEATURE(BVH_MOTION)
+                case PRIMITIVE_MOTION_TRIANGLE: {
+                  hit = motion_triangle_intersect(kg,
+                                                  &isect,
+                                                  P[i],
+                                                  dir[i],
+                                                  stream->tmin[i],
+                                                  stream->tmax[i],
+                                                  stream->time[i],
+                                                  visibility,
+                                                  prim_object,
+                                                  prim,
+                                                  prim_addr);
+                  break;
+                }
+#endif /* BVH_FEATURE(BVH_MOTION) */
+#if BVH_FEATURE(BVH_HAIR) && defined(__HAIR__)
+                case PRIMITIVE_CURVE_THICK:
+                case PRIMITIVE_MOTION_CURVE_THICK:
+                case PRIMITIVE_CURVE_RIBBON:
+                case PRIMITIVE_MOTION_CURVE_RIBBON:
+                case PRIMITIVE_CURVE_THICK_LINEAR:
+                case PRIMITIVE_MOTION_CURVE_THICK_LINEAR: {
+                  if ((type & PRIMITIVE_MOTION) && kernel_data.bvh.use_bvh_steps) {
+                    const float2 prim_time = kernel_data_fetch(prim_time, prim_addr);
+                    if (stream->time[i] < prim_time.x || stream->time[i] > prim_time.y) {
+                      break;
+                    }
+                  }
+
+                  const int curve_type = kernel_data_fetch(prim_type, prim_addr);
+                  hit = curve_intersect(kg,
+                                        &isect,
+                                        P[i],
+                                        dir[i],
+                                        stream->tmin[i],
+                                        stream->tmax[i],
+                                        prim_object,
+                                        prim,
+                                        stream->time[i],
+                                        curve_type);
+                  break;
+                }
+#endif /* BVH_FEATURE(BVH_HAIR) */
+#if BVH_FEATURE(BVH_POINTCLOUD) && defined(__POINTCLOUD__)
+                case PRIMITIVE_POINT:
+                case PRIMITIVE_MOTION_POINT: {
+                  if ((type & PRIMITIVE_MOTION) && kernel_data.bvh.use_bvh_steps) {
+                    const float2 prim_time = kernel_data_fetch(prim_time, prim_addr);
+                    if (stream->time[i] < prim_time.x || stream->time[i] > prim_time.y) {
+                      break;
+                    }
+                  }
+
+                  const int point_type = kernel_data_fetch(prim_type, prim_addr);
+                  hit = point_intersect(kg,
+                                        &isect,
+                                        P[i],
+                                        dir[i],
+                                        stream->tmin[i],
+                                        stream->tmax[i],
+                                        prim_object,
+                                        prim,
+                                        stream->time[i],
+                                        point_type);
+                  break;
+                }
+#endif /* BVH_FEATURE(BVH_POINTCLOUD) */
+              }
+
+              if (hit) {
+                /* shadow ray early termination */
+                occluded |= 1u << i;
+                leaf_mask &= ~(1u << i);
+              }
+            }
+          }
+
+          if (occluded == active) {
+            return occluded;
+          }
+        }
+        else {
+          /* instance push */
+          object = kernel_data_fetch(prim_object, -prim_addr - 1);
+
+#if BVH_FEATURE(BVH_MOTION)
+          for (uint lanes = node_mask & ~occluded; lanes != 0; lanes &= lanes - 1) {
+            const int i = count_trailing_zeros(lanes);
+            Ray ray;
+            ray_stream_get(stream, i, &ray);
+            bvh_instance_motion_push(kg, object, &ray, &P[i], &dir[i], &idir[i]);
+          }
+#else
+          /* Without motion all rays share the instance transform. */
+          const Transform tfm = object_fetch_transform(kg, object, OBJECT_INVERSE_TRANSFORM);
+          for (uint lanes = node_mask & ~occluded; lanes != 0; lanes &= lanes - 1) {
+            const int i = count_trailing_zeros(lanes);
+            P[i] = transform_point(
+                &tfm, make_float3(stream->P_x[i], stream->P_y[i], stream->P_z[i]));
+            dir[i] = bvh_clamp_direction(transform_direction(
+                &tfm, make_float3(stream->D_x[i], stream->D_y[i], stream->D_z[i])));
+            idir[i] = bvh_inverse_direction(dir[i]);
+          }
+#endif
+
+          ++stack_ptr;
+          kernel_assert(stack_ptr < BVH_STACK_SIZE);
+          traversal_stack[stack_ptr] = ENTRYPOINT_SENTINEL;
+          traversal_mask[stack_ptr] = 0;
+
+          node_addr = kernel_data_fetch(object_node, object);
+        }
+      }
+    } while (node_addr != ENTRYPOINT_SENTINEL);
+
+    if (stack_ptr >= 0) {
+      kernel_assert(object != OBJECT_NONE);
+
+      /* instance pop */
+      for (uint lanes = active & ~occluded; lanes != 0; lanes &= lanes - 1) {
+        const int i = count_trailing_zeros(lanes);
+        Ray ray;
+        ray_stream_get(stream, i, &ray);
+        bvh_instance_pop(&ray, &P[i], &dir[i], &idir[i]);
+      }
+
+      object = OBJECT_NONE;
+      node_addr = traversal_stack[stack_ptr];
+      node_mask = traversal_mask[stack_ptr];
+      --stack_ptr;
+    }
+  } while (node_addr != ENTRYPOINT_SENTINEL);
+
+  return occluded;
+}
+
+ccl_device_inline uint BVH_FUNCTION_NAME(KernelGlobals kg,
+                                         const ccl_private RayStream *stream,
+                                         const uint visibility)
+{
+  return BVH_FUNCTION_FULL_NAME(BVH)(kg, stream, visibility);
+}
+
+#undef BVH_FUNCTION_NAME
+#undef BVH_FUNCTION_FEATURES
+#undef NODE_INTERSECT
@@ -45,6 +45,9 @@ ccl_device_noinline bool BVH_FUNCTION_FULL_NAME(BVH)(KernelGlobals kg,
   float3 P = ray->P;
   float3 dir = bvh_clamp_direction(ray->D);
   float3 idir = bvh_inverse_direction(dir);
+#ifdef __BVH4__
+  const bool use_bvh4 = (kernel_data.bvh.bvh_layout == BVH_LAYOUT_BVH4);
+#endif
   const float tmin = ray->tmin;
   int object = OBJECT_NONE;
 
@@ -59,6 +62,14 @@ ccl_device_noinline bool BVH_FUNCTION_FULL_NAME(BVH)(KernelGlobals kg,
     do {
       /* traverse internal nodes */
       while (node_addr >= 0 && node_addr != ENTRYPOINT_SENTINEL) {
+#ifdef __BVH4__
+        if (use_bvh4) {
+          node_addr = bvh4_node_traverse(
+              kg, P, idir, tmin, isect->t, node_addr, visibility, traversal_stack, stack_ptr);
+          continue;
+        }
+#endif
+
         int node_addr_child1, traverse_mask;
         float dist[2];
         float4 cnodes = kernel_data_fetch(bvh_nodes, node_addr + 0);
@@ -17,7 +17,12 @@ CCL_NAMESPACE_BEGIN
 #define ENTRYPOINT_SENTINEL 0x76543210
 
 /* 64 object BVH + 64 mesh BVH + 64 object node splitting */
-#define BVH_STACK_SIZE 192
+#ifdef __BVH4__
+/* Wide nodes push up to three children per level. */
+#  define BVH_STACK_SIZE 384
+#else
+#  define BVH_STACK_SIZE 192
+#endif
 /* BVH intersection function variations */
 
 #define BVH_MOTION 1
@@ -8,6 +8,8 @@
 #include "kernel/integrator/state.h"
 #include "kernel/types.h"
 
+#include "kernel/util/differential.h"
+
 CCL_NAMESPACE_BEGIN
 
 ccl_device_inline bool intersection_ray_valid(const ccl_private Ray *ray)
@@ -59,6 +61,40 @@ ccl_device_forceinline float intersection_t_offset(const float t)
   return result;
 }
 
+/* Add a ray to the stream, returning its index. The stream must not be full. */
+ccl_device_inline int ray_stream_push(ccl_private RayStream *stream, const ccl_private Ray *ray)
+{
+  kernel_assert(stream->num_rays < RAY_STREAM_SIZE);
+  const int i = stream->num_rays++;
+  stream->P_x[i] = ray->P.x;
+  stream->P_y[i] = ray->P.y;
+  stream->P_z[i] = ray->P.z;
+  stream->D_x[i] = ray->D.x;
+  stream->D_y[i] = ray->D.y;
+  stream->D_z[i] = ray->D.z;
+  stream->tmin[i] = ray->tmin;
+  stream->tmax[i] = ray->tmax;
+  stream->time[i] = ray->time;
+  stream->self[i] = ray->self;
+  return i;
+}
+
+ccl_device_inline void ray_stream_get(const ccl_private RayStream *stream,
+                                      const int i,
+                                      ccl_private Ray *ray)
+{
+  ray->P = make_float3(stream->P_x[i], stream->P_y[i], stream->P_z[i]);
+  ray->D = make_float3(stream->D_x[i], stream->D_y[i], stream->D_z[i]);
+  ray->tmin = stream->tmin[i];
+  ray->tmax = stream->tmax[i];
+  ray->time = stream->time[i];
+#ifdef __RAY_DIFFERENTIALS__
+  ray->dP = differential_zero_compact();
+  ray->dD = differential_zero_compact();
+#endif
+  ray->self = stream->self[i];
+}
+
 /* Ray offset to avoid self intersection.
  *
  * This function can be used to compute a modified ray start position for rays
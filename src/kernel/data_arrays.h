@@ -24,6 +24,8 @@ KERNEL_DATA_ARRAY(Transform, object_motion_pass)
 KERNEL_DATA_ARRAY(DecomposedTransform, object_motion)
 KERNEL_DATA_ARRAY(uint, object_flag)
 KERNEL_DATA_ARRAY(uint, object_prim_offset)
+KERNEL_DATA_ARRAY(uint, object_constant_shaders)
+KERNEL_DATA_ARRAY(float4, object_constants)
 
 /* cameras */
 KERNEL_DATA_ARRAY(DecomposedTransform, camera_motion)
@@ -38,6 +38,16 @@ template<typename T> struct kernel_array {
   int width = 0;
 };
 
+struct IntegratorStateCPU;
+struct ThreadKernelGlobalsCPU;
+
+/* Surface shader evaluation generated for a single SVM program, see kernel/svm/specialized.h. */
+using SVMSpecializedFunction = void (*)(const ThreadKernelGlobalsCPU *kg,
+                                        const IntegratorStateCPU *state,
+                                        ShaderData *sd,
+                                        float *render_buffer,
+                                        const uint32_t path_flag);
+
 /* Constant globals shared between all threads. */
 struct KernelGlobalsCPU {
 #define KERNEL_DATA_ARRAY(type, name) kernel_array<type> name;
@@ -46,6 +56,10 @@ struct KernelGlobalsCPU {
   KernelData data = {};
 
   ProfilingState profiler;
+
+  /* Specialized SVM programs by shader index, null for interpreted shaders. */
+  const SVMSpecializedFunction *svm_specialized = nullptr;
+  int svm_specialized_size = 0;
 };
 
 /* Per-thread global state.
@@ -28,6 +28,8 @@
 KERNEL_INTEGRATOR_INIT_FUNCTION(init_from_camera);
 KERNEL_INTEGRATOR_INIT_FUNCTION(init_from_bake);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel);
+KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel_surface);
+KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel_volume);
 
 #undef KERNEL_INTEGRATOR_FUNCTION
 #undef KERNEL_INTEGRATOR_INIT_FUNCTION
@@ -51,6 +53,16 @@ KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel);
       const float *buffer, \
       uchar4 *pixel, \
       const int width, \
+      const int buffer_stride); \
+  void KERNEL_FUNCTION_FULL_NAME(film_convert_yuv420_##name)( \
+      const KernelFilmConvert *kfilm_convert, \
+      const float *buffer, \
+      const float *buffer_next_row, \
+      uchar *luma, \
+      uchar *luma_next_row, \
+      uchar *chroma_u, \
+      uchar *chroma_v, \
+      const int width, \
       const int buffer_stride);
 
 KERNEL_FILM_CONVERT_FUNCTION(depth)
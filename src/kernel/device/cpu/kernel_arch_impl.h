@@ -343,7 +343,29 @@ void KERNEL_FUNCTION_FULL_NAME(volume_guiding_filter_y)(const ThreadKernelGlobal
       (void)pixel; \
       (void)width; \
       (void)buffer_stride; \
-    }    
+    } \
+    void KERNEL_FUNCTION_FULL_NAME(film_convert_yuv420_##name)( \
+        const KernelFilmConvert *kfilm_convert, \
+        const float *buffer, \
+        const float *buffer_next_row, \
+        uchar *luma, \
+        uchar *luma_next_row, \
+        uchar *chroma_u, \
+        uchar *chroma_v, \
+        const int width, \
+        const int buffer_stride) \
+    { \
+      STUB_ASSERT(KERNEL_ARCH, film_convert_##name); \
+      (void)kfilm_convert; \
+      (void)buffer; \
+      (void)buffer_next_row; \
+      (void)luma; \
+      (void)luma_next_row; \
+      (void)chroma_u; \
+      (void)chroma_v; \
+      (void)width; \
+      (void)buffer_stride; \
+    }
 
 #else
 
@@ -393,10 +415,45 @@ void KERNEL_FUNCTION_FULL_NAME(volume_guiding_filter_y)(const ThreadKernelGlobal
           pixel_rgba[2] = pixel_rgba[0]; \
         } \
         film_apply_pass_pixel_overlays_rgba(kfilm_convert, buffer, pixel_rgba); \
-        *pixel = make_uchar4((uchar)(pixel_rgba[0] * 255.0f), \
-                             (uchar)(pixel_rgba[1] * 255.0f), \
-                             (uchar)(pixel_rgba[2] * 255.0f), \
-                             (uchar)(pixel_rgba[3] * 255.0f)); \
+        *pixel = film_display_pixel_srgb_byte(pixel_rgba); \
+      } \
+    } \
+    void KERNEL_FUNCTION_FULL_NAME(film_convert_yuv420_##name)( \
+        const KernelFilmConvert *kfilm_convert, \
+        const float *buffer, \
+        const float *buffer_next_row, \
+        uchar *luma, \
+        uchar *luma_next_row, \
+        uchar *chroma_u, \
+        uchar *chroma_v, \
+        const int width, \
+        const int buffer_stride) \
+    { \
+      /* Two rows at a time, with chroma averaged over each 2x2 block. Without a next row the \
+       * block is made of the last row only. */ \
+      const float *rows[2] = {buffer, buffer_next_row ? buffer_next_row : buffer}; \
+      uchar *luma_rows[2] = {luma, luma_next_row}; \
+      for (int x = 0; x < width; x += 2) { \
+        float4 srgb_sum = zero_float4(); \
+        for (int j = 0; j < 2; j++) { \
+          for (int i = 0; i < 2; i++) { \
+            const int pixel_x = min(x + i, width - 1); \
+            const float *pixel_buffer = rows[j] + int64_t(pixel_x) * buffer_stride; \
+            float pixel_rgba[4] = {0.0f, 0.0f, 0.0f, 1.0f}; \
+            film_get_pass_pixel_##name(kfilm_convert, pixel_buffer, pixel_rgba); \
+            if (is_float) { \
+              pixel_rgba[1] = pixel_rgba[0]; \
+              pixel_rgba[2] = pixel_rgba[0]; \
+            } \
+            film_apply_pass_pixel_overlays_rgba(kfilm_convert, pixel_buffer, pixel_rgba); \
+            const float4 srgb = film_display_pixel_srgb(pixel_rgba); \
+            if (luma_rows[j] && x + i < width) { \
+              luma_rows[j][x + i] = film_display_srgb_luma_byte(srgb); \
+            } \
+            srgb_sum += srgb; \
+          } \
+        } \
+        film_display_srgb_chroma_bytes(srgb_sum * 0.25f, chroma_u + x / 2, chroma_v + x / 2); \
       } \
     }
 
@@ -0,0 +1,54 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* Templated implementation of a megakernel specialized for a set of kernel features.
+ *
+ * The `.cpp` file defines __KERNEL_FEATURES__ to the feature set, KERNEL_ARCH and
+ * KERNEL_MEGAKERNEL_NAME to the name of the kernel, and includes this file. Only the megakernel
+ * is compiled, other kernels are the same for every feature set.
+ */
+
+#pragma once
+
+// clang-format off
+#include "kernel/device/cpu/compat.h"
+
+#ifndef KERNEL_STUB
+#    include "kernel/globals.h"
+
+#    include "kernel/device/cpu/image.h"
+
+#    include "kernel/integrator/state.h"
+#    include "kernel/integrator/state_flow.h"
+#    include "kernel/integrator/state_util.h"
+
+#    include "kernel/integrator/megakernel.h"
+#else
+#  define STUB_ASSERT(arch, name) \
+    assert(!(#name " kernel stub for architecture " #arch " was called!"))
+#endif   /* KERNEL_STUB */
+// clang-format on
+
+CCL_NAMESPACE_BEGIN
+
+void KERNEL_FUNCTION_FULL_NAME(KERNEL_MEGAKERNEL_NAME)(const ThreadKernelGlobalsCPU *kg,
+                                                       IntegratorStateCPU *state,
+                                                       ccl_global float *render_buffer)
+{
+#ifdef KERNEL_STUB
+  (void)kg;
+  (void)state;
+  (void)render_buffer;
+  STUB_ASSERT(KERNEL_ARCH, KERNEL_MEGAKERNEL_NAME);
+#else
+  integrator_megakernel(kg, state, render_buffer);
+#endif
+}
+
+#undef KERNEL_STUB
+#undef STUB_ASSERT
+#undef KERNEL_ARCH
+#undef KERNEL_MEGAKERNEL_NAME
+
+CCL_NAMESPACE_END
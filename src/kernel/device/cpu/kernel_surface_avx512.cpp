@@ -0,0 +1,33 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* Megakernel for scenes without volumes, with those and the other features in
+ * KERNEL_FEATURE_CPU_SPECIALIZED compiled out.
+ * This file is compiled with AVX-512 optimization flags. */
+
+#define __KERNEL_FEATURES__ KERNEL_FEATURES_CPU_SURFACE
+
+#include "util/optimization.h"
+
+#ifndef WITH_CYCLES_OPTIMIZED_KERNEL_AVX512
+#  define KERNEL_STUB
+#else
+/* SSE optimization disabled for now on 32 bit, see bug #36316. */
+#  if !(defined(__GNUC__) && (defined(i386) || defined(_M_IX86)))
+#    define __KERNEL_SSE__
+#    define __KERNEL_SSE2__
+#    define __KERNEL_SSE3__
+#    define __KERNEL_SSSE3__
+#    define __KERNEL_SSE42__
+#    define __KERNEL_AVX__
+#    define __KERNEL_AVX2__
+#    define __KERNEL_AVX512__
+#  endif
+#endif /* WITH_CYCLES_OPTIMIZED_KERNEL_AVX512 */
+
+#include "kernel/device/cpu/globals.h"
+#include "kernel/device/cpu/kernel.h"
+#define KERNEL_ARCH cpu_avx512
+#define KERNEL_MEGAKERNEL_NAME integrator_megakernel_surface
+#include "kernel/device/cpu/kernel_arch_megakernel_impl.h"
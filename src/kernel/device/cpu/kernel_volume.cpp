@@ -0,0 +1,42 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* Megakernel for scenes with volumes, with the other features in
+ * KERNEL_FEATURE_CPU_SPECIALIZED compiled out. */
+
+#define __KERNEL_FEATURES__ KERNEL_FEATURES_CPU_VOLUME
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define __KERNEL_SSE__
+#  define __KERNEL_SSE2__
+#  define __KERNEL_SSE3__
+#  define __KERNEL_SSSE3__
+#  define __KERNEL_SSE42__
+#endif
+
+#ifdef WITH_KERNEL_NATIVE
+#  ifdef __SSE4_2__
+#    ifndef __KERNEL_SSE42__
+#      define __KERNEL_SSE42__
+#    endif
+#  endif
+#  ifdef __AVX__
+#    ifndef __KERNEL_SSE__
+#      define __KERNEL_SSE__
+#    endif
+#    define __KERNEL_AVX__
+#  endif
+#  ifdef __AVX2__
+#    ifndef __KERNEL_SSE__
+#      define __KERNEL_SSE__
+#    endif
+#    define __KERNEL_AVX2__
+#  endif
+#endif
+
+#include "kernel/device/cpu/globals.h"
+#include "kernel/device/cpu/kernel.h"
+#define KERNEL_ARCH cpu
+#define KERNEL_MEGAKERNEL_NAME integrator_megakernel_volume
+#include "kernel/device/cpu/kernel_arch_megakernel_impl.h"
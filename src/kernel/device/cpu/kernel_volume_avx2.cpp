@@ -0,0 +1,32 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* Megakernel for scenes with volumes, with the other features in
+ * KERNEL_FEATURE_CPU_SPECIALIZED compiled out.
+ * This file is compiled with AVX2 optimization flags. */
+
+#define __KERNEL_FEATURES__ KERNEL_FEATURES_CPU_VOLUME
+
+#include "util/optimization.h"
+
+#ifndef WITH_CYCLES_OPTIMIZED_KERNEL_AVX2
+#  define KERNEL_STUB
+#else
+/* SSE optimization disabled for now on 32 bit, see bug #36316. */
+#  if !(defined(__GNUC__) && (defined(i386) || defined(_M_IX86)))
+#    define __KERNEL_SSE__
+#    define __KERNEL_SSE2__
+#    define __KERNEL_SSE3__
+#    define __KERNEL_SSSE3__
+#    define __KERNEL_SSE42__
+#    define __KERNEL_AVX__
+#    define __KERNEL_AVX2__
+#  endif
+#endif /* WITH_CYCLES_OPTIMIZED_KERNEL_AVX2 */
+
+#include "kernel/device/cpu/globals.h"
+#include "kernel/device/cpu/kernel.h"
+#define KERNEL_ARCH cpu_avx2
+#define KERNEL_MEGAKERNEL_NAME integrator_megakernel_volume
+#include "kernel/device/cpu/kernel_arch_megakernel_impl.h"
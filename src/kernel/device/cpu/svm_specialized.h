@@ -0,0 +1,43 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* Common part of the generated sources of specialized SVM programs, see kernel/svm/specialized.h.
+ *
+ * These are compiled at runtime for the machine they run on, so detect kernel features from the
+ * flags set by the compiler like the native kernel does. Optional libraries such as OSL, Embree
+ * and path guiding are left out, they do not change the layout of data used by SVM nodes. */
+
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define __KERNEL_SSE__
+#  define __KERNEL_SSE2__
+#  define __KERNEL_SSE3__
+#  define __KERNEL_SSSE3__
+#  define __KERNEL_SSE42__
+#endif
+
+#ifdef __AVX__
+#  define __KERNEL_AVX__
+#endif
+#ifdef __AVX2__
+#  define __KERNEL_AVX2__
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+#  define __KERNEL_AVX512__
+#endif
+
+// clang-format off
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+
+#include "kernel/globals.h"
+
+#include "kernel/device/cpu/image.h"
+
+#include "kernel/integrator/state.h"
+#include "kernel/integrator/state_util.h"
+
+#include "kernel/integrator/surface_shader.h"
+// clang-format on
@@ -113,6 +113,19 @@ CCL_NAMESPACE_BEGIN
 #define IF_NOT_KERNEL_NODES_FEATURE(feature) \
   if constexpr ((node_feature_mask & (KERNEL_FEATURE_NODE_##feature)) == 0U)
 
+/* Features that are compiled out of the specialized CPU megakernels when not in their feature
+ * set. The other features are always compiled in. Object motion is left out, as it changes the
+ * layout of ShaderData. */
+#define KERNEL_FEATURE_CPU_SPECIALIZED \
+  (KERNEL_FEATURE_HAIR | KERNEL_FEATURE_POINTCLOUD | KERNEL_FEATURE_VOLUME | \
+   KERNEL_FEATURE_SUBSURFACE | KERNEL_FEATURE_SHADOW_CATCHER | KERNEL_FEATURE_MNEE | \
+   KERNEL_FEATURE_PATH_GUIDING | KERNEL_FEATURE_NODE_PRINCIPLED_HAIR | \
+   KERNEL_FEATURE_LIGHT_LINKING | KERNEL_FEATURE_SHADOW_LINKING)
+
+/* Feature sets of the specialized CPU megakernels. */
+#define KERNEL_FEATURES_CPU_SURFACE (~KERNEL_FEATURE_CPU_SPECIALIZED)
+#define KERNEL_FEATURES_CPU_VOLUME (KERNEL_FEATURES_CPU_SURFACE | KERNEL_FEATURE_VOLUME)
+
 /* Kernel Feature Guards
  *
  * These are used throughout the code to disable code for certain features entirely.
@@ -160,6 +173,10 @@ CCL_NAMESPACE_BEGIN
 #    define __PATH_GUIDING__
 #  endif
 #  define __VOLUME_RECORD_ALL__
+/* Wide BVH4 nodes, traversed with SIMD box tests. */
+#  define __BVH4__
+/* Traversal of ray streams, with all rays in the stream visiting nodes together. */
+#  define __BVH_STREAM__
 #endif /* !__KERNEL_GPU__ */
 
 /* MNEE caused "Compute function exceeds available temporary registers" in macOS < 13 due to a bug
@@ -596,4 +596,47 @@ ccl_device_inline void film_apply_pass_pixel_overlays_rgba(
   }
 }
 
+/* --------------------------------------------------------------------
+ * Display formats.
+ */
+
+/* Linear display pixel to sRGB encoded color with straight alpha, all in 0..1. */
+ccl_device_inline float4 film_display_pixel_srgb(const ccl_private float *ccl_restrict pixel)
+{
+  return color_linear_to_srgb_display_v4(
+      saturate(make_float4(pixel[0], pixel[1], pixel[2], pixel[3])));
+}
+
+ccl_device_inline uchar4 film_display_pixel_srgb_byte(const ccl_private float *ccl_restrict pixel)
+{
+  const float4 srgb = film_display_pixel_srgb(pixel) * make_float4(255.0f);
+#ifdef __KERNEL_SSE2__
+  /* Round and pack all channels at once, values are already in range. */
+  const __m128i i32 = _mm_cvtps_epi32(srgb.m128);
+  const __m128i i16 = _mm_packs_epi32(i32, i32);
+  const int i8 = _mm_cvtsi128_si32(_mm_packus_epi16(i16, i16));
+  return make_uchar4(uchar(i8), uchar(i8 >> 8), uchar(i8 >> 16), uchar(i8 >> 24));
+#else
+  return make_uchar4(uchar(srgb.x + 0.5f),
+                     uchar(srgb.y + 0.5f),
+                     uchar(srgb.z + 0.5f),
+                     uchar(srgb.w + 0.5f));
+#endif
+}
+
+/* BT.709 limited range luma and chroma from sRGB encoded color, as expected by video
+ * encoders. */
+ccl_device_inline uchar film_display_srgb_luma_byte(const float4 srgb)
+{
+  return uchar(16.5f + 219.0f * (0.2126f * srgb.x + 0.7152f * srgb.y + 0.0722f * srgb.z));
+}
+
+ccl_device_inline void film_display_srgb_chroma_bytes(const float4 srgb,
+                                                      ccl_private uchar *u,
+                                                      ccl_private uchar *v)
+{
+  *u = uchar(128.5f + 224.0f * (-0.1146f * srgb.x - 0.3854f * srgb.y + 0.5f * srgb.z));
+  *v = uchar(128.5f + 224.0f * (0.5f * srgb.x - 0.4542f * srgb.y - 0.0458f * srgb.z));
+}
+
 CCL_NAMESPACE_END
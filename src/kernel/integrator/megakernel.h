@@ -15,6 +15,7 @@
 #include "kernel/integrator/shade_shadow.h"
 #include "kernel/integrator/shade_surface.h"
 #include "kernel/integrator/shade_volume.h"
+#include "kernel/integrator/volume_fast.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -68,6 +69,13 @@ ccl_device void integrator_megakernel(KernelGlobals kg,
     if (queued_kernel) {
       switch (queued_kernel) {
         case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
+#if !defined(__KERNEL_GPU__) && defined(__VOLUME__)
+          /* Volume-only integration, GPUs always use the full path tracer. */
+          if (kernel_data.integrator.volume_fast) {
+            integrator_volume_fast(kg, state, render_buffer);
+            break;
+          }
+#endif
           integrator_intersect_closest(kg, state, render_buffer);
           break;
         case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
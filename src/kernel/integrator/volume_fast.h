@@ -0,0 +1,254 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "kernel/integrator/shade_volume.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Fast Volume Integrator
+ *
+ * Volume-only integrator for interactive visualization of volume data. Camera rays are traced
+ * through the volume bounding meshes, and every segment inside a volume is integrated with
+ * emission and absorption plus single scattering of direct light, using delta tracking with the
+ * majorants of the volume octree. No surface shaders are evaluated and there is no indirect
+ * light, surfaces only act as volume boundaries and still occlude the direct light.
+ *
+ * It replaces the intersect_closest kernel in the CPU megakernel, one segment between two
+ * boundaries per call, so shadow rays queued for the direct light are traced before the next
+ * segment. */
+
+#ifdef __VOLUME__
+
+/* Scatter position for the direct light, picked from the collisions along the segment with
+ * weighted reservoir sampling. */
+struct VolumeFastScatter {
+  float total_weight;
+  float weight;
+  float rand;
+  float t;
+  Spectrum throughput;
+  uint lcg_state;
+};
+
+ccl_device_inline void volume_fast_scatter_add(ccl_private VolumeFastScatter &scatter,
+                                               const float t,
+                                               const Spectrum throughput,
+                                               const uint lcg_state)
+{
+  const float weight = reduce_add(fabs(throughput));
+  if (!(weight > 0.0f)) {
+    return;
+  }
+
+  scatter.total_weight += weight;
+  const float thresh = weight / scatter.total_weight;
+  if (scatter.rand <= thresh) {
+    scatter.rand = saturatef(scatter.rand / thresh);
+    scatter.weight = weight;
+    scatter.t = t;
+    scatter.throughput = throughput;
+    scatter.lcg_state = lcg_state;
+  }
+  else {
+    scatter.rand = saturatef((scatter.rand - thresh) / (1.0f - thresh));
+  }
+}
+
+/* Integrate the segment `[ray->tmin, ray->tmax]` of the volumes in the volume stack. Emission is
+ * written to the film, the path throughput is attenuated by the transmittance of the segment and
+ * a shadow ray is queued for the direct light scattered at one of the collisions. */
+ccl_device void volume_fast_integrate(KernelGlobals kg,
+                                      IntegratorState state,
+                                      const ccl_private Ray *ccl_restrict ray,
+                                      ccl_global float *ccl_restrict render_buffer)
+{
+  PROFILING_INIT(kg, PROFILING_SHADE_VOLUME_INTEGRATE);
+
+  ShaderData sd;
+  shader_setup_from_volume(&sd, ray, INTEGRATOR_STATE_ARRAY(state, volume_stack, 0, object));
+
+  RNGState rng_state;
+  path_state_rng_load(state, &rng_state);
+
+  /* For stochastic texture sampling. */
+  sd.lcg_state = lcg_state_init(
+      rng_state.rng_pixel, rng_state.rng_offset, rng_state.sample, 0x6a4c72b3);
+
+  /* Pick the light for the whole segment, before `sd.P` moves along the ray. */
+  LightSample ls ccl_optional_struct_init;
+  ls.emitter_id = EMITTER_NONE;
+  EquiangularCoefficients equiangular_coeffs = {zero_float3(), {ray->tmin, ray->tmax}};
+  integrate_volume_sample_direct_light(kg, state, ray, &sd, &rng_state, &equiangular_coeffs, &ls);
+
+  VolumeFastScatter scatter = {};
+  scatter.rand = path_state_rng_1D(kg, &rng_state, PRNG_VOLUME_RESERVOIR);
+
+  const uint32_t path_flag = INTEGRATOR_STATE(state, path, flag);
+  Spectrum throughput = INTEGRATOR_STATE(state, path, throughput);
+  Spectrum emission = zero_spectrum();
+
+  OctreeTracing octree(ray->tmin);
+  if (volume_octree_setup<false>(kg, ray, &sd, state, &rng_state, path_flag, octree)) {
+    float t = octree.t.min;
+    for (int step = 0; step < VOLUME_MAX_STEPS;) {
+      /* Sample the next collision with the majorant of the current octree node. */
+      const float sigma_max = octree.sigma.max;
+      const float2 rand = path_state_rng_2D(kg, &rng_state, PRNG_VOLUME_SCATTER_DISTANCE);
+      rng_state.rng_offset += PRNG_BOUNCE_NUM;
+
+      t = (sigma_max == 0.0f) ? FLT_MAX : t + sample_exponential_distribution(rand.x, sigma_max);
+      if (!(t < octree.t.max)) {
+        if (!volume_octree_advance<false>(kg, ray, &sd, state, &rng_state, path_flag, octree)) {
+          break;
+        }
+        t = octree.t.min;
+        continue;
+      }
+      step++;
+
+      sd.P = ray->P + ray->D * t;
+      const uint lcg_state = sd.lcg_state;
+      VolumeShaderCoefficients coeff ccl_optional_struct_init;
+      if (!volume_shader_sample(kg, state, &sd, &coeff)) {
+        continue;
+      }
+
+      /* Collision estimator for emission and in-scattering, and ratio tracking of the
+       * transmittance for the null collisions. */
+      float majorant;
+      const Spectrum sigma_n = volume_null_event_coefficients(coeff.sigma_t, sigma_max, majorant);
+      throughput /= majorant;
+
+      if (sd.flag & SD_EMISSION) {
+        emission += throughput * coeff.emission;
+      }
+      if (sd.flag & SD_SCATTER) {
+        volume_fast_scatter_add(scatter, t, throughput * coeff.sigma_s, lcg_state);
+      }
+
+      throughput *= sigma_n;
+
+      /* Russian roulette on the transmittance. */
+      const float thresh = reduce_max(fabs(throughput));
+      if (thresh < 0.05f) {
+        if (rand.y > thresh) {
+          throughput = zero_spectrum();
+          break;
+        }
+        throughput /= thresh;
+      }
+    }
+  }
+
+  INTEGRATOR_STATE_WRITE(state, path, throughput) = throughput;
+
+  if (!is_zero(emission)) {
+    if (light_link_object_match(kg, light_link_receiver_forward(kg, state), sd.object)) {
+      film_write_volume_emission(
+          kg, state, emission, render_buffer, object_lightgroup(kg, sd.object));
+    }
+  }
+
+  if (scatter.total_weight == 0.0f) {
+    return;
+  }
+
+  /* Evaluate the phase function at the picked scatter position again, and queue the shadow ray
+   * with the throughput divided by the probability of picking it. */
+  sd.P = ray->P + ray->D * scatter.t;
+  sd.lcg_state = scatter.lcg_state;
+  VolumeShaderCoefficients coeff ccl_optional_struct_init;
+  if (!volume_shader_sample(kg, state, &sd, &coeff) || !(sd.flag & SD_SCATTER)) {
+    return;
+  }
+
+  ShaderVolumePhases phases;
+  volume_shader_copy_phases(&phases, &sd);
+
+  const Spectrum direct_throughput = scatter.throughput * (scatter.total_weight / scatter.weight);
+  integrate_volume_direct_light(kg,
+                                state,
+                                &sd,
+                                &rng_state,
+                                sd.P,
+                                &phases,
+#  if defined(__PATH_GUIDING__)
+                                direct_throughput,
+#  endif
+                                direct_throughput,
+                                ls);
+}
+
+#endif /* __VOLUME__ */
+
+ccl_device void integrator_volume_fast(KernelGlobals kg,
+                                       IntegratorState state,
+                                       ccl_global float *ccl_restrict render_buffer)
+{
+#ifdef __VOLUME__
+  PROFILING_INIT(kg, PROFILING_INTERSECT_CLOSEST);
+
+  Ray ray ccl_optional_struct_init;
+  integrator_state_read_ray(state, &ray);
+  kernel_assert(ray.tmax != 0.0f);
+
+  /* Find the next volume boundary. */
+  Intersection isect ccl_optional_struct_init;
+  isect.object = OBJECT_NONE;
+  isect.prim = PRIM_NONE;
+  ray.self.object = INTEGRATOR_STATE(state, isect, object);
+  ray.self.prim = INTEGRATOR_STATE(state, isect, prim);
+  ray.self.light_object = OBJECT_NONE;
+  ray.self.light_prim = PRIM_NONE;
+  const bool hit = scene_intersect(kg, &ray, path_state_ray_visibility(state), &isect);
+
+  if (hit) {
+    ray.tmax = isect.t;
+  }
+  else {
+    isect.prim = PRIM_NONE;
+    ray.tmax = FLT_MAX;
+    volume_stack_clean(kg, state);
+  }
+
+  if (!integrator_state_volume_stack_is_empty(kg, state)) {
+    volume_fast_integrate(kg, state, &ray, render_buffer);
+  }
+
+  if (!hit) {
+    integrator_state_write_isect(state, &isect);
+    if (integrator_intersect_skip_lights(kg, state)) {
+      integrator_path_terminate(
+          kg, state, render_buffer, DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST);
+    }
+    else {
+      integrator_path_next(state,
+                           DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST,
+                           DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND);
+    }
+    return;
+  }
+
+  if (is_zero(INTEGRATOR_STATE(state, path, throughput)) || !path_state_volume_next(state)) {
+    integrator_path_terminate(
+        kg, state, render_buffer, DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST);
+    return;
+  }
+
+  /* Pass through the surface without shading it, only updating the volume stack. The kernel
+   * stays queued for the next segment. */
+  ShaderData sd;
+  shader_setup_from_ray(kg, &sd, &ray, &isect);
+  volume_stack_enter_exit<false>(kg, state, &sd);
+
+  integrator_state_write_isect(state, &isect);
+  INTEGRATOR_STATE_WRITE(state, ray, tmin) = intersection_t_offset(isect.t);
+#else
+  integrator_intersect_closest(kg, state, render_buffer);
+#endif /* __VOLUME__ */
+}
+
+CCL_NAMESPACE_END
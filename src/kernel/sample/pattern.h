@@ -59,6 +59,12 @@ ccl_device_forceinline uint3 blue_noise_indexing(KernelGlobals kg,
     pixel_index *= kernel_data.integrator.blue_noise_sequence_length;
     return make_uint3((sample - 1) + pixel_index, 0, 0xffffffff);
   }
+  if (kernel_data.integrator.sampling_pattern == SAMPLING_PATTERN_BLUE_NOISE_TILED) {
+    /* One sequence per pixel like Sobol-Burley, with the blue-noise distribution coming from the
+     * choice of the pixel seeds. The seeds were optimized for the sequence without the length
+     * mask optimization, so it's not used here. */
+    return make_uint3(sample, pixel_index, 0xffffffff);
+  }
   kernel_assert(false);
   return make_uint3(0, 0, 0);
 }
@@ -143,6 +149,13 @@ ccl_device_inline uint path_rng_pixel_init(KernelGlobals kg,
     return hash_iqnt2d(x, y) ^ kernel_data.integrator.seed;
   }
 
+  if (pattern == SAMPLING_PATTERN_BLUE_NOISE_TILED) {
+    /* Seeds from a precomputed tile, so that the sequences of neighboring pixels give errors which
+     * cancel out at every sample count. Works without knowing the number of samples to render in
+     * advance, like in interactive rendering. */
+    return sobol_burley_blue_noise_seed(x, y, kernel_data.integrator.seed);
+  }
+
   /* The blue-noise samplers use a single sequence for all pixels, but offset the index within
    * the sequence for each pixel. We use a hierarchically shuffled 2D morton curve to determine
    * each pixel's offset along the sequence.
@@ -200,4 +200,19 @@ ccl_device float4 sobol_burley_sample_4D(uint index,
                      sobol_burley(index, 3, seed ^ 0x1524cc56));
 }
 
+/*
+ * Seed of the pixel (x, y) for the tiled blue-noise sampling pattern.
+ *
+ * The seeds are looked up in a tile which repeats over the image. The tile was optimized so that
+ * the sequences of neighboring pixels give anti-correlated errors, which distributes the error
+ * as blue noise in screen space while every pixel keeps a full Sobol-Burley sequence. The seed
+ * of the render offsets the tile, giving a different pattern for every seed.
+ */
+ccl_device_inline uint sobol_burley_blue_noise_seed(const int x, const int y, const uint seed)
+{
+  const uint tile_x = (uint(x) + seed) % BLUE_NOISE_TILE_SIZE;
+  const uint tile_y = (uint(y) + (seed >> 16)) % BLUE_NOISE_TILE_SIZE;
+  return hash_uint(blue_noise_tile[tile_y * BLUE_NOISE_TILE_SIZE + tile_x]);
+}
+
 CCL_NAMESPACE_END
@@ -57,6 +57,12 @@ ccl_device float svm_ao(
   RNGState rng_state;
   path_state_rng_load(state, &rng_state);
 
+#  ifdef __BVH_STREAM__
+  /* Rays from the same point are traced together as a stream. */
+  RayStream stream;
+  stream.num_rays = 0;
+#  endif
+
   int unoccluded = 0;
   for (int sample = 0; sample < num_samples; sample++) {
     const float2 rand_disk = path_branched_rng_2D(
@@ -85,9 +91,18 @@ ccl_device float svm_ao(
       }
     }
     else {
+#  ifdef __BVH_STREAM__
+      ray_stream_push(&stream, &ray);
+      if (stream.num_rays == RAY_STREAM_SIZE || sample == num_samples - 1) {
+        const uint occluded = scene_intersect_shadow_stream(kg, &stream, PATH_RAY_SHADOW_OPAQUE);
+        unoccluded += stream.num_rays - int(popcount(occluded));
+        stream.num_rays = 0;
+      }
+#  else
       if (!scene_intersect_shadow(kg, &ray, PATH_RAY_SHADOW_OPAQUE)) {
         unoccluded++;
       }
+#  endif
     }
   }
 
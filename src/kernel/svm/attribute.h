@@ -209,6 +209,7 @@ ccl_device_noinline void svm_node_attr_volume(KernelGlobals kg,
                                               ccl_private float *stack,
                                               const uint4 node)
 {
+#ifdef __VOLUME__
   kernel_assert(primitive_is_volume_attribute(sd));
 
   NodeAttributeOutputType type = NODE_ATTR_OUTPUT_FLOAT;
@@ -227,6 +228,13 @@ ccl_device_noinline void svm_node_attr_volume(KernelGlobals kg,
   else {
     stack_store_float(stack, out_offset, volume_attribute_alpha(value));
   }
+#else
+  /* Only used by volume shaders, compiled out along with volumes. */
+  (void)kg;
+  (void)sd;
+  (void)stack;
+  (void)node;
+#endif
 }
 
 CCL_NAMESPACE_END
@@ -130,6 +130,51 @@ ccl_device_noinline void svm_node_object_info(KernelGlobals kg,
   stack_store_float(stack, out_offset, data);
 }
 
+/* Object Constant
+ *
+ * Output of a subgraph that only depends on object info, evaluated once per object on the host
+ * and stored in a table, see scene/object_constants.h. */
+
+ccl_device_noinline int svm_node_object_constant(KernelGlobals kg,
+                                                 ccl_private ShaderData *sd,
+                                                 ccl_private float *stack,
+                                                 const uint4 node,
+                                                 int offset)
+{
+  const uint slot = node.y;
+  const uint out_offset = node.z;
+  const bool is_float = node.w;
+
+  /* Value without an object, for the background. */
+  float4 value = read_node_float(kg, &offset);
+
+  if (sd->object != OBJECT_NONE) {
+    /* Number of shaders of the object, followed by the ID and values offset of each. */
+    const int shaders_offset = kernel_data_fetch(objects, sd->object).shader_constants_offset;
+    if (shaders_offset != -1) {
+      const uint shader = sd->shader & SHADER_MASK;
+      const uint num_shaders = kernel_data_fetch(object_constant_shaders, shaders_offset);
+      for (uint i = 0; i < num_shaders; i++) {
+        const int entry = shaders_offset + 1 + i * 2;
+        if (kernel_data_fetch(object_constant_shaders, entry) == shader) {
+          const uint values_offset = kernel_data_fetch(object_constant_shaders, entry + 1);
+          value = kernel_data_fetch(object_constants, values_offset + slot);
+          break;
+        }
+      }
+    }
+  }
+
+  if (is_float) {
+    stack_store_float(stack, out_offset, value.x);
+  }
+  else {
+    stack_store_float3(stack, out_offset, make_float3(value));
+  }
+
+  return offset;
+}
+
 /* Particle Info */
 
 ccl_device_noinline void svm_node_particle_info(KernelGlobals kg,
@@ -104,6 +104,11 @@ SHADER_NODE_TYPE(NODE_MIX_COLOR)
 SHADER_NODE_TYPE(NODE_MIX_FLOAT)
 SHADER_NODE_TYPE(NODE_MIX_VECTOR)
 SHADER_NODE_TYPE(NODE_MIX_VECTOR_NON_UNIFORM)
+SHADER_NODE_TYPE(NODE_OBJECT_CONSTANT)
+/* Superinstructions fused by the compiler, see `svm/superinstruction.h`. */
+SHADER_NODE_TYPE(NODE_VALUE_BATCH)
+SHADER_NODE_TYPE(NODE_MATH_CHAIN)
+SHADER_NODE_TYPE(NODE_TEXTURE_CHAIN)
 SHADER_NODE_TYPE(NODE_NONE)
 
 /* Padding for struct alignment. */
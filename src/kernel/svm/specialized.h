@@ -0,0 +1,110 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+/* Specialized SVM Programs
+ *
+ * On the CPU, the SVM programs of hot surface shaders can be turned into C++ code, compiled at
+ * runtime and called instead of the interpreter. The generated code evaluates each node with its
+ * operands as constants, so stack offsets and node parameters are folded, and jumps between
+ * consecutive nodes become direct branches instead of a dispatch on the node type.
+ *
+ * Programs are relocatable, node offsets in the generated code are local to the shader and the
+ * global offset is found through the shader jump table at runtime. */
+
+#include "kernel/globals.h"
+#include "kernel/types.h"
+
+#include "kernel/integrator/state.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Node features of the main surface shading kernel, which is the one specialized. */
+#define SVM_SPECIALIZED_NODE_FEATURE_MASK \
+  (KERNEL_FEATURE_NODE_MASK_SURFACE & ~KERNEL_FEATURE_NODE_RAYTRACE)
+
+template<uint node_feature_mask, ShaderType type, typename ConstIntegratorGenericState>
+constexpr bool svm_specialized_supported()
+{
+  return node_feature_mask == SVM_SPECIALIZED_NODE_FEATURE_MASK && type == SHADER_TYPE_SURFACE &&
+         std::is_same_v<ConstIntegratorGenericState, ConstIntegratorState>;
+}
+
+/* Evaluate the specialized program of the shader if there is one.
+ * Returns false if the shader is to be interpreted. */
+ccl_device_inline bool svm_eval_nodes_specialized(KernelGlobals kg,
+                                                  ConstIntegratorState state,
+                                                  ccl_private ShaderData *sd,
+                                                  ccl_global float *render_buffer,
+                                                  const uint32_t path_flag)
+{
+  const int shader = sd->shader & SHADER_MASK;
+  if (shader >= kg->svm_specialized_size || !kg->svm_specialized[shader]) {
+    return false;
+  }
+
+  kg->svm_specialized[shader](kg, state, sd, render_buffer, path_flag);
+  return true;
+}
+
+/* Building blocks of the generated code, see scene/svm_specialize.cpp. Every node of the program
+ * gets a case label, the offset after the node is known at compile time for most nodes so the
+ * switch is threaded into direct jumps. Data nodes which are never executed get a case as well
+ * when their first word happens to be a valid node type, which is harmless. */
+#define SVM_SPECIALIZED_SHADER_BEGIN(name, surface_offset) \
+  static void svm_specialized_##name(KernelGlobals kg, \
+                                     ConstIntegratorState state, \
+                                     ccl_private ShaderData *sd, \
+                                     ccl_global float *render_buffer, \
+                                     const uint32_t path_flag) \
+  { \
+    float stack[SVM_STACK_SIZE]; \
+    Spectrum closure_weight = zero_spectrum(); \
+    int offset = int(kernel_data_fetch(svm_nodes, sd->shader & SHADER_MASK).y); \
+    const int base = offset - (surface_offset); \
+    while (true) { \
+      switch (offset - base) {
+
+#define SVM_SPECIALIZED_NODE(local_offset, x, y, z, w) \
+  case local_offset: \
+    offset = base + (local_offset) + 1; \
+    if (!svm_eval_node<SVM_SPECIALIZED_NODE_FEATURE_MASK, SHADER_TYPE_SURFACE>( \
+            kg, state, sd, render_buffer, path_flag, stack, closure_weight, \
+            make_uint4(x, y, z, w), offset)) \
+    { \
+      return; \
+    } \
+    break;
+
+#define SVM_SPECIALIZED_SHADER_END \
+  default: { \
+    const uint4 node = read_node(kg, &offset); \
+    if (!svm_eval_node<SVM_SPECIALIZED_NODE_FEATURE_MASK, SHADER_TYPE_SURFACE>( \
+            kg, state, sd, render_buffer, path_flag, stack, closure_weight, node, offset)) \
+    { \
+      return; \
+    } \
+    break; \
+  } \
+    } \
+    } \
+    }
+
+/* Table of the generated functions, in the order of the programs passed to the generator. */
+#define SVM_SPECIALIZED_EXPORT_BEGIN \
+  extern "C" const SVMSpecializedFunction *cycles_svm_specialized_functions(int *r_num) \
+  { \
+    static const SVMSpecializedFunction functions[] = {
+
+#define SVM_SPECIALIZED_EXPORT(name) svm_specialized_##name,
+
+#define SVM_SPECIALIZED_EXPORT_END \
+  } \
+  ; \
+  *r_num = sizeof(functions) / sizeof(*functions); \
+  return functions; \
+  }
+
+CCL_NAMESPACE_END
@@ -0,0 +1,90 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "kernel/svm/attribute.h"
+#include "kernel/svm/image.h"
+#include "kernel/svm/mapping.h"
+#include "kernel/svm/math.h"
+#include "kernel/svm/tex_coord.h"
+#include "kernel/svm/util.h"
+#include "kernel/svm/value.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Superinstructions
+ *
+ * Frequent sequences of nodes are fused by the compiler into a single node, which evaluates the
+ * sequence without going through the main node dispatch for every node of it. The fused nodes
+ * follow the superinstruction unchanged, so jumps into the middle of a sequence still work. */
+
+/* Sequence of constant value nodes. */
+ccl_device int svm_node_value_batch(KernelGlobals kg,
+                                    ccl_private float *stack,
+                                    const uint num_nodes,
+                                    int offset)
+{
+  for (uint i = 0; i < num_nodes; i++) {
+    const uint4 node = read_node(kg, &offset);
+    if (node.x == NODE_VALUE_F) {
+      svm_node_value_f<float>(stack, node.y, node.z);
+    }
+    else {
+      offset = svm_node_value_v<float3>(kg, stack, node.y, offset);
+    }
+  }
+  return offset;
+}
+
+/* Sequence of math nodes. */
+ccl_device int svm_node_math_chain(KernelGlobals kg,
+                                   ccl_private float *stack,
+                                   const uint num_nodes,
+                                   int offset)
+{
+  for (uint i = 0; i < num_nodes; i++) {
+    const uint4 node = read_node(kg, &offset);
+    svm_node_math(stack, node.y, node.z, node.w);
+  }
+  return offset;
+}
+
+/* Texture coordinate or attribute, mapping and image texture lookup, with the constant inputs
+ * of the mapping and image nodes in between. */
+template<uint node_feature_mask>
+ccl_device int svm_node_texture_chain(KernelGlobals kg,
+                                      ccl_private ShaderData *sd,
+                                      const uint32_t path_flag,
+                                      ccl_private float *stack,
+                                      const uint num_mapping_values,
+                                      const uint num_image_values,
+                                      int offset)
+{
+  const uint4 coord_node = read_node(kg, &offset);
+  if (coord_node.x == NODE_TEX_COORD) {
+    offset = svm_node_tex_coord(kg, sd, path_flag, stack, coord_node, offset);
+  }
+  else {
+    IF_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_attr_volume(kg, sd, stack, coord_node);
+    }
+    else {
+      svm_node_attr_surface(kg, sd, stack, coord_node);
+    }
+  }
+
+  offset = svm_node_value_batch(kg, stack, num_mapping_values, offset);
+  const uint4 mapping_node = read_node(kg, &offset);
+  svm_node_mapping<float3>(stack, mapping_node.y, mapping_node.z, mapping_node.w);
+
+  offset = svm_node_value_batch(kg, stack, num_image_values, offset);
+  const uint4 image_node = read_node(kg, &offset);
+  svm_node_tex_image(kg, sd, stack, image_node, false);
+
+  return offset;
+}
+
+CCL_NAMESPACE_END
@@ -67,6 +67,7 @@
 #include "kernel/svm/sepcomb_color.h"
 #include "kernel/svm/sepcomb_vector.h"
 #include "kernel/svm/sky.h"
+#include "kernel/svm/superinstruction.h"
 #include "kernel/svm/tex_coord.h"
 #include "kernel/svm/value.h"
 #include "kernel/svm/vector_rotate.h"
@@ -84,6 +85,10 @@
 #  include "kernel/svm/raycast.h"
 #endif
 
+#ifndef __KERNEL_GPU__
+#  include "kernel/svm/specialized.h"
+#endif
+
 CCL_NAMESPACE_BEGIN
 
 #ifdef __KERNEL_USE_DATA_CONSTANTS__
@@ -95,6 +100,463 @@ CCL_NAMESPACE_BEGIN
 #  define SVM_CASE(node) case node:
 #endif
 
+/* Evaluate a single node, advancing the offset past any extra data it reads.
+ * Returns false when shader evaluation is finished. */
+template<uint node_feature_mask, ShaderType type, typename ConstIntegratorGenericState>
+ccl_device_forceinline bool svm_eval_node(KernelGlobals kg,
+                                          ConstIntegratorGenericState state,
+                                          ccl_private ShaderData *sd,
+                                          ccl_global float *render_buffer,
+                                          const uint32_t path_flag,
+                                          ccl_private float *stack,
+                                          ccl_private Spectrum &closure_weight,
+                                          const uint4 node,
+                                          ccl_private int &offset)
+{
+  switch (node.x) {
+    SVM_CASE(NODE_END)
+    return false;
+    SVM_CASE(NODE_SHADER_JUMP)
+    {
+      if (type == SHADER_TYPE_SURFACE) {
+        offset = int(node.y);
+      }
+      else if (type == SHADER_TYPE_VOLUME) {
+        offset = int(node.z);
+      }
+      else if (type == SHADER_TYPE_DISPLACEMENT) {
+        offset = int(node.w);
+      }
+      else {
+        return false;
+      }
+      break;
+    }
+    SVM_CASE(NODE_CLOSURE_BSDF)
+    offset = svm_node_closure_bsdf<node_feature_mask, type>(
+        kg, sd, stack, closure_weight, node, path_flag, offset);
+    break;
+    SVM_CASE(NODE_CLOSURE_EMISSION)
+    IF_KERNEL_NODES_FEATURE(EMISSION)
+    {
+      svm_node_closure_emission(kg, sd, stack, closure_weight, node);
+    }
+    break;
+    SVM_CASE(NODE_CLOSURE_BACKGROUND)
+    IF_KERNEL_NODES_FEATURE(EMISSION)
+    {
+      svm_node_closure_background(sd, stack, closure_weight, node);
+    }
+    break;
+    SVM_CASE(NODE_CLOSURE_SET_WEIGHT)
+    svm_node_closure_set_weight(&closure_weight, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_CLOSURE_WEIGHT)
+    svm_node_closure_weight(stack, &closure_weight, node.y);
+    break;
+    SVM_CASE(NODE_EMISSION_WEIGHT)
+    IF_KERNEL_NODES_FEATURE(EMISSION)
+    {
+      svm_node_emission_weight(stack, &closure_weight, node);
+    }
+    break;
+    SVM_CASE(NODE_MIX_CLOSURE)
+    svm_node_mix_closure(stack, node);
+    break;
+    SVM_CASE(NODE_JUMP_IF_ZERO)
+    if (stack_load_float(stack, node.z) <= 0.0f) {
+      offset += node.y;
+    }
+    break;
+    SVM_CASE(NODE_JUMP_IF_ONE)
+    if (stack_load_float(stack, node.z) >= 1.0f) {
+      offset += node.y;
+    }
+    break;
+    SVM_CASE(NODE_GEOMETRY)
+    svm_node_geometry(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_GEOMETRY_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_geometry_derivative(kg, sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_CONVERT)
+    svm_node_convert<float, float3>(kg, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_CONVERT_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_convert<dual1, dual3>(kg, stack, node.y, node.z, node.w);
+    }
+    break;
+    SVM_CASE(NODE_TEX_COORD)
+    offset = svm_node_tex_coord(kg, sd, path_flag, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_COORD_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      offset = svm_node_tex_coord_derivative(kg, sd, path_flag, stack, node, offset);
+    }
+    break;
+    SVM_CASE(NODE_VALUE_F)
+    svm_node_value_f<float>(stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_VALUE_F_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_value_f<dual1>(stack, node.y, node.z);
+    }
+    break;
+    SVM_CASE(NODE_VALUE_V)
+    offset = svm_node_value_v<float3>(kg, stack, node.y, offset);
+    break;
+    SVM_CASE(NODE_VALUE_V_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      offset = svm_node_value_v<dual3>(kg, stack, node.y, offset);
+    }
+    break;
+    SVM_CASE(NODE_ATTR)
+    IF_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_attr_volume(kg, sd, stack, node);
+    }
+    else {
+      svm_node_attr_surface(kg, sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_ATTR_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_attr_derivative(kg, sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_VERTEX_COLOR)
+    svm_node_vertex_color(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_VERTEX_COLOR_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_vertex_color_derivative(kg, sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_SET_DISPLACEMENT)
+    svm_node_set_displacement<node_feature_mask>(sd, stack, node.y);
+    break;
+    SVM_CASE(NODE_DISPLACEMENT)
+    svm_node_displacement<node_feature_mask>(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_VECTOR_DISPLACEMENT)
+    offset = svm_node_vector_displacement<node_feature_mask>(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_IMAGE)
+    svm_node_tex_image(kg, sd, stack, node, false);
+    break;
+    SVM_CASE(NODE_TEX_IMAGE_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_tex_image(kg, sd, stack, node, true);
+    }
+    break;
+    SVM_CASE(NODE_TEX_IMAGE_BOX)
+    svm_node_tex_image_box(kg, sd, stack, node, false);
+    break;
+    SVM_CASE(NODE_TEX_IMAGE_BOX_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_tex_image_box(kg, sd, stack, node, true);
+    }
+    break;
+    SVM_CASE(NODE_TEX_NOISE)
+    offset = svm_node_tex_noise(kg, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_SET_BUMP)
+    offset = svm_node_set_bump<node_feature_mask>(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_CLOSURE_SET_NORMAL)
+    IF_KERNEL_NODES_FEATURE(BUMP)
+    {
+      svm_node_set_normal(sd, stack, node.y, node.z);
+    }
+    break;
+    SVM_CASE(NODE_ENTER_BUMP_EVAL)
+    IF_KERNEL_NODES_FEATURE(BUMP_STATE)
+    {
+      svm_node_enter_bump_eval(kg, sd, stack, node.y);
+    }
+    break;
+    SVM_CASE(NODE_LEAVE_BUMP_EVAL)
+    IF_KERNEL_NODES_FEATURE(BUMP_STATE)
+    {
+      svm_node_leave_bump_eval(sd, stack, node.y);
+    }
+    break;
+    SVM_CASE(NODE_HSV)
+    svm_node_hsv(stack, node);
+    break;
+    SVM_CASE(NODE_CLOSURE_HOLDOUT)
+    svm_node_closure_holdout(sd, stack, closure_weight, node);
+    break;
+    SVM_CASE(NODE_FRESNEL)
+    svm_node_fresnel(sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_LAYER_WEIGHT)
+    svm_node_layer_weight(sd, stack, node);
+    break;
+    SVM_CASE(NODE_CLOSURE_VOLUME)
+    IF_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_closure_volume<type>(kg, sd, stack, closure_weight, node);
+    }
+    break;
+    SVM_CASE(NODE_VOLUME_COEFFICIENTS)
+    IF_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_volume_coefficients<type>(kg, sd, stack, closure_weight, node, path_flag);
+    }
+    break;
+    SVM_CASE(NODE_PRINCIPLED_VOLUME)
+    IF_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      offset = svm_node_principled_volume<type>(
+          kg, sd, stack, closure_weight, node, path_flag, offset);
+    }
+    break;
+    SVM_CASE(NODE_MATH)
+    svm_node_math(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_VECTOR_MATH)
+    offset = svm_node_vector_math<float3>(kg, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_VECTOR_MATH_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      offset = svm_node_vector_math<dual3>(kg, stack, node.y, node.z, node.w, offset);
+    }
+    break;
+    SVM_CASE(NODE_RGB_RAMP)
+    offset = svm_node_rgb_ramp(kg, stack, node, offset);
+    break;
+    SVM_CASE(NODE_GAMMA)
+    svm_node_gamma(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_BRIGHTCONTRAST)
+    svm_node_brightness(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_LIGHT_PATH)
+    svm_node_light_path<node_feature_mask>(kg, state, sd, stack, node.y, node.z, path_flag);
+    break;
+    SVM_CASE(NODE_OBJECT_INFO)
+    svm_node_object_info(kg, sd, stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_PARTICLE_INFO)
+    svm_node_particle_info(kg, sd, stack, node.y, node.z);
+    break;
+#if defined(__HAIR__)
+    SVM_CASE(NODE_HAIR_INFO)
+    svm_node_hair_info(kg, sd, stack, node.y, node.z);
+    break;
+#endif
+#if defined(__POINTCLOUD__)
+    SVM_CASE(NODE_POINT_INFO)
+    svm_node_point_info(kg, sd, stack, node.y, node.z);
+    break;
+#endif
+    SVM_CASE(NODE_TEXTURE_MAPPING)
+    offset = svm_node_texture_mapping(kg, stack, node.y, node.z, offset);
+    break;
+    SVM_CASE(NODE_MAPPING)
+    svm_node_mapping<float3>(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_MAPPING_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_mapping<dual3>(stack, node.y, node.z, node.w);
+    }
+    break;
+    SVM_CASE(NODE_MIN_MAX)
+    offset = svm_node_min_max(kg, stack, node.y, node.z, offset);
+    break;
+    SVM_CASE(NODE_CAMERA)
+    svm_node_camera(kg, sd, stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_TEX_ENVIRONMENT)
+    svm_node_tex_environment(kg, sd, stack, node, false);
+    break;
+    SVM_CASE(NODE_TEX_ENVIRONMENT_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_tex_environment(kg, sd, stack, node, true);
+    }
+    break;
+    SVM_CASE(NODE_TEX_SKY)
+    offset = svm_node_tex_sky(kg, sd, path_flag, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_GRADIENT)
+    svm_node_tex_gradient(stack, node);
+    break;
+    SVM_CASE(NODE_TEX_VORONOI)
+    offset = svm_node_tex_voronoi<node_feature_mask>(kg, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_TEX_GABOR)
+    offset = svm_node_tex_gabor(kg, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_TEX_WAVE)
+    offset = svm_node_tex_wave(kg, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_MAGIC)
+    offset = svm_node_tex_magic(kg, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_CHECKER)
+    svm_node_tex_checker(stack, node);
+    break;
+    SVM_CASE(NODE_TEX_BRICK)
+    offset = svm_node_tex_brick(kg, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TEX_WHITE_NOISE)
+    svm_node_tex_white_noise(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_NORMAL)
+    offset = svm_node_normal(kg, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_LIGHT_FALLOFF)
+    svm_node_light_falloff(sd, stack, node);
+    break;
+    SVM_CASE(NODE_IES)
+    svm_node_ies(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_CURVES)
+    offset = svm_node_curves(kg, stack, node, offset);
+    break;
+    SVM_CASE(NODE_TANGENT)
+    svm_node_tangent<float3>(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_TANGENT_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_tangent<dual3>(kg, sd, stack, node);
+    }
+    break;
+    SVM_CASE(NODE_NORMAL_MAP)
+    svm_node_normal_map(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_RADIAL_TILING)
+    offset = svm_node_radial_tiling<node_feature_mask>(stack, node, offset);
+    break;
+    SVM_CASE(NODE_INVERT)
+    svm_node_invert(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_MIX)
+    offset = svm_node_mix(kg, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_SEPARATE_COLOR)
+    svm_node_separate_color(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_COMBINE_COLOR)
+    svm_node_combine_color(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_SEPARATE_VECTOR)
+    svm_node_separate_vector<float3>(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_SEPARATE_VECTOR_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_separate_vector<dual3>(stack, node.y, node.z, node.w);
+    }
+    break;
+    SVM_CASE(NODE_COMBINE_VECTOR)
+    svm_node_combine_vector<float3>(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_COMBINE_VECTOR_DERIVATIVE)
+    IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
+    {
+      svm_node_combine_vector<dual3>(stack, node.y, node.z, node.w);
+    }
+    break;
+    SVM_CASE(NODE_VECTOR_ROTATE)
+    svm_node_vector_rotate(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_VECTOR_TRANSFORM)
+    svm_node_vector_transform(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_WIREFRAME)
+    svm_node_wireframe(kg, sd, stack, node);
+    break;
+    SVM_CASE(NODE_WAVELENGTH)
+    svm_node_wavelength(kg, stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_BLACKBODY)
+    svm_node_blackbody(kg, stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_MAP_RANGE)
+    offset = svm_node_map_range(kg, stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_VECTOR_MAP_RANGE)
+    offset = svm_node_vector_map_range(stack, node.y, node.z, node.w, offset);
+    break;
+    SVM_CASE(NODE_CLAMP)
+    offset = svm_node_clamp(kg, stack, node.y, node.z, node.w, offset);
+    break;
+#ifdef __SHADER_RAYTRACE__
+    SVM_CASE(NODE_BEVEL)
+    svm_node_bevel<node_feature_mask>(kg, state, sd, stack, node);
+    break;
+    SVM_CASE(NODE_AMBIENT_OCCLUSION)
+    svm_node_ao<node_feature_mask>(kg, state, sd, stack, node);
+    break;
+    SVM_CASE(NODE_RAYCAST)
+    offset = svm_node_raycast<node_feature_mask>(kg, state, sd, stack, node, offset);
+    break;
+#endif
+    SVM_CASE(NODE_AOV_START)
+    if (!svm_node_aov_check(path_flag, render_buffer)) {
+      return false;
+    }
+    break;
+    SVM_CASE(NODE_AOV_COLOR)
+    svm_node_aov_color<node_feature_mask>(kg, state, stack, node, render_buffer);
+    break;
+    SVM_CASE(NODE_AOV_VALUE)
+    svm_node_aov_value<node_feature_mask>(kg, state, stack, node, render_buffer);
+    break;
+    SVM_CASE(NODE_FLOAT_CURVE)
+    offset = svm_node_curve(kg, stack, node, offset);
+    break;
+    SVM_CASE(NODE_MIX_COLOR)
+    svm_node_mix_color(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_MIX_FLOAT)
+    svm_node_mix_float(stack, node.y, node.z, node.w);
+    break;
+    SVM_CASE(NODE_MIX_VECTOR)
+    svm_node_mix_vector(stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_MIX_VECTOR_NON_UNIFORM)
+    svm_node_mix_vector_non_uniform(stack, node.y, node.z);
+    break;
+    SVM_CASE(NODE_OBJECT_CONSTANT)
+    offset = svm_node_object_constant(kg, sd, stack, node, offset);
+    break;
+    SVM_CASE(NODE_VALUE_BATCH)
+    offset = svm_node_value_batch(kg, stack, node.y, offset);
+    break;
+    SVM_CASE(NODE_MATH_CHAIN)
+    offset = svm_node_math_chain(kg, stack, node.y, offset);
+    break;
+    SVM_CASE(NODE_TEXTURE_CHAIN)
+    offset = svm_node_texture_chain<node_feature_mask>(
+        kg, sd, path_flag, stack, node.y, node.z, offset);
+    break;
+    default:
+      kernel_assert(!"Unknown node type was passed to the SVM machine");
+      return false;
+  }
+
+  return true;
+}
+
 /* Main Interpreter Loop */
 template<uint node_feature_mask, ShaderType type, typename ConstIntegratorGenericState>
 ccl_device void svm_eval_nodes(KernelGlobals kg,
@@ -103,440 +565,26 @@ ccl_device void svm_eval_nodes(KernelGlobals kg,
                                ccl_global float *render_buffer,
                                const uint32_t path_flag)
 {
+#ifndef __KERNEL_GPU__
+  if constexpr (svm_specialized_supported<node_feature_mask, type, ConstIntegratorGenericState>())
+  {
+    if (svm_eval_nodes_specialized(kg, state, sd, render_buffer, path_flag)) {
+      return;
+    }
+  }
+#endif
+
   float stack[SVM_STACK_SIZE];
   /* Initialize to silence (false positive?) warning about uninitialized use on Windows. */
   Spectrum closure_weight = zero_spectrum();
   int offset = sd->shader & SHADER_MASK;
 
   while (true) {
-    uint4 node = read_node(kg, &offset);
-
-    switch (node.x) {
-      SVM_CASE(NODE_END)
+    const uint4 node = read_node(kg, &offset);
+    if (!svm_eval_node<node_feature_mask, type>(
+            kg, state, sd, render_buffer, path_flag, stack, closure_weight, node, offset))
+    {
       return;
-      SVM_CASE(NODE_SHADER_JUMP)
-      {
-        if (type == SHADER_TYPE_SURFACE) {
-          offset = int(node.y);
-        }
-        else if (type == SHADER_TYPE_VOLUME) {
-          offset = int(node.z);
-        }
-        else if (type == SHADER_TYPE_DISPLACEMENT) {
-          offset = int(node.w);
-        }
-        else {
-          return;
-        }
-        break;
-      }
-      SVM_CASE(NODE_CLOSURE_BSDF)
-      offset = svm_node_closure_bsdf<node_feature_mask, type>(
-          kg, sd, stack, closure_weight, node, path_flag, offset);
-      break;
-      SVM_CASE(NODE_CLOSURE_EMISSION)
-      IF_KERNEL_NODES_FEATURE(EMISSION)
-      {
-        svm_node_closure_emission(kg, sd, stack, closure_weight, node);
-      }
-      break;
-      SVM_CASE(NODE_CLOSURE_BACKGROUND)
-      IF_KERNEL_NODES_FEATURE(EMISSION)
-      {
-        svm_node_closure_background(sd, stack, closure_weight, node);
-      }
-      break;
-      SVM_CASE(NODE_CLOSURE_SET_WEIGHT)
-      svm_node_closure_set_weight(&closure_weight, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_CLOSURE_WEIGHT)
-      svm_node_closure_weight(stack, &closure_weight, node.y);
-      break;
-      SVM_CASE(NODE_EMISSION_WEIGHT)
-      IF_KERNEL_NODES_FEATURE(EMISSION)
-      {
-        svm_node_emission_weight(stack, &closure_weight, node);
-      }
-      break;
-      SVM_CASE(NODE_MIX_CLOSURE)
-      svm_node_mix_closure(stack, node);
-      break;
-      SVM_CASE(NODE_JUMP_IF_ZERO)
-      if (stack_load_float(stack, node.z) <= 0.0f) {
-        offset += node.y;
-      }
-      break;
-      SVM_CASE(NODE_JUMP_IF_ONE)
-      if (stack_load_float(stack, node.z) >= 1.0f) {
-        offset += node.y;
-      }
-      break;
-      SVM_CASE(NODE_GEOMETRY)
-      svm_node_geometry(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_GEOMETRY_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_geometry_derivative(kg, sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_CONVERT)
-      svm_node_convert<float, float3>(kg, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_CONVERT_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_convert<dual1, dual3>(kg, stack, node.y, node.z, node.w);
-      }
-      break;
-      SVM_CASE(NODE_TEX_COORD)
-      offset = svm_node_tex_coord(kg, sd, path_flag, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_COORD_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        offset = svm_node_tex_coord_derivative(kg, sd, path_flag, stack, node, offset);
-      }
-      break;
-      SVM_CASE(NODE_VALUE_F)
-      svm_node_value_f<float>(stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_VALUE_F_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_value_f<dual1>(stack, node.y, node.z);
-      }
-      break;
-      SVM_CASE(NODE_VALUE_V)
-      offset = svm_node_value_v<float3>(kg, stack, node.y, offset);
-      break;
-      SVM_CASE(NODE_VALUE_V_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        offset = svm_node_value_v<dual3>(kg, stack, node.y, offset);
-      }
-      break;
-      SVM_CASE(NODE_ATTR)
-      IF_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_attr_volume(kg, sd, stack, node);
-      }
-      else {
-        svm_node_attr_surface(kg, sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_ATTR_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_attr_derivative(kg, sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_VERTEX_COLOR)
-      svm_node_vertex_color(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_VERTEX_COLOR_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_vertex_color_derivative(kg, sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_SET_DISPLACEMENT)
-      svm_node_set_displacement<node_feature_mask>(sd, stack, node.y);
-      break;
-      SVM_CASE(NODE_DISPLACEMENT)
-      svm_node_displacement<node_feature_mask>(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_VECTOR_DISPLACEMENT)
-      offset = svm_node_vector_displacement<node_feature_mask>(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_IMAGE)
-      svm_node_tex_image(kg, sd, stack, node, false);
-      break;
-      SVM_CASE(NODE_TEX_IMAGE_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_tex_image(kg, sd, stack, node, true);
-      }
-      break;
-      SVM_CASE(NODE_TEX_IMAGE_BOX)
-      svm_node_tex_image_box(kg, sd, stack, node, false);
-      break;
-      SVM_CASE(NODE_TEX_IMAGE_BOX_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_tex_image_box(kg, sd, stack, node, true);
-      }
-      break;
-      SVM_CASE(NODE_TEX_NOISE)
-      offset = svm_node_tex_noise(kg, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_SET_BUMP)
-      offset = svm_node_set_bump<node_feature_mask>(kg, sd, stack, node, offset);
-      break;
-      SVM_CASE(NODE_CLOSURE_SET_NORMAL)
-      IF_KERNEL_NODES_FEATURE(BUMP)
-      {
-        svm_node_set_normal(sd, stack, node.y, node.z);
-      }
-      break;
-      SVM_CASE(NODE_ENTER_BUMP_EVAL)
-      IF_KERNEL_NODES_FEATURE(BUMP_STATE)
-      {
-        svm_node_enter_bump_eval(kg, sd, stack, node.y);
-      }
-      break;
-      SVM_CASE(NODE_LEAVE_BUMP_EVAL)
-      IF_KERNEL_NODES_FEATURE(BUMP_STATE)
-      {
-        svm_node_leave_bump_eval(sd, stack, node.y);
-      }
-      break;
-      SVM_CASE(NODE_HSV)
-      svm_node_hsv(stack, node);
-      break;
-      SVM_CASE(NODE_CLOSURE_HOLDOUT)
-      svm_node_closure_holdout(sd, stack, closure_weight, node);
-      break;
-      SVM_CASE(NODE_FRESNEL)
-      svm_node_fresnel(sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_LAYER_WEIGHT)
-      svm_node_layer_weight(sd, stack, node);
-      break;
-      SVM_CASE(NODE_CLOSURE_VOLUME)
-      IF_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_closure_volume<type>(kg, sd, stack, closure_weight, node);
-      }
-      break;
-      SVM_CASE(NODE_VOLUME_COEFFICIENTS)
-      IF_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_volume_coefficients<type>(kg, sd, stack, closure_weight, node, path_flag);
-      }
-      break;
-      SVM_CASE(NODE_PRINCIPLED_VOLUME)
-      IF_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        offset = svm_node_principled_volume<type>(
-            kg, sd, stack, closure_weight, node, path_flag, offset);
-      }
-      break;
-      SVM_CASE(NODE_MATH)
-      svm_node_math(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_VECTOR_MATH)
-      offset = svm_node_vector_math<float3>(kg, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_VECTOR_MATH_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        offset = svm_node_vector_math<dual3>(kg, stack, node.y, node.z, node.w, offset);
-      }
-      break;
-      SVM_CASE(NODE_RGB_RAMP)
-      offset = svm_node_rgb_ramp(kg, stack, node, offset);
-      break;
-      SVM_CASE(NODE_GAMMA)
-      svm_node_gamma(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_BRIGHTCONTRAST)
-      svm_node_brightness(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_LIGHT_PATH)
-      svm_node_light_path<node_feature_mask>(kg, state, sd, stack, node.y, node.z, path_flag);
-      break;
-      SVM_CASE(NODE_OBJECT_INFO)
-      svm_node_object_info(kg, sd, stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_PARTICLE_INFO)
-      svm_node_particle_info(kg, sd, stack, node.y, node.z);
-      break;
-#if defined(__HAIR__)
-      SVM_CASE(NODE_HAIR_INFO)
-      svm_node_hair_info(kg, sd, stack, node.y, node.z);
-      break;
-#endif
-#if defined(__POINTCLOUD__)
-      SVM_CASE(NODE_POINT_INFO)
-      svm_node_point_info(kg, sd, stack, node.y, node.z);
-      break;
-#endif
-      SVM_CASE(NODE_TEXTURE_MAPPING)
-      offset = svm_node_texture_mapping(kg, stack, node.y, node.z, offset);
-      break;
-      SVM_CASE(NODE_MAPPING)
-      svm_node_mapping<float3>(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_MAPPING_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_mapping<dual3>(stack, node.y, node.z, node.w);
-      }
-      break;
-      SVM_CASE(NODE_MIN_MAX)
-      offset = svm_node_min_max(kg, stack, node.y, node.z, offset);
-      break;
-      SVM_CASE(NODE_CAMERA)
-      svm_node_camera(kg, sd, stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_TEX_ENVIRONMENT)
-      svm_node_tex_environment(kg, sd, stack, node, false);
-      break;
-      SVM_CASE(NODE_TEX_ENVIRONMENT_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_tex_environment(kg, sd, stack, node, true);
-      }
-      break;
-      SVM_CASE(NODE_TEX_SKY)
-      offset = svm_node_tex_sky(kg, sd, path_flag, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_GRADIENT)
-      svm_node_tex_gradient(stack, node);
-      break;
-      SVM_CASE(NODE_TEX_VORONOI)
-      offset = svm_node_tex_voronoi<node_feature_mask>(kg, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_TEX_GABOR)
-      offset = svm_node_tex_gabor(kg, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_TEX_WAVE)
-      offset = svm_node_tex_wave(kg, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_MAGIC)
-      offset = svm_node_tex_magic(kg, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_CHECKER)
-      svm_node_tex_checker(stack, node);
-      break;
-      SVM_CASE(NODE_TEX_BRICK)
-      offset = svm_node_tex_brick(kg, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TEX_WHITE_NOISE)
-      svm_node_tex_white_noise(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_NORMAL)
-      offset = svm_node_normal(kg, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_LIGHT_FALLOFF)
-      svm_node_light_falloff(sd, stack, node);
-      break;
-      SVM_CASE(NODE_IES)
-      svm_node_ies(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_CURVES)
-      offset = svm_node_curves(kg, stack, node, offset);
-      break;
-      SVM_CASE(NODE_TANGENT)
-      svm_node_tangent<float3>(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_TANGENT_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_tangent<dual3>(kg, sd, stack, node);
-      }
-      break;
-      SVM_CASE(NODE_NORMAL_MAP)
-      svm_node_normal_map(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_RADIAL_TILING)
-      offset = svm_node_radial_tiling<node_feature_mask>(stack, node, offset);
-      break;
-      SVM_CASE(NODE_INVERT)
-      svm_node_invert(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_MIX)
-      offset = svm_node_mix(kg, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_SEPARATE_COLOR)
-      svm_node_separate_color(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_COMBINE_COLOR)
-      svm_node_combine_color(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_SEPARATE_VECTOR)
-      svm_node_separate_vector<float3>(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_SEPARATE_VECTOR_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_separate_vector<dual3>(stack, node.y, node.z, node.w);
-      }
-      break;
-      SVM_CASE(NODE_COMBINE_VECTOR)
-      svm_node_combine_vector<float3>(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_COMBINE_VECTOR_DERIVATIVE)
-      IF_NOT_KERNEL_NODES_FEATURE(VOLUME)
-      {
-        svm_node_combine_vector<dual3>(stack, node.y, node.z, node.w);
-      }
-      break;
-      SVM_CASE(NODE_VECTOR_ROTATE)
-      svm_node_vector_rotate(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_VECTOR_TRANSFORM)
-      svm_node_vector_transform(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_WIREFRAME)
-      svm_node_wireframe(kg, sd, stack, node);
-      break;
-      SVM_CASE(NODE_WAVELENGTH)
-      svm_node_wavelength(kg, stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_BLACKBODY)
-      svm_node_blackbody(kg, stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_MAP_RANGE)
-      offset = svm_node_map_range(kg, stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_VECTOR_MAP_RANGE)
-      offset = svm_node_vector_map_range(stack, node.y, node.z, node.w, offset);
-      break;
-      SVM_CASE(NODE_CLAMP)
-      offset = svm_node_clamp(kg, stack, node.y, node.z, node.w, offset);
-      break;
-#ifdef __SHADER_RAYTRACE__
-      SVM_CASE(NODE_BEVEL)
-      svm_node_bevel<node_feature_mask>(kg, state, sd, stack, node);
-      break;
-      SVM_CASE(NODE_AMBIENT_OCCLUSION)
-      svm_node_ao<node_feature_mask>(kg, state, sd, stack, node);
-      break;
-      SVM_CASE(NODE_RAYCAST)
-      offset = svm_node_raycast<node_feature_mask>(kg, state, sd, stack, node, offset);
-      break;
-#endif
-      SVM_CASE(NODE_AOV_START)
-      if (!svm_node_aov_check(path_flag, render_buffer)) {
-        return;
-      }
-      break;
-      SVM_CASE(NODE_AOV_COLOR)
-      svm_node_aov_color<node_feature_mask>(kg, state, stack, node, render_buffer);
-      break;
-      SVM_CASE(NODE_AOV_VALUE)
-      svm_node_aov_value<node_feature_mask>(kg, state, stack, node, render_buffer);
-      break;
-      SVM_CASE(NODE_FLOAT_CURVE)
-      offset = svm_node_curve(kg, stack, node, offset);
-      break;
-      SVM_CASE(NODE_MIX_COLOR)
-      svm_node_mix_color(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_MIX_FLOAT)
-      svm_node_mix_float(stack, node.y, node.z, node.w);
-      break;
-      SVM_CASE(NODE_MIX_VECTOR)
-      svm_node_mix_vector(stack, node.y, node.z);
-      break;
-      SVM_CASE(NODE_MIX_VECTOR_NON_UNIFORM)
-      svm_node_mix_vector_non_uniform(stack, node.y, node.z);
-      break;
-      default:
-        kernel_assert(!"Unknown node type was passed to the SVM machine");
-        return;
     }
   }
 }
@@ -121,4 +121,274 @@ ccl_inline_constant unsigned int sobol_burley_table[4][32] = {
   },
 };
 
+/*
+ * Tile of keys for the seeds of the pixels with the tiled blue-noise sampling pattern, the seed
+ * of a pixel is the hash of its key. Each key in [0, 4096) is used once.
+ *
+ * The keys were arranged by greedily swapping them between nearby pixels, minimizing the
+ * correlation of the errors of neighboring pixels (with a Gaussian falloff of 1.5 pixels) when
+ * integrating random step functions with 1, 2, 4 and 8 samples. Optimized for the camera filter
+ * and the first bounce light and BSDF dimensions, on a torus so the tile repeats seamlessly.
+ */
+#define BLUE_NOISE_TILE_SIZE 64
+
+ccl_inline_constant unsigned short blue_noise_tile[] = {
+  1211, 2364,  299, 1513, 2640, 1167, 2828, 3528, 2736, 3613, 4052, 2834, 3482,  906,  794, 2866,
+   826, 2654, 2169, 3039,  295, 1383, 2547, 2222,  269, 2293, 2277,  630, 2758, 3685, 3467, 1548,
+   150, 4081, 1975, 3041,  476, 2612, 2186,  935, 2846, 1906,  192,   36, 3460, 1604,  910, 1417,
+  3745, 2953, 1370, 3950, 1984, 2379, 2997, 1768, 1879, 1727,  247, 2628, 3785, 1550, 3420, 2569,
+  3668, 1914,  110, 3531, 1688, 1897,  836,  938, 1415, 2559, 2521, 2792, 1055, 1651, 1654, 3601,
+  2373, 1572, 1851, 2150,  616,  917, 2543, 3821, 3760, 1633, 3388, 3559,  548,  690, 1422, 1951,
+  3091,   10, 2288,  613, 3386, 2779,  703, 1033, 2641, 3254, 1379, 2531, 3075, 2774, 2666,  191,
+  1677, 1697,   19,  829,  768, 3332,  965,  121, 1224, 1399, 2290, 3832,   56, 3949, 1243, 3875,
+  1227, 3022, 3990, 4023, 2093, 1700, 1913, 2498, 2775,  145, 2930, 3567,  334, 3734, 2907, 1874,
+  3757, 2171,  706, 3942,  646, 2212, 1898, 2575, 1388, 3018, 2163, 3060, 2086, 3800, 1744, 1743,
+   375, 2170, 1847,  721, 3788, 2269,  376, 2555,  133,   99, 2707, 3858, 2533, 1490, 3513, 2752,
+     2, 2202,    4, 3366, 1674, 2456, 3295,  845, 3777,  796, 1326, 1338, 1049, 3649,  865,  398,
+   135, 2606,  264,  619, 1923,   93, 2057,  822, 1307, 3198,  825, 2213,  250,  952,  470, 3749,
+  1568,  549, 2254, 1428,  974, 1286, 2562, 2380, 2402, 2285, 2485,  902, 2971, 1908, 3318, 1559,
+  3801, 1331, 1940,  687,  766,  724, 1696, 2082, 2347, 1675, 2691, 2831, 2675,  244,  667, 3185,
+  2237, 2117, 2074, 1317, 3051,  383, 3248,  301, 3943, 4027, 2031, 1221, 1796, 1053, 2803, 2330,
+  3181,  163, 4016,  570, 3873, 2022, 3154, 3727, 3887, 1797, 1088, 2116, 3106, 1775, 2651, 2712,
+  1893, 2278, 3671, 3966, 3623, 1729, 4090, 3088, 2996, 3495,  117, 1007, 2325,  307, 1673, 2465,
+  3743, 2422, 3965, 1932,  881,  125,   71,  351,  800, 2742, 3554, 3395, 2198, 3385, 3628, 2445,
+  3426, 3255, 2700, 3079, 1939, 1628, 1944, 2386, 2261,  479, 1315, 1109, 2840, 3595, 3794, 3931,
+   132, 1333,  666, 3247, 2476,  494,  712, 1253, 3829, 2112,  509, 2140,  229,  300,  964, 1439,
+  2342,  529,  928, 3598,  627, 2560, 1950, 1591, 2865,  596, 2838, 1462, 2600, 1861, 1699, 1193,
+    43,  851, 3767, 3850, 3081, 2337, 1858, 1960, 3350, 1443, 2076, 3383, 1864, 1438, 1813, 1870,
+  3481, 2671, 2923, 1759,  739, 1460,  319,  316, 2682,  472,  714, 3637, 2071, 3663, 1758, 1980,
+   406, 2683, 2686, 2518,  161,  187,  331,  212,  332, 4003, 1012, 3093, 3592, 3152, 1231,   51,
+  4062, 3981, 1299, 1123, 3855, 2672,  815, 2046, 1710, 2759,  778,   59, 1184,  367, 2274, 3503,
+  2430, 3899, 3151, 1791, 1002, 1571, 1519, 2592, 2363, 1522,  579,   17,  273, 3716, 2499, 1240,
+  3140, 3518, 2627, 1882,  594,  686, 2231, 3187, 1907, 2404, 2783, 2119,  914, 3870,  421, 2137,
+   362, 1658, 1859,  213, 3004, 3311, 2554, 2179, 3562, 3525, 1436, 1539, 1044, 3987, 1239, 3183,
+   811, 1771,  806, 1531,  173, 2255, 1220,  261, 2880, 1683, 3999, 1943,   66,   20,  440,  764,
+  1814,   60, 1621, 4018, 1824, 3784,  441, 2236, 2565, 1523, 3853, 1375, 2878, 2078, 3063,  585,
+  2219, 2433, 1782, 2741,  395,  513, 1832, 3121,  531, 2016,  410, 1289, 1082, 3516,  329, 3105,
+   741, 3901, 1826,  860, 2984,  371,  864, 3339, 1679,  242, 3919, 1926, 3378, 2206, 2315, 3461,
+   238, 1171, 2418, 2932, 2826,  847, 2193, 3849, 3474,  799, 1128,  696,  109, 1161, 1146, 1225,
+  2420, 3527, 2263, 1819, 2722, 1268,  745, 3234,   91, 1270, 3490, 3971, 1434,  432, 3201, 3667,
+  1767, 1537, 3603, 3172,  283, 1606, 3447, 1748, 1091, 2019,  705, 3309,  707, 2496,  199, 1191,
+   569,   90,  489, 3953, 3036, 2810,  839, 2393,  617, 2912, 1875,  164,  671, 2578, 2657, 2719,
+  3107,  194, 1206,  220, 3596, 3706,  899, 1376,  358, 3968, 3886, 1863,   39, 2833, 3425,  665,
+  2122, 1175, 2714, 3305, 2044, 3343,  754, 2567, 2658, 3090, 1929,  846,  510, 1982, 3171, 2777,
+  3625,  921, 2895,  956, 2579, 2368,  341, 2943, 3964, 1586,  837,  454, 2453,  137, 2823, 2024,
+  3100, 2353, 1739, 3643, 1020, 2299, 1181, 1871, 2002,  387, 3652, 2812, 3314, 2884, 1868, 1130,
+  2034, 4077, 2541, 2577,  428, 2749, 3164, 2391,  693,  759, 2305, 1210, 3960,  153, 1147,  558,
+  1325,  540, 1453, 1504,  657, 3394, 3690, 3243, 2068, 2669,  782, 1032, 2343, 2185, 1556,  892,
+  3466,  200,  328, 3769,  752, 1241, 2508, 1505, 1924, 1321, 4092, 3894, 3722,  208, 2863, 2133,
+  1478, 2295, 3768, 3900, 3841, 1684, 1534, 1421, 3269, 3471, 2909, 2488, 1503, 2737, 1059,  240,
+  1348,  435, 3087, 3799,  784, 1412, 3331,  615, 1566, 2917, 3276, 4076,  126, 3260,  452, 3059,
+  1510, 1067, 3970, 1273, 2836,   13, 2801,  694, 1838,  402, 2135, 1041, 3729, 2187, 4057, 2542,
+   631, 2262, 2413, 3730,  685,  738, 1647,  601, 1933, 1770, 1648,  403, 2251, 1499, 2144, 2055,
+  2506, 3895, 1599, 4040, 4070,  669, 2434, 3413, 1794, 3294, 3750, 3820, 1839, 1580, 2232, 1576,
+  1526, 3830, 2469, 3979, 1142, 1361, 2655,  675, 4038, 3317, 3686, 3066, 2688,  728, 3250, 3605,
+  2032, 3417, 4021, 3456, 2030, 3020, 2945, 3202,  893, 1444, 3155,  167,  972, 1138, 2437,  159,
+  3488, 1827, 3176, 1780, 4010, 3328, 3666, 1392,  534,   49,   65, 1521, 1058, 2885,  218,  210,
+  3427, 1817, 1401, 1538, 1598,  413, 2867, 1855, 1381, 2636, 3165, 3144, 2188,  430, 1911, 2733,
+   966, 1682, 3145, 1105, 1416, 1885,  702, 3972, 1860, 4056,  587,  656,   72, 1061, 3977,   88,
+  3963, 1995, 3073, 1410, 3056,  446, 2069, 3563, 3552, 4029, 2940, 2698, 3565, 3626,   15, 1949,
+   905, 1772, 3861,  835, 1372,  418, 2061, 3876,  256, 1157, 1634, 2594, 2796, 1305, 3448,   11,
+   201, 3909, 1368, 1595,   82, 2497, 3071, 3070, 3675,  998, 1187, 1282, 3290, 2598,  831, 3627,
+  2816, 3632, 3538,  647, 2205,  480, 2194, 3217, 2787,  223, 3293, 2048,  734, 1087,  932, 3013,
+  2226,  154, 4012,  795, 3333, 3677, 2128,  653,  780, 1276,  922, 2421, 3891,  401, 3860,  955,
+  2645, 1294, 2553, 1905,  989, 2301, 2083, 3494, 2087, 1755, 4086, 4020,  471, 4050, 3967, 1602,
+  2292,  231, 2710, 2887,  498, 2283, 3446, 4080, 3323, 1355,  399, 2980, 3080,  589, 1274,  388,
+  1799, 2538,  566,  856, 3630,  483,  197, 2546, 1986,  108, 2870,   31, 1841, 3029,  682, 1120,
+   485, 3014, 1919, 3954, 3770, 1866, 3545, 3535, 2396,  948, 3868,  565, 3678, 1896, 2993,  528,
+  3267, 1891, 3440, 3194, 2270,   85,  961, 3664, 1916, 3302, 3173, 3161, 1527, 1678, 3604, 1190,
+  3220, 2089,  503, 3497, 2871, 4037, 3969, 1027, 2822,  787, 2694, 2126, 3581, 1734,  260, 2407,
+  2605, 3256, 2568,  717,  929, 2757, 1022, 1346, 3273, 3265,  349, 1215, 3126,  857,  652, 2210,
+  1127, 2596, 1083, 1495,  214, 3319, 1937, 3124, 4030, 2899,  552, 1564, 1003, 1714, 2245, 2303,
+  1278, 2246, 3246, 2763, 3134, 1831, 2662, 3661, 3281, 1330, 3732, 1835, 2156, 2355,  424,  557,
+  4095,  519,  149,  160, 2766, 1560, 1249, 4014, 1625, 2695, 2276, 3808, 1065, 1293,  977,  390,
+  2781, 2383, 2168, 1691, 3235, 1340,  737, 1728, 2905,  547, 3487, 3890, 1176,  270, 3573, 3324,
+  3065,  620,  143, 2152, 3907, 3344, 3312,   79, 1104,  913, 2979, 3232, 2753,  645, 3334, 3854,
+  1271, 2284, 3883, 2872,  788, 1962,  293, 3913, 2897,  684,  407, 3992,  673,  423, 1545, 1100,
+   443, 2957, 1442, 3845, 1432, 3443, 1380, 3650, 2676, 1543, 3162, 3491, 3355,  909, 4019,  934,
+   255, 2209, 1558, 2933,  318, 3329, 3797,   21, 2966, 3655, 3530, 1426, 4073,  773,  895, 1071,
+  1506,  286, 2915, 1788, 1042, 1010, 1255, 2191, 2615, 3609, 3453,  697,  744,  834, 1616, 1717,
+  3035, 1484, 2036,  623,  958, 1403,   75, 3728,  944, 2242, 3101,   42, 1498, 1389, 3935, 3617,
+  1079, 1575, 3142,  598, 2530, 3195, 3479, 1160, 3038, 2918, 1312, 2042,   98, 2983, 3064,  663,
+  3509, 2118,  658, 3435,  379, 2447, 2819, 3647,  908, 1448, 3416, 2444, 1721,   18, 3911, 2371,
+    30,  789, 1473, 3608, 1662, 3067, 1803, 2525, 2427, 2271, 3239, 1904, 3410, 1692, 1122, 3920,
+  2088, 4032, 1385,  781, 3032, 1899,  571,  354, 2097, 2416, 3869,  274,  188, 3015, 3780, 3762,
+   967,  950,  849, 3129, 1114, 3735, 1848,  245, 3376,  691,  230, 3500, 3431,  638, 1639, 3645,
+   848, 2423, 2417, 1244,  171, 1164, 2306, 1178, 1183, 3115,  879, 3212, 4024,  451,  774, 3403,
+  2789, 2114, 3782, 3404, 3346, 3335, 1642, 2190, 2429, 3541, 1994,  385, 2367,  603,  431, 1237,
+   209, 2563, 3695, 3724, 3228, 3847, 3756,  468, 3358, 2827, 1872,  626, 3111, 1720,  973, 3936,
+  1584, 1235,  757, 3098, 1000,  335, 1496,  756, 2399, 3918, 1516, 2426, 1528, 2258, 3008, 1593,
+  3542,  380, 1837,  532, 2336, 2130, 1151, 1208, 3952, 4048, 1019, 3701, 2701, 3795, 3147, 3818,
+  1623,  330, 1856,  939, 3708, 1382, 2608, 3054, 3746, 2931, 1018, 2844,  719, 3827, 2143, 2916,
+  2986,  285, 3373,  400,  586,  978, 2472, 3455, 2817,   94, 3776, 3593, 3397,  654,  919, 3184,
+   803, 2106, 1316, 1979, 2584,  227, 2755, 4033, 2821, 2162, 1198, 3546, 1958, 3959, 2256, 3191,
+  3097, 1339, 2320, 1323,  868,  599, 2244,  710, 3274, 2310, 1577, 1435,  340, 3379, 1180, 4017,
+  2975,  807,  278, 1162, 3303, 2265, 3879, 2484, 2582, 1011, 1765, 1948, 3257, 1334, 3551, 3933,
+  3702, 3925, 2646, 1337, 3998, 3583,  280, 1563, 1508, 3287, 2431, 1223, 4067, 3719, 2286, 2279,
+  1354,  674, 3436,   47, 3167, 3871, 2450,  722, 1125, 1536,  140, 3359, 1991,  241, 2289, 2224,
+  1820, 1423,  312,  353,  478,  103, 3325, 1165, 3524, 3748, 2858, 3857, 3400, 1985, 2053, 3108,
+   862,  321,  180, 2486, 1807, 1284, 3023, 1738, 3537, 1222,  134,  266, 2159,  337, 2094,  733,
+  2095,  563, 2665, 2670, 1954, 1664, 2911,  366, 2830, 3141, 2139, 2913,  525, 3292, 3188, 1419,
+   258, 3012,  736, 2043, 1809, 1441, 3113, 2647,  115, 3321, 1204, 3932, 4061, 2659, 1966,  442,
+  2181, 3219,  215, 1802,  882, 1408, 1631, 1983, 3930,  311, 3402, 3653, 3560, 3391,  267, 1862,
+  1818, 2017, 3512, 2901, 2696, 1212, 2064,  883, 1149, 3486,  979, 2927, 3286, 1792,  393, 2906,
+  1116, 2438,  797, 1801, 2045, 3631, 3506, 2536, 3132, 1690, 3119, 2684, 1915,  709,  562, 2614,
+  1398, 1199, 2012, 1113,  249, 2754, 1201, 3076, 1973,  268, 2985, 1877, 2963, 2297, 1233, 3459,
+  3914, 1957,  761, 2561, 3859,  689, 3638,  660, 1808, 3369, 4075, 2587, 1800, 1362, 2522, 3040,
+  4071, 1698, 2689,  775, 1562, 3216,  434, 3392, 2617, 4022,  597, 2351, 2703,  304, 3929,  680,
+  3099, 2595, 3387, 3582,  854, 3586,  984, 3310, 3131,  628,  422, 1925,  802, 2745, 3844,  670,
+  2091, 2517,  605, 1298, 2706,  611, 4025,  368, 2101, 2494, 1060, 1546, 2153, 3026, 3751, 2235,
+  3856, 3803, 3043, 2743, 3718, 1447, 1829, 1822, 3237, 3146, 2160,   73, 1612, 2204, 1043,  505,
+  1790, 2721, 1052, 3793, 1026, 1892, 1650,  622,  496, 3203, 2268, 1761, 3215, 3956, 2704, 2334,
+  2189, 3634,  455,   76, 3989,  833, 1267,  169, 2548, 1092, 3010, 2835,  819, 1552, 2760, 1207,
+  3470, 1464,  139, 2501, 1073,  951, 2795, 1909, 1760, 3577,  650, 2667, 1313, 1928, 1656,  243,
+   537, 3672,  564, 3580, 1468,   77,  625, 2010,  359,  762, 3656, 1493, 2702,  918, 1732,  793,
+  2092, 2583, 2526, 2601, 1849, 3778,  539, 2291, 2951, 3284, 1618, 3441,  453, 3399, 2797, 1182,
+   838,  602, 3766, 2851, 2172, 3136, 4074,  538,  578, 2770, 1711, 2509, 2345, 2146,  142,  131,
+  3639, 2177, 1659, 1261, 2478,  636, 3684,  155, 1511, 2825, 1789, 2946, 3225,  172,  490,  190,
+    38, 1069, 2732, 3714, 1620, 3533, 1393, 3507, 2474,  310,  469, 2415, 2502, 1219, 3804, 3407,
+   681, 2767, 2454, 3709, 1502,  870, 2350, 3364, 3893,  174, 3206, 2273, 2557,  416, 3731, 1581,
+  3096, 2785, 4002, 1649, 3307, 1477, 1214, 2099, 2487,  457, 1302, 3741, 1608, 3414, 1740, 3687,
+   459, 2904, 3072,  916, 3381, 3102, 3558,  372, 2239,  232,  700,  101, 2631, 2668, 2127, 1269,
+  3955, 4001, 4049, 1358, 1251, 3938, 1343, 4063, 1474, 3947, 2243, 2221, 1482, 2705,  872, 1230,
+  1540, 2610, 2512, 1570,  901,  279,  805, 1145, 3401, 1615, 3817, 3798,  867,   40, 2952, 3615,
+  3614, 1701, 1750,  456, 3674, 3304, 2468, 3587,  124,  582, 1702, 3520, 2613, 1725, 4009, 2065,
+  1440,   52,  148,  779, 1946, 3680,  544, 2419, 3180, 2483, 1514, 1549, 1063, 3048, 2653, 4094,
+   356, 1037, 1295, 3791,  104, 3790, 2734, 3846, 3327, 3566, 3348, 1786, 2054, 3688,  147, 1795,
+   512, 3156, 1285, 2744,  641, 1670, 1735, 3415, 3259, 1347, 3450, 2385, 1842,  275, 2611,  828,
+  1622, 2200,  291, 3547, 2535, 1365,  493, 1704,  211,  541, 1119, 1663,  412, 2735, 3906, 3519,
+  1242, 2516, 1153, 2813, 2922, 3457, 3707, 3469, 3957,  873, 1121, 1895, 2041,  896,  907, 1455,
+  1665,  254, 1117, 2687, 1409, 3122,  651, 1397,  535, 1961, 2018, 3007, 3682, 2052, 3242, 3352,
+   277,  102, 3620, 1846,  339, 2998, 3160, 1501,  491, 1035, 1996, 2131, 3207,   23,  555, 3241,
+  1394, 2312, 2381, 1166, 2708, 3699,  481, 2788, 1038, 1757,  404, 2178, 3816, 1638, 2058, 2772,
+    86, 1998, 4079, 1279,  884, 1752,  445, 3867, 3370, 2294, 2939, 1391,  253, 3449, 1301, 3881,
+  1015, 1115,  369, 2877,  889, 2879,  765, 2441,  786, 1480,  871, 1009, 2956, 4046, 3432, 1300,
+  2105, 1798, 3811,  648, 3434, 1024, 2029, 3086, 1197,  246,  343,  812, 3837, 1703, 3549,  303,
+   543, 3412, 1068,  224, 2063, 3192, 2249, 2173,  560, 3458, 1023, 2482,  219, 2504, 2990, 1470,
+   365, 2102, 3982, 3754, 2832, 2882,  610, 1605, 2195,   96,  677,  891, 1254, 3117, 1836, 2360,
+   475, 2217, 3619, 3019, 2747, 3986,  898, 2354, 3739, 2973, 1084, 2829, 3418, 2972, 1646, 3224,
+  3621, 3961, 1600, 3590, 3526, 2847,  612, 1074, 2514, 1118, 3326, 3253,  817, 3654, 2607, 3635,
+   389,  426,  377,  704, 2321, 3584,  711, 2765, 3622, 2678,  595, 1309,   80, 1287, 3120, 1956,
+  3888, 1590, 3781,  182, 1668, 2079,  281,  748, 3534, 2327, 2374, 2005, 3721, 2161,  545, 1745,
+  2051, 1133, 1103, 2976, 2124, 4015, 3993, 2893, 3354, 3356, 1424, 3539, 3594, 2461, 2287, 3851,
+   527, 3810, 2410,  968,  193,   46,    0, 1456, 2978,  360, 1449, 1008, 3451, 1264, 1218, 3597,
+  1407, 1601, 3937, 1124, 3822, 2799,  473, 1970,  271, 2818, 1126, 2066,  157,  447, 1669, 2073,
+  1592, 2633, 2527, 2455,  903, 2414, 3805, 3277, 3280, 1006, 1884, 1177, 2970,  233, 3061,  688,
+  3711, 2558, 4028, 2841, 1051, 3362, 1614, 2250,  262, 3316, 3110, 2448, 2340, 3836, 3636, 1304,
+  2109, 3752, 2891, 2104, 3083,  760, 3050,  770,  642, 2257, 3556,  151,  577, 1903, 4064, 3196,
+  2748, 1555, 2771, 2764, 2192, 3510, 2928,  324, 3783, 3802, 2062, 3880, 3199,  888, 3338, 1314,
+   467, 3852,  346,  959, 1627, 2738, 2008, 2004, 4084,   14, 3478, 3984, 1486, 3939,  713,  963,
+  2505,  876, 1920, 2811, 2282, 2238, 1520, 3498, 1152, 3148,  875, 3291, 2322, 2158, 4013, 2663,
+   980, 1491,  924,  248,    3, 2855, 1857, 2920, 1554, 3489, 2395, 1632, 3912, 1429, 1129, 2739,
+  3135,  408, 2214, 3031,  885, 4036,  957,  985,   54, 3252, 2346,  580, 3169, 1077, 2377, 1047,
+  3375, 2059, 2740, 2948, 3903,  769,  508,  221, 2861, 2449,   58, 2674, 1810, 3437, 1360, 3046,
+  1887, 2974, 1099, 2015, 2446,  785,  840, 3138,  962, 2462, 3133, 3452, 1733,  203,  484, 1163,
+   122, 1805, 3005,  730, 3983, 2275, 1823,  205, 2411, 1487,  515, 3774, 3114, 2924, 2266, 1585,
+   237, 1336, 3025, 1783, 2115, 2028, 3049,  118, 3946, 1319, 3368, 2992, 3602, 1345,  411, 4053,
+  2110,  336, 1990, 2802, 3835, 1784,   83, 3062, 2023, 1262,  130,  394, 1384,  502, 1259, 2047,
+   954, 3624, 2588,   22, 2324, 2649, 1342, 1324, 1997,  716, 3363, 2103, 2298, 3991, 3864,  414,
+  3296, 1901,  433, 2489, 3300,  308,  347, 3222, 1013,   69, 3865,  763, 2643, 1048, 3270, 2534,
+  2883,  178, 3209,  345, 2725, 3353,  994, 2854,  995, 1630, 1095, 3660, 2272, 3726, 2458, 3747,
+  3347, 1234, 2585, 3374, 2392,   55,  655, 2267,  350, 1414, 2387, 3492, 1883, 3574, 2319, 1988,
+  1617, 1454, 2067, 1363, 3221, 3679, 3045, 1283,  776, 1303, 3514, 2977,  384, 2460, 1821, 2965,
+  2356, 1774, 3336,  181, 1676, 3642, 1594, 2233, 2750, 1143,  196, 1736,  419,  482,  298,   16,
+  3815, 3610, 3341,  740,  152, 3704, 1852, 1353,  953, 3696, 1878, 2934, 3529, 2479, 1553, 2964,
+   969, 1263, 3464, 3720, 1200, 3521, 3568, 2850, 2394, 2513, 1987, 3579, 2451,   34, 2208,   48,
+  1876, 1040, 2493,  317, 3814, 4060, 1525,  912, 2400, 1777, 1245,  750, 1017, 2564,  614, 1054,
+  2804,  186,  904, 2358, 2511,  629, 1707, 2761,   67,  792, 2503, 2723, 3130, 1386,  790, 3646,
+  3975,  608, 1131, 2809,  679, 1256,  357,  931, 1135,  662, 1912, 1666, 2227, 1779, 1356,  747,
+  2994, 2428,  758, 1093,  217,  591, 2874, 3218, 3177, 3917,  637,  166, 1350,  504, 2389, 1641,
+  3288, 2849, 1097, 3877,  600,  735,  855, 1081, 2507,  877, 1551, 1971, 3337,  573,  499, 1101,
+  1751, 2620, 1754, 1833,  606, 2308, 2780,  170,  683, 3308,  517, 2435,  843,  568, 2988, 2800,
+  1335,  165, 3408,  530, 2540, 1025,  576, 1159,  289, 3941,  975, 2888, 1413,   97, 3428,  114,
+  3813,   35, 1959, 3995, 4051,  207, 1277,   87, 2090, 1378, 1547,  120, 1816, 2332,  251, 2378,
+   649,  415,  574, 2881, 3365, 1686, 1179, 3444, 3742,  937, 2693, 2630, 3553, 3289, 2987, 1494,
+   458, 1719, 2982, 2621,  632,  643, 3033, 2711, 4091, 3511, 1889, 2947, 2025, 3884, 2382,  374,
+   742, 1327,  999, 1485,  866, 3422,  111, 3569, 3357, 3439, 1168,  177, 2129, 1062, 3824, 2626,
+  3897, 2876, 3475, 1150, 2680, 1228, 1936,  771, 3694, 3796, 2673, 3564, 2142, 3550,  997, 2991,
+  1589, 2403, 2960, 3948, 2424,  751, 2925, 2593, 3174, 2769, 2731, 3831, 2784,   45, 3763, 3862,
+  2329, 3186, 3179, 3616, 1070, 3866, 2599, 1390, 3863, 3189, 3945,  607, 3315, 3499, 1400, 2729,
+  1574,  179,  949, 1524,  183, 3058, 2962, 2919, 4043,  391, 1332, 3874, 2323,  235,  698, 1541,
+  2459, 2390,  783,  129, 3275, 3193,   95, 1467,  313, 1016, 3508, 1921, 1737, 3297, 3544,  718,
+  1402, 3238, 1144, 2259, 1075,  887, 1881, 1463, 2746, 1229, 1236,  886, 2480,  633, 3078,  325,
+  2412,  259, 2859,   44, 1603, 3571, 1450, 1459, 2302,  635, 4054,  791, 3261, 1466, 3648, 1724,
+  3030, 3266, 1968, 3380,  827, 1977, 1687,  970,  463, 2602, 1329, 3496, 3738, 1186, 1014, 1569,
+  1873, 3713,  448, 1993, 3902, 3009, 1749, 2125,  874, 3389,  507,  894, 1900, 1850, 1509, 2715,
+  1080, 2175, 2300, 1953, 1718, 3759,  373, 2218, 2176, 1173, 4008, 1644, 2929,  672, 3633, 3411,
+  1660,  987, 3843, 2995, 1708, 1086, 3591, 3606, 1843,  900, 2642,  668, 3340, 3330, 4047, 3916,
+   474, 3360, 2296, 2215, 3398, 1185, 1533, 3872, 3377, 2908, 1246,  439, 2942,  947, 1532,   29,
+  1427, 2941, 3962, 2842, 3094, 3737, 1565,  695, 1030, 3771, 1257, 3703, 3213, 2697,  842,  624,
+  1029,  427, 1090, 1140, 3342, 1854, 1341, 2782, 1706, 2365, 2586,  588, 2937,  326, 2341, 2730,
+  1089, 3258, 1869, 2056,  333, 3555, 3923, 3089,  676, 2049, 3210, 2773, 1457, 3725, 3940, 2660,
+  1747,  425, 1250, 2793,  284, 3211, 3691, 2604, 2197, 3681, 2999, 2397, 3301, 3848, 1396, 3055,
+   925,   92,  296, 1989, 1557, 1969, 3182, 2852, 2376, 1945, 2625,  553,  449, 2013,  810, 3245,
+  1695, 2889, 3306, 4072, 3740, 1209, 1672, 1588, 2155, 2892, 4089,  861, 1308, 3772, 1085,  500,
+  2950,  185, 1952, 3809, 3393, 3985, 2466,  618, 1430, 3806, 2281, 3480,  772, 2113, 1174, 3445,
+  4083,  225, 2050, 3717, 2679, 3204, 1963,  844, 3753, 1005, 3934, 3298, 2304, 2361, 2603, 3485,
+  3150, 4082, 3170, 2896,  487, 2307, 2664, 3371,  397, 3465, 1947, 2154,  832, 1693, 2203, 3689,
+  1028, 3002, 3139, 1111, 2724, 1811, 3557,  234, 1258,  593,  294,  518,  292, 3077, 4059, 1582,
+  1056, 3755, 1226,  853, 2409,  715, 2677,  726,  699, 3578,  820, 4087, 3839, 2166, 3017, 3272,
+   878, 1927, 3543,  202, 2098, 3236, 1561, 3819, 2637, 3561, 1764, 2026, 3548,  450, 3629, 2873,
+  2339, 1941, 4026, 2967, 2164, 2875, 2597, 2989, 2661,  252, 3641, 1001, 3618, 3159, 4041,    9,
+   960,  290, 3905, 1232, 1645,  168, 3085, 2120,  501, 1281, 1830, 2225, 1680, 3034, 1472, 2405,
+  3123, 1425, 1579,  263,  364, 3047, 2442, 1078, 3472, 1137, 1497,  466, 2590, 1726, 1840, 3882,
+  1292, 1517, 2524, 3454, 3540,  942, 2033,  100, 3715, 3249, 1930,  708, 3052, 2768,  863,  858,
+  3640, 2648, 1139, 3773, 1169,  176, 1349, 3823, 4065, 2077, 1371, 3024, 1773, 2333, 4044, 2853,
+  1976, 1034,  461, 3109, 4004, 3263, 2495, 1507, 3599, 3278, 2528,  392,   12, 2148, 3163, 2183,
+  3468, 2580, 1475, 1922, 2165,  945, 3462, 1583,  816, 2338, 1489,  720, 3825, 2199, 3515,  926,
+  2072, 2690, 2260, 1351, 1544,  804,  823, 3838,  554, 2713, 2807, 3283, 3733,  144, 4005,  462,
+  3016,  236,  644, 3692, 2549, 2184, 2384,    7, 2039,  506, 3028, 1935, 4006,  941,  105, 2141,
+  3118,  546, 3351, 2791, 3572, 2352, 1072, 2326, 2408, 1357, 3421,  239, 2762,    8,   74, 2845,
+   725,  988, 1917, 3910, 1132,  818,  777, 3438, 2556, 1730,  678, 3299, 2136, 1156, 2720, 1194,
+  3208, 3262, 1778, 2619, 1433, 2492, 3116, 2398, 2869, 2452, 2839,  575, 1352,  352, 3229, 4042,
+  3042, 1769, 3758,  692,  943,  288, 3251,  141, 2515, 1626, 2681, 1031,   70, 2618, 1655, 2570,
+   523,  516, 3264, 3908,  755, 2650, 3644, 2900, 1613,  976, 3927,  222, 1106, 1705, 2864,  216,
+  3589,  438, 2349, 1992, 3384, 2862, 1247, 1311,  880, 2949,  128,  923,   84, 3807, 2656, 2936,
+  1039,  464,  809, 1057, 1671, 2778,  460, 3157, 1653,   57, 2182, 2616, 2490, 2491,  511,  315,
+  3744, 1107, 2545,  113, 1344, 2366, 1756,  993,  639, 1512, 2145, 2401,  542, 1154, 3522, 1471,
+  3576, 1320, 1640,  850, 1094,  282,  465, 2968,  927, 2550, 3657, 1265, 3001, 2824,  146,  869,
+   556,  195, 3775, 3659, 1978,  813,  297, 1709,  342, 3178,  492, 2335,  986, 3484, 2316, 3670,
+  1102, 4093, 1661, 1148,  136, 2572, 2035, 2692, 3786, 3585,  272, 2328, 1036, 3433, 1252, 2240,
+    27, 1965, 1318, 2464, 3268,  477, 2038, 1785, 1096, 1451, 2388, 1158, 1238, 2808, 1202, 1955,
+  1445, 3915, 1266, 3367, 3044, 3021,  420, 2728, 3127, 1542, 1411, 1619, 3697, 1406, 2958, 1964,
+  3826, 3840, 1322, 3683, 3828, 2574, 3924,  520, 3279, 1461, 3588,  841, 2070, 2591, 1291, 2629,
+  3904, 1374, 2020, 3812, 2644, 2635, 1834, 2581, 3504, 3698, 2180, 4034, 1530, 3921, 1942,  305,
+  3200, 1716, 3006, 1722, 2000, 2473,   24, 2914, 2037, 1248, 1806,  276, 1844,  228, 3761, 2652,
+   981, 2523, 2921, 3168, 2944, 3361, 2510, 2961, 3125, 3003, 2898,   32,  992,  158, 2027, 2718,
+  1216, 2375, 2860, 2311,  559, 2123, 3463,  206, 2886, 1046, 1888, 3700, 1753, 2639, 1203, 2786,
+  3693, 1715, 3233,  814, 1195, 1170,  767, 2096,  497, 3112, 2040,  621, 3575, 3477, 2107, 1387,
+  2149, 2520, 2220, 2370, 2624, 1134,  265, 1694, 2060, 1853,  314, 2814, 2938,  306,    6,   78,
+  2552, 2440, 2003, 3197,  990,  753,  915, 3313, 2910, 2500, 3423, 2467, 1776, 1635, 3419,  664,
+  1469,  348, 4078, 3712, 1981, 2344, 2471, 3442,  936, 2247, 2622,  287,  405, 2573, 3390, 1934,
+  2264,   28, 2369, 4055,    1, 3973, 2331,  302, 2571, 3149, 3517, 2894, 3285, 2890, 3231, 2406,
+  2470, 2084, 2837,  370,  592, 1141, 1367, 1458, 3240, 1742, 3978, 1492, 2903, 2132, 1825,  604,
+  3765, 3175, 4058, 2080,  322, 2439, 3789, 1359,  982,  933,  184, 2309, 2529,  897, 1452, 3069,
+  2463, 1596,  798,  743, 1763,  119, 2100, 2634, 3476, 2609, 1999, 2902,   37, 1288, 1306,  386,
+  3896,  437, 1076, 1643, 1610, 1974, 1938,  727, 1217,  409, 3523, 2085, 2716, 3676,  920, 3345,
+  2121,  661, 3430, 2726,  821, 3736, 2196, 1573, 1377,   41, 1420,  859, 1723,  584,  189, 2566,
+  2372,  930, 1136, 2638, 2157, 2007, 2223,  526,   33, 3792, 3158, 3885, 1815, 3166, 2436,  581,
+  4088, 1418, 1066,  344, 1828, 1064, 1894, 3153, 1483,  198,   26, 1213, 1205, 1609,   62, 1712,
+  2252, 3037,  522, 1902, 3600, 2313, 3607, 1004, 1172, 3834, 2457, 3922, 3074, 1652, 2868,  495,
+  2532,  361, 3053, 2727, 3710, 3878, 1910, 3429, 1050, 1290, 2954, 1366, 2201, 3205, 3976, 2981,
+   723,  824, 2211, 3988,  382, 1972, 3611, 3926, 4031, 1741, 3669, 3532, 3651,  257, 4085,  567,
+  1045, 3951,   89, 2589,  996,  634,  749, 1364, 1636,  323, 1624, 1021, 1515, 2134, 4039,  175,
+   533, 1297, 2969, 1481, 3104, 2009, 3409, 2081, 2362, 1500,  890, 1787, 2248, 2623, 3958,  561,
+  3190, 3673,  572,  940, 1637, 1328, 2857,  107, 2317, 2216, 2174, 1880, 3027, 3665, 3320, 2167,
+  2241, 2425,  204, 3483,  911, 2075,  338, 3424, 3396, 1890,  378, 2151, 2848, 2348, 1155,  396,
+  1437, 4068, 2280, 1804, 3892, 2111, 3536, 4045,  156, 3057, 3223, 1629, 1731, 2519,  521, 2314,
+  3322, 3898, 3230,  801,  127, 2357, 1098, 1578, 2253, 1310, 1781,  429, 1865, 3244,  524, 2794,
+   417, 1431, 1479, 1667, 1108, 1272,  106,  488, 3502, 1280, 2544, 1188,  363, 2481,  590, 1196,
+  1931, 3997, 2815,  640,  583,  983, 3658, 1597, 3842, 3405, 1260, 2632, 2537, 1488,  746, 2011,
+   138, 2229, 1657, 3011, 3473, 3787, 2021, 2685, 2699,   25, 2955, 1886, 3227, 1766, 2756, 1112,
+  1518, 1967, 2432, 3974,  514, 2477, 1681, 3944,  729,  551,   81, 1465, 1296, 2790, 1793, 1611,
+  2443,   50,  436, 3103, 2138,  327,  991,   53,  116,  971, 2751, 1275, 2935, 4035, 3349,  226,
+   112, 2856, 3764, 1587, 3779,  355, 3226, 1845, 3994, 1762, 2001, 3084, 1476, 1689, 2551, 2234,
+  1746, 3095, 2798, 1567, 3143, 1607,  659, 3068, 2820, 2318, 1685, 3406, 3493, 4011, 1405, 1713,
+   731,  381, 2108,  444, 3570, 3382, 1812,  701, 3928, 3996, 2805, 3000,  536, 2475, 3137, 1189,
+   320, 1867,  830, 3128, 3082, 3214, 3980, 1369, 2539, 4007, 1529, 1535,   64, 2926,  486, 2228,
+  3662, 2230,  609, 2959, 4000, 3282,   63, 3723, 2843, 2709, 2014, 1395,  808, 2207, 1110, 3372,
+  4066, 1918,   68, 2147, 1373, 3505, 1192, 1404,  162,  309, 4069,   61, 3501, 3612, 3833, 2776,
+     5,  123, 3705, 3271,  852,  732,  550, 2806, 2359, 2717,  946, 2006, 3092, 3889, 2576, 1446,
+};
+
 /* clang-format on */
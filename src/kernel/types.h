@@ -126,6 +126,7 @@ enum SamplingPattern {
   SAMPLING_PATTERN_BLUE_NOISE_ROUND = 4,
   /* Never used in kernel. */
   SAMPLING_PATTERN_AUTOMATIC = 5,
+  SAMPLING_PATTERN_BLUE_NOISE_TILED = 6,
 
   SAMPLING_NUM_PATTERNS,
 };
@@ -542,6 +543,27 @@ struct Ray {
   RaySelfPrimitives self;
 };
 
+/* Stream of rays that are traced together, stored as structure of arrays. Rays in a stream are
+ * expected to be coherent, for example sharing their origin, so they visit the same BVH nodes. */
+
+#define RAY_STREAM_SIZE 8
+
+struct RayStream {
+  float P_x[RAY_STREAM_SIZE];
+  float P_y[RAY_STREAM_SIZE];
+  float P_z[RAY_STREAM_SIZE];
+  float D_x[RAY_STREAM_SIZE];
+  float D_y[RAY_STREAM_SIZE];
+  float D_z[RAY_STREAM_SIZE];
+  float tmin[RAY_STREAM_SIZE];
+  float tmax[RAY_STREAM_SIZE];
+  float time[RAY_STREAM_SIZE];
+
+  RaySelfPrimitives self[RAY_STREAM_SIZE];
+
+  int num_rays;
+};
+
 /* Intersection */
 
 struct Intersection {
@@ -1245,13 +1267,14 @@ enum KernelBVHLayout {
   BVH_LAYOUT_EMBREEGPU = (1 << 11),
   BVH_LAYOUT_MULTI_EMBREEGPU = (1 << 12),
   BVH_LAYOUT_MULTI_EMBREEGPU_EMBREE = (1 << 13),
+  BVH_LAYOUT_BVH4 = (1 << 14),
 
   /* Default BVH layout to use for CPU. */
   BVH_LAYOUT_AUTO = BVH_LAYOUT_EMBREE,
   BVH_LAYOUT_ALL = BVH_LAYOUT_BVH2 | BVH_LAYOUT_EMBREE | BVH_LAYOUT_OPTIX | BVH_LAYOUT_METAL |
                    BVH_LAYOUT_HIPRT | BVH_LAYOUT_MULTI_HIPRT | BVH_LAYOUT_MULTI_HIPRT_EMBREE |
                    BVH_LAYOUT_EMBREEGPU | BVH_LAYOUT_MULTI_EMBREEGPU |
-                   BVH_LAYOUT_MULTI_EMBREEGPU_EMBREE,
+                   BVH_LAYOUT_MULTI_EMBREEGPU_EMBREE | BVH_LAYOUT_BVH4,
 };
 
 /* Specialized struct that can become constants in dynamic compilation. */
@@ -1385,6 +1408,10 @@ struct KernelObject {
   uint receiver_light_set;
   uint64_t shadow_set_membership;
   uint blocker_shadow_set;
+
+  /* Start of the shaders of this object in the object constant shaders table, or -1 if it has no
+   * object constants. */
+  int shader_constants_offset;
 };
 static_assert_align(KernelObject, 16);
 
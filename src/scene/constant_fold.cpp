@@ -12,8 +12,9 @@ CCL_NAMESPACE_BEGIN
 ConstantFolder::ConstantFolder(ShaderGraph *graph,
                                ShaderNode *node,
                                ShaderOutput *output,
-                               Scene *scene)
-    : graph(graph), node(node), output(output), scene(scene)
+                               Scene *scene,
+                               float3 *result)
+    : graph(graph), node(node), output(output), scene(scene), result(result), has_result(false)
 {
 }
 
@@ -30,6 +31,12 @@ bool ConstantFolder::all_inputs_constant() const
 
 void ConstantFolder::make_constant(const float value) const
 {
+  if (result) {
+    *result = make_float3(value);
+    has_result = true;
+    return;
+  }
+
   LOG_TRACE << "Folding " << node->name << "::" << output->name() << " to constant (" << value
             << ").";
 
@@ -43,6 +50,12 @@ void ConstantFolder::make_constant(const float value) const
 
 void ConstantFolder::make_constant(const float3 value) const
 {
+  if (result) {
+    *result = value;
+    has_result = true;
+    return;
+  }
+
   LOG_TRACE << "Folding " << node->name << "::" << output->name() << " to constant " << value
             << ".";
 
@@ -56,6 +69,12 @@ void ConstantFolder::make_constant(const float3 value) const
 
 void ConstantFolder::make_constant(const int value) const
 {
+  if (result) {
+    *result = make_float3(float(value));
+    has_result = true;
+    return;
+  }
+
   LOG_TRACE << "Folding " << node->name << "::" << output->name() << " to constant (" << value
             << ").";
 
@@ -113,6 +132,10 @@ void ConstantFolder::bypass(ShaderOutput *new_output) const
 {
   assert(new_output);
 
+  if (result) {
+    return;
+  }
+
   LOG_TRACE << "Folding " << node->name << "::" << output->name() << " to socket "
             << new_output->parent->name << "::" << new_output->name() << ".";
 
@@ -132,6 +155,10 @@ void ConstantFolder::discard() const
 {
   assert(output->type() == SocketType::CLOSURE);
 
+  if (result) {
+    return;
+  }
+
   LOG_TRACE << "Discarding closure " << node->name << ".";
 
   graph->disconnect(output);
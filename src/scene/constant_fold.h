@@ -23,7 +23,16 @@ class ConstantFolder {
 
   Scene *scene;
 
-  ConstantFolder(ShaderGraph *graph, ShaderNode *node, ShaderOutput *output, Scene *scene);
+  /* When set, the constant value of the output is written here instead of being folded into the
+   * graph, to evaluate nodes outside of the graph. Other changes to the graph are skipped. */
+  float3 *const result;
+  mutable bool has_result;
+
+  ConstantFolder(ShaderGraph *graph,
+                 ShaderNode *node,
+                 ShaderOutput *output,
+                 Scene *scene,
+                 float3 *result = nullptr);
 
   bool all_inputs_constant() const;
 
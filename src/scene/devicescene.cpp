@@ -30,6 +30,8 @@ DeviceScene::DeviceScene(Device *device)
       object_motion(device, "object_motion", MEM_GLOBAL),
       object_flag(device, "object_flag", MEM_GLOBAL),
       object_prim_offset(device, "object_prim_offset", MEM_GLOBAL),
+      object_constant_shaders(device, "object_constant_shaders", MEM_GLOBAL),
+      object_constants(device, "object_constants", MEM_GLOBAL),
       camera_motion(device, "camera_motion", MEM_GLOBAL),
       attributes_map(device, "attributes_map", MEM_GLOBAL),
       attributes_float(device, "attributes_float", MEM_GLOBAL),
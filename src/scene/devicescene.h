@@ -44,6 +44,8 @@ class DeviceScene {
   device_vector<DecomposedTransform> object_motion;
   device_vector<uint> object_flag;
   device_vector<uint> object_prim_offset;
+  device_vector<uint> object_constant_shaders;
+  device_vector<float4> object_constants;
 
   /* cameras */
   device_vector<DecomposedTransform> camera_motion;
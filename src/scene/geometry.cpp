@@ -992,6 +992,8 @@ void GeometryManager::device_update(Device *device,
    * change. */
   bool need_update_scene_bvh = (scene->bvh == nullptr ||
                                 (update_flags & (TRANSFORM_MODIFIED | VISIBILITY_MODIFIED)) != 0);
+  /* Whether primitives of the scene BVH changed, so it can not be refit. */
+  bool need_rebuild_scene_bvh = false;
   {
     const scoped_callback_timer timer([scene](double time) {
       if (scene->update_stats) {
@@ -1004,6 +1006,7 @@ void GeometryManager::device_update(Device *device,
     for (Geometry *geom : scene->geometry) {
       if (geom->is_modified() || geom->need_update_bvh_for_offset) {
         need_update_scene_bvh = true;
+        need_rebuild_scene_bvh |= geom->need_update_rebuild || geom->need_update_bvh_for_offset;
 
         if (geom->need_build_bvh(bvh_layout)) {
           i++;
@@ -1055,7 +1058,7 @@ void GeometryManager::device_update(Device *device,
         scene->update_stats->geometry.times.add_entry({"device_update (build scene BVH)", time});
       }
     });
-    device_update_bvh(device, dscene, scene, progress);
+    device_update_bvh(device, dscene, scene, need_rebuild_scene_bvh, progress);
     if (progress.get_cancel()) {
       return;
     }
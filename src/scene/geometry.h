@@ -290,7 +290,11 @@ class GeometryManager {
                                 Scene *scene,
                                 Progress &progress);
 
-  void device_update_bvh(Device *device, DeviceScene *dscene, Scene *scene, Progress &progress);
+  void device_update_bvh(Device *device,
+                         DeviceScene *dscene,
+                         Scene *scene,
+                         const bool need_rebuild,
+                         Progress &progress);
 
   void device_update_displacement_images(Device *device, Scene *scene, Progress &progress);
 
@@ -77,6 +77,7 @@ void Geometry::compute_bvh(Device *device,
       bparams.bvh_layout = bvh_layout;
       bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                     params->use_bvh_unaligned_nodes;
+      bparams.use_quantized_nodes = params->use_bvh_quantized_nodes;
       bparams.num_motion_triangle_steps = params->num_bvh_time_steps;
       bparams.num_motion_curve_steps = params->num_bvh_time_steps;
       bparams.num_motion_point_steps = params->num_bvh_time_steps;
@@ -95,6 +96,7 @@ void Geometry::compute_bvh(Device *device,
 void GeometryManager::device_update_bvh(Device *device,
                                         DeviceScene *dscene,
                                         Scene *scene,
+                                        const bool need_rebuild,
                                         Progress &progress)
 {
   /* bvh build */
@@ -107,6 +109,7 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.use_spatial_split = scene->params.use_bvh_spatial_split;
   bparams.use_unaligned_nodes = dscene->data.bvh.have_curves &&
                                 scene->params.use_bvh_unaligned_nodes;
+  bparams.use_quantized_nodes = scene->params.use_bvh_quantized_nodes;
   bparams.num_motion_triangle_steps = scene->params.num_bvh_time_steps;
   bparams.num_motion_curve_steps = scene->params.num_bvh_time_steps;
   bparams.num_motion_point_steps = scene->params.num_bvh_time_steps;
@@ -115,9 +118,16 @@ void GeometryManager::device_update_bvh(Device *device,
 
   LOG_INFO << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
+  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2 ||
+                                 bparams.bvh_layout == BVH_LAYOUT_BVH4);
+
+  /* BVH2 refits the top level when it still references the same primitives, merging in the
+   * instance BVHs again. It rebuilds by itself when refitting degraded the tree too much. */
   const bool can_refit = scene->bvh != nullptr && scene->params.bvh_type == BVH_TYPE_DYNAMIC &&
                          (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX ||
-                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL);
+                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL ||
+                          (has_bvh2_layout && !need_rebuild &&
+                           scene->bvh->params.bvh_layout == bparams.bvh_layout));
 
   BVH *bvh = scene->bvh.get();
   if (bvh == nullptr) {
@@ -131,11 +141,11 @@ void GeometryManager::device_update_bvh(Device *device,
     return;
   }
 
-  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
-
   PackedBVH pack;
   if (has_bvh2_layout) {
-    pack = std::move(static_cast<BVH2 *>(bvh)->pack);
+    /* Keep the top level part for refitting on the next update, the instance BVHs are merged
+     * in again then. */
+    pack = static_cast<BVH2 *>(bvh)->take_pack(scene->params.bvh_type == BVH_TYPE_DYNAMIC);
   }
   else {
     pack.root_index = -1;
@@ -181,6 +191,7 @@ void GeometryManager::device_update_bvh(Device *device,
   }
 
   dscene->data.bvh.root = pack.root_index;
+  dscene->data.bvh.use_quantized_nodes = has_bvh2_layout && bvh->params.use_quantized_nodes;
   dscene->data.bvh.use_bvh_steps = (scene->params.num_bvh_time_steps != 0);
   dscene->data.bvh.curve_subdivisions = scene->params.curve_subdivisions();
 
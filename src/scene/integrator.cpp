@@ -61,6 +61,7 @@ NODE_DEFINE(Integrator)
   SOCKET_BOOLEAN(volume_ray_marching, "Biased", false);
   SOCKET_INT(volume_max_steps, "Volume Max Steps", 1024);
   SOCKET_FLOAT(volume_step_rate, "Volume Step Rate", 1.0f);
+  SOCKET_BOOLEAN(volume_fast, "Volume Fast", false);
 
   static NodeEnum guiding_distribution_enum;
   guiding_distribution_enum.insert("PARALLAX_AWARE_VMM", GUIDING_TYPE_PARALLAX_AWARE_VMM);
@@ -127,6 +128,7 @@ NODE_DEFINE(Integrator)
   sampling_pattern_enum.insert("blue_noise_pure", SAMPLING_PATTERN_BLUE_NOISE_PURE);
   sampling_pattern_enum.insert("blue_noise_round", SAMPLING_PATTERN_BLUE_NOISE_ROUND);
   sampling_pattern_enum.insert("blue_noise_first", SAMPLING_PATTERN_BLUE_NOISE_FIRST);
+  sampling_pattern_enum.insert("blue_noise_tiled", SAMPLING_PATTERN_BLUE_NOISE_TILED);
   SOCKET_ENUM(sampling_pattern,
               "Sampling Pattern",
               sampling_pattern_enum,
@@ -234,6 +236,8 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
 
   kintegrator->volume_ray_marching = volume_ray_marching;
   kintegrator->volume_max_steps = volume_max_steps;
+  /* The fast integrator relies on the octree, which is not built for ray marching. */
+  kintegrator->volume_fast = volume_fast && !volume_ray_marching;
 
   kintegrator->caustics_reflective = caustics_reflective;
   kintegrator->caustics_refractive = caustics_refractive;
@@ -302,9 +306,11 @@ void Integrator::device_update(Device *device, DeviceScene *dscene, Scene *scene
   }
 
   /* The blue-noise sampler needs a randomized seed to scramble properly, providing e.g. 0 won't
-   * work properly. Therefore, hash the seed in those cases. */
+   * work properly. Therefore, hash the seed in those cases. The tiled pattern uses it to offset
+   * the tile, which should also differ between consecutive seeds. */
   if (kintegrator->sampling_pattern == SAMPLING_PATTERN_BLUE_NOISE_FIRST ||
-      kintegrator->sampling_pattern == SAMPLING_PATTERN_BLUE_NOISE_PURE)
+      kintegrator->sampling_pattern == SAMPLING_PATTERN_BLUE_NOISE_PURE ||
+      kintegrator->sampling_pattern == SAMPLING_PATTERN_BLUE_NOISE_TILED)
   {
     kintegrator->seed = hash_uint(seed);
   }
@@ -44,6 +44,8 @@ class Integrator : public Node {
   NODE_SOCKET_API(bool, volume_ray_marching)
   NODE_SOCKET_API(int, volume_max_steps)
   NODE_SOCKET_API(float, volume_step_rate)
+  /* Volume-only emission, absorption and single scattering on the CPU, for visualization. */
+  NODE_SOCKET_API(bool, volume_fast)
 
   NODE_SOCKET_API(bool, use_guiding);
   NODE_SOCKET_API(bool, deterministic_guiding);
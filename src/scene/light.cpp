@@ -492,6 +492,8 @@ LightManager::LightManager()
   last_background_resolution = 0;
 }
 
+LightManager::~LightManager() = default;
+
 bool LightManager::has_background_light(Scene *scene)
 {
   for (Object *object : scene->objects) {
@@ -1057,48 +1059,59 @@ void LightManager::device_update_tree(Device * /*unused*/,
   KernelIntegrator *kintegrator = &dscene->data.integrator;
 
   if (!kintegrator->use_light_tree) {
+    light_tree.reset();
     return;
   }
 
   /* Update light tree. */
   progress.set_status("Updating Lights", "Computing tree");
 
-  /* TODO: For now, we'll start with a smaller number of max lights in a node.
-   * More benchmarking is needed to determine what number works best. */
-  LightTree light_tree(scene, dscene, progress, 8);
-  LightTreeNode *root = light_tree.build(scene, dscene);
+  /* Refit the tree of the previous update when only lights and emissive objects were modified,
+   * for example when moving them interactively. */
+  const uint32_t refit_flags = LIGHT_MODIFIED | EMISSIVE_OBJECT_MODIFIED | OBJECT_MANAGER;
+  LightTreeNode *root;
+  if (light_tree && !(update_flags & ~refit_flags) && light_tree->refit(scene, dscene, progress)) {
+    root = light_tree->get_root();
+  }
+  else {
+    /* TODO: For now, we'll start with a smaller number of max lights in a node.
+     * More benchmarking is needed to determine what number works best. */
+    light_tree = make_unique<LightTree>(scene, dscene, progress, 8);
+    root = light_tree->build(scene, dscene);
+  }
   if (progress.get_cancel()) {
+    light_tree.reset();
     return;
   }
 
   /* Create arguments for recursive tree flatten. */
   LightTreeFlatten flatten;
   flatten.scene = scene;
-  flatten.emitters = light_tree.get_emitters();
+  flatten.emitters = light_tree->get_emitters();
   flatten.object_lookup_offset = dscene->object_lookup_offset.data();
   /* We want to create separate arrays corresponding to triangles and lights,
    * which will be used to index back into the light tree for PDF calculations. */
   flatten.light_array = dscene->light_to_tree.alloc(scene->objects.size());
-  flatten.triangle_array = dscene->triangle_to_tree.alloc(light_tree.num_triangles);
+  flatten.triangle_array = dscene->triangle_to_tree.alloc(light_tree->num_triangles);
 
   /* Allocate emitters */
-  const size_t num_emitters = light_tree.num_emitters();
+  const size_t num_emitters = light_tree->num_emitters();
   KernelLightTreeEmitter *kemitters = dscene->light_tree_emitters.alloc(num_emitters);
 
   /* Update integrator state. */
   kintegrator->use_direct_light = num_emitters > 0;
 
   /* Test if light linking is used. */
-  const bool use_light_linking = root && (light_tree.light_link_receiver_used != 1);
+  const bool use_light_linking = root && (light_tree->light_link_receiver_used != 1);
   KernelLightLinkSet *klight_link_sets = dscene->data.light_link_sets;
   memset(klight_link_sets, 0, sizeof(dscene->data.light_link_sets));
 
-  LOG_INFO << "Use light tree with " << num_emitters << " emitters and " << light_tree.num_nodes
+  LOG_INFO << "Use light tree with " << num_emitters << " emitters and " << light_tree->num_nodes
            << " nodes.";
 
   if (!use_light_linking) {
     /* Regular light tree without linking. */
-    KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(light_tree.num_nodes);
+    KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(light_tree->num_nodes);
 
     if (root) {
       int next_node_index = 0;
@@ -1114,7 +1127,7 @@ void LightManager::device_update_tree(Device * /*unused*/,
     if (root) {
       /* Reserve enough size of all instance subtrees, then shrink back to
        * actual number of nodes used. */
-      light_link_nodes.resize(light_tree.num_nodes);
+      light_link_nodes.resize(light_tree->num_nodes);
       light_tree_emitters_copy_and_flatten(
           flatten, root, light_link_nodes.data(), kemitters, next_node_index);
       light_link_nodes.resize(next_node_index);
@@ -1123,7 +1136,7 @@ void LightManager::device_update_tree(Device * /*unused*/,
     /* Specialized light trees for linking. */
     for (uint64_t tree_index = 0; tree_index < LIGHT_LINK_SET_MAX; tree_index++) {
       const uint64_t tree_mask = uint64_t(1) << tree_index;
-      if (!(light_tree.light_link_receiver_used & tree_mask)) {
+      if (!(light_tree->light_link_receiver_used & tree_mask)) {
         continue;
       }
 
@@ -1140,7 +1153,7 @@ void LightManager::device_update_tree(Device * /*unused*/,
     memcpy(knodes, light_link_nodes.data(), light_link_nodes.size() * sizeof(*knodes));
 
     LOG_INFO << "Specialized light tree for light linking, with "
-             << light_link_nodes.size() - light_tree.num_nodes << " additional nodes.";
+             << light_link_nodes.size() - light_tree->num_nodes << " additional nodes.";
   }
 
   /* Copy arrays to device. */
@@ -20,6 +20,7 @@ CCL_NAMESPACE_BEGIN
 
 class Device;
 class DeviceScene;
+class LightTree;
 class Object;
 class Progress;
 class Scene;
@@ -194,6 +195,7 @@ class LightManager {
     OBJECT_MANAGER = (1 << 5),
     SHADER_COMPILED = (1 << 6),
     SHADER_MODIFIED = (1 << 7),
+    EMISSIVE_OBJECT_MODIFIED = (1 << 8),
 
     /* tag everything in the manager for an update */
     UPDATE_ALL = ~0u,
@@ -205,6 +207,7 @@ class LightManager {
   bool need_update_background;
 
   LightManager();
+  ~LightManager();
 
   /* IES texture management */
   int add_ies(const string &content);
@@ -255,6 +258,10 @@ class LightManager {
   int last_background_resolution;
 
   uint32_t update_flags;
+
+  /* Light tree of the previous update, refit instead of built again when only lights and
+   * emissive objects were modified. */
+  unique_ptr<LightTree> light_tree;
 };
 
 CCL_NAMESPACE_END
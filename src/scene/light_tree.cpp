@@ -279,44 +279,38 @@ LightTree::LightTree(Scene *scene,
                      DeviceScene *dscene,
                      Progress &progress,
                      const uint max_lights_in_leaf)
-    : progress_(progress), max_lights_in_leaf_(max_lights_in_leaf)
+    : progress_(&progress), max_lights_in_leaf_(max_lights_in_leaf)
 {
   KernelIntegrator *kintegrator = &dscene->data.integrator;
 
   local_lights_.reserve(kintegrator->num_lights - kintegrator->num_distant_lights);
   distant_lights_.reserve(kintegrator->num_distant_lights);
 
+  collect_scene_emitters(scene, scene_emitters_);
+
   /* When we keep track of the light index, only contributing lights will be added to the device.
    * Therefore, we want to keep track of the light's index on the device.
    * However, we also need the light's index in the scene when we're constructing the tree. */
   int device_light_index = 0;
-  for (Object *object : scene->objects) {
-    if (progress_.get_cancel()) {
+  for (const SceneEmitter &scene_emitter : scene_emitters_) {
+    if (progress_->get_cancel()) {
       return;
     }
 
-    if (object->get_geometry()->is_light()) {
+    if (scene_emitter.geometry->is_light()) {
       /* Regular lights. */
-      Light *light = static_cast<Light *>(object->get_geometry());
-      if (light->is_enabled) {
-        if (light->is_distant_light()) {
-          distant_lights_.emplace_back(scene, ~device_light_index, object->index);
-        }
-        else {
-          local_lights_.emplace_back(scene, ~device_light_index, object->index);
-        }
-
-        device_light_index++;
+      if (scene_emitter.is_distant) {
+        distant_lights_.emplace_back(scene, ~device_light_index, scene_emitter.object_id);
+      }
+      else {
+        local_lights_.emplace_back(scene, ~device_light_index, scene_emitter.object_id);
       }
+
+      device_light_index++;
     }
     else {
       /* Emissive triangles. */
-      light_link_receiver_used |= (uint64_t(1) << object->get_receiver_light_set());
-
-      if (!object->usable_as_light()) {
-        continue;
-      }
-
+      Object *object = scene->objects[scene_emitter.object_id];
       mesh_lights_.emplace_back(object, object->index);
 
       /* Only count unique meshes. */
@@ -330,6 +324,52 @@ LightTree::LightTree(Scene *scene,
   }
 }
 
+void LightTree::collect_scene_emitters(Scene *scene, vector<SceneEmitter> &scene_emitters)
+{
+  for (Object *object : scene->objects) {
+    Geometry *geometry = object->get_geometry();
+    if (geometry->is_light()) {
+      Light *light = static_cast<Light *>(geometry);
+      if (light->is_enabled) {
+        scene_emitters.push_back({object, geometry, object->index, light->is_distant_light()});
+      }
+    }
+    else {
+      light_link_receiver_used |= (uint64_t(1) << object->get_receiver_light_set());
+
+      if (object->usable_as_light()) {
+        scene_emitters.push_back({object, geometry, object->index, false});
+      }
+    }
+  }
+}
+
+LightTreeMeasure LightTree::mesh_measure(Scene *scene, const int object_id)
+{
+  Object *object = scene->objects[object_id];
+  Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
+  LightTreeMeasure measure = mesh_measures_.find(mesh)->second;
+
+  /* Transform measure. The measure is only directly transformable if the transformation has
+   * uniform scaling, otherwise recount all the triangles in the mesh with transformation. */
+  /* NOTE: in theory only energy needs recalculating: #bbox is available via `object->bounds`,
+   * transformation of #bcone is possible. However, the computation involves eigendecomposition
+   * and solving a cubic equation (https://doi.org/10.1016/j.nima.2009.11.075 section 3.4), then
+   * the angle is derived from the major axis of the resulted right elliptic cone's base, which
+   * can be an overestimation. */
+  if (!mesh->transform_applied && !measure.transform(object->get_tfm())) {
+    measure.reset();
+    size_t const mesh_num_triangles = mesh->num_triangles();
+    for (size_t i = 0; i < mesh_num_triangles; i++) {
+      if (triangle_usable_as_light(mesh, i)) {
+        measure.add(LightTreeEmitter(scene, i, object_id, true).measure);
+      }
+    }
+  }
+
+  return measure;
+}
+
 LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
 {
   if (local_lights_.empty() && distant_lights_.empty() && mesh_lights_.empty()) {
@@ -374,30 +414,13 @@ LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
   });
   task_pool.wait_work();
 
+  for (const auto &map_it : unique_mesh) {
+    mesh_measures_[map_it.first] = std::get<0>(map_it.second)->measure;
+  }
+
   /* Update measure. */
   parallel_for_each(mesh_lights_, [&](LightTreeEmitter &emitter) {
-    Object *object = scene->objects[emitter.object_id];
-    Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
-
-    LightTreeNode *reference = std::get<0>(unique_mesh.find(mesh)->second);
-    emitter.measure = emitter.root->measure = reference->measure;
-
-    /* Transform measure. The measure is only directly transformable if the transformation has
-     * uniform scaling, otherwise recount all the triangles in the mesh with transformation. */
-    /* NOTE: in theory only energy needs recalculating: #bbox is available via `object->bounds`,
-     * transformation of #bcone is possible. However, the computation involves eigendecomposition
-     * and solving a cubic equation (https://doi.org/10.1016/j.nima.2009.11.075 section 3.4), then
-     * the angle is derived from the major axis of the resulted right elliptic cone's base, which
-     * can be an overestimation. */
-    if (!mesh->transform_applied && !emitter.measure.transform(object->get_tfm())) {
-      emitter.measure.reset();
-      size_t const mesh_num_triangles = mesh->num_triangles();
-      for (size_t i = 0; i < mesh_num_triangles; i++) {
-        if (triangle_usable_as_light(mesh, i)) {
-          emitter.measure.add(LightTreeEmitter(scene, i, emitter.object_id, true).measure);
-        }
-      }
-    }
+    emitter.measure = mesh_measure(scene, emitter.object_id);
   });
 
   for (LightTreeEmitter &emitter : mesh_lights_) {
@@ -418,7 +441,7 @@ LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
       left, root_.get(), num_emissive_triangles, num_local_lights, emitters_.data(), 0, 1);
   task_pool.wait_work();
 
-  if (progress_.get_cancel()) {
+  if (progress_->get_cancel()) {
     root_.reset();
     return nullptr;
   }
@@ -444,9 +467,199 @@ LightTreeNode *LightTree::build(Scene *scene, DeviceScene *dscene)
 
   std::move(distant_lights_.begin(), distant_lights_.end(), std::back_inserter(emitters_));
 
+  record_build_cost(root_->get_inner().children[left].get());
+
   return root_.get();
 }
 
+/* Rebuild a subtree of the top level tree when refitting made its cost this much higher than
+ * when it was built. */
+static const float light_tree_refit_max_cost_ratio = 2.0f;
+
+/* Cost of a node independent of the energy of its emitters, so that changing the strength of
+ * lights does not trigger rebuilds. */
+static float light_tree_node_cost(LightTreeMeasure measure)
+{
+  return measure.is_zero() ? 0.0f : measure.calculate() / measure.energy;
+}
+
+static int light_tree_num_nodes(const LightTreeNode *node)
+{
+  if (!node->is_inner()) {
+    return 1;
+  }
+  return 1 + light_tree_num_nodes(node->get_inner().children[LightTree::left].get()) +
+         light_tree_num_nodes(node->get_inner().children[LightTree::right].get());
+}
+
+/* Range of the emitters in the subtree, which are consecutive. */
+static void light_tree_emitter_range(const LightTreeNode *node, int &start, int &end)
+{
+  const LightTreeNode *first = node;
+  while (first->is_inner()) {
+    first = first->get_inner().children[LightTree::left].get();
+  }
+  const LightTreeNode *last = node;
+  while (last->is_inner()) {
+    last = last->get_inner().children[LightTree::right].get();
+  }
+  start = first->get_leaf().first_emitter_index;
+  end = last->get_leaf().first_emitter_index + last->get_leaf().num_emitters;
+}
+
+void LightTree::record_build_cost(LightTreeNode *node)
+{
+  if (!node->is_inner()) {
+    return;
+  }
+  if (node->build_cost < 0.0f) {
+    node->build_cost = light_tree_node_cost(node->measure);
+  }
+  record_build_cost(node->get_inner().children[left].get());
+  record_build_cost(node->get_inner().children[right].get());
+}
+
+void LightTree::refit_node(LightTreeNode *node)
+{
+  /* Reset the node index written when specializing the tree for light linking. */
+  node->light_link.shared_node_index = -1;
+
+  if (node->is_inner()) {
+    LightTreeNode *left_node = node->get_inner().children[left].get();
+    LightTreeNode *right_node = node->get_inner().children[right].get();
+    refit_node(left_node);
+    refit_node(right_node);
+    node->measure = left_node->measure + right_node->measure;
+    return;
+  }
+
+  const LightTreeNode::Leaf &leaf = node->get_leaf();
+  node->measure.reset();
+  for (int i = 0; i < leaf.num_emitters; i++) {
+    node->measure.add(emitters_[leaf.first_emitter_index + i].measure);
+  }
+}
+
+void LightTree::refit_rebuild(LightTreeNode *node, const int depth)
+{
+  if (!node->is_inner() || progress_->get_cancel()) {
+    return;
+  }
+
+  if (node->build_cost >= 0.0f &&
+      light_tree_node_cost(node->measure) > node->build_cost * light_tree_refit_max_cost_ratio)
+  {
+    int start;
+    int end;
+    light_tree_emitter_range(node, start, end);
+
+    /* The node itself is reused. */
+    num_nodes -= light_tree_num_nodes(node) - 1;
+    node->build_cost = -1.0f;
+    recursive_build(self, node, start, end, emitters_.data(), node->bit_trail, depth);
+    return;
+  }
+
+  refit_rebuild(node->get_inner().children[left].get(), depth + 1);
+  refit_rebuild(node->get_inner().children[right].get(), depth + 1);
+}
+
+bool LightTree::refit(Scene *scene, DeviceScene *dscene, Progress &progress)
+{
+  progress_ = &progress;
+
+  if (!root_) {
+    return false;
+  }
+
+  /* Only the measure of the emitters may change, the emitters themselves must be the same. */
+  const uint64_t prev_light_link_receiver_used = light_link_receiver_used;
+  vector<SceneEmitter> scene_emitters;
+  collect_scene_emitters(scene, scene_emitters);
+  if (!(scene_emitters == scene_emitters_) ||
+      light_link_receiver_used != prev_light_link_receiver_used)
+  {
+    return false;
+  }
+
+  /* Flattening moves the subtree of an instanced mesh to the first instance it visits, point the
+   * other instances to that one again. */
+  std::unordered_map<const Geometry *, LightTreeNode *> mesh_roots;
+  for (LightTreeEmitter &emitter : emitters_) {
+    if (emitter.is_mesh() &&
+        !std::holds_alternative<LightTreeNode::Instance>(emitter.root->variant_type))
+    {
+      mesh_roots[scene->objects[emitter.object_id]->get_geometry()] = emitter.root.get();
+    }
+  }
+  for (LightTreeEmitter &emitter : emitters_) {
+    if (emitter.is_mesh()) {
+      LightTreeNode *reference = mesh_roots[scene->objects[emitter.object_id]->get_geometry()];
+      if (emitter.root.get() == reference) {
+        reference->type |= LIGHT_TREE_INSTANCE;
+      }
+      else {
+        emitter.root->make_instance(reference, emitter.object_id);
+      }
+    }
+  }
+
+  /* Update the measure of lights and mesh lights. The triangles and the subtrees of the meshes are
+   * in object space and stay valid. */
+  std::atomic<bool> light_link_modified = false;
+  parallel_for_each(emitters_, [&](LightTreeEmitter &emitter) {
+    if (emitter.is_triangle()) {
+      return;
+    }
+
+    uint64_t light_set_membership;
+    if (emitter.is_mesh()) {
+      Object *object = scene->objects[emitter.object_id];
+      emitter.measure = emitter.root->measure = mesh_measure(scene, emitter.object_id);
+      emitter.centroid = object->bounds.center();
+      light_set_membership = object->get_light_set_membership();
+    }
+    else {
+      const LightTreeEmitter light(scene, emitter.prim_id, emitter.object_id);
+      emitter.measure = light.measure;
+      emitter.centroid = light.centroid;
+      light_set_membership = light.light_set_membership;
+    }
+
+    if (light_set_membership != emitter.light_set_membership) {
+      light_link_modified = true;
+    }
+  });
+
+  if (light_link_modified) {
+    return false;
+  }
+
+  /* Refit the top level tree, then build again the subtrees that degraded too much. The distant
+   * lights are in a single leaf and only need to be refit. */
+  refit_node(root_.get());
+  refit_rebuild(root_->get_inner().children[left].get(), 1);
+  task_pool.wait_work();
+
+  if (progress_->get_cancel()) {
+    return false;
+  }
+
+  root_->measure = root_->get_inner().children[left]->measure +
+                   root_->get_inner().children[right]->measure;
+  record_build_cost(root_->get_inner().children[left].get());
+
+  uint *object_offsets = dscene->object_lookup_offset.alloc(scene->objects.size());
+  for (const LightTreeEmitter &emitter : emitters_) {
+    if (emitter.is_mesh()) {
+      Mesh *mesh = static_cast<Mesh *>(scene->objects[emitter.object_id]->get_geometry());
+      object_offsets[emitter.object_id] = offset_map_[mesh];
+    }
+  }
+
+  return true;
+}
+
 void LightTree::recursive_build(const Child child,
                                 LightTreeNode *inner,
                                 const int start,
@@ -455,7 +668,7 @@ void LightTree::recursive_build(const Child child,
                                 const uint bit_trail,
                                 const int depth)
 {
-  if (progress_.get_cancel()) {
+  if (progress_->get_cancel()) {
     return;
   }
 
@@ -511,6 +724,31 @@ void LightTree::recursive_build(const Child child,
   }
 }
 
+/* Buckets of the emitters along every dimension. */
+using LightTreeBuckets = std::array<std::array<LightTreeBucket, LightTreeBucket::num_buckets>, 3>;
+
+static void fill_buckets(const LightTreeEmitter *emitters,
+                         const int start,
+                         const int end,
+                         const BoundBox &centroid_bbox,
+                         const float3 inv_extent,
+                         LightTreeBuckets &buckets)
+{
+  for (int i = start; i < end; i++) {
+    const LightTreeEmitter *emitter = emitters + i;
+
+    for (int dim = 0; dim < 3; dim++) {
+      /* Place emitter into the appropriate bucket, where the centroid box is split into equal
+       * partitions. */
+      int bucket_idx = LightTreeBucket::num_buckets *
+                       (emitter->centroid[dim] - centroid_bbox.min[dim]) * inv_extent[dim];
+      bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
+
+      buckets[dim][bucket_idx].add(*emitter);
+    }
+  }
+}
+
 bool LightTree::should_split(LightTreeEmitter *emitters,
                              const int start,
                              int &middle,
@@ -531,61 +769,89 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
 
   middle = (start + end) / 2;
 
+  /* Large nodes are processed in blocks of emitters in parallel. The results of the blocks are
+   * merged in order, so the tree does not depend on the scheduling of the threads. */
+  const bool use_parallel = num_emitters >= MIN_EMITTERS_PARALLEL_SPLIT;
+  const int num_blocks = divide_up(num_emitters, SPLIT_BLOCK_SIZE);
+  auto for_each_block = [&](const auto &func) {
+    parallel_for(blocked_range<int>(0, num_blocks, 1), [&](const blocked_range<int> &r) {
+      for (int block = r.begin(); block < r.end(); block++) {
+        const int block_start = start + block * SPLIT_BLOCK_SIZE;
+        func(block, block_start, min(block_start + SPLIT_BLOCK_SIZE, end));
+      }
+    });
+  };
+
   BoundBox centroid_bbox = BoundBox::empty;
-  for (int i = start; i < end; i++) {
-    centroid_bbox.grow((emitters + i)->centroid);
+  if (use_parallel) {
+    vector<BoundBox> block_bbox(num_blocks, BoundBox::empty);
+    for_each_block([&](const int block, const int block_start, const int block_end) {
+      for (int i = block_start; i < block_end; i++) {
+        block_bbox[block].grow(emitters[i].centroid);
+      }
+    });
+    for (const BoundBox &bbox : block_bbox) {
+      centroid_bbox.grow(bbox);
+    }
+  }
+  else {
+    for (int i = start; i < end; i++) {
+      centroid_bbox.grow((emitters + i)->centroid);
+    }
   }
 
   const float3 extent = centroid_bbox.size();
   const float max_extent = max4(extent.x, extent.y, extent.z, 0.0f);
 
-  /* Check each dimension to find the minimum splitting cost. */
-  float total_cost = 0.0f;
-  float min_cost = FLT_MAX;
+  /* Fill in buckets with emitters, for all dimensions in one pass. In the degenerate case of a
+   * zero size along a dimension everything ends up in the first bucket. */
+  float3 inv_extent;
   for (int dim = 0; dim < 3; dim++) {
-    std::array<LightTreeBucket, LightTreeBucket::num_buckets> buckets;
-    float inv_extent;
-
-    if (centroid_bbox.size()[dim] == 0.0f) {
-      /* If the centroid bounding box is 0 along a given dimension and the node measure is
-       * already computed, skip it. */
-      if (dim != 0) {
-        continue;
-      }
+    inv_extent[dim] = (extent[dim] == 0.0f) ? 0.0f : 1 / extent[dim];
+  }
 
-      /* Degenerate case, everything in the same bucket. */
-      inv_extent = FLT_MAX;
-      for (int i = start; i < end; i++) {
-        buckets[0].add(emitters[i]);
+  LightTreeBuckets buckets;
+  if (use_parallel) {
+    vector<LightTreeBuckets> block_buckets(num_blocks);
+    for_each_block([&](const int block, const int block_start, const int block_end) {
+      fill_buckets(
+          emitters, block_start, block_end, centroid_bbox, inv_extent, block_buckets[block]);
+    });
+    for (const LightTreeBuckets &local_buckets : block_buckets) {
+      for (int dim = 0; dim < 3; dim++) {
+        for (int i = 0; i < LightTreeBucket::num_buckets; i++) {
+          buckets[dim][i] = buckets[dim][i] + local_buckets[dim][i];
+        }
       }
     }
-    else {
-      /* Fill in buckets with emitters. */
-      inv_extent = 1 / (centroid_bbox.size()[dim]);
-      for (int i = start; i < end; i++) {
-        const LightTreeEmitter *emitter = emitters + i;
-
-        /* Place emitter into the appropriate bucket, where the centroid box is split into equal
-         * partitions. */
-        int bucket_idx = LightTreeBucket::num_buckets *
-                         (emitter->centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
-        bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
-
-        buckets[bucket_idx].add(*emitter);
-      }
+  }
+  else {
+    fill_buckets(emitters, start, end, centroid_bbox, inv_extent, buckets);
+  }
+
+  /* Check each dimension to find the minimum splitting cost. */
+  float total_cost = 0.0f;
+  float min_cost = FLT_MAX;
+  for (int dim = 0; dim < 3; dim++) {
+    /* If the centroid bounding box is 0 along a given dimension and the node measure is already
+     * computed, skip it. */
+    if (extent[dim] == 0.0f && dim != 0) {
+      continue;
     }
 
+    const std::array<LightTreeBucket, LightTreeBucket::num_buckets> &dim_buckets = buckets[dim];
+
     /* Precompute the left bucket measure cumulatively. */
     std::array<LightTreeBucket, LightTreeBucket::num_buckets - 1> left_buckets;
-    left_buckets.front() = buckets.front();
+    left_buckets.front() = dim_buckets.front();
     for (int i = 1; i < LightTreeBucket::num_buckets - 1; i++) {
-      left_buckets[i] = left_buckets[i - 1] + buckets[i];
+      left_buckets[i] = left_buckets[i - 1] + dim_buckets[i];
     }
 
     if (dim == 0) {
       /* Calculate node measure by summing up the bucket measure. */
-      measure = left_buckets.back().measure + buckets.back().measure;
-      light_link = left_buckets.back().light_link + buckets.back().light_link;
+      measure = left_buckets.back().measure + dim_buckets.back().measure;
+      light_link = left_buckets.back().light_link + dim_buckets.back().light_link;
 
       /* Degenerate case with co-located emitters. */
       if (is_zero(centroid_bbox.size())) {
@@ -605,13 +871,13 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
 
     /* Precompute the right bucket measure cumulatively. */
     std::array<LightTreeBucket, LightTreeBucket::num_buckets - 1> right_buckets;
-    right_buckets.back() = buckets.back();
+    right_buckets.back() = dim_buckets.back();
     for (int i = LightTreeBucket::num_buckets - 3; i >= 0; i--) {
-      right_buckets[i] = right_buckets[i + 1] + buckets[i + 1];
+      right_buckets[i] = right_buckets[i + 1] + dim_buckets[i + 1];
     }
 
     /* Calculate the cost of splitting at each point between partitions. */
-    const float regularization = max_extent * inv_extent;
+    const float regularization = max_extent * inv_extent[dim];
     for (int split = 0; split < LightTreeBucket::num_buckets - 1; split++) {
       const float left_cost = left_buckets[split].measure.calculate();
       const float right_cost = right_buckets[split].measure.calculate();
@@ -249,6 +249,9 @@ struct LightTreeNode {
   LightTreeLightLink light_link;
   uint bit_trail;
   int object_id;
+  /* Cost of the node when its subtree was built, negative if not computed yet. Used to detect
+   * when refitting degraded the subtree too much. */
+  float build_cost = -1.0f;
 
   /* A bitmask of `LightTreeNodeType`, as in the building process an instance node can also be a
    * leaf or an inner node. */
@@ -392,7 +395,25 @@ class LightTree {
 
   std::unordered_map<Mesh *, int> offset_map_;
 
-  Progress &progress_;
+  /* Measure of the subtree of every unique mesh, in object space. */
+  std::unordered_map<const Mesh *, LightTreeMeasure> mesh_measures_;
+
+  /* An object with a light or an emissive mesh, in the order they are added to the tree. */
+  struct SceneEmitter {
+    const Object *object;
+    const Geometry *geometry;
+    int object_id;
+    bool is_distant;
+
+    bool operator==(const SceneEmitter &other) const
+    {
+      return object == other.object && geometry == other.geometry &&
+             object_id == other.object_id && is_distant == other.is_distant;
+    }
+  };
+  vector<SceneEmitter> scene_emitters_;
+
+  Progress *progress_;
 
   uint max_lights_in_leaf_;
 
@@ -415,6 +436,17 @@ class LightTree {
   /* Returns a pointer to the root node. */
   LightTreeNode *build(Scene *scene, DeviceScene *dscene);
 
+  /* Update a built tree for modified lights and transforms of emissive objects. The subtrees of
+   * the meshes are kept, the top level tree is refit and only the parts of it whose cost grew too
+   * much are built again. Returns false if the emitters in the scene changed, then a new tree
+   * must be built. */
+  bool refit(Scene *scene, DeviceScene *dscene, Progress &progress);
+
+  LightTreeNode *get_root() const
+  {
+    return root_.get();
+  }
+
   /* NOTE: Always use this function to create a new node so the number of nodes is in sync. */
   unique_ptr<LightTreeNode> create_node(const LightTreeMeasure &measure, const uint &bit_trial)
   {
@@ -437,6 +469,10 @@ class LightTree {
   TaskPool task_pool;
   /* Do not spawn a thread if less than this amount of emitters are to be processed. */
   enum { MIN_EMITTERS_PER_THREAD = 4096 };
+  /* Compute the split of a node in parallel if it has at least this amount of emitters, in blocks
+   * of SPLIT_BLOCK_SIZE emitters. */
+  enum { MIN_EMITTERS_PARALLEL_SPLIT = 65536 };
+  enum { SPLIT_BLOCK_SIZE = 8192 };
 
   void recursive_build(Child child,
                        LightTreeNode *inner,
@@ -454,6 +490,21 @@ class LightTree {
                     LightTreeLightLink &light_link,
                     int &split_dim);
 
+  /* Refit the measure of a node of the top level tree to its emitters. */
+  void refit_node(LightTreeNode *node);
+
+  /* Build again the subtrees of the top level tree whose cost grew too much. */
+  void refit_rebuild(LightTreeNode *node, const int depth);
+
+  /* Record the cost of the newly built nodes of the top level tree. */
+  void record_build_cost(LightTreeNode *node);
+
+  /* Collect the objects of the scene contributing emitters to the tree. */
+  void collect_scene_emitters(Scene *scene, vector<SceneEmitter> &scene_emitters);
+
+  /* Measure of a mesh light in world space. */
+  LightTreeMeasure mesh_measure(Scene *scene, const int object_id);
+
   /* Check whether the light tree can use this triangle as light-emissive. */
   bool triangle_usable_as_light(Mesh *mesh, const int prim_id);
 
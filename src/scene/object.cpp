@@ -16,6 +16,7 @@
 #include "scene/pointcloud.h"
 #include "scene/scene.h"
 #include "scene/shader.h"
+#include "scene/shader_graph.h"
 #include "scene/stats.h"
 #include "scene/volume.h"
 
@@ -242,7 +243,7 @@ void Object::tag_update(Scene *scene)
     for (Node *node : geometry->get_used_shaders()) {
       Shader *shader = static_cast<Shader *>(node);
       if (shader->emission_sampling != EMISSION_SAMPLING_NONE) {
-        scene->light_manager->tag_update(scene, LightManager::EMISSIVE_MESH_MODIFIED);
+        scene->light_manager->tag_update(scene, LightManager::EMISSIVE_OBJECT_MODIFIED);
       }
     }
   }
@@ -555,6 +556,7 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
                                    0 :
                                    ob->blocker_shadow_set;
   kobject.shadow_set_membership = ob->shadow_set_membership;
+  kobject.shader_constants_offset = ob->shader_constants_offset;
 
   if (geom->get_use_motion_blur()) {
     state->have_motion = true;
@@ -813,6 +815,171 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
   dscene->object_motion.clear_modified();
 }
 
+void ObjectManager::device_update_shader_constants(DeviceScene *dscene,
+                                                   Scene *scene,
+                                                   Progress &progress)
+{
+  vector<ObjectConstants *> shader_constants(scene->shaders.size(), nullptr);
+  for (Shader *shader : scene->shaders) {
+    shader_constants[shader->id] = shader->graph->object_constants.get();
+  }
+
+  /* Shaders of the previous update, the values of objects are kept if they still use the same
+   * subgraphs and their object info did not change. */
+  const uint *old_shaders = dscene->object_constant_shaders.data();
+  const size_t old_shaders_size = dscene->object_constant_shaders.size();
+  const size_t old_values_size = dscene->object_constants.size();
+
+  /* Every object with object constants has the number of its shaders, followed by the ID and
+   * values offset of each shader used by its geometry. */
+  vector<uint> shaders;
+  /* Offset of the shaders of the object in the previous table to copy the values from, or -1 to
+   * evaluate them. */
+  vector<int> keep_offsets(scene->objects.size(), -1);
+  size_t num_values = 0;
+  bool layout_modified = false;
+  bool values_moved = false;
+  bool need_eval = false;
+
+  for (Object *ob : scene->objects) {
+    const int old_offset = ob->shader_constants_offset;
+    int offset = -1;
+
+    for (Node *node : ob->get_geometry()->get_used_shaders()) {
+      const Shader *shader = static_cast<const Shader *>(node);
+      if (shader_constants[shader->id] == nullptr) {
+        continue;
+      }
+      if (offset == -1) {
+        offset = shaders.size();
+        shaders.push_back(0);
+      }
+      shaders[offset]++;
+      shaders.push_back(shader->id);
+      shaders.push_back(num_values);
+      num_values += shader_constants[shader->id]->num_slots();
+    }
+
+    ob->shader_constants_offset = offset;
+    layout_modified |= (offset != old_offset);
+    if (offset == -1) {
+      continue;
+    }
+
+    bool keep = old_offset != -1 && size_t(old_offset) < old_shaders_size &&
+                old_shaders[old_offset] == shaders[offset] &&
+                old_offset + 1 + shaders[offset] * 2 <= old_shaders_size &&
+                !(ob->color_is_modified() || ob->alpha_is_modified() ||
+                  ob->pass_id_is_modified() || ob->random_id_is_modified());
+    bool moved = false;
+    for (uint i = 0; keep && i < shaders[offset]; i++) {
+      const uint old_id = old_shaders[old_offset + 1 + i * 2];
+      const uint old_values_offset = old_shaders[old_offset + 2 + i * 2];
+      const ObjectConstants *constants = shader_constants[shaders[offset + 1 + i * 2]];
+      keep = old_id < shader_object_constants_.size() &&
+             shader_object_constants_[old_id] == constants && !constants->is_modified() &&
+             old_values_offset + constants->num_slots() <= old_values_size;
+      moved |= (old_values_offset != shaders[offset + 2 + i * 2]);
+    }
+
+    if (keep) {
+      keep_offsets[ob->index] = old_offset;
+      values_moved |= moved;
+    }
+    else {
+      need_eval = true;
+    }
+  }
+
+  if (num_values == 0) {
+    dscene->object_constant_shaders.free();
+    dscene->object_constants.free();
+  }
+  else if (need_eval || layout_modified || values_moved || shaders.size() != old_shaders_size ||
+           num_values != old_values_size)
+  {
+    /* Values that are kept but move to another offset are copied from the previous table. */
+    vector<float4> old_values;
+    vector<uint> old_shaders_copy;
+    if (values_moved || num_values != old_values_size) {
+      old_values.assign(dscene->object_constants.data(),
+                        dscene->object_constants.data() + old_values_size);
+      old_shaders_copy.assign(old_shaders, old_shaders + old_shaders_size);
+    }
+
+    float4 *values = dscene->object_constants.alloc(num_values);
+    const KernelObject *kobjects = dscene->objects.data();
+
+    /* The nodes are evaluated through their sockets, so every thread uses its own copies. */
+    enumerable_thread_specific<vector<unique_ptr<ObjectConstants>>> thread_constants;
+
+    static const int OBJECTS_PER_TASK = 32;
+    parallel_for(blocked_range<size_t>(0, scene->objects.size(), OBJECTS_PER_TASK),
+                 [&](const blocked_range<size_t> &r) {
+                   vector<unique_ptr<ObjectConstants>> &local_constants =
+                       thread_constants.local();
+                   local_constants.resize(shader_constants.size());
+
+                   for (size_t i = r.begin(); i != r.end(); i++) {
+                     const int offset = scene->objects[i]->shader_constants_offset;
+                     if (offset == -1 || (keep_offsets[i] != -1 && old_values.empty())) {
+                       continue;
+                     }
+
+                     for (uint k = 0; k < shaders[offset]; k++) {
+                       const uint id = shaders[offset + 1 + k * 2];
+                       float4 *object_values = values + shaders[offset + 2 + k * 2];
+
+                       if (keep_offsets[i] != -1) {
+                         const uint old_values_offset =
+                             old_shaders_copy[keep_offsets[i] + 2 + k * 2];
+                         std::copy_n(old_values.data() + old_values_offset,
+                                     shader_constants[id]->num_slots(),
+                                     object_values);
+                         continue;
+                       }
+
+                       if (!local_constants[id]) {
+                         local_constants[id] = shader_constants[id]->clone();
+                       }
+                       local_constants[id]->eval(scene, kobjects[i], object_values);
+                     }
+                   }
+                 });
+
+    if (progress.get_cancel()) {
+      /* Nothing can be kept in the next update. */
+      for (Object *ob : scene->objects) {
+        ob->shader_constants_offset = -1;
+      }
+      shader_object_constants_.clear();
+      return;
+    }
+
+    uint *device_shaders = dscene->object_constant_shaders.alloc(shaders.size());
+    std::copy_n(shaders.data(), shaders.size(), device_shaders);
+
+    dscene->object_constant_shaders.copy_to_device();
+    dscene->object_constants.copy_to_device();
+  }
+
+  /* The offsets of the shaders are only known now, after the objects were copied to the device. */
+  if (layout_modified) {
+    KernelObject *kobjects = dscene->objects.data();
+    for (Object *ob : scene->objects) {
+      kobjects[ob->index].shader_constants_offset = ob->shader_constants_offset;
+    }
+    dscene->objects.copy_to_device();
+  }
+
+  shader_object_constants_.assign(shader_constants.begin(), shader_constants.end());
+  for (ObjectConstants *constants : shader_constants) {
+    if (constants) {
+      constants->clear_modified();
+    }
+  }
+}
+
 void ObjectManager::device_update(Device *device,
                                   DeviceScene *dscene,
                                   Scene *scene,
@@ -838,7 +1005,7 @@ void ObjectManager::device_update(Device *device,
     dscene->object_flag.tag_modified();
   }
 
-  if (update_flags & PARTICLE_MODIFIED) {
+  if (update_flags & (PARTICLE_MODIFIED | SHADER_CONSTANTS_MODIFIED)) {
     dscene->objects.tag_modified();
   }
 
@@ -897,6 +1064,23 @@ void ObjectManager::device_update(Device *device,
     device_update_transforms(dscene, scene, progress);
   }
 
+  if (progress.get_cancel()) {
+    return;
+  }
+
+  {
+    /* Evaluate object constants of shaders, after the object info is known. */
+    const scoped_callback_timer timer([scene](double time) {
+      if (scene->update_stats) {
+        scene->update_stats->object.times.add_entry(
+            {"device_update (evaluate shader constants)", time});
+      }
+    });
+
+    progress.set_status("Updating Objects", "Evaluating shader constants");
+    device_update_shader_constants(dscene, scene, progress);
+  }
+
   for (Object *object : scene->objects) {
     object->clear_modified();
   }
@@ -1076,6 +1260,13 @@ void ObjectManager::device_free(Device * /*unused*/, DeviceScene *dscene, bool f
   dscene->object_motion.free_if_need_realloc(force_free);
   dscene->object_flag.free_if_need_realloc(force_free);
   dscene->object_prim_offset.free_if_need_realloc(force_free);
+
+  /* Values of objects are kept between updates, unless freed. */
+  if (force_free) {
+    dscene->object_constant_shaders.free();
+    dscene->object_constants.free();
+    shader_object_constants_.clear();
+  }
 }
 
 void ObjectManager::apply_static_transforms(DeviceScene *dscene, Scene *scene, Progress &progress)
@@ -1152,6 +1343,11 @@ void ObjectManager::tag_update(Scene *scene, const uint32_t flag)
 {
   update_flags |= flag;
 
+  /* Only the object constants table is affected, which no other manager uses. */
+  if (flag == SHADER_CONSTANTS_MODIFIED) {
+    return;
+  }
+
   /* avoid infinite loops if the geometry manager tagged us for an update */
   if ((flag & GEOMETRY_MANAGER) == 0) {
     uint32_t geometry_flag = GeometryManager::OBJECT_MANAGER;
@@ -25,6 +25,7 @@ CCL_NAMESPACE_BEGIN
 class Device;
 class DeviceScene;
 class Geometry;
+class ObjectConstants;
 class ParticleSystem;
 class Progress;
 class Scene;
@@ -135,6 +136,10 @@ class Object : public Node {
    * or 0 if none. Set in update_svm_attributes. */
   size_t attr_map_offset;
 
+  /* Start of the shaders of this object in the object constant shaders table, or -1 if none.
+   * Set in device_update_shader_constants. */
+  int shader_constants_offset;
+
   friend class ObjectManager;
   friend class GeometryManager;
 };
@@ -155,6 +160,7 @@ class ObjectManager {
     HOLDOUT_MODIFIED = (1 << 6),
     TRANSFORM_MODIFIED = (1 << 7),
     VISIBILITY_MODIFIED = (1 << 8),
+    SHADER_CONSTANTS_MODIFIED = (1 << 9),
 
     /* tag everything in the manager for an update */
     UPDATE_ALL = ~0u,
@@ -169,6 +175,7 @@ class ObjectManager {
 
   void device_update(Device *device, DeviceScene *dscene, Scene *scene, Progress &progress);
   void device_update_transforms(DeviceScene *dscene, Scene *scene, Progress &progress);
+  void device_update_shader_constants(DeviceScene *dscene, Scene *scene, Progress &progress);
   void device_update_prim_offsets(Device *device, DeviceScene *dscene, Scene *scene);
 
   void device_update_flags(Device *device,
@@ -198,6 +205,9 @@ class ObjectManager {
   bool device_update_object_transform_pop_work(UpdateObjectTransformState *state,
                                                int *start_index,
                                                int *num_objects);
+
+  /* Object constants of every shader by ID, as of the last evaluation of the objects. */
+  vector<const ObjectConstants *> shader_object_constants_;
 };
 
 CCL_NAMESPACE_END
@@ -0,0 +1,300 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "scene/object_constants.h"
+#include "scene/constant_fold.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
+
+#include "kernel/types.h"
+
+#include "util/log.h"
+#include "util/map.h"
+#include "util/set.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Outputs of the object info node which are the same for every shading point of an object, in
+ * the order of their registers. The location is left out, as it changes with motion blur. */
+static const char *object_info_outputs[] = {"Color", "Alpha", "Object Index", "Random"};
+static const int num_object_info_outputs = sizeof(object_info_outputs) / sizeof(char *);
+
+struct ObjectConstants::ExtractState {
+  /* Register of every output that is constant per object. */
+  map<ShaderOutput *, int> registers;
+  /* Value of every register without an object, all object info is zero then. */
+  vector<float3> values;
+  set<ShaderNode *> visited;
+  set<ShaderNode *> constant_nodes;
+};
+
+ObjectConstants::ObjectConstants() : modified_(true) {}
+
+ObjectConstants::~ObjectConstants() = default;
+
+static bool object_constant_socket_type(const SocketType::Type type)
+{
+  return type == SocketType::FLOAT || type == SocketType::INT || SocketType::is_float3(type);
+}
+
+static void object_constant_set_input(ShaderInput *input, const float3 value)
+{
+  if (input->type() == SocketType::FLOAT) {
+    input->set(value.x);
+  }
+  else if (input->type() == SocketType::INT) {
+    input->set(int(value.x));
+  }
+  else {
+    input->set(value);
+  }
+}
+
+void ObjectConstants::visit(ShaderNode *node, Scene *scene, ExtractState &state)
+{
+  if (!state.visited.insert(node).second) {
+    return;
+  }
+
+  if (node->type == ObjectInfoNode::get_node_type()) {
+    for (int i = 0; i < num_object_info_outputs; i++) {
+      state.registers[node->output(object_info_outputs[i])] = i;
+    }
+    return;
+  }
+
+  if (node->special_type != SHADER_SPECIAL_TYPE_NONE &&
+      node->special_type != SHADER_SPECIAL_TYPE_AUTOCONVERT)
+  {
+    return;
+  }
+  if (node->bump != SHADER_BUMP_NONE || node->has_spatial_varying() ||
+      node->has_attribute_dependency())
+  {
+    return;
+  }
+
+  /* All linked inputs must be constant per object. */
+  bool has_link = false;
+  for (ShaderInput *input : node->inputs) {
+    if (input->link) {
+      visit(input->link->parent, scene, state);
+      if (state.registers.find(input->link) == state.registers.end() ||
+          !object_constant_socket_type(input->type()))
+      {
+        return;
+      }
+      has_link = true;
+    }
+  }
+  if (!has_link) {
+    return;
+  }
+
+  /* Evaluate a copy of the node without an object, which also checks that constant folding of the
+   * node gives a value for every used output. */
+  Op op;
+  op.node = node->clone(graph_.get());
+
+  for (ShaderInput *input : node->inputs) {
+    if (input->link) {
+      const int reg = state.registers[input->link];
+      ShaderInput *op_input = op.node->input(input->name());
+      object_constant_set_input(op_input, state.values[reg]);
+      op.inputs.push_back({op_input, reg});
+    }
+  }
+
+  vector<float3> values;
+  for (ShaderOutput *output : node->outputs) {
+    if (output->links.empty()) {
+      continue;
+    }
+    if (!object_constant_socket_type(output->type())) {
+      return;
+    }
+
+    ShaderOutput *op_output = op.node->output(output->name());
+    float3 value = zero_float3();
+    const ConstantFolder folder(graph_.get(), op.node, op_output, scene, &value);
+    op.node->constant_fold(folder);
+    if (!folder.has_result) {
+      return;
+    }
+
+    op.outputs.push_back({op_output, int(state.values.size() + values.size())});
+    values.push_back(value);
+  }
+
+  int num_outputs = 0;
+  for (ShaderOutput *output : node->outputs) {
+    if (!output->links.empty()) {
+      state.registers[output] = state.values.size();
+      state.values.push_back(values[num_outputs++]);
+    }
+  }
+  ops_.push_back(std::move(op));
+  state.constant_nodes.insert(node);
+}
+
+bool ObjectConstants::extract(ShaderGraph *graph, Scene *scene)
+{
+  graph_ = make_unique<ShaderGraph>();
+  ops_.clear();
+  slots_.clear();
+  modified_ = true;
+
+  ExtractState state;
+  state.values.resize(num_object_info_outputs, zero_float3());
+
+  for (ShaderNode *node : graph->nodes) {
+    visit(node, scene, state);
+  }
+
+  /* Replace the outputs of constant nodes used by other nodes. */
+  struct Replacement {
+    ShaderOutput *output;
+    int reg;
+    vector<ShaderInput *> links;
+  };
+  vector<Replacement> replacements;
+
+  for (ShaderNode *node : graph->nodes) {
+    if (state.constant_nodes.find(node) == state.constant_nodes.end()) {
+      continue;
+    }
+    for (ShaderOutput *output : node->outputs) {
+      const SocketType::Type type = output->type();
+      if (output->links.empty() ||
+          !(type == SocketType::FLOAT || type == SocketType::COLOR || type == SocketType::VECTOR))
+      {
+        continue;
+      }
+
+      Replacement replacement = {output, state.registers[output], {}};
+      for (ShaderInput *input : output->links) {
+        if (state.constant_nodes.find(input->parent) == state.constant_nodes.end()) {
+          replacement.links.push_back(input);
+        }
+      }
+      if (!replacement.links.empty()) {
+        replacements.push_back(std::move(replacement));
+      }
+    }
+  }
+
+  for (const Replacement &replacement : replacements) {
+    ObjectConstantNode *constant = graph->create_node<ObjectConstantNode>();
+    constant->set_slot(slots_.size());
+    constant->set_fallback(state.values[replacement.reg]);
+    slots_.push_back(replacement.reg);
+
+    const SocketType::Type type = replacement.output->type();
+    ShaderOutput *constant_output = constant->output(type == SocketType::FLOAT ? "Value" :
+                                                     type == SocketType::COLOR ? "Color" :
+                                                                                 "Vector");
+    for (ShaderInput *input : replacement.links) {
+      graph->disconnect(input);
+      graph->connect(constant_output, input);
+    }
+  }
+
+  registers_.resize(state.values.size());
+  remove_unused_ops();
+
+  if (slots_.empty()) {
+    graph_.reset();
+    return false;
+  }
+
+  LOG_TRACE << "Replaced " << slots_.size() << " outputs by object constants, evaluated by "
+            << ops_.size() << " nodes.";
+  return true;
+}
+
+void ObjectConstants::remove_unused_ops()
+{
+  vector<bool> used(registers_.size(), false);
+  for (const int reg : slots_) {
+    used[reg] = true;
+  }
+
+  vector<Op> ops;
+  for (auto it = ops_.rbegin(); it != ops_.rend(); ++it) {
+    bool is_used = false;
+    for (const Socket<ShaderOutput> &output : it->outputs) {
+      is_used |= used[output.reg];
+    }
+    if (!is_used) {
+      continue;
+    }
+    for (const Socket<ShaderInput> &input : it->inputs) {
+      used[input.reg] = true;
+    }
+    ops.push_back(std::move(*it));
+  }
+
+  ops_.assign(ops.rbegin(), ops.rend());
+}
+
+template<typename T>
+static size_t socket_index(const unique_ptr_vector<T> &sockets, const T *socket)
+{
+  size_t index = 0;
+  while (sockets[index] != socket) {
+    index++;
+  }
+  return index;
+}
+
+unique_ptr<ObjectConstants> ObjectConstants::clone() const
+{
+  unique_ptr<ObjectConstants> copy = make_unique<ObjectConstants>();
+  copy->graph_ = make_unique<ShaderGraph>();
+  copy->slots_ = slots_;
+  copy->registers_ = registers_;
+  copy->modified_ = modified_;
+
+  /* Sockets are found by their position, which the copy of a node keeps. */
+  for (const Op &op : ops_) {
+    Op op_copy;
+    op_copy.node = op.node->clone(copy->graph_.get());
+    for (const Socket<ShaderInput> &input : op.inputs) {
+      op_copy.inputs.push_back(
+          {op_copy.node->inputs[socket_index(op.node->inputs, input.socket)], input.reg});
+    }
+    for (const Socket<ShaderOutput> &output : op.outputs) {
+      op_copy.outputs.push_back(
+          {op_copy.node->outputs[socket_index(op.node->outputs, output.socket)], output.reg});
+    }
+    copy->ops_.push_back(std::move(op_copy));
+  }
+
+  return copy;
+}
+
+void ObjectConstants::eval(Scene *scene, const KernelObject &kobject, float4 *values)
+{
+  registers_[0] = make_float3(kobject.color[0], kobject.color[1], kobject.color[2]);
+  registers_[1] = make_float3(kobject.alpha);
+  registers_[2] = make_float3(kobject.pass_id);
+  registers_[3] = make_float3(kobject.random_number);
+
+  for (const Op &op : ops_) {
+    for (const Socket<ShaderInput> &input : op.inputs) {
+      object_constant_set_input(input.socket, registers_[input.reg]);
+    }
+    for (const Socket<ShaderOutput> &output : op.outputs) {
+      const ConstantFolder folder(
+          graph_.get(), op.node, output.socket, scene, &registers_[output.reg]);
+      op.node->constant_fold(folder);
+    }
+  }
+
+  for (size_t i = 0; i < slots_.size(); i++) {
+    values[i] = make_float4(registers_[slots_[i]]);
+  }
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,92 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/types.h"
+#include "util/unique_ptr.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class Scene;
+class ShaderGraph;
+class ShaderInput;
+class ShaderNode;
+class ShaderOutput;
+struct KernelObject;
+
+/* Object Constants
+ *
+ * Subgraphs of a shader that only depend on object info, like a color ramp driven by the random
+ * number of the object, give the same result for every shading point of an object. When the
+ * graph is finalized for SVM they are replaced by an ObjectConstantNode, which reads the result
+ * from a table with the values of every object instead of evaluating the nodes.
+ *
+ * The table is filled by the object manager. Copies of the nodes of the subgraphs are kept here,
+ * and evaluated once per object on the host with the constant folding of the nodes. Objects only
+ * get values for the shaders of their geometry, which are evaluated again when the object info of
+ * the object or the subgraphs change. */
+
+class ObjectConstants {
+ public:
+  ObjectConstants();
+  ~ObjectConstants();
+
+  /* Replace the subgraphs of the graph that only depend on object info.
+   * Returns true if the graph was modified. */
+  bool extract(ShaderGraph *graph, Scene *scene);
+
+  /* Number of values of the shader in the table, for every object. */
+  int num_slots() const
+  {
+    return slots_.size();
+  }
+
+  /* Evaluate the values of the object, one per slot. Not thread-safe, as the nodes are evaluated
+   * by setting their inputs, use a clone for every thread. */
+  void eval(Scene *scene, const KernelObject &kobject, float4 *values);
+
+  /* Copy with its own nodes and registers. */
+  unique_ptr<ObjectConstants> clone() const;
+
+  /* Subgraphs were extracted since the values of objects were last evaluated. */
+  bool is_modified() const
+  {
+    return modified_;
+  }
+
+  void clear_modified()
+  {
+    modified_ = false;
+  }
+
+ protected:
+  struct ExtractState;
+
+  /* Input or output of a node, and the register holding its value. */
+  template<typename T> struct Socket {
+    T *socket;
+    int reg;
+  };
+
+  struct Op {
+    ShaderNode *node;
+    vector<Socket<ShaderInput>> inputs;
+    vector<Socket<ShaderOutput>> outputs;
+  };
+
+  void visit(ShaderNode *node, Scene *scene, ExtractState &state);
+  void remove_unused_ops();
+
+  /* Graph owning the copies of the nodes. */
+  unique_ptr<ShaderGraph> graph_;
+  vector<Op> ops_;
+  /* Register of the value of every slot. */
+  vector<int> slots_;
+  vector<float3> registers_;
+  bool modified_;
+};
+
+CCL_NAMESPACE_END
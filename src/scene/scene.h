@@ -73,6 +73,7 @@ class SceneParams {
   bool use_bvh_spatial_split;
   bool use_bvh_compact_structure;
   bool use_bvh_unaligned_nodes;
+  bool use_bvh_quantized_nodes;
   int num_bvh_time_steps;
   int hair_subdivisions;
   CurveShapeType hair_shape;
@@ -88,6 +89,7 @@ class SceneParams {
     use_bvh_spatial_split = false;
     use_bvh_compact_structure = true;
     use_bvh_unaligned_nodes = true;
+    use_bvh_quantized_nodes = false;
     num_bvh_time_steps = 0;
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
@@ -102,6 +104,7 @@ class SceneParams {
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_compact_structure == params.use_bvh_compact_structure &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
+             use_bvh_quantized_nodes == params.use_bvh_quantized_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
              texture_limit == params.texture_limit);
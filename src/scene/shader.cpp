@@ -111,6 +111,7 @@ Shader::Shader() : Node(get_node_type())
   displacement_method = DISPLACE_BUMP;
 
   id = -1;
+  use_svm_specialization = false;
 
   need_update_uvs = true;
   need_update_attribute = true;
@@ -608,6 +609,8 @@ void ShaderManager::device_update_common(Device * /*device*/,
 
   KernelShader *kshader = dscene->shaders.alloc(scene->shaders.size());
   bool has_transparent_shadow = false;
+  vector<const ObjectConstants *> object_constants;
+  bool object_constants_modified = false;
 
   for (Shader *shader : scene->shaders) {
     uint flag = 0;
@@ -694,9 +697,21 @@ void ShaderManager::device_update_common(Device * /*device*/,
     kshader->cryptomatte_id = util_hash_to_float(cryptomatte_id);
     kshader++;
 
+    object_constants.push_back(shader->graph->object_constants.get());
+    if (shader->graph->object_constants && shader->graph->object_constants->is_modified()) {
+      object_constants_modified = true;
+    }
+
     has_transparent_shadow |= (flag & SD_HAS_TRANSPARENT_SHADOW) != 0;
   }
 
+  /* The values of object constants are evaluated by the object manager, which needs to know when
+   * subgraphs were extracted again, or moved to another shader ID. */
+  if (object_constants_modified || object_constants != object_constants_) {
+    object_constants_ = std::move(object_constants);
+    scene->object_manager->tag_update(scene, ObjectManager::SHADER_CONSTANTS_MODIFIED);
+  }
+
   /* lookup tables */
   KernelTables *ktables = &dscene->data.tables;
   ktables->ggx_E = ensure_bsdf_table(dscene, scene, table_ggx_E);
@@ -24,12 +24,14 @@
 #include "util/thread.h"
 #include "util/types.h"
 #include "util/unique_ptr.h"
+#include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
 class Device;
 class DeviceScene;
 class Mesh;
+class ObjectConstants;
 class Progress;
 class Scene;
 class ShaderGraph;
@@ -132,6 +134,9 @@ class Shader : public Node {
   /* determined before compiling */
   uint id;
 
+  /* Generate and compile code for the SVM program of this shader on the CPU, for hot shaders. */
+  bool use_svm_specialization;
+
 #ifdef WITH_OSL
   /* Compiled osl shading state references. */
   struct OSLCache {
@@ -234,6 +239,9 @@ class ShaderManager {
 
   uint32_t update_flags;
 
+  /* Object constants of every shader by ID, as of the last update. */
+  vector<const ObjectConstants *> object_constants_;
+
   using AttributeIDMap = unordered_map<ustring, uint64_t>;
   AttributeIDMap unique_attribute_id;
 
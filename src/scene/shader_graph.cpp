@@ -395,6 +395,17 @@ void ShaderGraph::finalize(Scene *scene, bool do_bump, bool bump_in_object_space
       transform_multi_closure(volume_in->link->parent, nullptr, true);
     }
 
+    /* OSL has no table lookup, it evaluates the nodes as they are. */
+    if (!scene->shader_manager->use_osl()) {
+      object_constants = make_unique<ObjectConstants>();
+      if (object_constants->extract(this, scene)) {
+        clean(scene);
+      }
+      else {
+        object_constants.reset();
+      }
+    }
+
     finalized = true;
   }
 }
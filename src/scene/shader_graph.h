@@ -10,6 +10,8 @@
 #include "kernel/svm/types.h"
 #include "kernel/types.h"
 
+#include "scene/object_constants.h"
+
 #include "util/map.h"
 #include "util/param.h"
 #include "util/set.h"
@@ -334,6 +336,8 @@ class ShaderGraph : public NodeOwner {
   bool finalized;
   bool simplified;
   string displacement_hash;
+  /* Subgraphs replaced by values per object when finalizing, null if there are none. */
+  unique_ptr<ObjectConstants> object_constants;
 
   ShaderGraph();
   ~ShaderGraph() override;
@@ -4682,6 +4682,42 @@ void ObjectInfoNode::compile(OSLCompiler &compiler)
   compiler.add(this, "node_object_info");
 }
 
+/* Object Constant */
+
+NODE_DEFINE(ObjectConstantNode)
+{
+  NodeType *type = NodeType::add("object_constant", create, NodeType::SHADER);
+
+  SOCKET_INT(slot, "Slot", 0);
+  SOCKET_COLOR(fallback, "Fallback", zero_float3());
+
+  SOCKET_OUT_FLOAT(value, "Value");
+  SOCKET_OUT_COLOR(color, "Color");
+  SOCKET_OUT_VECTOR(vector, "Vector");
+
+  return type;
+}
+
+ObjectConstantNode::ObjectConstantNode() : ShaderNode(get_node_type()) {}
+
+void ObjectConstantNode::compile(SVMCompiler &compiler)
+{
+  for (ShaderOutput *out : outputs) {
+    if (!out->links.empty()) {
+      compiler.add_node(NODE_OBJECT_CONSTANT,
+                        slot,
+                        compiler.stack_assign(out),
+                        out->type() == SocketType::FLOAT);
+      compiler.add_node(make_float4(fallback));
+    }
+  }
+}
+
+void ObjectConstantNode::compile(OSLCompiler & /*compiler*/)
+{
+  assert(0);
+}
+
 /* Particle Info */
 
 NODE_DEFINE(ParticleInfoNode)
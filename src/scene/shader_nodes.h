@@ -1079,6 +1079,17 @@ class ObjectInfoNode : public ShaderNode {
   SHADER_NODE_CLASS(ObjectInfoNode)
 };
 
+/* Output of a subgraph that only depends on object info, replaced by a lookup in the object
+ * constants table. Only created for SVM, see scene/object_constants.h. */
+class ObjectConstantNode : public ShaderNode {
+ public:
+  SHADER_NODE_CLASS(ObjectConstantNode)
+
+  NODE_SOCKET_API(int, slot)
+  /* Value for shading points without an object, like the background. */
+  NODE_SOCKET_API(float3, fallback)
+};
+
 class ParticleInfoNode : public ShaderNode {
  public:
   SHADER_NODE_CLASS(ParticleInfoNode)
@@ -225,6 +225,18 @@ string ImageStats::full_report(const int indent_level)
   return result;
 }
 
+/* Device memory statistics. */
+
+DeviceMemoryStats::DeviceMemoryStats() = default;
+
+string DeviceMemoryStats::full_report(const int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  string result;
+  result += indent + "Huge pages:\n" + huge_pages.full_report(indent_level + 1);
+  return result;
+}
+
 /* Overall statistics. */
 
 RenderStats::RenderStats()
@@ -292,6 +304,9 @@ string RenderStats::full_report()
   string result;
   result += "Mesh statistics:\n" + mesh.full_report(1);
   result += "Image statistics:\n" + image.full_report(1);
+  if (!device_memory.huge_pages.entries.empty()) {
+    result += "Device memory statistics:\n" + device_memory.full_report(1);
+  }
   if (has_profiling) {
     result += "Kernel statistics:\n" + kernel.full_report(1);
     result += "Shader statistics:\n" + shaders.full_report(1);
@@ -159,6 +159,18 @@ class ImageStats {
   NamedSizeStats textures;
 };
 
+/* Statistics about device memory. */
+class DeviceMemoryStats {
+ public:
+  DeviceMemoryStats();
+
+  /* Generate full human-readable report. */
+  string full_report(const int indent_level = 0);
+
+  /* Arrays backed by huge pages on the CPU device. */
+  NamedSizeStats huge_pages;
+};
+
 /* Render process statistics. */
 class RenderStats {
  public:
@@ -174,6 +186,7 @@ class RenderStats {
 
   MeshStats mesh;
   ImageStats image;
+  DeviceMemoryStats device_memory;
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
@@ -15,6 +15,7 @@
 #include "scene/shader_nodes.h"
 #include "scene/stats.h"
 #include "scene/svm.h"
+#include "scene/svm_specialize.h"
 
 #include "util/log.h"
 #include "util/progress.h"
@@ -133,6 +134,27 @@ void SVMShaderManager::device_update_specific(Device *device,
     return;
   }
 
+  /* Specialized programs of hot shaders, devices which do not support them ignore this. */
+  vector<const array<int4> *> specialized_programs;
+  vector<int> specialized_shaders;
+  for (int i = 0; i < num_shaders; i++) {
+    if (scene->shaders[i]->use_svm_specialization) {
+      specialized_programs.push_back(&shader_svm_nodes[i]);
+      specialized_shaders.push_back(scene->shaders[i]->id);
+    }
+  }
+  const string specialized_source = (specialized_programs.empty()) ?
+                                        string() :
+                                        svm_specialize_source(specialized_programs);
+  device->foreach_device([&](Device *sub_device) {
+    if (!sub_device->load_cpu_svm_specialized(specialized_source, specialized_shaders) &&
+        !specialized_shaders.empty())
+    {
+      LOG_WARNING << "Specialized SVM programs are not used on " << sub_device->info.description
+                  << ".";
+    }
+  });
+
   device_update_common(device, dscene, scene, progress);
 
   update_flags = UPDATE_NONE;
@@ -148,6 +170,152 @@ void SVMShaderManager::device_free(Device *device, DeviceScene *dscene, Scene *s
   dscene->svm_nodes.free();
 }
 
+/* Superinstructions */
+
+/* Size of nodes which can be part of a superinstruction, including their extra data. Zero for
+ * other nodes. */
+static int svm_fusable_node_size(const int4 &node)
+{
+  switch (node.x) {
+    case NODE_VALUE_F:
+    case NODE_MATH:
+    case NODE_MAPPING:
+    case NODE_TEX_IMAGE:
+    case NODE_ATTR:
+      return 1;
+    case NODE_VALUE_V:
+    case NODE_VALUE_V_DERIVATIVE:
+      return 2;
+    case NODE_TEX_COORD:
+      /* The object transform follows the node. */
+      return ((node.y & 0xFF) == NODE_TEXCO_OBJECT_WITH_TRANSFORM) ? 4 : 1;
+    default:
+      return 0;
+  }
+}
+
+void svm_fuse_superinstructions(array<int4> &nodes,
+                                const vector<int> &node_starts,
+                                std::atomic_int *node_types_used)
+{
+  /* Value nodes store their value as a node with a node type, skip those. */
+  vector<int> starts;
+  starts.reserve(node_starts.size());
+  int next_start = 0;
+  for (const int start : node_starts) {
+    if (start >= next_start) {
+      starts.push_back(start);
+      next_start = start + max(svm_fusable_node_size(nodes[start]), 1);
+    }
+  }
+
+  const int num_starts = starts.size();
+  auto type = [&](const int i) { return (i < num_starts) ? nodes[starts[i]].x : int(NODE_NONE); };
+  /* Node i directly follows node i - 1, as opposed to following extra data of unknown size. */
+  auto follows = [&](const int i) {
+    return i < num_starts &&
+           starts[i] == starts[i - 1] + svm_fusable_node_size(nodes[starts[i - 1]]);
+  };
+  auto is_value = [&](const int i) {
+    return type(i) == NODE_VALUE_F || type(i) == NODE_VALUE_V;
+  };
+
+  /* Find sequences, as the index of their first node and the superinstruction to insert. */
+  vector<std::pair<int, int4>> fused;
+  for (int i = 0; i < num_starts;) {
+    int end = i + 1;
+
+    /* Texture coordinate, mapping and image texture with constant inputs in between. */
+    if (type(i) == NODE_TEX_COORD || type(i) == NODE_ATTR) {
+      int mapping = end;
+      while (follows(mapping) && is_value(mapping)) {
+        mapping++;
+      }
+      int image = mapping + 1;
+      while (follows(image) && is_value(image)) {
+        image++;
+      }
+      if (follows(mapping) && type(mapping) == NODE_MAPPING && follows(image) &&
+          type(image) == NODE_TEX_IMAGE)
+      {
+        fused.emplace_back(starts[i],
+                           make_int4(NODE_TEXTURE_CHAIN, mapping - i - 1, image - mapping - 1, 0));
+        i = image + 1;
+        continue;
+      }
+    }
+
+    /* Constant values. */
+    if (is_value(i)) {
+      while (follows(end) && is_value(end)) {
+        end++;
+      }
+      if (end - i > 1) {
+        fused.emplace_back(starts[i], make_int4(NODE_VALUE_BATCH, end - i, 0, 0));
+        i = end;
+        continue;
+      }
+    }
+
+    /* Math nodes. */
+    if (type(i) == NODE_MATH) {
+      while (follows(end) && type(end) == NODE_MATH) {
+        end++;
+      }
+      if (end - i > 1) {
+        fused.emplace_back(starts[i], make_int4(NODE_MATH_CHAIN, end - i, 0, 0));
+        i = end;
+        continue;
+      }
+    }
+
+    i++;
+  }
+
+  if (fused.empty()) {
+    return;
+  }
+
+  /* Index of a node in the new program. The superinstruction takes the place of the first node
+   * of its sequence, so jumps to the sequence run it. */
+  auto new_index = [&](const int index) {
+    const int num_before = std::lower_bound(fused.begin(),
+                                            fused.end(),
+                                            index,
+                                            [](const std::pair<int, int4> &it, const int index) {
+                                              return it.first < index;
+                                            }) -
+                           fused.begin();
+    return index + num_before;
+  };
+
+  /* Jumps are relative to the node after the jump. */
+  for (const int start : starts) {
+    int4 &node = nodes[start];
+    if (node.x == NODE_JUMP_IF_ZERO || node.x == NODE_JUMP_IF_ONE) {
+      node.y = new_index(start + 1 + node.y) - new_index(start) - 1;
+    }
+  }
+
+  array<int4> fused_nodes;
+  fused_nodes.reserve(nodes.size() + fused.size());
+  int copied = 0;
+  for (const std::pair<int, int4> &it : fused) {
+    for (; copied < it.first; copied++) {
+      fused_nodes.push_back_reserved(nodes[copied]);
+    }
+    fused_nodes.push_back_reserved(it.second);
+    if (node_types_used) {
+      node_types_used[it.second.x] = true;
+    }
+  }
+  for (; copied < int(nodes.size()); copied++) {
+    fused_nodes.push_back_reserved(nodes[copied]);
+  }
+
+  nodes.steal_data(fused_nodes);
+}
+
 /* Graph Compiler */
 
 SVMCompiler::SVMCompiler(Scene *scene, Progress &progress) : scene(scene), progress(progress)
@@ -411,6 +579,7 @@ void SVMCompiler::add_node(const int a, const int b, int c, const int d)
 void SVMCompiler::add_node(ShaderNodeType type, const int a, int b, const int c)
 {
   svm_node_types_used[type] = true;
+  current_svm_node_starts.push_back(current_svm_nodes.size());
   current_svm_nodes.push_back_slow(make_int4(type, a, b, c));
 }
 static ShaderNodeType svm_node_type_with_derivatives(ShaderNodeType type)
@@ -748,8 +917,7 @@ void SVMCompiler::generate_multi_closure(ShaderNode *root_node,
         /* Add instruction to skip closure and its dependencies if mix
          * weight is zero.
          */
-        svm_node_types_used[NODE_JUMP_IF_ONE] = true;
-        current_svm_nodes.push_back_slow(make_int4(NODE_JUMP_IF_ONE, 0, stack_assign(facin), 0));
+        add_node(NODE_JUMP_IF_ONE, 0, stack_assign(facin), 0);
         const int node_jump_skip_index = current_svm_nodes.size() - 1;
 
         generate_multi_closure(root_node, cl1in->link->parent, state);
@@ -764,8 +932,7 @@ void SVMCompiler::generate_multi_closure(ShaderNode *root_node,
         /* Add instruction to skip closure and its dependencies if mix
          * weight is zero.
          */
-        svm_node_types_used[NODE_JUMP_IF_ZERO] = true;
-        current_svm_nodes.push_back_slow(make_int4(NODE_JUMP_IF_ZERO, 0, stack_assign(facin), 0));
+        add_node(NODE_JUMP_IF_ZERO, 0, stack_assign(facin), 0);
         const int node_jump_skip_index = current_svm_nodes.size() - 1;
 
         generate_multi_closure(root_node, cl2in->link->parent, state);
@@ -881,6 +1048,7 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   /* clear all compiler state */
   memset((void *)&active_stack, 0, sizeof(active_stack));
   current_svm_nodes.clear();
+  current_svm_node_starts.clear();
 
   for (ShaderNode *node : graph->nodes) {
     for (ShaderInput *input : node->inputs) {
@@ -958,6 +1126,7 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   /* if compile failed, generate empty shader */
   if (compile_failed) {
     current_svm_nodes.clear();
+    current_svm_node_starts.clear();
     compile_failed = false;
   }
 
@@ -966,6 +1135,8 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   if (type != SHADER_TYPE_BUMP) {
     add_node(NODE_END, 0, 0, 0);
   }
+
+  svm_fuse_superinstructions(current_svm_nodes, current_svm_node_starts, svm_node_types_used);
 }
 
 void SVMCompiler::compile(Shader *shader,
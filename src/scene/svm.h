@@ -43,6 +43,14 @@ class SVMShaderManager : public ShaderManager {
                             array<int4> *svm_nodes);
 };
 
+/* Fuse frequent sequences of nodes into superinstructions, see kernel/svm/superinstruction.h.
+ * Node starts are the indices of the nodes in the program as opposed to their extra data, in
+ * increasing order. Relative jumps are updated for the inserted nodes. Superinstruction types
+ * which are used are marked in node_types_used if given. */
+void svm_fuse_superinstructions(array<int4> &nodes,
+                                const vector<int> &node_starts,
+                                std::atomic_int *node_types_used = nullptr);
+
 /* Graph Compiler */
 
 class SVMCompiler {
@@ -230,6 +238,8 @@ class SVMCompiler {
 
   std::atomic_int *svm_node_types_used;
   array<int4> current_svm_nodes;
+  /* Indices of the nodes added with a node type, used to find node sequences to fuse. */
+  vector<int> current_svm_node_starts;
   ShaderType current_type;
   Shader *current_shader;
   Stack active_stack;
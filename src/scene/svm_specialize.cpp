@@ -0,0 +1,89 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "scene/svm_specialize.h"
+
+#include "kernel/svm/types.h"
+
+#include "util/md5.h"
+#include "util/set.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Name the function after the program content, so identical programs share code. */
+static string svm_specialize_name(const array<int4> &nodes)
+{
+  MD5Hash md5;
+  md5.append((const uint8_t *)nodes.data(), nodes.size() * sizeof(int4));
+  return md5.get_hex().substr(0, 16);
+}
+
+/* The surface program runs from its entry in the local jump table to the start of the volume or
+ * displacement program, whichever follows it. */
+static int svm_specialize_surface_end(const array<int4> &nodes)
+{
+  const int4 &jump = nodes[0];
+  int end = nodes.size();
+  if (jump.z > jump.y) {
+    end = min(end, jump.z);
+  }
+  if (jump.w > jump.y) {
+    end = min(end, jump.w);
+  }
+  return end;
+}
+
+string svm_specialize_source(const vector<const array<int4> *> &programs)
+{
+  string source =
+      "/* Generated specialized SVM programs. */\n"
+      "\n"
+      "#include \"kernel/device/cpu/svm_specialized.h\"\n"
+      "\n"
+      "CCL_NAMESPACE_BEGIN\n";
+
+  vector<string> names;
+  set<string> generated;
+  for (const array<int4> *program : programs) {
+    const array<int4> &nodes = *program;
+    const string name = svm_specialize_name(nodes);
+    names.push_back(name);
+
+    if (!generated.insert(name).second) {
+      continue;
+    }
+
+    const int surface_offset = nodes[0].y;
+    source += string_printf(
+        "\nSVM_SPECIALIZED_SHADER_BEGIN(%s, %d)\n", name.c_str(), surface_offset);
+
+    for (int i = surface_offset; i < svm_specialize_surface_end(nodes); i++) {
+      const int4 &node = nodes[i];
+      /* Data nodes are never executed, skip those which can not be a node type. */
+      if (node.x < 0 || node.x >= NODE_NUM) {
+        continue;
+      }
+      source += string_printf("SVM_SPECIALIZED_NODE(%d, %uu, %uu, %uu, %uu)\n",
+                              i,
+                              uint(node.x),
+                              uint(node.y),
+                              uint(node.z),
+                              uint(node.w));
+    }
+
+    source += "SVM_SPECIALIZED_SHADER_END\n";
+  }
+
+  source += "\nSVM_SPECIALIZED_EXPORT_BEGIN\n";
+  for (const string &name : names) {
+    source += string_printf("SVM_SPECIALIZED_EXPORT(%s)\n", name.c_str());
+  }
+  source += "SVM_SPECIALIZED_EXPORT_END\n";
+
+  source += "\nCCL_NAMESPACE_END\n";
+
+  return source;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,19 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/array.h"
+#include "util/string.h"
+#include "util/types.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Generate C++ source evaluating the surface part of the given SVM programs, as compiled for a
+ * single shader with offsets local to it. The source exports one function per program in the
+ * given order, see kernel/svm/specialized.h. */
+string svm_specialize_source(const vector<const array<int4> *> &programs);
+
+CCL_NAMESPACE_END
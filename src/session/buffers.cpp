@@ -2,6 +2,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0 */
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "device/device.h"
@@ -9,6 +10,7 @@
 #include "session/buffers.h"
 
 #include "util/log.h"
+#include "util/string.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -274,6 +276,8 @@ void RenderBuffers::reset(const BufferParams &params_)
 
   params = params_;
 
+  free_packed();
+
   /* re-allocate buffer */
   buffer.alloc(params.width * params.pass_stride, params.height);
 }
@@ -301,6 +305,161 @@ void RenderBuffers::copy_to_device()
   buffer.copy_to_device();
 }
 
+/* Passes which are only used as denoiser guides or written once per pixel, and which tolerate the
+ * reduced precision. Accumulated sums keep their relative precision in half. */
+static bool pass_allows_half_storage(const PassType type)
+{
+  switch (type) {
+    case PASS_DENOISING_ALBEDO:
+    case PASS_DENOISING_NORMAL:
+    case PASS_DENOISING_DEPTH:
+    case PASS_DEPTH:
+    case PASS_NORMAL:
+    case PASS_MIST:
+    case PASS_ROUGHNESS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void RenderBuffers::pack()
+{
+  if (is_packed_ || !copy_from_device()) {
+    return;
+  }
+
+  const int64_t num_pixels = int64_t(params.width) * params.height;
+  const float *data = buffer.data();
+
+  packed_passes_.clear();
+  for (int i = 0; i < 3; i++) {
+    packed_stride_[i] = 0;
+  }
+
+  for (const BufferPass &pass : params.passes) {
+    if (pass.offset == PASS_UNUSED) {
+      continue;
+    }
+
+    PackedPass packed_pass;
+    packed_pass.offset = pass.offset;
+    packed_pass.num_components = pass.get_info().num_components;
+    packed_pass.storage = PackedStorage::FLOAT;
+
+    /* Only use the compact storage if every value is exactly or approximately representable. */
+    const bool allow_half = pass_allows_half_storage(pass.type);
+    const bool allow_uint16 = (pass.type == PASS_SAMPLE_COUNT);
+    if (allow_half || allow_uint16) {
+      bool fits = true;
+      for (int64_t pixel = 0; pixel < num_pixels && fits; pixel++) {
+        const float *value = data + pixel * params.pass_stride + pass.offset;
+        for (int c = 0; c < packed_pass.num_components; c++) {
+          if (allow_half) {
+            fits &= (fabsf(value[c]) <= 65504.0f);
+          }
+          else {
+            fits &= (value[c] >= 0.0f && value[c] <= 65535.0f && value[c] == floorf(value[c]));
+          }
+        }
+      }
+      if (fits) {
+        packed_pass.storage = allow_half ? PackedStorage::HALF : PackedStorage::UINT16;
+      }
+    }
+
+    const int storage_index = int(packed_pass.storage);
+    packed_pass.packed_offset = packed_stride_[storage_index];
+    packed_stride_[storage_index] += packed_pass.num_components;
+
+    packed_passes_.push_back(packed_pass);
+  }
+
+  packed_float_.resize(num_pixels * packed_stride_[int(PackedStorage::FLOAT)]);
+  packed_half_.resize(num_pixels * packed_stride_[int(PackedStorage::HALF)]);
+  packed_uint16_.resize(num_pixels * packed_stride_[int(PackedStorage::UINT16)]);
+
+  for (const PackedPass &packed_pass : packed_passes_) {
+    const int packed_stride = packed_stride_[int(packed_pass.storage)];
+    for (int64_t pixel = 0; pixel < num_pixels; pixel++) {
+      const float *value = data + pixel * params.pass_stride + packed_pass.offset;
+      const int64_t packed_index = pixel * packed_stride + packed_pass.packed_offset;
+      for (int c = 0; c < packed_pass.num_components; c++) {
+        switch (packed_pass.storage) {
+          case PackedStorage::FLOAT:
+            packed_float_[packed_index + c] = value[c];
+            break;
+          case PackedStorage::HALF:
+            packed_half_[packed_index + c] = float_to_half(value[c]);
+            break;
+          case PackedStorage::UINT16:
+            packed_uint16_[packed_index + c] = uint16_t(value[c]);
+            break;
+        }
+      }
+    }
+  }
+
+  const size_t unpacked_size = buffer.memory_size();
+  buffer.free();
+  is_packed_ = true;
+
+  LOG_INFO << "Packed render buffers from " << string_human_readable_size(unpacked_size)
+           << " to " << string_human_readable_size(packed_size()) << ".";
+}
+
+void RenderBuffers::unpack()
+{
+  if (!is_packed_) {
+    return;
+  }
+
+  const int64_t num_pixels = int64_t(params.width) * params.height;
+  float *data = buffer.alloc(params.width * params.pass_stride, params.height);
+
+  /* Gaps between passes are not stored. */
+  std::fill_n(data, num_pixels * params.pass_stride, 0.0f);
+
+  for (const PackedPass &packed_pass : packed_passes_) {
+    const int packed_stride = packed_stride_[int(packed_pass.storage)];
+    for (int64_t pixel = 0; pixel < num_pixels; pixel++) {
+      float *value = data + pixel * params.pass_stride + packed_pass.offset;
+      const int64_t packed_index = pixel * packed_stride + packed_pass.packed_offset;
+      for (int c = 0; c < packed_pass.num_components; c++) {
+        switch (packed_pass.storage) {
+          case PackedStorage::FLOAT:
+            value[c] = packed_float_[packed_index + c];
+            break;
+          case PackedStorage::HALF:
+            value[c] = half_to_float(packed_half_[packed_index + c]);
+            break;
+          case PackedStorage::UINT16:
+            value[c] = float(packed_uint16_[packed_index + c]);
+            break;
+        }
+      }
+    }
+  }
+
+  free_packed();
+  buffer.copy_to_device();
+}
+
+size_t RenderBuffers::packed_size() const
+{
+  return packed_float_.size() * sizeof(float) + packed_half_.size() * sizeof(half) +
+         packed_uint16_.size() * sizeof(uint16_t);
+}
+
+void RenderBuffers::free_packed()
+{
+  is_packed_ = false;
+  packed_passes_.clear();
+  packed_float_.free_memory();
+  packed_half_.free_memory();
+  packed_uint16_.free_memory();
+}
+
 void render_buffers_host_copy_denoised(RenderBuffers *dst,
                                        const BufferParams &dst_params,
                                        const RenderBuffers *src,
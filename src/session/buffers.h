@@ -10,6 +10,7 @@
 
 #include "kernel/types.h"
 
+#include "util/half.h"
 #include "util/string.h"
 #include "util/unique_ptr.h"
 #include "util/vector.h"
@@ -165,6 +166,42 @@ class RenderBuffers {
 
   bool copy_from_device();
   void copy_to_device();
+
+  /* Move the buffer to compact host storage while nothing renders into it, freeing the device
+   * and host float buffer. Guiding passes like albedo, normal and depth are stored in half
+   * precision and the sample count as 16 bit integers when their values fit, all other passes
+   * are kept exact. unpack() restores the float buffer on host and device, reset() discards the
+   * packed data. */
+  void pack();
+  void unpack();
+
+  bool is_packed() const
+  {
+    return is_packed_;
+  }
+
+  /* Size in bytes of the packed storage. */
+  size_t packed_size() const;
+
+ protected:
+  enum class PackedStorage { FLOAT, HALF, UINT16 };
+
+  struct PackedPass {
+    int offset;
+    int num_components;
+    PackedStorage storage;
+    /* Offset of the pass within the per-pixel stride of its storage. */
+    int packed_offset;
+  };
+
+  void free_packed();
+
+  bool is_packed_ = false;
+  vector<PackedPass> packed_passes_;
+  int packed_stride_[3] = {0, 0, 0};
+  vector<float> packed_float_;
+  vector<half> packed_half_;
+  vector<uint16_t> packed_uint16_;
 };
 
 /* Copy denoised passes form source to destination.
@@ -151,6 +151,9 @@ class DisplayDriver {
 
   virtual bool only_device_buffer() { return false; };
   virtual bool buffer_linear2srgb() { return false; };
+  /* Mapped texture buffer receives planar 8-bit YUV 4:2:0 instead of half4 pixels, for video
+   * encoding. Only supported by CPU devices. */
+  virtual bool buffer_yuv420() { return false; };
 
   virtual half4 *map_texture_buffer() = 0;
   virtual void unmap_texture_buffer() = 0;
@@ -2,6 +2,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0 */
 
+#include <algorithm>
 #include <cstring>
 
 #include "device/cpu/device.h"
@@ -14,7 +15,9 @@
 #include "scene/mesh.h"
 #include "scene/object.h"
 #include "scene/scene.h"
+#include "scene/shader.h"
 #include "scene/shader_graph.h"
+#include "scene/stats.h"
 #include "session/buffers.h"
 #include "session/display_driver.h"
 #include "session/output_driver.h"
@@ -305,9 +308,20 @@ RenderWork Session::run_update_for_next_iteration()
 
   thread_scoped_lock scene_lock(scene->mutex);
 
+  if (delayed_reset_.do_reset || scene->need_update()) {
+    updating_scene_ = true;
+  }
+
   /* Perform delayed reset if requested. */
   const bool reset_buffers = delayed_reset_buffer_params();
 
+  /* Keep the samples of the previous camera, before the scene update replaces it. */
+  if (reset_buffers) {
+    TemporalReprojectionParams temporal_reprojection = params.temporal_reprojection;
+    temporal_reprojection.use &= !tile_manager_.has_multiple_tiles();
+    path_trace_->update_temporal_reprojection(temporal_reprojection);
+  }
+
   /* Update scene */
   const bool reset_scene = update_scene(delayed_reset_.do_reset);
 
@@ -418,6 +432,12 @@ RenderWork Session::run_update_for_next_iteration()
     progress.add_skip_time(update_timer, params.background);
   }
 
+  {
+    /* A reset which came in during the update is handled by the next iteration. */
+    const thread_scoped_lock reset_lock(delayed_reset_.mutex);
+    updating_scene_ = delayed_reset_.do_reset;
+  }
+
   return render_work;
 }
 
@@ -529,7 +549,9 @@ void Session::update_buffers_for_params()
                                       params.use_sample_subset,
                                       params.sample_subset_offset,
                                       params.sample_subset_length);
+  render_scheduler_.set_navigation_time_budget(params.navigation_time_budget);
   render_scheduler_.reset(buffer_params_);
+  path_trace_->set_sample_density(params.sample_density);
 
   /* Update for new state of scene and passes. */
   buffer_params_.update_passes(scene->passes);
@@ -565,6 +587,7 @@ void Session::reset(const SessionParams &session_params, const BufferParams &buf
     delayed_reset_.buffer_params = buffer_params;
 
     scene->scene_updated_while_loading_kernels = true;
+    updating_scene_ = true;
 
     path_trace_->cancel();
   }
@@ -694,8 +717,11 @@ bool Session::update_scene(const bool reset_samples)
   scene->integrator->set_sample_subset_length(params.sample_subset_length);
 
   /* When multiple tiles are used SAMPLE_COUNT pass is used to keep track of possible partial
-   * tile results. */
-  scene->film->set_use_sample_count(tile_manager_.has_multiple_tiles());
+   * tile results. The same goes for pixels which get fewer samples with a sample density, and for
+   * pixels seeded with the samples of the previous camera. */
+  scene->film->set_use_sample_count(tile_manager_.has_multiple_tiles() ||
+                                    !params.sample_density.is_uniform() ||
+                                    params.temporal_reprojection.use);
 
   const bool reset = scene->need_reset(false);
 
@@ -770,9 +796,57 @@ void Session::device_free()
   path_trace_->device_free();
 }
 
+void Session::pack_render_buffers()
+{
+  const thread_scoped_lock buffers_lock(buffers_mutex_);
+  path_trace_->pack_render_buffers();
+}
+
+void Session::specialize_hot_shaders(const int num_shaders)
+{
+  const thread_scoped_lock scene_lock(scene->mutex);
+
+  vector<std::pair<uint64_t, Shader *>> ranked_shaders;
+  for (Shader *shader : scene->shaders) {
+    uint64_t samples;
+    uint64_t hits;
+    if (profiler.get_shader(shader->id, samples, hits) && samples > 0) {
+      ranked_shaders.emplace_back(samples, shader);
+    }
+  }
+  std::sort(ranked_shaders.begin(),
+            ranked_shaders.end(),
+            [](const std::pair<uint64_t, Shader *> &a, const std::pair<uint64_t, Shader *> &b) {
+              return a.first > b.first;
+            });
+  ranked_shaders.resize(std::min(ranked_shaders.size(), size_t(max(num_shaders, 0))));
+
+  bool modified = false;
+  for (Shader *shader : scene->shaders) {
+    const bool use_svm_specialization = std::any_of(
+        ranked_shaders.begin(),
+        ranked_shaders.end(),
+        [shader](const std::pair<uint64_t, Shader *> &it) { return it.second == shader; });
+    if (shader->use_svm_specialization != use_svm_specialization) {
+      shader->use_svm_specialization = use_svm_specialization;
+      modified = true;
+    }
+  }
+
+  if (modified) {
+    LOG_INFO << "Specializing SVM programs of " << ranked_shaders.size() << " shader(s).";
+    scene->shader_manager->tag_update(scene.get(), ShaderManager::SHADER_MODIFIED);
+  }
+}
+
 void Session::collect_statistics(RenderStats *render_stats)
 {
   scene->collect_statistics(render_stats);
+  device->foreach_device([render_stats](Device *sub_device) {
+    for (const DeviceMemoryEntry &entry : sub_device->get_huge_page_allocations()) {
+      render_stats->device_memory.huge_pages.add_entry(NamedSizeEntry(entry.name, entry.size));
+    }
+  });
   if (params.use_profiling && (params.device.type == DEVICE_CPU)) {
     render_stats->collect_profiling(scene.get(), profiler);
   }
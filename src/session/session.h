@@ -4,10 +4,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 
 #include "device/device.h"
 #include "integrator/render_scheduler.h"
+#include "integrator/temporal_reprojection.h"
 #include "scene/shader.h"
 #include "scene/stats.h"
 #include "session/buffers.h"
@@ -62,6 +64,17 @@ class SessionParams {
 
   bool use_resolution_divider;
 
+  /* Time in seconds a viewport update may take while navigating, the resolution divider is chosen
+   * to fit it. Zero uses the default interval. */
+  double navigation_time_budget;
+
+  /* Fraction of the samples rendered in the regions of the image, for foveated rendering. Takes
+   * effect on reset. */
+  SampleDensityMap sample_density;
+
+  /* Reuse of the samples of the previous camera after a reset. */
+  TemporalReprojectionParams temporal_reprojection;
+
   ShadingSystem shadingsystem;
 
   /* Session-specific temporary directory to store in-progress EXR files in. */
@@ -86,6 +99,7 @@ class SessionParams {
     tile_size = 2048;
 
     use_resolution_divider = true;
+    navigation_time_budget = 0.0;
 
     shadingsystem = SHADINGSYSTEM_SVM;
   }
@@ -138,6 +152,23 @@ class Session {
   bool ready_to_reset();
   void reset(const SessionParams &session_params, const BufferParams &buffer_params);
 
+  /* True from a reset until the device side of the scene is updated for it, and the session
+   * thread is about to render new samples. The display is not touched during this time, so an
+   * interactive host may keep presenting the previous image instead of waiting for the update,
+   * which can take seconds when shaders are compiled. */
+  bool is_updating_scene() const
+  {
+    return updating_scene_;
+  }
+
+  /* True when adaptive sampling found all pixels converged. Raising the number of samples does not
+   * render anything until the next reset then, so an interactive host can stop asking for more.
+   * Only meaningful after the display was updated with the last rendered samples. */
+  bool is_render_converged() const
+  {
+    return render_scheduler_.is_converged();
+  }
+
   void set_pause(bool pause);
 
   void set_samples(const int samples);
@@ -150,6 +181,15 @@ class Session {
 
   void device_free();
 
+  /* Reduce memory used by the render buffers of an idle session, for example a paused one which
+   * is kept around to continue rendering later. Buffers are restored when rendering resumes. */
+  void pack_render_buffers();
+
+  /* Generate and compile code for the SVM programs of the given number of shaders which took
+   * most of the shading time so far, according to the profiler. Only supported on the CPU, and
+   * requires profiling to be enabled. Rendering restarts with the next scene update. */
+  void specialize_hot_shaders(const int num_shaders);
+
   /* Returns the rendering progress or 0 if no progress can be determined
    * (for example, when rendering with unlimited samples). */
   float get_progress();
@@ -234,6 +274,9 @@ class Session {
   bool pause_ = false;
   bool new_work_added_ = false;
 
+  /* Set on reset or scene modification, and cleared once the scene is updated. */
+  std::atomic<bool> updating_scene_ = false;
+
   thread_condition_variable pause_cond_;
   thread_mutex pause_mutex_;
   thread_mutex tile_mutex_;
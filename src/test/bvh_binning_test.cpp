@@ -0,0 +1,203 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include "bvh/binning.h"
+
+#include "util/hash.h"
+#include "util/time.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Small random triangles scattered in a unit cube, like a dense mesh. */
+static BVHRange make_references(const int num,
+                                vector<BVHReference> &references,
+                                const uint seed = 0)
+{
+  BoundBox bounds = BoundBox::empty;
+  BoundBox cent_bounds = BoundBox::empty;
+
+  references.resize(num);
+  for (int i = 0; i < num; i++) {
+    const float3 P = make_float3(hash_uint3_to_float(i, 0, seed),
+                                 hash_uint3_to_float(i, 1, seed),
+                                 hash_uint3_to_float(i, 2, seed));
+    const float3 size = make_float3(1e-3f) * hash_uint3_to_float(i, 3, seed);
+    const BoundBox prim_bounds(P - size, P + size);
+
+    references[i] = BVHReference(prim_bounds, i, 0, PRIMITIVE_TRIANGLE);
+    bounds.grow(prim_bounds);
+    cent_bounds.grow(prim_bounds.center2());
+  }
+
+  return BVHRange(bounds, cent_bounds, 0, num);
+}
+
+/* Exposes the chosen split for comparing the serial and parallel code. */
+class BVHObjectBinningTest : public BVHObjectBinning {
+ public:
+  using BVHObjectBinning::BVHObjectBinning;
+  using BVHObjectBinning::dim;
+  using BVHObjectBinning::pos;
+};
+
+static bool bounds_equal(const BoundBox &a, const BoundBox &b)
+{
+  return a.min == b.min && a.max == b.max;
+}
+
+static vector<int> sorted_prim_indices(const BVHReference *references, const BVHRange &range)
+{
+  vector<int> prim_index;
+  for (int i = range.start(); i < range.end(); i++) {
+    prim_index.push_back(references[i].prim_index());
+  }
+  std::sort(prim_index.begin(), prim_index.end());
+  return prim_index;
+}
+
+static bool bounds_contain(const BoundBox &outer, const BoundBox &inner)
+{
+  return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+         outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+static void test_split(const int num)
+{
+  vector<BVHReference> references;
+  const BVHRange root = make_references(num, references);
+
+  const BVHObjectBinning range(root, references.data());
+  EXPECT_LT(range.splitSAH, FLT_MAX);
+
+  BVHObjectBinning left;
+  BVHObjectBinning right;
+  range.split(references.data(), left, right);
+
+  /* Both sides are used and together cover the whole range. */
+  EXPECT_GT(left.size(), 0);
+  EXPECT_GT(right.size(), 0);
+  EXPECT_EQ(left.start(), 0);
+  EXPECT_EQ(right.start(), left.size());
+  EXPECT_EQ(left.size() + right.size(), num);
+
+  /* Every reference is inside the bounds of its side. */
+  for (int i = left.start(); i < left.end(); i++) {
+    EXPECT_TRUE(bounds_contain(left.bounds(), references[i].bounds()));
+  }
+  for (int i = right.start(); i < right.end(); i++) {
+    EXPECT_TRUE(bounds_contain(right.bounds(), references[i].bounds()));
+  }
+
+  /* No reference is lost or duplicated by the partition. */
+  vector<int> prim_index(num);
+  for (int i = 0; i < num; i++) {
+    prim_index[i] = references[i].prim_index();
+  }
+  std::sort(prim_index.begin(), prim_index.end());
+  for (int i = 0; i < num; i++) {
+    EXPECT_EQ(prim_index[i], i);
+  }
+}
+
+TEST(BVHObjectBinning, split)
+{
+  test_split(1000);
+}
+
+TEST(BVHObjectBinning, parallel_split)
+{
+  test_split(300000);
+}
+
+/* The parallel binning and partition find the same split as the serial code, and put the same
+ * references on each side. Only the order of references within a side may differ. */
+TEST(BVHObjectBinning, parallel_matches_serial)
+{
+  for (const uint seed : {0u, 1u, 2u, 3u}) {
+    vector<BVHReference> serial_references;
+    const BVHRange root = make_references(200000 + 10000 * seed, serial_references, seed);
+    vector<BVHReference> parallel_references = serial_references;
+
+    const BVHObjectBinningTest serial(root, serial_references.data(), nullptr, nullptr, false);
+    const BVHObjectBinningTest parallel(root, parallel_references.data(), nullptr, nullptr, true);
+    EXPECT_EQ(serial.dim, parallel.dim);
+    EXPECT_EQ(serial.pos, parallel.pos);
+    EXPECT_EQ(serial.splitSAH, parallel.splitSAH);
+    EXPECT_EQ(serial.leafSAH, parallel.leafSAH);
+
+    BVHObjectBinningTest serial_left, serial_right;
+    BVHObjectBinningTest parallel_left, parallel_right;
+    serial.split(serial_references.data(), serial_left, serial_right);
+    parallel.split(parallel_references.data(), parallel_left, parallel_right);
+
+    EXPECT_EQ(serial_left.size(), parallel_left.size());
+    EXPECT_EQ(serial_right.size(), parallel_right.size());
+    EXPECT_TRUE(bounds_equal(serial_left.bounds(), parallel_left.bounds()));
+    EXPECT_TRUE(bounds_equal(serial_right.bounds(), parallel_right.bounds()));
+    EXPECT_TRUE(bounds_equal(serial_left.cent_bounds(), parallel_left.cent_bounds()));
+    EXPECT_TRUE(bounds_equal(serial_right.cent_bounds(), parallel_right.cent_bounds()));
+    EXPECT_EQ(sorted_prim_indices(serial_references.data(), serial_left),
+              sorted_prim_indices(parallel_references.data(), parallel_left));
+    EXPECT_EQ(sorted_prim_indices(serial_references.data(), serial_right),
+              sorted_prim_indices(parallel_references.data(), parallel_right));
+
+    /* The children bin the same references, so they choose the same splits too. */
+    EXPECT_EQ(serial_left.dim, parallel_left.dim);
+    EXPECT_EQ(serial_left.pos, parallel_left.pos);
+    EXPECT_EQ(serial_left.splitSAH, parallel_left.splitSAH);
+    EXPECT_EQ(serial_right.dim, parallel_right.dim);
+    EXPECT_EQ(serial_right.pos, parallel_right.pos);
+    EXPECT_EQ(serial_right.splitSAH, parallel_right.splitSAH);
+  }
+}
+
+/* Bins and splits down to the size where the builder switches to subtree tasks. */
+static double benchmark_binning(const BVHRange &root,
+                                vector<BVHReference> &references,
+                                const bool use_parallel)
+{
+  const double start_time = time_dt();
+
+  vector<BVHObjectBinning> stack;
+  stack.push_back(BVHObjectBinning(root, references.data(), nullptr, nullptr, use_parallel));
+  while (!stack.empty()) {
+    const BVHObjectBinning range = stack.back();
+    stack.pop_back();
+    if (range.size() < 4096) {
+      continue;
+    }
+
+    BVHObjectBinning left;
+    BVHObjectBinning right;
+    range.split(references.data(), left, right);
+    stack.push_back(left);
+    stack.push_back(right);
+  }
+
+  return time_dt() - start_time;
+}
+
+/* Run with --gtest_also_run_disabled_tests to measure the top level build time. */
+TEST(BVHObjectBinning, DISABLED_benchmark)
+{
+  const int num = 4000000;
+  vector<BVHReference> references;
+  const BVHRange root = make_references(num, references);
+
+  vector<BVHReference> serial_references = references;
+  const double serial_time = benchmark_binning(root, serial_references, false);
+  const double parallel_time = benchmark_binning(root, references, true);
+
+  std::cout << "Binned " << num << " references in " << serial_time * 1000.0 << " ms serial, "
+            << parallel_time * 1000.0 << " ms parallel, " << serial_time / parallel_time
+            << "x speedup\n";
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,201 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+
+#include "bvh/bvh2.h"
+
+#include "util/hash.h"
+#include "util/time.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Gives access to packing of wide nodes without building a tree. */
+class BVH2PackTest : public BVH2 {
+ public:
+  BVH2PackTest(const bool use_quantized_nodes)
+      : BVH2(make_params(use_quantized_nodes), vector<Geometry *>(), vector<Object *>())
+  {
+  }
+
+  using BVH2::pack_wide_node;
+
+  void pack_nodes(const vector<BoundBox> &bounds)
+  {
+    const int num_nodes = bounds.size() / BVH4_NODE_CHILDREN;
+    pack.nodes.resize(num_nodes * wide_node_size());
+
+    const int child[BVH4_NODE_CHILDREN] = {~0, ~1, ~2, ~3};
+    const uint visibility[BVH4_NODE_CHILDREN] = {1, 1, 1, 1};
+    for (int i = 0; i < num_nodes; i++) {
+      pack_wide_node(i * wide_node_size(),
+                     &bounds[i * BVH4_NODE_CHILDREN],
+                     child,
+                     visibility,
+                     BVH4_NODE_CHILDREN);
+    }
+  }
+
+  /* Child bounds as read by the kernel, see bvh4_quantized_node_intersect(). */
+  BoundBox child_bounds(const int node, const int child) const
+  {
+    const int4 *data = &pack.nodes[node * wide_node_size()];
+
+    if (!params.use_quantized_nodes) {
+      return BoundBox(make_float3(__int_as_float(data[2][child]),
+                                  __int_as_float(data[4][child]),
+                                  __int_as_float(data[6][child])),
+                      make_float3(__int_as_float(data[3][child]),
+                                  __int_as_float(data[5][child]),
+                                  __int_as_float(data[7][child])));
+    }
+
+    const float3 origin = make_float3(
+        __int_as_float(data[2].x), __int_as_float(data[2].y), __int_as_float(data[2].z));
+    const float3 scale = make_float3(
+        __int_as_float(data[2].w), __int_as_float(data[3].x), __int_as_float(data[3].y));
+    const int shift = child * 8;
+    const float3 qlo = make_float3((float)(((uint)data[3].z >> shift) & 0xff),
+                                   (float)(((uint)data[4].x >> shift) & 0xff),
+                                   (float)(((uint)data[4].z >> shift) & 0xff));
+    const float3 qhi = make_float3((float)(((uint)data[3].w >> shift) & 0xff),
+                                   (float)(((uint)data[4].y >> shift) & 0xff),
+                                   (float)(((uint)data[4].w >> shift) & 0xff));
+    return BoundBox(origin + qlo * scale, origin + qhi * scale);
+  }
+
+ protected:
+  static BVHParams make_params(const bool use_quantized_nodes)
+  {
+    BVHParams params;
+    params.bvh_layout = BVH_LAYOUT_BVH4;
+    params.use_quantized_nodes = use_quantized_nodes;
+    return params;
+  }
+};
+
+/* Groups of four boxes close to each other, at varying scale and distance from the origin. */
+static vector<BoundBox> make_bounds(const int num_nodes)
+{
+  vector<BoundBox> bounds(num_nodes * BVH4_NODE_CHILDREN);
+  for (int i = 0; i < num_nodes; i++) {
+    const float node_scale = powf(10.0f, hash_uint2_to_float(i, 0) * 8.0f - 4.0f);
+    const float3 node_center = make_float3(hash_uint2_to_float(i, 1) - 0.5f,
+                                           hash_uint2_to_float(i, 2) - 0.5f,
+                                           hash_uint2_to_float(i, 3) - 0.5f) *
+                               (node_scale * 100.0f);
+
+    for (int j = 0; j < BVH4_NODE_CHILDREN; j++) {
+      const uint seed = i * BVH4_NODE_CHILDREN + j;
+      const float3 P = node_center + make_float3(hash_uint3_to_float(seed, 0, 1),
+                                                 hash_uint3_to_float(seed, 1, 1),
+                                                 hash_uint3_to_float(seed, 2, 1)) *
+                                         node_scale;
+      const float3 size = make_float3(hash_uint3_to_float(seed, 3, 1),
+                                      hash_uint3_to_float(seed, 4, 1),
+                                      hash_uint3_to_float(seed, 5, 1)) *
+                          (node_scale * 0.5f);
+      bounds[seed] = BoundBox(P, P + size);
+    }
+  }
+  return bounds;
+}
+
+static bool bounds_contain(const BoundBox &outer, const BoundBox &inner)
+{
+  return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+         outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+TEST(BVH2, quantized_nodes_conservative)
+{
+  const int num_nodes = 10000;
+  const vector<BoundBox> bounds = make_bounds(num_nodes);
+
+  BVH2PackTest bvh(true);
+  bvh.pack_nodes(bounds);
+  EXPECT_EQ(bvh.pack.nodes.size(), num_nodes * BVH4_QUANTIZED_NODE_SIZE);
+
+  for (int i = 0; i < num_nodes; i++) {
+    BoundBox node_bounds = BoundBox::empty;
+    for (int j = 0; j < BVH4_NODE_CHILDREN; j++) {
+      node_bounds.grow(bounds[i * BVH4_NODE_CHILDREN + j]);
+    }
+
+    for (int j = 0; j < BVH4_NODE_CHILDREN; j++) {
+      const BoundBox &exact = bounds[i * BVH4_NODE_CHILDREN + j];
+      const BoundBox quantized = bvh.child_bounds(i, j);
+
+      /* Never smaller than the exact box, and not much larger relative to the node. */
+      EXPECT_TRUE(bounds_contain(quantized, exact));
+      const float3 tolerance = node_bounds.size() * (2.0f / 255.0f);
+      EXPECT_TRUE(bounds_contain(BoundBox(exact.min - tolerance, exact.max + tolerance),
+                                 quantized));
+    }
+  }
+}
+
+TEST(BVH2, quantized_nodes_unused_slots)
+{
+  BVH2PackTest bvh(true);
+  bvh.pack.nodes.resize(BVH4_QUANTIZED_NODE_SIZE);
+
+  const BoundBox bounds[2] = {BoundBox(make_float3(0.0f), make_float3(1.0f)),
+                              BoundBox(make_float3(2.0f), make_float3(3.0f))};
+  const int child[2] = {~0, ~1};
+  const uint visibility[2] = {1, 1};
+  bvh.pack_wide_node(0, bounds, child, visibility, 2);
+
+  /* Unused slots are invisible, have no child and an inverted box. */
+  const int4 *data = bvh.pack.nodes.data();
+  EXPECT_EQ(data[0].z, 0);
+  EXPECT_EQ(data[0].w, 0);
+  EXPECT_EQ(data[1].z, 0);
+  EXPECT_EQ(data[1].w, 0);
+  EXPECT_GT(bvh.child_bounds(0, 2).min.x, bvh.child_bounds(0, 2).max.x);
+  EXPECT_GT(bvh.child_bounds(0, 3).min.x, bvh.child_bounds(0, 3).max.x);
+}
+
+/* Compares memory use and the time to test rays against all child boxes of every node, for
+ * full precision and quantized nodes. Run with --gtest_also_run_disabled_tests. */
+TEST(BVH2, DISABLED_quantized_nodes_benchmark)
+{
+  const int num_nodes = 1000000;
+  const int num_rays = 16;
+  const vector<BoundBox> bounds = make_bounds(num_nodes);
+
+  for (const bool use_quantized_nodes : {false, true}) {
+    BVH2PackTest bvh(use_quantized_nodes);
+    bvh.pack_nodes(bounds);
+
+    const double start_time = time_dt();
+    int num_hits = 0;
+    for (int r = 0; r < num_rays; r++) {
+      const float3 P = make_float3(0.0f);
+      const float3 D = normalize(make_float3(hash_uint2_to_float(r, 0) - 0.5f,
+                                             hash_uint2_to_float(r, 1) - 0.5f,
+                                             hash_uint2_to_float(r, 2) - 0.5f));
+      const float3 idir = reciprocal(D);
+      for (int i = 0; i < num_nodes; i++) {
+        for (int j = 0; j < BVH4_NODE_CHILDREN; j++) {
+          const BoundBox b = bvh.child_bounds(i, j);
+          const float3 t0 = (b.min - P) * idir;
+          const float3 t1 = (b.max - P) * idir;
+          const float t_near = reduce_max(min(t0, t1));
+          const float t_far = reduce_min(max(t0, t1));
+          num_hits += (t_near <= t_far && t_far >= 0.0f);
+        }
+      }
+    }
+
+    std::cout << (use_quantized_nodes ? "Quantized" : "Full precision") << " nodes: "
+              << bvh.pack.nodes.size() * sizeof(int4) / (1024 * 1024) << " MB, "
+              << (time_dt() - start_time) * 1000.0 << " ms, " << num_hits << " hits\n";
+  }
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,326 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "bvh/bvh2.h"
+
+#include "scene/mesh.h"
+#include "scene/object.h"
+
+#include "util/hash.h"
+#include "util/progress.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Mesh with small triangles scattered in a unit cube. */
+static void create_scattered_triangles(Mesh &mesh, const int num_triangles)
+{
+  array<float3> verts(num_triangles * 3);
+  array<int> triangles(num_triangles * 3);
+  array<int> shader_index(num_triangles);
+  array<bool> smooth(num_triangles);
+  for (int i = 0; i < num_triangles; i++) {
+    const float3 P = make_float3(
+        hash_uint2_to_float(i, 0), hash_uint2_to_float(i, 1), hash_uint2_to_float(i, 2));
+    for (int k = 0; k < 3; k++) {
+      const float3 offset = make_float3(hash_uint2_to_float(i, 3 + k * 3),
+                                        hash_uint2_to_float(i, 4 + k * 3),
+                                        hash_uint2_to_float(i, 5 + k * 3));
+      verts[i * 3 + k] = P + offset * 1e-2f;
+      triangles[i * 3 + k] = i * 3 + k;
+    }
+    shader_index[i] = 0;
+    smooth[i] = false;
+  }
+  mesh.set_verts(verts);
+  mesh.set_triangles(triangles);
+  mesh.set_shader(shader_index);
+  mesh.set_smooth(smooth);
+}
+
+static bool bounds_contain(const BoundBox &outer, const BoundBox &inner)
+{
+  return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+         outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+/* Bounds of a child of a packed aligned BVH2 inner node. */
+static BoundBox node_child_bounds(const int4 *data, const int i)
+{
+  return BoundBox(make_float3(__int_as_float(data[1][i]),
+                              __int_as_float(data[2][i]),
+                              __int_as_float(data[3][i])),
+                  make_float3(__int_as_float(data[1][i + 2]),
+                              __int_as_float(data[2][i + 2]),
+                              __int_as_float(data[3][i + 2])));
+}
+
+/* Object level BVH2 of a mesh with small triangles scattered in a unit cube. */
+class BVH2Refit : public testing::Test {
+ protected:
+  Mesh mesh;
+  Object object;
+  Progress progress;
+  unique_ptr<BVH2> bvh;
+
+  void SetUp() override
+  {
+    create_scattered_triangles(mesh, 1000);
+
+    object.set_visibility(~0);
+    object.set_geometry(&mesh);
+
+    BVHParams params;
+    params.bvh_layout = BVH_LAYOUT_BVH2;
+    params.bvh_type = BVH_TYPE_DYNAMIC;
+    /* Leaves of spatial splits only bound the clipped part of their triangles. */
+    params.use_spatial_split = false;
+
+    vector<Geometry *> geometry;
+    geometry.push_back(&mesh);
+    vector<Object *> objects;
+    objects.push_back(&object);
+
+    bvh = make_unique<BVH2>(params, geometry, objects);
+    bvh->build(progress, nullptr);
+  }
+
+  BoundBox triangle_bounds(const int prim) const
+  {
+    BoundBox bounds = BoundBox::empty;
+    mesh.get_triangle(bvh->pack.prim_index[prim]).bounds_grow(mesh.get_verts().data(), bounds);
+    return bounds;
+  }
+
+  /* Checks that the child boxes of every inner node contain all triangles below them. Returns
+   * the bounds of those triangles. */
+  BoundBox check_node(const int idx, const bool leaf, int &num_prims) const
+  {
+    BoundBox bounds = BoundBox::empty;
+
+    if (leaf) {
+      const int4 data = bvh->pack.leaf_nodes[idx];
+      for (int prim = data.x; prim < data.y; prim++) {
+        bounds.grow(triangle_bounds(prim));
+        num_prims++;
+      }
+      return bounds;
+    }
+
+    const int4 *data = &bvh->pack.nodes[idx];
+    const int child[2] = {data[0].z, data[0].w};
+    for (int i = 0; i < 2; i++) {
+      const BoundBox child_bounds = node_child_bounds(data, i);
+      const BoundBox prim_bounds = (child[i] < 0) ? check_node(~child[i], true, num_prims) :
+                                                    check_node(child[i], false, num_prims);
+      EXPECT_TRUE(bounds_contain(child_bounds, prim_bounds));
+      bounds.grow(prim_bounds);
+    }
+    return bounds;
+  }
+
+  void check_bounds() const
+  {
+    int num_prims = 0;
+    const BoundBox bounds = check_node(0, bvh->pack.root_index == -1, num_prims);
+    EXPECT_EQ(num_prims, (int)mesh.num_triangles());
+    EXPECT_TRUE(bounds_contain(bounds, mesh.bounds));
+  }
+};
+
+/* Moving a vertex to the middle of the mesh grows the boxes above its triangle, the tree itself
+ * is kept. */
+TEST_F(BVH2Refit, vertex_move)
+{
+  const float build_sah_cost = bvh->build_sah_cost;
+  const vector<int> prim_index(bvh->pack.prim_index.begin(), bvh->pack.prim_index.end());
+
+  mesh.get_verts()[0] = make_float3(0.5f, 0.5f, 0.5f);
+  mesh.compute_bounds();
+  bvh->refit(progress);
+
+  check_bounds();
+  EXPECT_EQ(bvh->build_sah_cost, build_sah_cost);
+  EXPECT_GT(bvh->refit_sah_cost, build_sah_cost);
+  EXPECT_LE(bvh->refit_sah_cost, build_sah_cost * bvh->params.refit_sah_threshold);
+  EXPECT_EQ(vector<int>(bvh->pack.prim_index.begin(), bvh->pack.prim_index.end()), prim_index);
+}
+
+/* Scattering all triangles to new places makes the refit tree much more expensive to traverse
+ * than a new one, so it is rebuilt. */
+TEST_F(BVH2Refit, sah_degradation_rebuild)
+{
+  const float build_sah_cost = bvh->build_sah_cost;
+  const vector<int> prim_index(bvh->pack.prim_index.begin(), bvh->pack.prim_index.end());
+
+  array<float3> &verts = mesh.get_verts();
+  for (size_t i = 0; i < mesh.num_triangles(); i++) {
+    const float3 offset = make_float3(hash_uint2_to_float(i, 20) - 0.5f,
+                                      hash_uint2_to_float(i, 21) - 0.5f,
+                                      hash_uint2_to_float(i, 22) - 0.5f);
+    for (int k = 0; k < 3; k++) {
+      verts[i * 3 + k] += offset;
+    }
+  }
+  mesh.compute_bounds();
+  bvh->refit(progress);
+
+  check_bounds();
+
+  /* The rebuilt tree has a new topology and about the original quality. */
+  EXPECT_EQ(bvh->refit_sah_cost, bvh->build_sah_cost);
+  EXPECT_LT(bvh->build_sah_cost, build_sah_cost * bvh->params.refit_sah_threshold);
+  EXPECT_NE(vector<int>(bvh->pack.prim_index.begin(), bvh->pack.prim_index.end()), prim_index);
+}
+
+/* Top level BVH2 of instances of a mesh on a row, with the mesh BVH merged into it like for
+ * scene updates. */
+class BVH2TopLevelRefit : public testing::Test {
+ protected:
+  static constexpr int num_instances = 8;
+
+  Mesh mesh;
+  Object mesh_object;
+  Object instances[num_instances];
+  vector<Geometry *> geometry;
+  vector<Object *> objects;
+  Progress progress;
+  BVHParams params;
+
+  void SetUp() override
+  {
+    create_scattered_triangles(mesh, 100);
+    mesh.compute_bounds();
+
+    /* Geometry level BVH, like Geometry::compute_bvh(). */
+    params.bvh_layout = BVH_LAYOUT_BVH2;
+    params.bvh_type = BVH_TYPE_DYNAMIC;
+    params.use_spatial_split = false;
+
+    mesh_object.set_visibility(~0);
+    mesh_object.set_geometry(&mesh);
+    unique_ptr<BVH2> mesh_bvh = make_unique<BVH2>(
+        params, vector<Geometry *>{&mesh}, vector<Object *>{&mesh_object});
+    mesh_bvh->build(progress, nullptr);
+    mesh.bvh = std::move(mesh_bvh);
+
+    geometry.push_back(&mesh);
+    for (int i = 0; i < num_instances; i++) {
+      instances[i].set_visibility(~0);
+      instances[i].set_geometry(&mesh);
+      move_instance(i, make_float3(i * 2.0f, 0.0f, 0.0f));
+      objects.push_back(&instances[i]);
+    }
+
+    params.top_level = true;
+  }
+
+  void move_instance(const int i, const float3 P)
+  {
+    instances[i].set_tfm(transform_translate(P));
+    instances[i].compute_bounds(false);
+  }
+
+  unique_ptr<BVH2> build()
+  {
+    unique_ptr<BVH2> bvh = make_unique<BVH2>(params, geometry, objects);
+    bvh->build(progress, nullptr);
+    return bvh;
+  }
+
+  /* Checks that the child boxes of every top level inner node contain the instances below them,
+   * and counts how often every instance is reached. Returns the bounds of those instances. */
+  BoundBox check_node(const BVH2 &bvh, const int idx, const bool leaf, vector<int> &num_visits)
+  {
+    BoundBox bounds = BoundBox::empty;
+
+    if (leaf) {
+      const int4 data = bvh.pack.leaf_nodes[idx];
+      const int start = (data.x < 0) ? ~data.x : data.x;
+      const int end = (data.x < 0) ? start + 1 : data.y;
+      for (int prim = start; prim < end; prim++) {
+        EXPECT_EQ(bvh.pack.prim_index[prim], -1);
+        const int object = bvh.pack.prim_object[prim];
+        bounds.grow(instances[object].bounds);
+        num_visits[object]++;
+      }
+      return bounds;
+    }
+
+    const int4 *data = &bvh.pack.nodes[idx];
+    const int child[2] = {data[0].z, data[0].w};
+    for (int i = 0; i < 2; i++) {
+      const BoundBox child_bounds = node_child_bounds(data, i);
+      const BoundBox object_bounds = (child[i] < 0) ?
+                                         check_node(bvh, ~child[i], true, num_visits) :
+                                         check_node(bvh, child[i], false, num_visits);
+      EXPECT_TRUE(bounds_contain(child_bounds, object_bounds));
+      bounds.grow(object_bounds);
+    }
+    return bounds;
+  }
+
+  /* Every instance is reached once, and all instances point to the merged mesh BVH, which is
+   * stored after the top level nodes. */
+  BoundBox check_bvh(const BVH2 &bvh)
+  {
+    vector<int> num_visits(num_instances, 0);
+    const BoundBox bounds = check_node(bvh, 0, bvh.pack.root_index == -1, num_visits);
+    EXPECT_EQ(num_visits, vector<int>(num_instances, 1));
+
+    const BVH2 *instance_bvh = static_cast<const BVH2 *>(mesh.bvh.get());
+    const int mesh_node = bvh.pack.nodes.size() - instance_bvh->pack.nodes.size();
+    EXPECT_EQ(bvh.pack.object_node.size(), num_instances);
+    for (const int node : bvh.pack.object_node) {
+      EXPECT_EQ(node, mesh_node);
+    }
+    EXPECT_EQ(bvh.pack.prim_index.size(),
+              num_instances + instance_bvh->pack.prim_index.size());
+    return bounds;
+  }
+};
+
+/* Refitting after the packed data was moved to the device only keeps the top level part, and
+ * merges the mesh BVH in again. The boxes of the moved instances grow, and the tree bounds the
+ * same instances as a new build. */
+TEST_F(BVH2TopLevelRefit, moved_instances)
+{
+  unique_ptr<BVH2> bvh = build();
+  const PackedBVH device_pack = bvh->take_pack(true);
+  EXPECT_LT(bvh->pack.nodes.size(), device_pack.nodes.size());
+  EXPECT_LT(bvh->pack.prim_index.size(), device_pack.prim_index.size());
+  EXPECT_EQ(bvh->pack.object_node.size(), 0);
+
+  move_instance(1, make_float3(2.0f, 0.5f, 0.0f));
+  move_instance(5, make_float3(10.0f, 0.0f, 0.5f));
+  const float build_sah_cost = bvh->build_sah_cost;
+  bvh->refit(progress);
+
+  /* The tree was refit, not rebuilt. */
+  EXPECT_EQ(bvh->build_sah_cost, build_sah_cost);
+  EXPECT_EQ(bvh->pack.nodes.size(), device_pack.nodes.size());
+  EXPECT_EQ(bvh->pack.leaf_nodes.size(), device_pack.leaf_nodes.size());
+  EXPECT_EQ(bvh->pack.prim_visibility.size(), device_pack.prim_visibility.size());
+
+  const BoundBox refit_bounds = check_bvh(*bvh);
+  const BoundBox build_bounds = check_bvh(*build());
+  EXPECT_EQ(refit_bounds.min, build_bounds.min);
+  EXPECT_EQ(refit_bounds.max, build_bounds.max);
+}
+
+/* Without keeping the top level part, nothing is left to refit. */
+TEST_F(BVH2TopLevelRefit, take_pack)
+{
+  unique_ptr<BVH2> bvh = build();
+  const size_t num_nodes = bvh->pack.nodes.size();
+  const PackedBVH device_pack = bvh->take_pack(false);
+
+  EXPECT_EQ(device_pack.nodes.size(), num_nodes);
+  EXPECT_EQ(bvh->pack.nodes.size(), 0);
+  EXPECT_EQ(bvh->pack.prim_index.size(), 0);
+}
+
+CCL_NAMESPACE_END
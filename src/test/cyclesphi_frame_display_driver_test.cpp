@@ -0,0 +1,183 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "cyclesphi/frame_display_driver.h"
+
+#include "util/hash.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Driver with pixels rendered at a lower resolution, filled with random bytes. The full size
+ * pixels are filled with a marker, to find the bytes which were not written. */
+static void init_driver(FrameDisplayDriver &driver,
+                        const int texture_width,
+                        const int texture_height,
+                        const int width,
+                        const int height)
+{
+  driver.texture_width = texture_width;
+  driver.texture_height = texture_height;
+  driver.width = width;
+  driver.height = height;
+
+  driver.texture_pixels.resize(size_t(texture_width) * texture_height);
+  uchar *texture_bytes = reinterpret_cast<uchar *>(driver.texture_pixels.data());
+  for (size_t i = 0; i < driver.texture_pixels.size() * sizeof(half4); i++) {
+    texture_bytes[i] = uchar(hash_uint(i));
+  }
+
+  driver.pixels.resize(size_t(width) * height);
+  memset(driver.pixels.data(), 0xAB, driver.pixels.size() * sizeof(half4));
+}
+
+/* Every pixel of the plane is a copy of the source pixel it falls into. */
+static void expect_nearest_plane(const uchar *src,
+                                 const int src_width,
+                                 const int src_height,
+                                 const uchar *dst,
+                                 const int dst_width,
+                                 const int dst_height,
+                                 const size_t pixel_size,
+                                 const char *name)
+{
+  int num_wrong = 0;
+  for (int y = 0; y < dst_height; y++) {
+    const int src_y = y * src_height / dst_height;
+    for (int x = 0; x < dst_width; x++) {
+      const int src_x = x * src_width / dst_width;
+      num_wrong += memcmp(dst + (size_t(y) * dst_width + x) * pixel_size,
+                          src + (size_t(src_y) * src_width + src_x) * pixel_size,
+                          pixel_size) != 0;
+    }
+  }
+  EXPECT_EQ(num_wrong, 0) << name << " " << src_width << "x" << src_height << " to " << dst_width
+                          << "x" << dst_height;
+}
+
+/* Only the bytes of the pixels in the current format are written. */
+static void expect_written_size(const FrameDisplayDriver &driver)
+{
+  const uchar *bytes = reinterpret_cast<const uchar *>(driver.pixels.data());
+  const size_t size = driver.pixels.size() * sizeof(half4);
+  const size_t pixels_size = driver.pixels_size();
+  ASSERT_LE(pixels_size, size);
+
+  int num_written = 0;
+  for (size_t i = pixels_size; i < size; i++) {
+    num_written += bytes[i] != 0xAB;
+  }
+  EXPECT_EQ(num_written, 0);
+}
+
+/* Sizes of the texture and pixels, with an exact resolution divider, with odd sizes which are
+ * not a multiple of the texture size, and with a single texture pixel. */
+static const int upsample_sizes[][4] = {
+    {4, 3, 16, 12}, {5, 3, 17, 9}, {7, 5, 15, 11}, {1, 1, 7, 5}};
+
+TEST(FrameDisplayDriver, upsample_half4)
+{
+  for (const auto &size : upsample_sizes) {
+    FrameDisplayDriver driver;
+    init_driver(driver, size[0], size[1], size[2], size[3]);
+    driver.upsample_texture();
+
+    expect_nearest_plane(reinterpret_cast<const uchar *>(driver.texture_pixels.data()),
+                         size[0],
+                         size[1],
+                         reinterpret_cast<const uchar *>(driver.pixels.data()),
+                         size[2],
+                         size[3],
+                         sizeof(half4),
+                         "half4");
+  }
+}
+
+TEST(FrameDisplayDriver, upsample_uchar4)
+{
+  for (const auto &size : upsample_sizes) {
+    FrameDisplayDriver driver;
+    driver.use_linear2srgb = true;
+    init_driver(driver, size[0], size[1], size[2], size[3]);
+    driver.upsample_texture();
+
+    expect_nearest_plane(reinterpret_cast<const uchar *>(driver.texture_pixels.data()),
+                         size[0],
+                         size[1],
+                         reinterpret_cast<const uchar *>(driver.pixels.data()),
+                         size[2],
+                         size[3],
+                         sizeof(uchar4),
+                         "uchar4");
+    expect_written_size(driver);
+  }
+}
+
+/* The Y plane is followed by the U and V planes of half the size rounded up, odd sizes give
+ * chroma planes with an extra row and column. */
+TEST(FrameDisplayDriver, upsample_yuv420)
+{
+  for (const auto &size : upsample_sizes) {
+    FrameDisplayDriver driver;
+    driver.use_yuv420 = true;
+    init_driver(driver, size[0], size[1], size[2], size[3]);
+    driver.upsample_texture();
+
+    const uchar *src = reinterpret_cast<const uchar *>(driver.texture_pixels.data());
+    const uchar *dst = reinterpret_cast<const uchar *>(driver.pixels.data());
+    expect_nearest_plane(src, size[0], size[1], dst, size[2], size[3], 1, "Y");
+
+    const int src_chroma_width = (size[0] + 1) / 2;
+    const int src_chroma_height = (size[1] + 1) / 2;
+    const int dst_chroma_width = (size[2] + 1) / 2;
+    const int dst_chroma_height = (size[3] + 1) / 2;
+    src += size[0] * size[1];
+    dst += size[2] * size[3];
+    for (const char *plane : {"U", "V"}) {
+      expect_nearest_plane(src,
+                           src_chroma_width,
+                           src_chroma_height,
+                           dst,
+                           dst_chroma_width,
+                           dst_chroma_height,
+                           1,
+                           plane);
+      src += src_chroma_width * src_chroma_height;
+      dst += dst_chroma_width * dst_chroma_height;
+    }
+
+    EXPECT_EQ(driver.pixels_size(),
+              size_t(size[2] * size[3] + 2 * dst_chroma_width * dst_chroma_height));
+    expect_written_size(driver);
+  }
+}
+
+/* With an exact resolution divider every texture pixel becomes a block of pixels. */
+TEST(FrameDisplayDriver, upsample_blocks)
+{
+  FrameDisplayDriver driver;
+  driver.use_linear2srgb = true;
+  init_driver(driver, 2, 2, 6, 4);
+  const uchar4 texture[4] = {make_uchar4(1, 2, 3, 4),
+                             make_uchar4(5, 6, 7, 8),
+                             make_uchar4(9, 10, 11, 12),
+                             make_uchar4(13, 14, 15, 16)};
+  memcpy(driver.texture_pixels.data(), texture, sizeof(texture));
+  driver.upsample_texture();
+
+  const uchar4 *pixels = reinterpret_cast<const uchar4 *>(driver.pixels.data());
+  for (int y = 0; y < 4; y++) {
+    for (int x = 0; x < 6; x++) {
+      const uchar4 expected = texture[(y / 2) * 2 + x / 3];
+      EXPECT_EQ(pixels[y * 6 + x].x, expected.x) << x << " " << y;
+      EXPECT_EQ(pixels[y * 6 + x].w, expected.w) << x << " " << y;
+    }
+  }
+}
+
+CCL_NAMESPACE_END
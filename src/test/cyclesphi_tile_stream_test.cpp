@@ -0,0 +1,217 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "cyclesphi/tile_stream.h"
+
+#include "util/hash.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Message of TileStream::pack split into its parts. */
+struct TileStreamMessage {
+  int num_changed_tiles = 0;
+  vector<uchar> bitmap;
+  vector<int> changed_tiles;
+  vector<char> pixels;
+
+  TileStreamMessage(const vector<char> &message, const int num_tiles)
+  {
+    const char *data = message.data();
+    memcpy(&num_changed_tiles, data, sizeof(int));
+    data += sizeof(int);
+
+    bitmap.assign(data, data + divide_up(num_tiles, 8));
+    data += bitmap.size();
+
+    changed_tiles.resize(num_changed_tiles);
+    memcpy(changed_tiles.data(), data, num_changed_tiles * sizeof(int));
+    data += num_changed_tiles * sizeof(int);
+
+    pixels.assign(data, message.data() + message.size());
+  }
+};
+
+static vector<char> make_pixels(const size_t size, const uint seed)
+{
+  vector<char> pixels(size);
+  for (size_t i = 0; i < size; i++) {
+    pixels[i] = char(hash_uint2(i, seed));
+  }
+  return pixels;
+}
+
+/* Rows of a tile in a plane of pixels. */
+static void append_tile_rows(const char *plane,
+                             const int width,
+                             const int height,
+                             const int bytes_per_pixel,
+                             const int x0,
+                             const int y0,
+                             const int tile_size,
+                             vector<char> &rows)
+{
+  const int x1 = min(x0 + tile_size, width);
+  const int y1 = min(y0 + tile_size, height);
+  for (int y = y0; y < y1; y++) {
+    const char *row = plane + (size_t(y) * width + x0) * bytes_per_pixel;
+    rows.insert(rows.end(), row, row + (x1 - x0) * bytes_per_pixel);
+  }
+}
+
+/* All tiles are sent for the first frame and after a change of the image size, even if the size
+ * of the pixels stays the same. */
+TEST(TileStream, send_all_after_resize)
+{
+  const int bytes_per_pixel = 8;
+  const vector<uchar> converged;
+  TileStream stream;
+  vector<char> message;
+
+  const vector<char> pixels = make_pixels(70 * 40 * bytes_per_pixel, 0);
+  stream.pack(pixels.data(), 70, 40, bytes_per_pixel, false, converged, message);
+
+  const TileStreamMessage first(message, 3 * 2);
+  EXPECT_EQ(stream.num_changed_tiles(), 6);
+  EXPECT_EQ(first.changed_tiles, vector<int>({0, 1, 2, 3, 4, 5}));
+
+  vector<char> expected_pixels;
+  for (int tile = 0; tile < 6; tile++) {
+    append_tile_rows(pixels.data(),
+                     70,
+                     40,
+                     bytes_per_pixel,
+                     (tile % 3) * TILE_STREAM_SIZE,
+                     (tile / 3) * TILE_STREAM_SIZE,
+                     TILE_STREAM_SIZE,
+                     expected_pixels);
+  }
+  EXPECT_EQ(first.pixels, expected_pixels);
+
+  /* Same pixels, nothing to send. */
+  stream.pack(pixels.data(), 70, 40, bytes_per_pixel, false, converged, message);
+  EXPECT_EQ(stream.num_changed_tiles(), 0);
+  EXPECT_EQ(message.size(), sizeof(int) + 1);
+
+  /* Transposed image of the same size in bytes. */
+  stream.pack(pixels.data(), 40, 70, bytes_per_pixel, false, converged, message);
+  const TileStreamMessage resized(message, 2 * 3);
+  EXPECT_EQ(stream.num_changed_tiles(), 6);
+  EXPECT_EQ(resized.pixels.size(), pixels.size());
+}
+
+/* Later calls only send the tiles with changed pixels, in row major order. */
+TEST(TileStream, changed_tiles)
+{
+  const int width = 100;
+  const int height = 70;
+  const int bytes_per_pixel = 4;
+  const vector<uchar> converged;
+  TileStream stream;
+  vector<char> message;
+
+  vector<char> pixels = make_pixels(width * height * bytes_per_pixel, 0);
+  stream.pack(pixels.data(), width, height, bytes_per_pixel, false, converged, message);
+
+  /* Last pixel of the last tile in the first row, first pixel of the second tile in the third
+   * row. */
+  pixels[(size_t(TILE_STREAM_SIZE - 1) * width + width - 1) * bytes_per_pixel] ^= 1;
+  pixels[(size_t(2 * TILE_STREAM_SIZE) * width + TILE_STREAM_SIZE) * bytes_per_pixel + 3] ^= 1;
+  stream.pack(pixels.data(), width, height, bytes_per_pixel, false, converged, message);
+
+  const TileStreamMessage changed(message, 4 * 3);
+  EXPECT_EQ(stream.num_changed_tiles(), 2);
+  EXPECT_EQ(changed.changed_tiles, vector<int>({3, 9}));
+
+  vector<char> expected_pixels;
+  append_tile_rows(pixels.data(),
+                   width,
+                   height,
+                   bytes_per_pixel,
+                   3 * TILE_STREAM_SIZE,
+                   0,
+                   TILE_STREAM_SIZE,
+                   expected_pixels);
+  append_tile_rows(pixels.data(),
+                   width,
+                   height,
+                   bytes_per_pixel,
+                   TILE_STREAM_SIZE,
+                   2 * TILE_STREAM_SIZE,
+                   TILE_STREAM_SIZE,
+                   expected_pixels);
+  EXPECT_EQ(changed.pixels, expected_pixels);
+}
+
+/* The rows of the Y plane of a tile are followed by those of the U and V planes, which have half
+ * the resolution. A change in a chroma plane sends the tile. */
+TEST(TileStream, yuv420)
+{
+  const int width = 70;
+  const int height = 40;
+  const int chroma_width = 35;
+  const int chroma_height = 20;
+  const size_t luma_size = width * height;
+  const size_t chroma_size = chroma_width * chroma_height;
+  const vector<uchar> converged;
+  TileStream stream;
+  vector<char> message;
+
+  vector<char> pixels = make_pixels(luma_size + 2 * chroma_size, 0);
+  stream.pack(pixels.data(), width, height, 1, true, converged, message);
+  EXPECT_EQ(TileStreamMessage(message, 3 * 2).pixels.size(), pixels.size());
+
+  /* V of the last tile of the first row. */
+  pixels[luma_size + chroma_size + 5 * chroma_width + 34] ^= 1;
+  stream.pack(pixels.data(), width, height, 1, true, converged, message);
+
+  const TileStreamMessage changed(message, 3 * 2);
+  EXPECT_EQ(changed.changed_tiles, vector<int>({2}));
+
+  const int half_tile = TILE_STREAM_SIZE / 2;
+  vector<char> expected_pixels;
+  append_tile_rows(
+      pixels.data(), width, height, 1, 2 * TILE_STREAM_SIZE, 0, TILE_STREAM_SIZE, expected_pixels);
+  for (int plane = 0; plane < 2; plane++) {
+    append_tile_rows(pixels.data() + luma_size + plane * chroma_size,
+                     chroma_width,
+                     chroma_height,
+                     1,
+                     2 * half_tile,
+                     0,
+                     half_tile,
+                     expected_pixels);
+  }
+  /* 6 x 32 luma and 3 x 16 chroma pixels. */
+  EXPECT_EQ(expected_pixels.size(), 6 * 32 + 2 * 3 * 16);
+  EXPECT_EQ(changed.pixels, expected_pixels);
+}
+
+/* Bit (i % 8) of byte (i / 8) of the bitmap is set for converged tile i. */
+TEST(TileStream, convergence_bitmap)
+{
+  const int width = 3 * TILE_STREAM_SIZE;
+  const int height = 4 * TILE_STREAM_SIZE;
+  TileStream stream;
+  vector<char> message;
+
+  const vector<char> pixels = make_pixels(width * height * 4, 0);
+  vector<uchar> converged(3 * 4, 0);
+  converged[0] = 1;
+  converged[3] = 1;
+  converged[9] = 1;
+  stream.pack(pixels.data(), width, height, 4, false, converged, message);
+  EXPECT_EQ(TileStreamMessage(message, 3 * 4).bitmap, vector<uchar>({0x09, 0x02}));
+
+  /* A bitmap of another image size is ignored. */
+  converged.resize(2 * 4);
+  stream.pack(pixels.data(), width, height, 4, false, converged, message);
+  EXPECT_EQ(TileStreamMessage(message, 3 * 4).bitmap, vector<uchar>({0x00, 0x00}));
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,128 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "device/cpu/kernel.h"
+#include "device/device.h"
+
+#include "kernel/types.h"
+
+#include "scene/integrator.h"
+
+#include "util/debug.h"
+
+#include "session_render_test.h"
+
+CCL_NAMESPACE_BEGIN
+
+TEST(CPUKernels, megakernel_for_features)
+{
+  const CPUKernels &kernels = Device::get_cpu_kernels();
+  DebugFlags().cpu.specialized_megakernels = true;
+
+  const uint surface_features = KERNEL_FEATURE_PATH_TRACING | KERNEL_FEATURE_NODE_BSDF |
+                                KERNEL_FEATURE_TRANSPARENT | KERNEL_FEATURE_DENOISING;
+
+  EXPECT_EQ(&kernels.integrator_megakernel_for_features(surface_features),
+            &kernels.integrator_megakernel_surface);
+  EXPECT_EQ(&kernels.integrator_megakernel_for_features(surface_features | KERNEL_FEATURE_VOLUME),
+            &kernels.integrator_megakernel_volume);
+  EXPECT_EQ(&kernels.integrator_megakernel_for_features(surface_features | KERNEL_FEATURE_HAIR),
+            &kernels.integrator_megakernel);
+  EXPECT_EQ(&kernels.integrator_megakernel_for_features(
+                surface_features | KERNEL_FEATURE_VOLUME | KERNEL_FEATURE_SUBSURFACE),
+            &kernels.integrator_megakernel);
+  EXPECT_EQ(&kernels.integrator_megakernel_for_features(~0U), &kernels.integrator_megakernel);
+
+  DebugFlags().cpu.specialized_megakernels = false;
+  EXPECT_EQ(&kernels.integrator_megakernel_for_features(surface_features),
+            &kernels.integrator_megakernel);
+  DebugFlags().cpu.reset();
+}
+
+/* Renders of boxes lit by the background, with a diffuse and a glossy surface, and a scattering
+ * volume box when the parameter is set. The specialized megakernel for the features of the scene
+ * renders the same as the generic megakernel. */
+class CPUKernelsMegakernelRender : public testing::TestWithParam<bool> {
+ protected:
+  void TearDown() override
+  {
+    DebugFlags().cpu.reset();
+  }
+
+  vector<float> render(const bool specialized_megakernels, uint &kernel_features)
+  {
+    DebugFlags().cpu.specialized_megakernels = specialized_megakernels;
+
+    const bool use_volume = GetParam();
+    return session_render_test(
+        [use_volume](Scene *scene) {
+          session_render_test_set_background(scene, 1.0f);
+
+          unique_ptr<ShaderGraph> diffuse_graph = make_unique<ShaderGraph>();
+          DiffuseBsdfNode *diffuse = diffuse_graph->create_node<DiffuseBsdfNode>();
+          diffuse->set_color(make_float3(0.8f, 0.5f, 0.2f));
+          diffuse_graph->connect(diffuse->output("BSDF"),
+                                 diffuse_graph->output()->input("Surface"));
+          session_render_test_add_box(
+              scene,
+              session_render_test_add_shader(scene, std::move(diffuse_graph)),
+              make_float3(-2.0f, -2.0f, 1.0f),
+              make_float3(2.0f, 2.0f, 2.0f));
+
+          unique_ptr<ShaderGraph> glossy_graph = make_unique<ShaderGraph>();
+          GlossyBsdfNode *glossy = glossy_graph->create_node<GlossyBsdfNode>();
+          glossy->set_roughness(0.3f);
+          glossy_graph->connect(glossy->output("BSDF"), glossy_graph->output()->input("Surface"));
+          session_render_test_add_box(
+              scene,
+              session_render_test_add_shader(scene, std::move(glossy_graph)),
+              make_float3(-0.6f, -0.6f, -0.5f),
+              make_float3(0.2f, 0.2f, 0.5f));
+
+          if (use_volume) {
+            unique_ptr<ShaderGraph> volume_graph = make_unique<ShaderGraph>();
+            ScatterVolumeNode *scatter = volume_graph->create_node<ScatterVolumeNode>();
+            scatter->set_density(2.0f);
+            volume_graph->connect(scatter->output("Volume"),
+                                  volume_graph->output()->input("Volume"));
+            session_render_test_add_box(
+                scene,
+                session_render_test_add_shader(scene, std::move(volume_graph)),
+                make_float3(0.0f, 0.0f, -1.0f),
+                make_float3(1.0f, 1.0f, 0.8f));
+          }
+        },
+        16,
+        16,
+        &kernel_features);
+  }
+};
+
+TEST_P(CPUKernelsMegakernelRender, matches_generic)
+{
+  const CPUKernels &kernels = Device::get_cpu_kernels();
+
+  uint kernel_features = 0;
+  const vector<float> specialized = render(true, kernel_features);
+  EXPECT_EQ(&kernels.integrator_megakernel_for_features(kernel_features),
+            GetParam() ? &kernels.integrator_megakernel_volume :
+                         &kernels.integrator_megakernel_surface);
+
+  const vector<float> generic = render(false, kernel_features);
+  EXPECT_EQ(&kernels.integrator_megakernel_for_features(kernel_features),
+            &kernels.integrator_megakernel);
+
+  ASSERT_EQ(specialized.size(), generic.size());
+  for (size_t i = 0; i < generic.size(); i++) {
+    EXPECT_NEAR(specialized[i], generic[i], 1e-4f * max(1.0f, fabsf(generic[i])))
+        << "pixel " << i / 4 << " channel " << i % 4;
+  }
+  EXPECT_GT(session_render_test_average(generic), 0.0f);
+}
+
+INSTANTIATE_TEST_SUITE_P(Volume, CPUKernelsMegakernelRender, testing::Bool());
+
+CCL_NAMESPACE_END
@@ -0,0 +1,64 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "device/cpu/scene_store.h"
+
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+TEST(CPUSceneStore, share_identical)
+{
+  /* Local store, independent of the process wide instance. */
+  CPUSceneStore store;
+
+  vector<int> a(1000, 1);
+  vector<int> b(1000, 1);
+  vector<int> c(1000, 1);
+  c[999] = 2;
+
+  const size_t size = a.size() * sizeof(int);
+  EXPECT_EQ(store.acquire(a.data(), size), a.data());
+  EXPECT_EQ(store.acquire(b.data(), size), a.data());
+  EXPECT_EQ(store.acquire(c.data(), size), c.data());
+
+  EXPECT_EQ(store.num_allocations(), 2);
+  EXPECT_EQ(store.saved_size(), size);
+}
+
+TEST(CPUSceneStore, share_different_size)
+{
+  CPUSceneStore store;
+
+  vector<char> a(100, 0);
+
+  EXPECT_EQ(store.acquire(a.data(), 100), a.data());
+  EXPECT_EQ(store.acquire(a.data() + 50, 50), a.data() + 50);
+  EXPECT_EQ(store.num_allocations(), 2);
+}
+
+TEST(CPUSceneStore, release)
+{
+  CPUSceneStore store;
+
+  vector<int> a(1000, 1);
+  vector<int> b(1000, 1);
+  vector<int> unshared(1000, 1);
+
+  const size_t size = a.size() * sizeof(int);
+  store.acquire(a.data(), size);
+  store.acquire(b.data(), size);
+
+  EXPECT_EQ(store.release(unshared.data()), CPUSceneStore::Release::NOT_SHARED);
+  EXPECT_EQ(store.release(a.data()), CPUSceneStore::Release::SHARED);
+  EXPECT_EQ(store.release(a.data()), CPUSceneStore::Release::LAST_USER);
+  EXPECT_EQ(store.num_allocations(), 0);
+
+  /* Released memory is no longer found. */
+  EXPECT_EQ(store.acquire(b.data(), size), b.data());
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,133 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "device/device.h"
+
+#include "integrator/path_trace_work_cpu.h"
+
+#include "util/tbb.h"
+#include "util/time.h"
+#include "util/unique_ptr.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* CPU device without memory, reporting the given NUMA nodes. */
+class NUMATestDevice : public Device {
+ public:
+  NUMATestDevice(const DeviceInfo &info_,
+                 Stats &stats_,
+                 Profiler &profiler_,
+                 const vector<DeviceNUMANode> &numa_nodes)
+      : Device(info_, stats_, profiler_, true), numa_nodes_(numa_nodes)
+  {
+  }
+
+  BVHLayoutMask get_bvh_layout_mask(uint /*kernel_features*/) const override
+  {
+    return 0;
+  }
+
+  void mem_alloc(device_memory & /*mem*/) override {}
+
+  void mem_copy_to(device_memory & /*mem*/) override {}
+
+  void mem_move_to_host(device_memory & /*mem*/) override {}
+
+  void mem_copy_from(
+      device_memory & /*mem*/, size_t /*y*/, size_t /*w*/, size_t /*h*/, size_t /*elem*/) override
+  {
+  }
+
+  void mem_zero(device_memory & /*mem*/) override {}
+
+  void mem_free(device_memory & /*mem*/) override {}
+
+  void const_copy_to(const char * /*name*/, void * /*host*/, size_t /*size*/) override {}
+
+  vector<DeviceNUMANode> get_cpu_numa_nodes() const override
+  {
+    return numa_nodes_;
+  }
+
+ protected:
+  vector<DeviceNUMANode> numa_nodes_;
+};
+
+/* Runs the work on the device, and checks that every work index is done once, by threads with
+ * valid kernel globals indices. Returns the threads which did work, as a bitmask. When all
+ * threads are expected to take part, the first work of every thread waits for the others. */
+static uint parallel_for_work_threads(const vector<DeviceNUMANode> &numa_nodes,
+                                      const int num_threads,
+                                      const bool wait_for_all_threads)
+{
+  /* Allow enough worker threads for all arenas, also on machines with fewer cores. */
+  const tbb::global_control control(tbb::global_control::max_allowed_parallelism,
+                                    num_threads + 1);
+
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo info;
+  info.type = DEVICE_CPU;
+  info.cpu_threads = num_threads;
+  NUMATestDevice device(info, stats, profiler, numa_nodes);
+
+  const int64_t num_work = 10000;
+  unique_ptr<std::atomic<int>[]> num_done(new std::atomic<int>[num_work]());
+  std::atomic<uint> threads = 0;
+  std::atomic<bool> invalid_thread = false;
+  const uint all_threads = (1u << num_threads) - 1;
+
+  PathTraceWorkCPU::parallel_for_work(
+      &device, num_work, [&](const int64_t work_index, const int thread) {
+        num_done[work_index]++;
+        if (thread < 0 || thread >= num_threads) {
+          invalid_thread = true;
+          return;
+        }
+
+        const uint thread_bit = 1u << thread;
+        if ((threads.fetch_or(thread_bit) & thread_bit) == 0 && wait_for_all_threads) {
+          const double timeout = time_dt() + 10.0;
+          while (threads != all_threads && time_dt() < timeout) {
+            std::this_thread::yield();
+          }
+        }
+      });
+
+  EXPECT_FALSE(invalid_thread);
+  int num_wrong = 0;
+  for (int64_t i = 0; i < num_work; i++) {
+    num_wrong += (num_done[i] != 1);
+  }
+  EXPECT_EQ(num_wrong, 0);
+
+  return threads;
+}
+
+/* Without NUMA nodes, all work is done in a single arena. */
+TEST(PathTraceWorkCPU, parallel_for_work)
+{
+  EXPECT_NE(parallel_for_work_threads({}, 4, false), 0);
+}
+
+/* Two NUMA nodes of two threads each. Both use the automatic node identifier, so the arenas can
+ * be created without topology information. The calling thread only waits for the arenas, so all
+ * threads of both nodes must be working at the same time. */
+TEST(PathTraceWorkCPU, parallel_for_work_numa)
+{
+  vector<DeviceNUMANode> numa_nodes(2);
+  for (DeviceNUMANode &node : numa_nodes) {
+    node.id = tbb::task_arena::automatic;
+    node.num_threads = 2;
+  }
+
+  EXPECT_EQ(parallel_for_work_threads(numa_nodes, 4, true), 0xF);
+}
+
+CCL_NAMESPACE_END
@@ -6,6 +6,9 @@
 
 #include "integrator/render_scheduler.h"
 
+#include "session/session.h"
+#include "session/tile.h"
+
 CCL_NAMESPACE_BEGIN
 
 TEST(IntegratorRenderScheduler, calculate_resolution_divider_for_resolution)
@@ -22,4 +25,67 @@ TEST(IntegratorRenderScheduler, calculate_resolution_for_divider)
   EXPECT_EQ(calculate_resolution_for_divider(1920, 1080, 4), 360);
 }
 
+/* Viewport render whose first full resolution sample took the given time, returns the first work
+ * after the next reset. */
+static RenderWork navigation_work_after_first_sample(const double time_budget,
+                                                     const double time_per_sample)
+{
+  SessionParams params;
+  params.background = false;
+  TileManager tile_manager;
+  RenderScheduler scheduler(tile_manager, params);
+  scheduler.set_sample_params(16, false, 0, 0);
+  scheduler.set_navigation_time_budget(time_budget);
+
+  BufferParams buffer_params;
+  buffer_params.width = 1920;
+  buffer_params.height = 1080;
+  buffer_params.full_width = 1920;
+  buffer_params.full_height = 1080;
+
+  /* Navigation work at the initial resolution divider, then the first full resolution sample. */
+  scheduler.reset(buffer_params);
+  EXPECT_GT(scheduler.get_render_work().resolution_divider, 1);
+  const RenderWork first_sample_work = scheduler.get_render_work();
+  EXPECT_EQ(first_sample_work.resolution_divider, 1);
+  EXPECT_EQ(first_sample_work.path_trace.num_samples, 1);
+  scheduler.report_path_trace_time(first_sample_work, time_per_sample, false);
+
+  scheduler.reset(buffer_params);
+  return scheduler.get_render_work();
+}
+
+/* Time of the navigation work estimated like the scheduler does, from the time of a full
+ * resolution sample. */
+static double navigation_work_time(const double time_per_sample,
+                                   const int resolution_divider,
+                                   const int num_samples)
+{
+  return time_per_sample * num_samples / (resolution_divider * resolution_divider);
+}
+
+/* The navigation work fits into the time budget, and a smaller resolution divider would not. The
+ * scheduler renders as many samples as the resolution divider during navigation, up to four. */
+TEST(IntegratorRenderScheduler, navigation_time_budget)
+{
+  const double time_budget = 0.05;
+
+  /* Includes the first sample being slightly slower than the budget, which a tolerance on the
+   * budget would render at full resolution. */
+  for (const double time_per_sample : {0.04, 0.06, 0.12, 0.3, 1.0}) {
+    const RenderWork work = navigation_work_after_first_sample(time_budget, time_per_sample);
+    const int divider = work.resolution_divider;
+
+    EXPECT_LE(navigation_work_time(time_per_sample, divider, work.path_trace.num_samples),
+              time_budget)
+        << "time per sample " << time_per_sample << " divider " << divider;
+
+    if (divider > 1) {
+      EXPECT_GT(navigation_work_time(time_per_sample, divider - 1, min(divider - 1, 4)),
+                time_budget)
+          << "time per sample " << time_per_sample << " divider " << divider;
+    }
+  }
+}
+
 CCL_NAMESPACE_END
@@ -0,0 +1,113 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "integrator/sample_density.h"
+#include "integrator/work_tile_scheduler.h"
+
+#include "kernel/types.h"
+
+#include "session/buffers.h"
+
+CCL_NAMESPACE_BEGIN
+
+TEST(IntegratorSampleDensity, sample_density_range)
+{
+  EXPECT_EQ(sample_density_range(1.0f, 5, 3), make_int2(5, 3));
+  EXPECT_EQ(sample_density_range(0.5f, 0, 1), make_int2(0, 1));
+  EXPECT_EQ(sample_density_range(0.5f, 1, 1), make_int2(1, 0));
+
+  /* Rendering the samples one by one covers the same range as rendering them all at once. */
+  for (const float density : {0.1f, 0.25f, 0.3f, 0.5f, 0.75f}) {
+    int end = 0;
+    for (int sample = 0; sample < 100; sample++) {
+      const int2 range = sample_density_range(density, sample, 1);
+      EXPECT_EQ(range.x, end);
+      end = range.x + range.y;
+    }
+    EXPECT_EQ(end, sample_density_range(density, 0, 100).y);
+    EXPECT_GE(end, int(100 * density));
+  }
+}
+
+TEST(IntegratorSampleDensity, focus)
+{
+  SampleDensityMap map;
+  EXPECT_TRUE(map.is_uniform());
+  EXPECT_EQ(map.get_density(make_int2(100, 100), 10, 10), 1.0f);
+
+  /* Circular fovea in the center of the image. */
+  map.set_focus(make_int2(640, 480), make_float4(320, 240, 320, 240), 64.0f, 128.0f, 0.25f);
+  EXPECT_FALSE(map.is_uniform());
+  EXPECT_EQ(map.get_density(make_int2(640, 480), 320, 240), 1.0f);
+  EXPECT_EQ(map.get_density(make_int2(640, 480), 0, 0), 0.25f);
+
+  const float half_way = map.get_density(make_int2(640, 480), 320 + 128, 240);
+  EXPECT_GT(half_way, 0.25f);
+  EXPECT_LT(half_way, 1.0f);
+
+  /* Same densities at a lower resolution. */
+  EXPECT_EQ(map.get_density(make_int2(160, 120), 80, 60), 1.0f);
+  EXPECT_EQ(map.get_density(make_int2(160, 120), 0, 0), 0.25f);
+  EXPECT_EQ(map.get_density(make_int2(160, 120), 159, 119), 0.25f);
+
+  const float average = map.get_average_density();
+  EXPECT_GT(average, 0.25f);
+  EXPECT_LT(average, 1.0f);
+
+  map.clear();
+  EXPECT_TRUE(map.is_uniform());
+}
+
+/* Every pixel of the scheduled work tiles gets the samples of its density. */
+TEST(IntegratorSampleDensity, work_tile_scheduler)
+{
+  const int2 size = make_int2(200, 100);
+
+  BufferParams buffer_params;
+  buffer_params.width = size.x;
+  buffer_params.height = size.y;
+  buffer_params.full_width = size.x;
+  buffer_params.full_height = size.y;
+  buffer_params.window_width = size.x;
+  buffer_params.window_height = size.y;
+  buffer_params.update_offset_stride();
+
+  SampleDensityMap map;
+  map.set_focus(size, make_float4(0, 0, 50, 100), 0.0f, 0.0f, 0.25f);
+
+  WorkTileScheduler scheduler;
+  scheduler.set_max_num_path_states(4096);
+  scheduler.set_sample_density(&map);
+
+  vector<int> num_samples(size.x * size.y, 0);
+  const int samples_num = 16;
+  for (int start_sample = 0; start_sample < samples_num; start_sample += 4) {
+    scheduler.reset(buffer_params, start_sample, 4, 0, 1.0f);
+
+    KernelWorkTile work_tile;
+    while (scheduler.get_work(&work_tile)) {
+      EXPECT_GT(work_tile.num_samples, 0);
+      for (int y = work_tile.y; y < work_tile.y + work_tile.h; y++) {
+        for (int x = work_tile.x; x < work_tile.x + work_tile.w; x++) {
+          num_samples[y * size.x + x] += work_tile.num_samples;
+        }
+      }
+    }
+  }
+
+  for (int y = 0; y < size.y; y++) {
+    for (int x = 0; x < size.x; x++) {
+      const float density = map.get_density(size, x, y);
+      EXPECT_EQ(num_samples[y * size.x + x], sample_density_range(density, 0, samples_num).y);
+    }
+  }
+
+  /* Pixels in the region of interest get all samples, the others a quarter. */
+  EXPECT_EQ(num_samples[0], samples_num);
+  EXPECT_EQ(num_samples[size.x - 1], samples_num / 4);
+}
+
+CCL_NAMESPACE_END
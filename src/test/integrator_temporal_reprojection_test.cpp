@@ -0,0 +1,197 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "integrator/temporal_reprojection.h"
+
+#include "util/projection.h"
+#include "util/transform.h"
+
+CCL_NAMESPACE_BEGIN
+
+static const int width = 16;
+static const int height = 8;
+static const float focal_length = 8.0f;
+
+static BufferPass make_pass(const PassType type, const int offset)
+{
+  BufferPass pass;
+  pass.type = type;
+  pass.offset = offset;
+  return pass;
+}
+
+static BufferParams make_buffer_params(const bool use_depth, const bool use_shadow_catcher = false)
+{
+  BufferParams params;
+  params.width = width;
+  params.height = height;
+  params.window_width = width;
+  params.window_height = height;
+  params.full_width = width;
+  params.full_height = height;
+
+  params.passes.push_back(make_pass(PASS_COMBINED, 0));
+  params.passes.push_back(make_pass(PASS_DEPTH, use_depth ? 4 : PASS_UNUSED));
+  params.passes.push_back(make_pass(PASS_SAMPLE_COUNT, use_depth ? 5 : 4));
+  if (use_shadow_catcher) {
+    params.passes.push_back(make_pass(PASS_SHADOW_CATCHER_SAMPLE_COUNT, use_depth ? 6 : 5));
+  }
+  params.update_passes();
+
+  return params;
+}
+
+/* Perspective camera looking down +Z from (offset_x, 0, 0). */
+static KernelCamera make_camera(const float offset_x)
+{
+  KernelCamera camera = {};
+  camera.type = CAMERA_PERSPECTIVE;
+  camera.nearclip = 0.01f;
+
+  camera.cameratoworld = transform_translate(offset_x, 0.0f, 0.0f);
+  camera.worldtocamera = transform_translate(-offset_x, 0.0f, 0.0f);
+
+  camera.rastertocamera = ProjectionTransform(
+      transform_scale(1.0f / focal_length, 1.0f / focal_length, 1.0f) *
+      transform_translate(-0.5f * width, -0.5f * height, 1.0f));
+
+  ProjectionTransform cameratoraster;
+  cameratoraster.x = make_float4(focal_length, 0.0f, 0.5f * width, 0.0f);
+  cameratoraster.y = make_float4(0.0f, focal_length, 0.5f * height, 0.0f);
+  cameratoraster.z = make_float4(0.0f, 0.0f, 1.0f, 0.0f);
+  cameratoraster.w = make_float4(0.0f, 0.0f, 1.0f, 0.0f);
+  camera.worldtoraster = cameratoraster * ProjectionTransform(camera.worldtocamera);
+
+  return camera;
+}
+
+/* Plane at depth 4 rendered with 32 samples, the pixel index in red. The last row is
+ * background. The shadow catcher was hit by 24 of the samples. */
+static vector<float> make_buffer(const BufferParams &params)
+{
+  vector<float> buffer(size_t(width) * height * params.pass_stride, 0.0f);
+  const int shadow_catcher_offset = params.get_pass_offset(PASS_SHADOW_CATCHER_SAMPLE_COUNT);
+
+  for (int y = 0; y < height - 1; y++) {
+    for (int x = 0; x < width; x++) {
+      float *pixel = buffer.data() + size_t(y * width + x) * params.pass_stride;
+      pixel[0] = float(y * width + x) * 32.0f;
+      pixel[3] = 32.0f;
+      pixel[4] = 4.0f;
+      *(uint *)(pixel + 5) = 32;
+      if (shadow_catcher_offset != PASS_UNUSED) {
+        pixel[shadow_catcher_offset] = 24.0f;
+      }
+    }
+  }
+
+  return buffer;
+}
+
+TEST(TemporalReprojection, same_camera)
+{
+  const BufferParams params = make_buffer_params(true);
+  const KernelCamera camera = make_camera(0.0f);
+
+  TemporalReprojection reprojection;
+  reprojection.store(params, make_buffer(params).data(), camera, 1);
+  ASSERT_TRUE(reprojection.has_history());
+
+  TemporalReprojectionParams reprojection_params;
+  reprojection_params.use = true;
+  reprojection_params.confidence = 0.5f;
+  reprojection_params.max_samples = 64;
+
+  vector<float> buffer(size_t(width) * height * params.pass_stride, 0.0f);
+  EXPECT_EQ(reprojection.reproject(params, buffer.data(), camera, reprojection_params),
+            width * (height - 1));
+
+  /* Half of the samples, with the same average. */
+  for (int y = 0; y < height - 1; y++) {
+    for (int x = 0; x < width; x++) {
+      const float *pixel = buffer.data() + size_t(y * width + x) * params.pass_stride;
+      EXPECT_EQ(*(const uint *)(pixel + 5), 16);
+      EXPECT_FLOAT_EQ(pixel[0] / 16.0f, float(y * width + x));
+      EXPECT_FLOAT_EQ(pixel[4], 4.0f);
+    }
+  }
+
+  /* Background is not seeded. */
+  const float *pixel = buffer.data() + size_t((height - 1) * width) * params.pass_stride;
+  EXPECT_EQ(*(const uint *)(pixel + 5), 0);
+}
+
+TEST(TemporalReprojection, camera_move)
+{
+  const BufferParams params = make_buffer_params(true);
+
+  TemporalReprojection reprojection;
+  reprojection.store(params, make_buffer(params).data(), make_camera(0.0f), 1);
+
+  TemporalReprojectionParams reprojection_params;
+  reprojection_params.use = true;
+  reprojection_params.confidence = 1.0f;
+  reprojection_params.max_samples = 8;
+
+  /* Moving the camera by one unit shifts the plane at depth 4 by two pixels to the left. */
+  vector<float> buffer(size_t(width) * height * params.pass_stride, 0.0f);
+  EXPECT_EQ(reprojection.reproject(params, buffer.data(), make_camera(1.0f), reprojection_params),
+            (width - 2) * (height - 1));
+
+  for (int y = 0; y < height - 1; y++) {
+    for (int x = 0; x < width; x++) {
+      const float *pixel = buffer.data() + size_t(y * width + x) * params.pass_stride;
+      if (x >= width - 2) {
+        /* Not visible before. */
+        EXPECT_EQ(*(const uint *)(pixel + 5), 0);
+        continue;
+      }
+      EXPECT_EQ(*(const uint *)(pixel + 5), 8);
+      EXPECT_FLOAT_EQ(pixel[0] / 8.0f, float(y * width + x + 2));
+    }
+  }
+}
+
+/* The shadow catcher sample count is a float pass, scaled like the accumulated passes. */
+TEST(TemporalReprojection, shadow_catcher_sample_count)
+{
+  const BufferParams params = make_buffer_params(true, true);
+  const KernelCamera camera = make_camera(0.0f);
+  const int offset = params.get_pass_offset(PASS_SHADOW_CATCHER_SAMPLE_COUNT);
+  ASSERT_EQ(offset, 6);
+
+  TemporalReprojection reprojection;
+  reprojection.store(params, make_buffer(params).data(), camera, 1);
+
+  TemporalReprojectionParams reprojection_params;
+  reprojection_params.use = true;
+  reprojection_params.confidence = 0.5f;
+  reprojection_params.max_samples = 64;
+
+  vector<float> buffer(size_t(width) * height * params.pass_stride, 0.0f);
+  EXPECT_EQ(reprojection.reproject(params, buffer.data(), camera, reprojection_params),
+            width * (height - 1));
+
+  for (int y = 0; y < height - 1; y++) {
+    for (int x = 0; x < width; x++) {
+      const float *pixel = buffer.data() + size_t(y * width + x) * params.pass_stride;
+      EXPECT_EQ(*(const uint *)(pixel + 5), 16);
+      EXPECT_FLOAT_EQ(pixel[offset], 12.0f);
+    }
+  }
+}
+
+TEST(TemporalReprojection, requires_depth)
+{
+  const BufferParams params = make_buffer_params(false);
+  const vector<float> buffer(size_t(width) * height * params.pass_stride, 0.0f);
+
+  TemporalReprojection reprojection;
+  reprojection.store(params, buffer.data(), make_camera(0.0f), 1);
+  EXPECT_FALSE(reprojection.has_history());
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,76 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#define __KERNEL_SSE__
+#define __KERNEL_AVX__
+#define __KERNEL_AVX2__
+#define __KERNEL_AVX512__
+
+#if (defined(i386) || defined(_M_IX86) || defined(__x86_64__) || defined(_M_X64)) && \
+    defined(__AVX512F__) && defined(__AVX512VL__)
+#  include "kernel_bvh_nodes_test.h"
+
+#  include "util/system.h"
+
+CCL_NAMESPACE_BEGIN
+
+int kernel_bvh4_aligned_node_intersect_default(KernelGlobals kg,
+                                               const float3 P,
+                                               const float3 idir,
+                                               const float tmin,
+                                               const float tmax,
+                                               const int node_addr,
+                                               const uint visibility,
+                                               float4 *dist);
+
+/* NaN distances from rays starting on a box plane must be NaN in both code paths. */
+static bool same_float(const float a, const float b)
+{
+  return (isnan_safe(a) && isnan_safe(b)) || a == b;
+}
+
+/* The AVX-512 code path gives the same hit mask and distances as the default one. */
+TEST(KernelBVH4Nodes_avx512, aligned_node_intersect)
+{
+  if (!system_cpu_support_avx512()) {
+    GTEST_SKIP() << "AVX-512 not supported";
+  }
+
+  const KernelBVH4Nodes nodes;
+
+  for (uint seed = 0; seed < 1000; seed++) {
+    const KernelBVH4NodesRay ray(nodes, seed);
+
+    for (int i = 0; i < KernelBVH4Nodes::num_nodes; i++) {
+      float4 dist;
+      const int mask = bvh4_aligned_node_intersect(nodes.kg.get(),
+                                                   ray.P,
+                                                   ray.idir,
+                                                   ray.tmin,
+                                                   ray.tmax,
+                                                   i * BVH4_NODE_SIZE,
+                                                   ray.visibility,
+                                                   &dist);
+      float4 expected_dist;
+      const int expected = kernel_bvh4_aligned_node_intersect_default(nodes.kg.get(),
+                                                                      ray.P,
+                                                                      ray.idir,
+                                                                      ray.tmin,
+                                                                      ray.tmax,
+                                                                      i * BVH4_NODE_SIZE,
+                                                                      ray.visibility,
+                                                                      &expected_dist);
+
+      EXPECT_EQ(mask, expected) << "ray " << seed << " node " << i;
+      for (int j = 0; j < BVH4_NODE_CHILDREN; j++) {
+        EXPECT_PRED2(same_float, dist[j], expected_dist[j])
+            << "ray " << seed << " node " << i << " child " << j;
+      }
+    }
+  }
+}
+
+CCL_NAMESPACE_END
+
+#endif
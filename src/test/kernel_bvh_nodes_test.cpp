@@ -0,0 +1,75 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "kernel_bvh_nodes_test.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Intersection compiled with the default instruction set, to compare the code paths of other
+ * instruction sets against. */
+int kernel_bvh4_aligned_node_intersect_default(KernelGlobals kg,
+                                               const float3 P,
+                                               const float3 idir,
+                                               const float tmin,
+                                               const float tmax,
+                                               const int node_addr,
+                                               const uint visibility,
+                                               float4 *dist)
+{
+  return bvh4_aligned_node_intersect(kg, P, idir, tmin, tmax, node_addr, visibility, dist);
+}
+
+/* Slab test of the ray against one child box, in the same order of operations as the kernel. */
+static bool slab_intersect(const KernelBVH4NodesRay &ray, const BoundBox &b, float *dist)
+{
+  const float3 lo = (b.min - ray.P) * ray.idir;
+  const float3 hi = (b.max - ray.P) * ray.idir;
+  const float t_near = max(max(min(lo.x, hi.x), min(lo.y, hi.y)), max(min(lo.z, hi.z), ray.tmin));
+  const float t_far = min(min(max(lo.x, hi.x), max(lo.y, hi.y)), min(max(lo.z, hi.z), ray.tmax));
+  *dist = t_near;
+  return t_near <= t_far;
+}
+
+/* Children are hit when the ray intersects their box and has their visibility, unused slots are
+ * never hit. */
+TEST(KernelBVH4Nodes, aligned_node_intersect)
+{
+  const KernelBVH4Nodes nodes;
+  int num_hits = 0;
+
+  for (uint seed = 0; seed < 1000; seed++) {
+    const KernelBVH4NodesRay ray(nodes, seed);
+
+    for (int i = 0; i < KernelBVH4Nodes::num_nodes; i++) {
+      float4 dist;
+      const int mask = bvh4_aligned_node_intersect(nodes.kg.get(),
+                                                   ray.P,
+                                                   ray.idir,
+                                                   ray.tmin,
+                                                   ray.tmax,
+                                                   i * BVH4_NODE_SIZE,
+                                                   ray.visibility,
+                                                   &dist);
+
+      int expected = 0;
+      for (int j = 0; j < KernelBVH4Nodes::num_children(i); j++) {
+        float expected_dist;
+        const int child = i * BVH4_NODE_CHILDREN + j;
+        if (slab_intersect(ray, nodes.bounds[child], &expected_dist) &&
+            (nodes.visibility[child] & ray.visibility))
+        {
+          expected |= 1 << j;
+          EXPECT_EQ(dist[j], expected_dist) << "ray " << seed << " node " << i << " child " << j;
+        }
+      }
+
+      EXPECT_EQ(mask, expected) << "ray " << seed << " node " << i;
+      num_hits += popcount(uint(expected));
+    }
+  }
+
+  EXPECT_GT(num_hits, 1000);
+}
+
+CCL_NAMESPACE_END
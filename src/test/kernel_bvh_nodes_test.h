@@ -0,0 +1,127 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include "bvh/bvh2.h"
+
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+
+#include "kernel/bvh/nodes.h"
+
+#include "util/hash.h"
+#include "util/profiling.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Compiled into tests with different instruction sets, so the test types must not be shared
+ * between them. */
+namespace {
+
+/* Wide BVH4 nodes with random child boxes, with kernel globals pointing to them. The nodes have
+ * one to four children, so they include unused child slots. Some boxes are flat along an axis. */
+class KernelBVH4Nodes : public BVH2 {
+ public:
+  static constexpr int num_nodes = 64;
+
+  vector<BoundBox> bounds;
+  vector<uint> visibility;
+  Profiler profiler;
+  unique_ptr<ThreadKernelGlobalsCPU> kg;
+
+  KernelBVH4Nodes()
+      : BVH2(make_params(), vector<Geometry *>(), vector<Object *>()),
+        bounds(num_nodes * BVH4_NODE_CHILDREN),
+        visibility(num_nodes * BVH4_NODE_CHILDREN)
+  {
+    pack.nodes.resize(num_nodes * BVH4_NODE_SIZE);
+
+    const int child[BVH4_NODE_CHILDREN] = {~0, ~1, ~2, ~3};
+    for (int i = 0; i < num_nodes; i++) {
+      for (int j = 0; j < BVH4_NODE_CHILDREN; j++) {
+        const uint seed = i * BVH4_NODE_CHILDREN + j;
+        const float3 P = make_float3(hash_uint3_to_float(seed, 0, 2),
+                                     hash_uint3_to_float(seed, 1, 2),
+                                     hash_uint3_to_float(seed, 2, 2)) *
+                             2.0f -
+                         one_float3();
+        float3 size = make_float3(hash_uint3_to_float(seed, 3, 2),
+                                  hash_uint3_to_float(seed, 4, 2),
+                                  hash_uint3_to_float(seed, 5, 2));
+        if (seed % 5 == 0) {
+          size[seed % 3] = 0.0f;
+        }
+        bounds[seed] = BoundBox(P, P + size);
+        visibility[seed] = 1 + hash_uint3(seed, 6, 2) % 3;
+      }
+
+      pack_wide_node(i * BVH4_NODE_SIZE,
+                     &bounds[i * BVH4_NODE_CHILDREN],
+                     child,
+                     &visibility[i * BVH4_NODE_CHILDREN],
+                     num_children(i));
+    }
+
+    KernelGlobalsCPU globals;
+    globals.bvh_nodes.data = reinterpret_cast<float4 *>(pack.nodes.data());
+    globals.bvh_nodes.width = pack.nodes.size();
+    kg = make_unique<ThreadKernelGlobalsCPU>(globals, nullptr, profiler, 0);
+  }
+
+  static int num_children(const int node)
+  {
+    return 1 + node % BVH4_NODE_CHILDREN;
+  }
+
+ protected:
+  static BVHParams make_params()
+  {
+    BVHParams params;
+    params.bvh_layout = BVH_LAYOUT_BVH4;
+    return params;
+  }
+};
+
+/* Ray as passed to the node intersection. Every third ray is parallel to an axis, and some of
+ * those start on a plane of a child box. */
+struct KernelBVH4NodesRay {
+  float3 P;
+  float3 idir;
+  float tmin;
+  float tmax;
+  uint visibility;
+
+  KernelBVH4NodesRay(const KernelBVH4Nodes &nodes, const uint seed)
+  {
+    P = make_float3(hash_uint2_to_float(seed, 0),
+                    hash_uint2_to_float(seed, 1),
+                    hash_uint2_to_float(seed, 2)) *
+            4.0f -
+        make_float3(2.0f);
+    float3 dir = normalize(make_float3(hash_uint2_to_float(seed, 3) - 0.5f,
+                                       hash_uint2_to_float(seed, 4) - 0.5f,
+                                       hash_uint2_to_float(seed, 5) - 0.5f));
+    if (seed % 3 == 0) {
+      const int axis = hash_uint2(seed, 6) % 3;
+      dir = zero_float3();
+      dir[axis] = (seed % 2) ? 1.0f : -1.0f;
+      if (seed % 9 == 0) {
+        const BoundBox &b = nodes.bounds[hash_uint2(seed, 7) % nodes.bounds.size()];
+        P[(axis + 1) % 3] = b.min[(axis + 1) % 3];
+      }
+    }
+    idir = bvh_inverse_direction(dir);
+    tmin = (seed % 4 == 0) ? hash_uint2_to_float(seed, 8) : 0.0f;
+    tmax = (seed % 2 == 0) ? FLT_MAX : hash_uint2_to_float(seed, 9) * 4.0f;
+    visibility = (seed % 5 == 0) ? ~0u : 1 + hash_uint2(seed, 10) % 3;
+  }
+};
+
+}  // namespace
+
+CCL_NAMESPACE_END
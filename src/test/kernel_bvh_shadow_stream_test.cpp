@@ -0,0 +1,182 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "bvh/bvh2.h"
+
+#include "scene/mesh.h"
+#include "scene/object.h"
+
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+
+#include "kernel/integrator/state_util.h"
+
+#include "kernel/bvh/bvh.h"
+
+#include "util/hash.h"
+#include "util/profiling.h"
+#include "util/progress.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Scene BVH of a single mesh with triangles scattered in a unit cube, with the kernel data
+ * arrays pointing to it. */
+class KernelBVHShadowStream : public testing::TestWithParam<BVHLayout> {
+ protected:
+  Mesh mesh;
+  Object object;
+  Progress progress;
+  Profiler profiler;
+  unique_ptr<BVH2> bvh;
+  vector<packed_uint3> tri_vindex;
+  vector<packed_float3> tri_verts;
+  unique_ptr<ThreadKernelGlobalsCPU> kg;
+
+  void SetUp() override
+  {
+    const int num_triangles = 200;
+
+    array<float3> verts(num_triangles * 3);
+    array<int> triangles(num_triangles * 3);
+    array<int> shader_index(num_triangles);
+    array<bool> smooth(num_triangles);
+    for (int i = 0; i < num_triangles; i++) {
+      const float3 P = make_float3(
+          hash_uint2_to_float(i, 0), hash_uint2_to_float(i, 1), hash_uint2_to_float(i, 2));
+      for (int k = 0; k < 3; k++) {
+        const float3 offset = make_float3(hash_uint2_to_float(i, 3 + k * 3) - 0.5f,
+                                          hash_uint2_to_float(i, 4 + k * 3) - 0.5f,
+                                          hash_uint2_to_float(i, 5 + k * 3) - 0.5f);
+        verts[i * 3 + k] = P + offset * 0.2f;
+        triangles[i * 3 + k] = i * 3 + k;
+        tri_verts.push_back(verts[i * 3 + k]);
+      }
+      tri_vindex.push_back(make_packed_uint3(i * 3 + 0, i * 3 + 1, i * 3 + 2));
+      shader_index[i] = 0;
+      smooth[i] = false;
+    }
+    mesh.set_verts(verts);
+    mesh.set_triangles(triangles);
+    mesh.set_shader(shader_index);
+    mesh.set_smooth(smooth);
+
+    object.set_is_shadow_catcher(true);
+    object.set_visibility(~0);
+    object.set_geometry(&mesh);
+
+    BVHParams params;
+    params.bvh_layout = GetParam();
+
+    vector<Geometry *> geometry;
+    geometry.push_back(&mesh);
+    vector<Object *> objects;
+    objects.push_back(&object);
+
+    bvh = make_unique<BVH2>(params, geometry, objects);
+    bvh->build(progress, nullptr);
+
+    PackedBVH &pack = bvh->pack;
+    KernelGlobalsCPU globals;
+    set_array(
+        globals.bvh_nodes, reinterpret_cast<float4 *>(pack.nodes.data()), pack.nodes.size());
+    set_array(globals.bvh_leaf_nodes,
+              reinterpret_cast<float4 *>(pack.leaf_nodes.data()),
+              pack.leaf_nodes.size());
+    set_array(
+        globals.prim_type, reinterpret_cast<uint *>(pack.prim_type.data()), pack.prim_type.size());
+    set_array(globals.prim_visibility, pack.prim_visibility.data(), pack.prim_visibility.size());
+    set_array(globals.prim_index,
+              reinterpret_cast<uint *>(pack.prim_index.data()),
+              pack.prim_index.size());
+    set_array(globals.prim_object,
+              reinterpret_cast<uint *>(pack.prim_object.data()),
+              pack.prim_object.size());
+    set_array(globals.tri_vindex, tri_vindex.data(), tri_vindex.size());
+    set_array(globals.tri_verts, tri_verts.data(), tri_verts.size());
+
+    globals.data.bvh.root = pack.root_index;
+    globals.data.bvh.bvh_layout = params.bvh_layout;
+
+    kg = make_unique<ThreadKernelGlobalsCPU>(globals, nullptr, profiler, 0);
+  }
+
+  template<typename T> static void set_array(kernel_array<T> &array, T *data, const size_t size)
+  {
+    array.data = data;
+    array.width = size;
+  }
+};
+
+static Ray make_ray(const uint seed)
+{
+  Ray ray;
+  ray.P = make_float3(hash_uint2_to_float(seed, 0),
+                      hash_uint2_to_float(seed, 1),
+                      hash_uint2_to_float(seed, 2));
+  ray.D = normalize(make_float3(hash_uint2_to_float(seed, 3) - 0.5f,
+                                hash_uint2_to_float(seed, 4) - 0.5f,
+                                hash_uint2_to_float(seed, 5) - 0.5f));
+  ray.tmin = 0.0f;
+  ray.tmax = hash_uint2_to_float(seed, 6) * 0.5f;
+  ray.time = 0.5f;
+  ray.self.prim = PRIM_NONE;
+  ray.self.object = OBJECT_NONE;
+  ray.self.light_prim = PRIM_NONE;
+  ray.self.light_object = OBJECT_NONE;
+  ray.dP = differential_zero_compact();
+  ray.dD = differential_zero_compact();
+  return ray;
+}
+
+/* Streams give the same result as tracing their rays one by one, for full and partial streams,
+ * with rays from a shared origin and with invalid rays. */
+TEST_P(KernelBVHShadowStream, matches_single_rays)
+{
+  int num_occluded = 0;
+  int num_rays = 0;
+
+  for (int s = 0; s < 500; s++) {
+    RayStream stream;
+    stream.num_rays = 0;
+
+    const int size = 1 + s % RAY_STREAM_SIZE;
+    const bool shared_origin = (s % 3 == 0);
+    uint expected = 0;
+    for (int i = 0; i < size; i++) {
+      Ray ray = make_ray(s * RAY_STREAM_SIZE + i);
+      if (shared_origin) {
+        ray.P = make_float3(
+            hash_uint2_to_float(s, 7), hash_uint2_to_float(s, 8), hash_uint2_to_float(s, 9));
+      }
+      if (s % 7 == 0 && i == 0) {
+        ray.D = zero_float3();
+      }
+
+      if (scene_intersect_shadow(kg.get(), &ray, PATH_RAY_SHADOW_OPAQUE)) {
+        expected |= 1u << i;
+      }
+      ray_stream_push(&stream, &ray);
+    }
+
+    const uint occluded = scene_intersect_shadow_stream(
+        kg.get(), &stream, PATH_RAY_SHADOW_OPAQUE);
+    EXPECT_EQ(occluded, expected) << "stream " << s;
+
+    num_occluded += popcount(expected);
+    num_rays += size;
+  }
+
+  /* Both occluded and unoccluded rays were tested. */
+  EXPECT_GT(num_occluded, num_rays / 10);
+  EXPECT_LT(num_occluded, num_rays - num_rays / 10);
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts,
+                         KernelBVHShadowStream,
+                         testing::Values(BVH_LAYOUT_BVH2, BVH_LAYOUT_BVH4));
+
+CCL_NAMESPACE_END
@@ -0,0 +1,219 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <algorithm>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "kernel/types.h"
+
+#include "kernel/sample/sobol_burley.h"
+
+#include "util/math.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+static const int image_size = 64;
+
+/* Step edge through the unit square, like the visibility of an edge or a shadow boundary. */
+struct StepIntegrand {
+  float2 normal;
+  float offset;
+  double reference;
+
+  StepIntegrand(const float angle, const float2 point)
+  {
+    normal = make_float2(cosf(angle), sinf(angle));
+    offset = dot(normal, point);
+
+    const int resolution = 256;
+    int inside = 0;
+    for (int y = 0; y < resolution; y++) {
+      for (int x = 0; x < resolution; x++) {
+        inside += eval(make_float2((x + 0.5f) / resolution, (y + 0.5f) / resolution)) != 0.0f;
+      }
+    }
+    reference = double(inside) / (resolution * resolution);
+  }
+
+  float eval(const float2 rand) const
+  {
+    return (dot(normal, rand) < offset) ? 1.0f : 0.0f;
+  }
+};
+
+static vector<StepIntegrand> make_integrands()
+{
+  vector<StepIntegrand> integrands;
+  for (int i = 0; i < 8; i++) {
+    const float angle = (i + 0.3f) * M_2PI_F / 8.0f;
+    const float2 point = make_float2(0.2f + 0.6f * hash_uint_to_float(i),
+                                     0.2f + 0.6f * hash_uint2_to_float(i, 1));
+    integrands.push_back(StepIntegrand(angle, point));
+  }
+  return integrands;
+}
+
+/* Sample of the first two dimensions of a dimension set, with the sample function the kernel
+ * uses for it. */
+static float2 sample_2D(const uint sample, const int dimension, const uint seed)
+{
+  if (dimension == PRNG_FILTER) {
+    return sobol_burley_sample_2D(sample, dimension, seed, 0xffffffff);
+  }
+  const float3 rand = sobol_burley_sample_3D(sample, dimension, seed, 0xffffffff);
+  return make_float2(rand.x, rand.y);
+}
+
+/* Error of every pixel of the image when estimating the integral with the given samples. */
+static vector<double> render_error(const StepIntegrand &integrand,
+                                   const int dimension,
+                                   const int num_samples,
+                                   const bool use_blue_noise)
+{
+  const uint seed = hash_uint(0);
+  vector<double> error(image_size * image_size);
+
+  for (int y = 0; y < image_size; y++) {
+    for (int x = 0; x < image_size; x++) {
+      const uint pixel_seed = use_blue_noise ? sobol_burley_blue_noise_seed(x, y, seed) :
+                                               hash_iqnt2d(x, y) ^ seed;
+      double sum = 0.0;
+      for (int sample = 0; sample < num_samples; sample++) {
+        sum += integrand.eval(sample_2D(sample, dimension, pixel_seed));
+      }
+      error[y * image_size + x] = sum / num_samples - integrand.reference;
+    }
+  }
+
+  return error;
+}
+
+/* Power spectrum of the image, without the DC component. */
+static vector<double> power_spectrum(const vector<double> &image)
+{
+  const int n = image_size;
+  vector<double> rows_re(n * n), rows_im(n * n);
+  for (int y = 0; y < n; y++) {
+    for (int u = 0; u < n; u++) {
+      double re = 0.0, im = 0.0;
+      for (int x = 0; x < n; x++) {
+        const double angle = -2.0 * M_PI * u * x / n;
+        re += image[y * n + x] * std::cos(angle);
+        im += image[y * n + x] * std::sin(angle);
+      }
+      rows_re[y * n + u] = re;
+      rows_im[y * n + u] = im;
+    }
+  }
+
+  vector<double> power(n * n);
+  for (int v = 0; v < n; v++) {
+    for (int u = 0; u < n; u++) {
+      double re = 0.0, im = 0.0;
+      for (int y = 0; y < n; y++) {
+        const double angle = -2.0 * M_PI * v * y / n;
+        const double c = std::cos(angle), s = std::sin(angle);
+        re += rows_re[y * n + u] * c - rows_im[y * n + u] * s;
+        im += rows_re[y * n + u] * s + rows_im[y * n + u] * c;
+      }
+      power[v * n + u] = re * re + im * im;
+    }
+  }
+  power[0] = 0.0;
+
+  return power;
+}
+
+/* Average power of the frequencies below 1/8 of the image size relative to the average power of
+ * all frequencies. Around 1 for white noise, lower for blue noise. */
+static double low_frequency_power_ratio(const vector<double> &power)
+{
+  const int n = image_size;
+  const int radius = n / 8;
+  double low = 0.0, all = 0.0;
+  int num_low = 0, num_all = 0;
+
+  for (int v = 0; v < n; v++) {
+    for (int u = 0; u < n; u++) {
+      if (u == 0 && v == 0) {
+        continue;
+      }
+      const int fu = (u <= n / 2) ? u : u - n;
+      const int fv = (v <= n / 2) ? v : v - n;
+      if (fu * fu + fv * fv <= radius * radius) {
+        low += power[v * n + u];
+        num_low++;
+      }
+      all += power[v * n + u];
+      num_all++;
+    }
+  }
+
+  return (low / num_low) / (all / num_all);
+}
+
+static double rms(const vector<double> &image)
+{
+  double sum = 0.0;
+  for (const double value : image) {
+    sum += value * value;
+  }
+  return std::sqrt(sum / image.size());
+}
+
+TEST(KernelSampleBlueNoise, error_spectrum)
+{
+  const vector<StepIntegrand> integrands = make_integrands();
+  const int dimensions[] = {PRNG_FILTER,
+                            PRNG_BOUNCE_NUM + PRNG_LIGHT,
+                            PRNG_BOUNCE_NUM + PRNG_SURFACE_BSDF};
+
+  for (const int dimension : dimensions) {
+    for (const int num_samples : {1, 2, 4, 8}) {
+      double white_ratio = 0.0, blue_ratio = 0.0;
+      double white_rms = 0.0, blue_rms = 0.0;
+
+      for (const StepIntegrand &integrand : integrands) {
+        const vector<double> white = render_error(integrand, dimension, num_samples, false);
+        const vector<double> blue = render_error(integrand, dimension, num_samples, true);
+        white_ratio += low_frequency_power_ratio(power_spectrum(white)) / integrands.size();
+        blue_ratio += low_frequency_power_ratio(power_spectrum(blue)) / integrands.size();
+        white_rms += rms(white) / integrands.size();
+        blue_rms += rms(blue) / integrands.size();
+      }
+
+      /* Less low frequency error, at the same error per pixel. */
+      EXPECT_LT(blue_ratio, white_ratio * ((num_samples <= 2) ? 0.75 : 0.95))
+          << "dimension " << dimension << ", " << num_samples << " samples";
+      EXPECT_LT(blue_rms, white_rms * 1.05)
+          << "dimension " << dimension << ", " << num_samples << " samples";
+    }
+  }
+}
+
+TEST(KernelSampleBlueNoise, seed_tile)
+{
+  const uint seed = hash_uint(1);
+
+  /* The tile repeats, and is offset by the seed. */
+  EXPECT_EQ(sobol_burley_blue_noise_seed(3, 5, seed),
+            sobol_burley_blue_noise_seed(3 + BLUE_NOISE_TILE_SIZE, 5, seed));
+  EXPECT_EQ(sobol_burley_blue_noise_seed(3, 5, seed),
+            sobol_burley_blue_noise_seed(3, 5 + 2 * BLUE_NOISE_TILE_SIZE, seed));
+
+  /* Every pixel of a tile has its own seed. */
+  vector<uint> seeds;
+  for (int y = 0; y < BLUE_NOISE_TILE_SIZE; y++) {
+    for (int x = 0; x < BLUE_NOISE_TILE_SIZE; x++) {
+      seeds.push_back(sobol_burley_blue_noise_seed(x, y, seed));
+    }
+  }
+  std::sort(seeds.begin(), seeds.end());
+  EXPECT_EQ(std::unique(seeds.begin(), seeds.end()), seeds.end());
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,109 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "scene/integrator.h"
+
+#include "session_render_test.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Renders of a homogeneous box, with and without the fast volume integrator. The box covers the
+ * whole image and is 1 deep along the camera rays, so all pixels have the same expected value. */
+class VolumeFastRender : public testing::TestWithParam<bool> {
+ protected:
+  static constexpr float depth = 1.0f;
+
+  /* The fast integrator is stochastic, the mean of its 4096 paths is within a few percent. */
+  static constexpr float tolerance = 0.03f;
+
+  vector<float> render_box(const float background, const float sigma_a, const float emission)
+  {
+    return session_render_test([&](Scene *scene) {
+      scene->integrator->set_volume_fast(GetParam());
+      session_render_test_set_background(scene, background);
+
+      unique_ptr<ShaderGraph> graph = make_unique<ShaderGraph>();
+      AbsorptionVolumeNode *absorption = graph->create_node<AbsorptionVolumeNode>();
+      absorption->set_color(zero_float3());
+      absorption->set_density(sigma_a);
+      EmissionNode *emission_node = graph->create_node<EmissionNode>();
+      emission_node->set_color(one_float3());
+      emission_node->set_strength(emission);
+      AddClosureNode *add = graph->create_node<AddClosureNode>();
+      graph->connect(absorption->output("Volume"), add->input("Closure1"));
+      graph->connect(emission_node->output("Emission"), add->input("Closure2"));
+      graph->connect(add->output("Closure"), graph->output()->input("Volume"));
+
+      session_render_test_add_box(scene,
+                                  session_render_test_add_shader(scene, std::move(graph)),
+                                  make_float3(-2.0f, -2.0f, -0.5f * depth),
+                                  make_float3(2.0f, 2.0f, 0.5f * depth));
+    });
+  }
+};
+
+/* The background seen through the box is attenuated by exp(-sigma_t * d). */
+TEST_P(VolumeFastRender, transmittance)
+{
+  const float sigma_a = 1.5f;
+  const vector<float> pixels = render_box(1.0f, sigma_a, 0.0f);
+
+  EXPECT_NEAR(session_render_test_average(pixels), expf(-sigma_a * depth), tolerance);
+}
+
+/* Emission integrated along the ray, attenuated by the absorption in front of it:
+ * E / sigma_t * (1 - exp(-sigma_t * d)). */
+TEST_P(VolumeFastRender, emission)
+{
+  const float sigma_a = 1.5f;
+  const float emission = 2.0f;
+  const vector<float> pixels = render_box(0.0f, sigma_a, emission);
+
+  EXPECT_NEAR(session_render_test_average(pixels),
+              emission / sigma_a * (1.0f - expf(-sigma_a * depth)),
+              tolerance);
+}
+
+INSTANTIATE_TEST_SUITE_P(VolumeFast, VolumeFastRender, testing::Bool());
+
+/* The megakernel only runs the fast volume integrator when it is enabled: surfaces are shaded by
+ * the full path tracer, and only act as volume boundaries in the fast integrator. A volume box
+ * outside of the view makes the scene use volume kernels. */
+TEST(VolumeFastMegakernel, selection)
+{
+  for (const bool volume_fast : {false, true}) {
+    const vector<float> pixels = session_render_test([&](Scene *scene) {
+      scene->integrator->set_volume_fast(volume_fast);
+      session_render_test_set_background(scene, 0.0f);
+
+      unique_ptr<ShaderGraph> surface_graph = make_unique<ShaderGraph>();
+      EmissionNode *emission = surface_graph->create_node<EmissionNode>();
+      emission->set_color(one_float3());
+      emission->set_strength(4.0f);
+      surface_graph->connect(emission->output("Emission"),
+                             surface_graph->output()->input("Surface"));
+
+      session_render_test_add_box(scene,
+                                  session_render_test_add_shader(scene, std::move(surface_graph)),
+                                  make_float3(-2.0f, -2.0f, -0.5f),
+                                  make_float3(2.0f, 2.0f, 0.5f));
+
+      unique_ptr<ShaderGraph> volume_graph = make_unique<ShaderGraph>();
+      AbsorptionVolumeNode *absorption = volume_graph->create_node<AbsorptionVolumeNode>();
+      volume_graph->connect(absorption->output("Volume"), volume_graph->output()->input("Volume"));
+
+      session_render_test_add_box(scene,
+                                  session_render_test_add_shader(scene, std::move(volume_graph)),
+                                  make_float3(10.0f, 10.0f, -0.5f),
+                                  make_float3(11.0f, 11.0f, 0.5f));
+    });
+
+    EXPECT_NEAR(session_render_test_average(pixels), volume_fast ? 0.0f : 4.0f, 1e-3f)
+        << "volume_fast " << volume_fast;
+  }
+}
+
+CCL_NAMESPACE_END
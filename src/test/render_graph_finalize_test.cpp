@@ -1583,4 +1583,96 @@ TEST_F(RenderGraph, stochastic_sample_principled_volume_mix)
   log.correct_info_message("Volume attribute node Attribute uses stochastic sampling");
 }
 
+/*
+ * Tests:
+ *  - Math nodes that only depend on object info are replaced by an object constant.
+ */
+TEST_F(RenderGraph, object_constants_math)
+{
+  builder.add_node(ShaderNodeBuilder<ObjectInfoNode>(graph, "ObjectInfo"))
+      .add_node(ShaderNodeBuilder<MathNode>(graph, "Multiply")
+                    .set_param("math_type", NODE_MATH_MULTIPLY)
+                    .set("Value2", 2.0f))
+      .add_node(ShaderNodeBuilder<MathNode>(graph, "Add")
+                    .set_param("math_type", NODE_MATH_ADD)
+                    .set("Value2", 1.0f))
+      .add_connection("ObjectInfo::Random", "Multiply::Value1")
+      .add_connection("Multiply::Value", "Add::Value1")
+      .output_value("Add::Value");
+
+  graph.finalize(scene.get());
+
+  ASSERT_NE(graph.object_constants.get(), nullptr);
+  EXPECT_EQ(graph.object_constants->num_slots(), 1);
+
+  /* The nodes are replaced, with the value without an object as fallback. */
+  ObjectConstantNode *constant = nullptr;
+  for (ShaderNode *node : graph.nodes) {
+    EXPECT_NE(node->type, MathNode::get_node_type());
+    if (node->type == ObjectConstantNode::get_node_type()) {
+      constant = static_cast<ObjectConstantNode *>(node);
+    }
+  }
+  ASSERT_NE(constant, nullptr);
+  EXPECT_EQ(constant->get_fallback().x, 1.0f);
+
+  KernelObject kobject = {};
+  kobject.random_number = 0.25f;
+  float4 value;
+  graph.object_constants->eval(scene.get(), kobject, &value);
+  EXPECT_EQ(value.x, 1.5f);
+}
+
+/*
+ * Tests:
+ *  - Color ramp driven by the random number of the object is replaced by an object constant.
+ */
+TEST_F(RenderGraph, object_constants_rgb_ramp)
+{
+  array<float3> curve;
+  array<float> alpha;
+  init_test_curve(curve, make_float3(0.0f, 0.25f, 0.5f), make_float3(0.25f, 0.5f, 0.75f), 9);
+  init_test_curve(alpha, 0.75f, 1.0f, 9);
+
+  builder.add_node(ShaderNodeBuilder<ObjectInfoNode>(graph, "ObjectInfo"))
+      .add_node(ShaderNodeBuilder<RGBRampNode>(graph, "Ramp")
+                    .set_param("ramp", curve)
+                    .set_param("ramp_alpha", alpha)
+                    .set_param("interpolate", true))
+      .add_connection("ObjectInfo::Random", "Ramp::Fac")
+      .output_color("Ramp::Color");
+
+  graph.finalize(scene.get());
+
+  ASSERT_NE(graph.object_constants.get(), nullptr);
+  EXPECT_EQ(graph.object_constants->num_slots(), 1);
+
+  KernelObject kobject = {};
+  kobject.random_number = 0.5f;
+  float4 value;
+  graph.object_constants->eval(scene.get(), kobject, &value);
+  EXPECT_NEAR(value.x, 0.125f, 1e-6f);
+  EXPECT_NEAR(value.y, 0.375f, 1e-6f);
+  EXPECT_NEAR(value.z, 0.625f, 1e-6f);
+}
+
+/*
+ * Tests:
+ *  - Nodes that also depend on the shading point are kept.
+ */
+TEST_F(RenderGraph, object_constants_spatial_varying)
+{
+  builder.add_node(ShaderNodeBuilder<ObjectInfoNode>(graph, "ObjectInfo"))
+      .add_node(ShaderNodeBuilder<GeometryNode>(graph, "Geometry"))
+      .add_node(
+          ShaderNodeBuilder<MathNode>(graph, "Add").set_param("math_type", NODE_MATH_ADD))
+      .add_connection("ObjectInfo::Random", "Add::Value1")
+      .add_connection("Geometry::Backfacing", "Add::Value2")
+      .output_value("Add::Value");
+
+  graph.finalize(scene.get());
+
+  EXPECT_EQ(graph.object_constants.get(), nullptr);
+}
+
 CCL_NAMESPACE_END
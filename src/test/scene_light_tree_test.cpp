@@ -0,0 +1,347 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+
+#include "device/device.h"
+
+#include "scene/light.h"
+#include "scene/light_tree.h"
+#include "scene/mesh.h"
+#include "scene/object.h"
+#include "scene/scene.h"
+
+#include "util/colorspace.h"
+#include "util/hash.h"
+#include "util/progress.h"
+#include "util/stats.h"
+#include "util/time.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class LightTreeBuild : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  unique_ptr<Device> device_cpu;
+  SceneParams scene_params;
+  unique_ptr<Scene> scene;
+  Progress progress;
+
+  void SetUp() override
+  {
+    ColorSpaceManager::init_fallback_config();
+
+    device_cpu = Device::create(device_info, stats, profiler, true);
+    scene = make_unique<Scene>(scene_params, device_cpu.get());
+
+    scene->dscene.data.integrator.num_lights = 0;
+    scene->dscene.data.integrator.num_distant_lights = 0;
+  }
+
+  void TearDown() override
+  {
+    scene.reset();
+    device_cpu.reset();
+  }
+
+  /* Object with small emissive triangles scattered in a unit cube, like particles. */
+  Object *add_emissive_mesh(const int num_triangles, const Transform &tfm = transform_identity())
+  {
+    Shader *shader = scene->create_node<Shader>();
+    shader->emission_sampling = EMISSION_SAMPLING_FRONT_BACK;
+    shader->emission_estimate = one_float3();
+
+    Mesh *mesh = scene->create_node<Mesh>();
+    array<Node *> used_shaders;
+    used_shaders.push_back_slow(shader);
+    mesh->set_used_shaders(used_shaders);
+
+    array<float3> verts(num_triangles * 3);
+    array<int> triangles(num_triangles * 3);
+    array<int> shader_index(num_triangles);
+    array<bool> smooth(num_triangles);
+    for (int i = 0; i < num_triangles; i++) {
+      const float3 P = make_float3(
+          hash_uint2_to_float(i, 0), hash_uint2_to_float(i, 1), hash_uint2_to_float(i, 2));
+      for (int k = 0; k < 3; k++) {
+        const float3 offset = make_float3(hash_uint2_to_float(i, 3 + k * 3),
+                                          hash_uint2_to_float(i, 4 + k * 3),
+                                          hash_uint2_to_float(i, 5 + k * 3));
+        verts[i * 3 + k] = P + offset * 1e-3f;
+        triangles[i * 3 + k] = i * 3 + k;
+      }
+      shader_index[i] = 0;
+      smooth[i] = false;
+    }
+    mesh->set_verts(verts);
+    mesh->set_triangles(triangles);
+    mesh->set_shader(shader_index);
+    mesh->set_smooth(smooth);
+    mesh->compute_bounds();
+
+    return add_object(mesh, tfm);
+  }
+
+  Object *add_point_light(const float3 P)
+  {
+    return add_object(scene->create_node<PointLight>(), transform_translate(P));
+  }
+
+  Object *add_object(Geometry *geometry, const Transform &tfm)
+  {
+    Object *object = scene->create_node<Object>();
+    object->set_geometry(geometry);
+    object->set_tfm(tfm);
+    object->index = scene->objects.size() - 1;
+    object->compute_bounds(false);
+    return object;
+  }
+};
+
+static bool bounds_contain(const BoundBox &outer, const BoundBox &inner)
+{
+  return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+         outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
+
+static void check_subtree(const LightTreeNode *node,
+                          const LightTreeEmitter *emitters,
+                          vector<int> &num_visits)
+{
+  if (node->is_inner()) {
+    const LightTreeNode *left = node->get_inner().children[LightTree::left].get();
+    const LightTreeNode *right = node->get_inner().children[LightTree::right].get();
+    EXPECT_TRUE(bounds_contain(node->measure.bbox, left->measure.bbox));
+    EXPECT_TRUE(bounds_contain(node->measure.bbox, right->measure.bbox));
+    check_subtree(left, emitters, num_visits);
+    check_subtree(right, emitters, num_visits);
+    return;
+  }
+
+  const LightTreeNode::Leaf &leaf = node->get_leaf();
+  for (int i = leaf.first_emitter_index; i < leaf.first_emitter_index + leaf.num_emitters; i++) {
+    EXPECT_TRUE(bounds_contain(node->measure.bbox, emitters[i].measure.bbox));
+    num_visits[i]++;
+  }
+}
+
+/* The mesh is large enough for the splits near the root to be computed in parallel. */
+TEST_F(LightTreeBuild, parallel_split)
+{
+  const int num_triangles = 300000;
+  add_emissive_mesh(num_triangles);
+
+  LightTree light_tree(scene.get(), &scene->dscene, progress, 8);
+  LightTreeNode *root = light_tree.build(scene.get(), &scene->dscene);
+  ASSERT_NE(root, nullptr);
+
+  /* All the triangles, followed by the mesh. */
+  ASSERT_EQ(light_tree.num_emitters(), num_triangles + 1);
+  const LightTreeEmitter *emitters = light_tree.get_emitters();
+  const LightTreeEmitter &mesh_emitter = emitters[num_triangles];
+  ASSERT_TRUE(mesh_emitter.is_mesh());
+
+  /* Every triangle is in exactly one leaf, inside the bounds of its parents. */
+  vector<int> num_visits(num_triangles, 0);
+  check_subtree(mesh_emitter.root.get(), emitters, num_visits);
+  for (int i = 0; i < num_triangles; i++) {
+    EXPECT_EQ(num_visits[i], 1);
+  }
+
+  EXPECT_TRUE(bounds_contain(mesh_emitter.root->measure.bbox, emitters[0].measure.bbox));
+  EXPECT_NEAR(mesh_emitter.measure.energy, root->measure.energy, 1e-3f * root->measure.energy);
+}
+
+/* Run with --gtest_also_run_disabled_tests to measure the build time of the light tree of a
+ * mesh with many emissive triangles. */
+TEST_F(LightTreeBuild, DISABLED_benchmark)
+{
+  const int num_triangles = 4000000;
+  add_emissive_mesh(num_triangles);
+
+  const double start_time = time_dt();
+
+  LightTree light_tree(scene.get(), &scene->dscene, progress, 8);
+  light_tree.build(scene.get(), &scene->dscene);
+
+  std::cout << "Built light tree of " << num_triangles << " triangles with "
+            << light_tree.num_nodes << " nodes in " << (time_dt() - start_time) * 1000.0
+            << " ms\n";
+}
+
+/* Light manager keeping the light tree between updates, like during interactive rendering. */
+class LightTreeManager : public LightManager {
+ public:
+  void update_tree(Scene *scene, const uint32_t flags, Progress &progress)
+  {
+    update_flags = flags;
+    device_update_tree(scene->device, &scene->dscene, scene, progress);
+  }
+
+  LightTree *get_tree() const
+  {
+    return light_tree.get();
+  }
+};
+
+/* Scene with clusters of point lights and an emissive mesh instanced twice. */
+class LightTreeRefit : public LightTreeBuild {
+ protected:
+  static const int num_clusters = 4;
+  static const int num_cluster_lights = 16;
+
+  vector<Object *> lights;
+  vector<Object *> instances;
+  LightTreeManager light_manager;
+
+  void SetUp() override
+  {
+    LightTreeBuild::SetUp();
+
+    for (int i = 0; i < num_clusters * num_cluster_lights; i++) {
+      lights.push_back(add_point_light(light_position(i / num_cluster_lights, i)));
+    }
+    instances.push_back(add_emissive_mesh(100, transform_translate(0.0f, 5.0f, 0.0f)));
+    instances.push_back(
+        add_object(instances[0]->get_geometry(), transform_translate(20.0f, 5.0f, 0.0f)));
+
+    scene->dscene.data.integrator.use_light_tree = true;
+    light_manager.update_tree(scene.get(), LightManager::UPDATE_ALL, progress);
+  }
+
+  /* Position of a light in one of the clusters, which are 10 apart along X. */
+  static float3 light_position(const int cluster, const int i)
+  {
+    return make_float3(cluster * 10.0f, 0.0f, 0.0f) + make_float3(hash_uint2_to_float(i, 0),
+                                                                   hash_uint2_to_float(i, 1),
+                                                                   hash_uint2_to_float(i, 2));
+  }
+
+  void move_object(Object *object, const Transform &tfm)
+  {
+    object->set_tfm(tfm);
+    object->compute_bounds(false);
+  }
+
+  /* Refit the tree for moved objects and flatten it, like an update of the light manager. */
+  void refit()
+  {
+    const LightTree *light_tree = light_manager.get_tree();
+    light_manager.update_tree(
+        scene.get(), LightManager::LIGHT_MODIFIED | LightManager::OBJECT_MANAGER, progress);
+    ASSERT_EQ(light_manager.get_tree(), light_tree);
+  }
+
+  vector<int> emitter_order() const
+  {
+    const LightTree *light_tree = light_manager.get_tree();
+    vector<int> order;
+    for (size_t i = 0; i < light_tree->num_emitters(); i++) {
+      const LightTreeEmitter &emitter = light_tree->get_emitters()[i];
+      order.push_back(emitter.is_triangle() ? emitter.prim_id : ~emitter.object_id);
+    }
+    return order;
+  }
+
+  /* Checks that the bounds of every node contain the bounds of its children and emitters, and
+   * that every emitter is visited exactly once. Returns the number of nodes, including the
+   * subtrees of meshes which are in object space. */
+  static int check_refit_subtree(const LightTreeNode *node,
+                                 const LightTreeEmitter *emitters,
+                                 vector<int> &num_visits,
+                                 const bool check_bounds = true)
+  {
+    if (std::holds_alternative<LightTreeNode::Instance>(node->variant_type)) {
+      return 1;
+    }
+
+    if (std::holds_alternative<LightTreeNode::Inner>(node->variant_type)) {
+      const LightTreeNode *left = node->get_inner().children[LightTree::left].get();
+      const LightTreeNode *right = node->get_inner().children[LightTree::right].get();
+      if (check_bounds) {
+        EXPECT_TRUE(bounds_contain(node->measure.bbox, left->measure.bbox));
+        EXPECT_TRUE(bounds_contain(node->measure.bbox, right->measure.bbox));
+      }
+      return 1 + check_refit_subtree(left, emitters, num_visits) +
+             check_refit_subtree(right, emitters, num_visits);
+    }
+
+    int num_nodes = 1;
+    const LightTreeNode::Leaf &leaf = node->get_leaf();
+    for (int i = leaf.first_emitter_index; i < leaf.first_emitter_index + leaf.num_emitters; i++) {
+      if (check_bounds) {
+        EXPECT_TRUE(bounds_contain(node->measure.bbox, emitters[i].measure.bbox));
+      }
+      num_visits[i]++;
+
+      /* The root of a mesh has its measure in world space and its children in object space. */
+      if (emitters[i].is_mesh()) {
+        num_nodes += check_refit_subtree(emitters[i].root.get(), emitters, num_visits, false);
+      }
+    }
+    return num_nodes;
+  }
+
+  void check_tree()
+  {
+    const LightTree *light_tree = light_manager.get_tree();
+    const LightTreeEmitter *emitters = light_tree->get_emitters();
+
+    vector<int> num_visits(light_tree->num_emitters(), 0);
+    const int num_nodes = check_refit_subtree(light_tree->get_root(), emitters, num_visits);
+    EXPECT_EQ(num_nodes, light_tree->num_nodes);
+    for (size_t i = 0; i < num_visits.size(); i++) {
+      EXPECT_EQ(num_visits[i], 1) << "emitter " << i;
+    }
+
+    for (const Object *object : instances) {
+      EXPECT_TRUE(bounds_contain(light_tree->get_root()->measure.bbox, object->bounds));
+    }
+
+    /* Same energy as a tree built from scratch. */
+    LightTree fresh_tree(scene.get(), &scene->dscene, progress, 8);
+    const LightTreeNode *fresh_root = fresh_tree.build(scene.get(), &scene->dscene);
+    ASSERT_NE(fresh_root, nullptr);
+    EXPECT_NEAR(light_tree->get_root()->measure.energy,
+                fresh_root->measure.energy,
+                1e-4f * fresh_root->measure.energy);
+  }
+};
+
+/* Moving a light and an instance keeps the tree, its bounds follow the objects. */
+TEST_F(LightTreeRefit, move)
+{
+  check_tree();
+
+  for (int step = 1; step <= 2; step++) {
+    const float3 offset = make_float3(0.0f, 0.0f, step);
+    move_object(lights[0], transform_translate(light_position(0, 0) + offset));
+    move_object(instances[1], transform_translate(20.0f, 5.0f + step, 0.0f));
+    refit();
+    check_tree();
+  }
+}
+
+/* Mixing the lights of the clusters makes the refit subtrees much more expensive than when they
+ * were built, so they are built again. */
+TEST_F(LightTreeRefit, rebuild)
+{
+  const vector<int> order = emitter_order();
+
+  for (size_t i = 0; i < lights.size(); i++) {
+    move_object(lights[i], transform_translate(light_position(i % num_clusters, i)));
+  }
+  refit();
+  check_tree();
+
+  /* Building sorts the emitters of the rebuilt subtrees by their new positions. */
+  EXPECT_NE(emitter_order(), order);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,192 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "device/device.h"
+
+#include "scene/mesh.h"
+#include "scene/object.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
+
+#include "util/colorspace.h"
+#include "util/hash.h"
+#include "util/progress.h"
+#include "util/stats.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Instances of a mesh whose shader has an emission strength of 2 * random + 1, and an object of
+ * a mesh with a shader without object constants. */
+class ObjectConstantsUpdate : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  unique_ptr<Device> device_cpu;
+  SceneParams scene_params;
+  unique_ptr<Scene> scene;
+  Progress progress;
+
+  Shader *shader = nullptr;
+  Mesh *mesh = nullptr;
+  vector<Object *> instances;
+
+  void SetUp() override
+  {
+    ColorSpaceManager::init_fallback_config();
+
+    device_cpu = Device::create(device_info, stats, profiler, true);
+    scene = make_unique<Scene>(scene_params, device_cpu.get());
+
+    shader = scene->create_node<Shader>();
+    set_shader_graph(2.0f);
+
+    mesh = add_mesh(shader);
+    for (int i = 0; i < 3; i++) {
+      instances.push_back(add_object(mesh, i));
+    }
+    add_object(add_mesh(scene->default_surface), 3);
+
+    update();
+  }
+
+  void TearDown() override
+  {
+    scene.reset();
+    device_cpu.reset();
+  }
+
+  void set_shader_graph(const float multiplier)
+  {
+    unique_ptr<ShaderGraph> graph = make_unique<ShaderGraph>();
+    ObjectInfoNode *object_info = graph->create_node<ObjectInfoNode>();
+    MathNode *multiply = graph->create_node<MathNode>();
+    multiply->set_math_type(NODE_MATH_MULTIPLY);
+    multiply->set_value2(multiplier);
+    MathNode *add = graph->create_node<MathNode>();
+    add->set_math_type(NODE_MATH_ADD);
+    add->set_value2(1.0f);
+    EmissionNode *emission = graph->create_node<EmissionNode>();
+
+    graph->connect(object_info->output("Random"), multiply->input("Value1"));
+    graph->connect(multiply->output("Value"), add->input("Value1"));
+    graph->connect(add->output("Value"), emission->input("Strength"));
+    graph->connect(emission->output("Emission"), graph->output()->input("Surface"));
+
+    shader->set_graph(std::move(graph));
+  }
+
+  Mesh *add_mesh(Shader *mesh_shader)
+  {
+    Mesh *mesh = scene->create_node<Mesh>();
+    array<Node *> used_shaders;
+    used_shaders.push_back_slow(mesh_shader);
+    mesh->set_used_shaders(used_shaders);
+    return mesh;
+  }
+
+  Object *add_object(Mesh *mesh, const uint seed)
+  {
+    Object *object = scene->create_node<Object>();
+    object->set_geometry(mesh);
+    object->set_random_id(hash_uint(seed));
+    return object;
+  }
+
+  /* Finalize the graphs like the shader manager, and update the objects. */
+  void update()
+  {
+    for (size_t i = 0; i < scene->shaders.size(); i++) {
+      scene->shaders[i]->id = i;
+      if (!scene->shaders[i]->graph->finalized) {
+        scene->shaders[i]->graph->finalize(scene.get());
+      }
+    }
+    ASSERT_NE(shader->graph->object_constants.get(), nullptr);
+
+    scene->object_manager->device_update(
+        device_cpu.get(), &scene->dscene, scene.get(), progress);
+  }
+
+  float4 *values(const Object *object)
+  {
+    const int offset = scene->dscene.objects[object->index].shader_constants_offset;
+    device_vector<uint> &shaders = scene->dscene.object_constant_shaders;
+    EXPECT_NE(offset, -1);
+    EXPECT_EQ(shaders[offset], 1u);
+    EXPECT_EQ(shaders[offset + 1], shader->id);
+    return scene->dscene.object_constants.data() + shaders[offset + 2];
+  }
+
+  float expected_value(const Object *object, const float multiplier = 2.0f)
+  {
+    return scene->dscene.objects[object->index].random_number * multiplier + 1.0f;
+  }
+};
+
+/* Only the objects using the shader have values. */
+TEST_F(ObjectConstantsUpdate, layout)
+{
+  EXPECT_EQ(scene->dscene.object_constants.size(), instances.size());
+  EXPECT_EQ(scene->dscene.object_constant_shaders.size(), instances.size() * 3);
+  EXPECT_EQ(scene->dscene.objects[3].shader_constants_offset, -1);
+
+  for (const Object *object : instances) {
+    EXPECT_FLOAT_EQ(values(object)->x, expected_value(object));
+  }
+}
+
+/* Only the object with modified object info is evaluated again, moving an object evaluates
+ * nothing. */
+TEST_F(ObjectConstantsUpdate, modified_object)
+{
+  for (const Object *object : instances) {
+    values(object)->x = -1.0f;
+  }
+
+  instances[0]->set_tfm(transform_translate(make_float3(1.0f, 0.0f, 0.0f)));
+  instances[1]->set_random_id(hash_uint(10));
+  instances[0]->tag_update(scene.get());
+  instances[1]->tag_update(scene.get());
+  update();
+
+  EXPECT_EQ(values(instances[0])->x, -1.0f);
+  EXPECT_FLOAT_EQ(values(instances[1])->x, expected_value(instances[1]));
+  EXPECT_EQ(values(instances[2])->x, -1.0f);
+}
+
+/* New objects get values, the values of the other objects are kept. */
+TEST_F(ObjectConstantsUpdate, added_object)
+{
+  for (const Object *object : instances) {
+    values(object)->x = -1.0f;
+  }
+
+  instances.push_back(add_object(mesh, 4));
+  update();
+
+  EXPECT_EQ(scene->dscene.object_constants.size(), instances.size());
+  EXPECT_EQ(values(instances[0])->x, -1.0f);
+  EXPECT_EQ(values(instances[2])->x, -1.0f);
+  EXPECT_FLOAT_EQ(values(instances[3])->x, expected_value(instances[3]));
+}
+
+/* A new graph of the shader evaluates all objects using it. */
+TEST_F(ObjectConstantsUpdate, modified_shader)
+{
+  set_shader_graph(3.0f);
+  scene->object_manager->tag_update(scene.get(), ObjectManager::SHADER_CONSTANTS_MODIFIED);
+  update();
+
+  for (const Object *object : instances) {
+    EXPECT_FLOAT_EQ(values(object)->x, expected_value(object, 3.0f));
+  }
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,69 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "scene/svm_specialize.h"
+
+#include "kernel/svm/types.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Program with a surface part of two nodes followed by a displacement part. */
+static array<int4> svm_specialize_test_program(const int value)
+{
+  array<int4> nodes;
+  nodes.push_back_slow(make_int4(NODE_SHADER_JUMP, 1, 0, 3));
+  nodes.push_back_slow(make_int4(NODE_VALUE_F, __float_as_int(float(value)), 0, 0));
+  nodes.push_back_slow(make_int4(NODE_END, 0, 0, 0));
+  nodes.push_back_slow(make_int4(NODE_VALUE_F, 0, 1, 0));
+  nodes.push_back_slow(make_int4(NODE_END, 0, 0, 0));
+  return nodes;
+}
+
+static int count(const string &source, const string &pattern)
+{
+  int num = 0;
+  for (size_t pos = source.find(pattern); pos != string::npos;
+       pos = source.find(pattern, pos + 1))
+  {
+    num++;
+  }
+  return num;
+}
+
+TEST(svm_specialize_source, surface_nodes)
+{
+  const array<int4> program = svm_specialize_test_program(1);
+  const string source = svm_specialize_source({&program});
+
+  EXPECT_EQ(count(source, "SVM_SPECIALIZED_SHADER_BEGIN("), 1);
+  /* Only the surface part is generated, with offsets local to the shader. */
+  EXPECT_EQ(count(source, "SVM_SPECIALIZED_NODE("), 2);
+  EXPECT_EQ(count(source, "SVM_SPECIALIZED_NODE(1, "), 1);
+  EXPECT_EQ(count(source, "SVM_SPECIALIZED_NODE(2, "), 1);
+  EXPECT_EQ(count(source, "SVM_SPECIALIZED_NODE(3, "), 0);
+  EXPECT_EQ(count(source, "SVM_SPECIALIZED_EXPORT("), 1);
+}
+
+TEST(svm_specialize_source, deduplicate)
+{
+  const array<int4> a = svm_specialize_test_program(1);
+  const array<int4> b = svm_specialize_test_program(2);
+  const array<int4> c = svm_specialize_test_program(1);
+  const string source = svm_specialize_source({&a, &b, &c});
+
+  /* Identical programs share a function, but every program has an entry in the table. */
+  EXPECT_EQ(count(source, "SVM_SPECIALIZED_SHADER_BEGIN("), 2);
+  EXPECT_EQ(count(source, "SVM_SPECIALIZED_EXPORT("), 3);
+
+  const size_t export_a = source.find("SVM_SPECIALIZED_EXPORT(");
+  const size_t export_b = source.find("SVM_SPECIALIZED_EXPORT(", export_a + 1);
+  const size_t export_c = source.find("SVM_SPECIALIZED_EXPORT(", export_b + 1);
+  const size_t length = source.find('\n', export_a) - export_a;
+  EXPECT_EQ(source.substr(export_a, length), source.substr(export_c, length));
+  EXPECT_NE(source.substr(export_a, length), source.substr(export_b, length));
+}
+
+CCL_NAMESPACE_END
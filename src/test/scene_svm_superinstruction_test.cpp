@@ -0,0 +1,233 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+// clang-format off
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+
+#include "kernel/globals.h"
+
+#include "kernel/device/cpu/image.h"
+
+#include "kernel/integrator/state.h"
+#include "kernel/integrator/state_util.h"
+
+#include "kernel/integrator/surface_shader.h"
+// clang-format on
+
+#include "scene/svm.h"
+
+#include "util/profiling.h"
+#include "util/time.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* SVM program with the node starts as recorded by the compiler. */
+struct SVMTestProgram {
+  array<int4> nodes;
+  vector<int> starts;
+
+  void add_node(const int x, const int y = 0, const int z = 0, const int w = 0)
+  {
+    starts.push_back(nodes.size());
+    nodes.push_back_slow(make_int4(x, y, z, w));
+  }
+
+  void add_value(const float value, const int out)
+  {
+    add_node(NODE_VALUE_F, __float_as_int(value), out);
+  }
+
+  void add_value(const float3 value, const int out)
+  {
+    add_node(NODE_VALUE_V, out);
+    /* The value is added with a node type, like the compiler does. */
+    add_node(
+        NODE_VALUE_V, __float_as_int(value.x), __float_as_int(value.y), __float_as_int(value.z));
+  }
+
+  void add_math(const NodeMathType type, const int a, const int b, const int out)
+  {
+    add_node(NODE_MATH, type, a | (b << 8) | (a << 16), out);
+  }
+
+  void fuse()
+  {
+    svm_fuse_superinstructions(nodes, starts);
+  }
+};
+
+/* Run the program in the interpreter, leaving the results on the stack. */
+class SVMTestEval {
+ public:
+  explicit SVMTestEval(const array<int4> &nodes)
+      : kg_(make_globals(nodes), nullptr, profiler_, 0)
+  {
+  }
+
+  void eval(float *stack)
+  {
+    ShaderData sd = {};
+    Spectrum closure_weight = zero_spectrum();
+    int offset = 0;
+    while (true) {
+      const uint4 node = read_node(&kg_, &offset);
+      if (!svm_eval_node<KERNEL_FEATURE_NODE_MASK_SURFACE,
+                         SHADER_TYPE_SURFACE,
+                         ConstIntegratorState>(
+              &kg_, nullptr, &sd, nullptr, 0, stack, closure_weight, node, offset))
+      {
+        break;
+      }
+    }
+  }
+
+ protected:
+  static KernelGlobalsCPU make_globals(const array<int4> &nodes)
+  {
+    KernelGlobalsCPU globals;
+    globals.svm_nodes.data = (uint4 *)nodes.data();
+    globals.svm_nodes.width = nodes.size();
+    return globals;
+  }
+
+  Profiler profiler_;
+  ThreadKernelGlobalsCPU kg_;
+};
+
+/* Constant inputs followed by a chain of math nodes. */
+SVMTestProgram make_math_program(const int num_values, const int num_math)
+{
+  SVMTestProgram program;
+  for (int i = 0; i < num_values; i++) {
+    program.add_value(float(i + 1), i);
+  }
+  for (int i = 0; i < num_math; i++) {
+    program.add_math((i % 2) ? NODE_MATH_SUBTRACT : NODE_MATH_ADD,
+                     i % num_values,
+                     (i + 1) % num_values,
+                     (i + 2) % num_values);
+  }
+  program.add_node(NODE_END);
+  return program;
+}
+
+bool node_equal(const int4 &a, const int4 &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+}
+
+}  // namespace
+
+TEST(SVMSuperinstruction, fuse_math)
+{
+  SVMTestProgram program = make_math_program(4, 8);
+  const int size = program.nodes.size();
+  program.fuse();
+
+  ASSERT_EQ(program.nodes.size(), size + 2);
+  EXPECT_TRUE(node_equal(program.nodes[0], make_int4(NODE_VALUE_BATCH, 4, 0, 0)));
+  EXPECT_TRUE(node_equal(program.nodes[5], make_int4(NODE_MATH_CHAIN, 8, 0, 0)));
+
+  float stack[SVM_STACK_SIZE] = {};
+  float fused_stack[SVM_STACK_SIZE] = {};
+  SVMTestEval(make_math_program(4, 8).nodes).eval(stack);
+  SVMTestEval(program.nodes).eval(fused_stack);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(stack[i], fused_stack[i]);
+  }
+}
+
+TEST(SVMSuperinstruction, fuse_values_with_vector)
+{
+  SVMTestProgram program;
+  program.add_value(make_float3(1.0f, 2.0f, 3.0f), 0);
+  program.add_value(4.0f, 3);
+  program.add_node(NODE_END);
+  program.fuse();
+
+  ASSERT_EQ(program.nodes.size(), 5);
+  EXPECT_TRUE(node_equal(program.nodes[0], make_int4(NODE_VALUE_BATCH, 2, 0, 0)));
+
+  float stack[SVM_STACK_SIZE] = {};
+  SVMTestEval(program.nodes).eval(stack);
+  EXPECT_EQ(stack[0], 1.0f);
+  EXPECT_EQ(stack[2], 3.0f);
+  EXPECT_EQ(stack[3], 4.0f);
+}
+
+TEST(SVMSuperinstruction, fuse_texture_chain)
+{
+  SVMTestProgram program;
+  program.add_node(NODE_TEX_COORD, NODE_TEXCO_NORMAL, 0);
+  program.add_value(make_float3(0.0f), 3);
+  program.add_value(make_float3(0.0f), 6);
+  program.add_value(make_float3(1.0f), 9);
+  program.add_node(
+      NODE_MAPPING, NODE_MAPPING_TYPE_POINT, 0 | (3 << 8) | (6 << 16) | (9 << 24), 12);
+  program.add_node(NODE_TEX_IMAGE, 0, 12 | (15 << 8) | (SVM_STACK_INVALID << 16), 0);
+  program.add_node(NODE_END);
+  program.fuse();
+
+  EXPECT_TRUE(node_equal(program.nodes[0], make_int4(NODE_TEXTURE_CHAIN, 3, 0, 0)));
+  EXPECT_EQ(program.nodes[1].x, NODE_TEX_COORD);
+  EXPECT_EQ(program.nodes.size(), 11);
+}
+
+TEST(SVMSuperinstruction, jumps)
+{
+  /* Skip two values when the condition is zero, landing in the middle of the fused values. */
+  SVMTestProgram program;
+  program.add_value(0.0f, 5);
+  program.add_node(NODE_JUMP_IF_ZERO, 2, 5);
+  program.add_value(100.0f, 0);
+  program.add_value(200.0f, 1);
+  program.add_value(2.0f, 2);
+  program.add_value(3.0f, 3);
+  program.add_math(NODE_MATH_ADD, 2, 3, 0);
+  program.add_math(NODE_MATH_MULTIPLY, 0, 3, 1);
+  program.add_node(NODE_END);
+  program.fuse();
+
+  ASSERT_TRUE(node_equal(program.nodes[2], make_int4(NODE_VALUE_BATCH, 4, 0, 0)));
+  EXPECT_EQ(program.nodes[1].y, 3);
+
+  float stack[SVM_STACK_SIZE] = {};
+  SVMTestEval(program.nodes).eval(stack);
+  EXPECT_EQ(stack[0], 5.0f);
+  EXPECT_EQ(stack[1], 15.0f);
+}
+
+/* Compares evaluation time of a program of constant inputs and math nodes, as separate nodes
+ * and as superinstructions. Run with --gtest_also_run_disabled_tests. */
+TEST(SVMSuperinstruction, DISABLED_benchmark)
+{
+  const int num_evals = 1000000;
+
+  for (const bool use_superinstructions : {false, true}) {
+    SVMTestProgram program = make_math_program(8, 32);
+    if (use_superinstructions) {
+      program.fuse();
+    }
+    SVMTestEval eval(program.nodes);
+
+    const double start_time = time_dt();
+    float sum = 0.0f;
+    for (int i = 0; i < num_evals; i++) {
+      float stack[SVM_STACK_SIZE];
+      eval.eval(stack);
+      sum += stack[0];
+    }
+
+    std::cout << (use_superinstructions ? "Superinstructions" : "Separate nodes") << ": "
+              << program.nodes.size() << " nodes, " << (time_dt() - start_time) * 1000.0
+              << " ms, result " << sum << "\n";
+  }
+}
+
+CCL_NAMESPACE_END
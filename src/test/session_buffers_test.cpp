@@ -0,0 +1,116 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "device/device.h"
+
+#include "session/buffers.h"
+
+#include "util/hash.h"
+#include "util/stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+static BufferPass make_pass(const PassType type, const int offset)
+{
+  BufferPass pass;
+  pass.type = type;
+  pass.offset = offset;
+  return pass;
+}
+
+static BufferParams make_buffer_params(const int width, const int height)
+{
+  BufferParams params;
+  params.width = width;
+  params.height = height;
+  params.window_width = width;
+  params.window_height = height;
+  params.full_width = width;
+  params.full_height = height;
+
+  params.passes.push_back(make_pass(PASS_COMBINED, 0));
+  params.passes.push_back(make_pass(PASS_DENOISING_ALBEDO, 4));
+  params.passes.push_back(make_pass(PASS_DENOISING_NORMAL, 7));
+  params.passes.push_back(make_pass(PASS_DEPTH, PASS_UNUSED));
+  params.passes.push_back(make_pass(PASS_SAMPLE_COUNT, 10));
+  params.update_passes();
+
+  return params;
+}
+
+TEST(RenderBuffers, pack_unpack)
+{
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  unique_ptr<Device> device = Device::create(device_info, stats, profiler, true);
+
+  const BufferParams params = make_buffer_params(64, 32);
+  EXPECT_EQ(params.pass_stride, 11);
+
+  RenderBuffers buffers(device.get());
+  buffers.reset(params);
+
+  const int num_values = params.width * params.height * params.pass_stride;
+  for (int i = 0; i < num_values; i++) {
+    const int component = i % params.pass_stride;
+    buffers.buffer.data()[i] = (component == 10) ? float(i % 4096) :
+                                                   hash_uint2_to_float(i, 0) * 1000.0f;
+  }
+  buffers.copy_to_device();
+  const vector<float> original(buffers.buffer.data(), buffers.buffer.data() + num_values);
+
+  buffers.pack();
+  EXPECT_TRUE(buffers.is_packed());
+  EXPECT_EQ(buffers.buffer.data(), nullptr);
+
+  /* Combined stays float, guiding passes are half and the sample count is 16 bit. */
+  const size_t pixel_size = 4 * sizeof(float) + 6 * sizeof(half) + sizeof(uint16_t);
+  EXPECT_EQ(buffers.packed_size(), params.width * params.height * pixel_size);
+
+  buffers.unpack();
+  EXPECT_FALSE(buffers.is_packed());
+  ASSERT_NE(buffers.buffer.data(), nullptr);
+
+  for (int i = 0; i < num_values; i++) {
+    const int component = i % params.pass_stride;
+    if (component < 4 || component == 10) {
+      EXPECT_EQ(buffers.buffer.data()[i], original[i]);
+    }
+    else {
+      EXPECT_NEAR(buffers.buffer.data()[i], original[i], max(original[i] * 1e-3f, 1e-3f));
+    }
+  }
+}
+
+TEST(RenderBuffers, pack_out_of_range)
+{
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  unique_ptr<Device> device = Device::create(device_info, stats, profiler, true);
+
+  const BufferParams params = make_buffer_params(4, 4);
+
+  RenderBuffers buffers(device.get());
+  buffers.reset(params);
+  buffers.buffer.zero_to_device();
+
+  /* Values which do not fit the compact storage keep the pass in full precision. */
+  buffers.buffer.data()[4] = 1e6f;
+  buffers.buffer.data()[10] = 0.5f;
+  buffers.copy_to_device();
+
+  buffers.pack();
+  const size_t pixel_size = 8 * sizeof(float) + 3 * sizeof(half);
+  EXPECT_EQ(buffers.packed_size(), params.width * params.height * pixel_size);
+
+  buffers.unpack();
+  EXPECT_EQ(buffers.buffer.data()[4], 1e6f);
+  EXPECT_EQ(buffers.buffer.data()[10], 0.5f);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,170 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <functional>
+
+#include "device/device.h"
+
+#include "scene/background.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/object.h"
+#include "scene/pass.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
+
+#include "session/buffers.h"
+#include "session/output_driver.h"
+#include "session/session.h"
+
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Renders of small synthetic scenes on the CPU, for tests comparing the combined pass against
+ * analytic values or other renders.
+ *
+ * The camera is orthographic at z = -5 looking along +z, so every pixel of the square image sees
+ * the square [-1, 1]^2 in x and y, and all camera rays are parallel. */
+
+/* Output driver keeping the RGBA pixels of the combined pass. */
+class SessionRenderTestOutputDriver : public OutputDriver {
+ public:
+  explicit SessionRenderTestOutputDriver(vector<float> &pixels) : pixels_(pixels) {}
+
+  void write_render_tile(const Tile &tile) override
+  {
+    pixels_.resize(size_t(tile.size.x) * tile.size.y * 4);
+    EXPECT_TRUE(tile.get_pass_pixels("combined", 4, pixels_.data()));
+  }
+
+ protected:
+  vector<float> &pixels_;
+};
+
+/* Render the scene created by the function, returns the combined pass as RGBA pixels. The kernel
+ * features used for rendering are returned when requested. */
+static vector<float> session_render_test(const std::function<void(Scene *)> &create_scene,
+                                         const int size = 16,
+                                         const int samples = 16,
+                                         uint *kernel_features = nullptr)
+{
+  SessionParams session_params;
+  session_params.device = Device::available_devices(DEVICE_MASK_CPU).front();
+  session_params.background = true;
+  session_params.headless = true;
+  session_params.samples = samples;
+  session_params.use_auto_tile = false;
+
+  vector<float> pixels;
+  Session session(session_params, SceneParams());
+  session.set_output_driver(make_unique<SessionRenderTestOutputDriver>(pixels));
+
+  Scene *scene = session.scene.get();
+  scene->camera->set_camera_type(CAMERA_ORTHOGRAPHIC);
+  scene->camera->set_matrix(transform_translate(make_float3(0.0f, 0.0f, -5.0f)));
+  scene->camera->set_full_width(size);
+  scene->camera->set_full_height(size);
+  scene->camera->compute_auto_viewplane();
+
+  Pass *pass = scene->create_node<Pass>();
+  pass->set_name(ustring("combined"));
+  pass->set_type(PASS_COMBINED);
+
+  create_scene(scene);
+
+  BufferParams buffer_params;
+  buffer_params.width = size;
+  buffer_params.height = size;
+  buffer_params.full_width = size;
+  buffer_params.full_height = size;
+
+  session.reset(session_params, buffer_params);
+  session.start();
+  session.wait();
+
+  EXPECT_FALSE(session.progress.get_error()) << session.progress.get_error_message();
+  EXPECT_EQ(pixels.size(), size_t(size) * size * 4);
+  if (kernel_features) {
+    *kernel_features = session.device->get_cpu_kernel_features();
+  }
+  return pixels;
+}
+
+/* Average of the red channel over all pixels. */
+static float session_render_test_average(const vector<float> &pixels)
+{
+  double sum = 0.0;
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    sum += pixels[i];
+  }
+  return pixels.empty() ? 0.0f : float(sum / (pixels.size() / 4));
+}
+
+static Shader *session_render_test_add_shader(Scene *scene, unique_ptr<ShaderGraph> graph)
+{
+  Shader *shader = scene->create_node<Shader>();
+  shader->set_graph(std::move(graph));
+  shader->tag_update(scene);
+  return shader;
+}
+
+/* White background with the given strength. */
+static void session_render_test_set_background(Scene *scene, const float strength)
+{
+  unique_ptr<ShaderGraph> graph = make_unique<ShaderGraph>();
+  BackgroundNode *background = graph->create_node<BackgroundNode>();
+  background->set_color(one_float3());
+  background->set_strength(strength);
+  graph->connect(background->output("Background"), graph->output()->input("Surface"));
+
+  scene->default_background->set_graph(std::move(graph));
+  scene->default_background->tag_update(scene);
+}
+
+/* Object of an axis aligned box with outward facing triangles. */
+static Object *session_render_test_add_box(Scene *scene,
+                                           Shader *shader,
+                                           const float3 bmin,
+                                           const float3 bmax)
+{
+  const vector<int> tris = {0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+                            2, 3, 7, 2, 7, 6, 1, 2, 6, 1, 6, 5, 0, 4, 7, 0, 7, 3};
+
+  Mesh *mesh = scene->create_node<Mesh>();
+  array<Node *> used_shaders;
+  used_shaders.push_back_slow(shader);
+  mesh->set_used_shaders(used_shaders);
+
+  array<float3> verts;
+  verts.push_back_slow(make_float3(bmin.x, bmin.y, bmin.z));
+  verts.push_back_slow(make_float3(bmax.x, bmin.y, bmin.z));
+  verts.push_back_slow(make_float3(bmax.x, bmax.y, bmin.z));
+  verts.push_back_slow(make_float3(bmin.x, bmax.y, bmin.z));
+  verts.push_back_slow(make_float3(bmin.x, bmin.y, bmax.z));
+  verts.push_back_slow(make_float3(bmax.x, bmin.y, bmax.z));
+  verts.push_back_slow(make_float3(bmax.x, bmax.y, bmax.z));
+  verts.push_back_slow(make_float3(bmin.x, bmax.y, bmax.z));
+  mesh->set_verts(verts);
+  mesh->resize_mesh(8, tris.size() / 3);
+  std::copy(tris.begin(), tris.end(), mesh->get_triangles().data());
+  std::fill(mesh->get_smooth().begin(), mesh->get_smooth().end(), false);
+  std::fill(mesh->get_shader().begin(), mesh->get_shader().end(), 0);
+
+  mesh->tag_triangles_modified();
+  mesh->tag_shader_modified();
+  mesh->tag_smooth_modified();
+
+  Object *object = scene->create_node<Object>();
+  object->set_geometry(mesh);
+  return object;
+}
+
+CCL_NAMESPACE_END
@@ -27,4 +27,25 @@ TEST(util_aligned_malloc, aligned_malloc_32)
 }
 #endif /* __APPLE__ */
 
+TEST(util_aligned_malloc, aligned_malloc_huge)
+{
+  /* Small allocations never use huge pages. */
+  bool use_huge_pages = true;
+  char *small = (char *)util_aligned_malloc_huge(1024, 32, &use_huge_pages);
+  CHECK_ALIGNMENT(small, 32);
+  EXPECT_FALSE(use_huge_pages);
+  util_aligned_free(small, 1024);
+
+  /* Large allocations are aligned to huge pages when they are used, and always writable. */
+  const size_t size = HUGE_PAGE_MIN_SIZE + 1;
+  char *large = (char *)util_aligned_malloc_huge(size, 32, &use_huge_pages);
+  CHECK_ALIGNMENT(large, 32);
+  if (use_huge_pages) {
+    CHECK_ALIGNMENT(large, HUGE_PAGE_SIZE);
+  }
+  large[0] = 1;
+  large[size - 1] = 1;
+  util_aligned_free(large, size);
+}
+
 CCL_NAMESPACE_END
@@ -0,0 +1,27 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "util/color.h"
+
+CCL_NAMESPACE_BEGIN
+
+TEST(util_color, linear_to_srgb_display)
+{
+  /* Within a quarter of an 8-bit step of the exact conversion over the display range. */
+  for (int i = 0; i <= 10000; i++) {
+    const float c = i / 10000.0f;
+    const float4 srgb = color_linear_to_srgb_display_v4(make_float4(c, c * c, c * 0.01f, c));
+    EXPECT_NEAR(srgb.x, color_linear_to_srgb(c), 0.25f / 255.0f);
+    EXPECT_NEAR(srgb.y, color_linear_to_srgb(c * c), 0.25f / 255.0f);
+    EXPECT_NEAR(srgb.z, color_linear_to_srgb(c * 0.01f), 0.25f / 255.0f);
+    EXPECT_EQ(srgb.w, c);
+  }
+
+  /* Negative values map to black. */
+  EXPECT_EQ(color_linear_to_srgb_display_v4(make_float4(-1.0f)).x, 0.0f);
+}
+
+CCL_NAMESPACE_END
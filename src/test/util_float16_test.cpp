@@ -0,0 +1,6 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#define TEST_CATEGORY_NAME util_float16
+#include "util_float16_test.h"
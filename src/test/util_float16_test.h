@@ -0,0 +1,145 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include <gtest/gtest.h>
+
+#include "util/math.h"
+#include "util/system.h"
+#include "util/types.h"
+
+CCL_NAMESPACE_BEGIN
+
+static bool validate_cpu_capabilities()
+{
+#if defined(__KERNEL_AVX512__)
+  return system_cpu_support_avx512();
+#else
+  return true;
+#endif
+}
+
+/* These are not just static variables because we don't want to run the
+ * constructor until we know the instructions are supported. */
+static vfloat16 float16_a()
+{
+  vfloat16 a;
+  for (int i = 0; i < 16; i++) {
+    a[i] = 0.1f * float(i + 1);
+  }
+  return a;
+}
+
+static vfloat16 float16_b()
+{
+  vfloat16 b;
+  for (int i = 0; i < 16; i++) {
+    b[i] = float(i + 1);
+  }
+  return b;
+}
+
+#define INIT_FLOAT16_TEST \
+  if (!validate_cpu_capabilities()) \
+    return;
+
+#define compare_vector_vector(a, b) \
+  for (size_t index = 0; index < 16; index++) \
+    EXPECT_FLOAT_EQ(a[index], b[index]);
+
+#define basic_test_vv(a, b, op) \
+  INIT_FLOAT16_TEST \
+  vfloat16 c = a op b; \
+  for (size_t i = 0; i < 16; i++) \
+    EXPECT_FLOAT_EQ(c[i], a[i] op b[i]);
+
+TEST(TEST_CATEGORY_NAME, float16_add_vv)
+{
+  basic_test_vv(float16_a(), float16_b(), +)
+}
+
+TEST(TEST_CATEGORY_NAME, float16_sub_vv)
+{
+  basic_test_vv(float16_a(), float16_b(), -)
+}
+
+TEST(TEST_CATEGORY_NAME, float16_mul_vv)
+{
+  basic_test_vv(float16_a(), float16_b(), *)
+}
+
+TEST(TEST_CATEGORY_NAME, float16_div_vv)
+{
+  basic_test_vv(float16_a(), float16_b(), /)
+}
+
+TEST(TEST_CATEGORY_NAME, float16_ctor)
+{
+  INIT_FLOAT16_TEST
+  float values[17];
+  for (int i = 0; i < 17; i++) {
+    values[i] = float(i);
+  }
+  /* Unaligned load. */
+  const vfloat16 a = load_vfloat16(values + 1);
+  for (int i = 0; i < 16; i++) {
+    EXPECT_FLOAT_EQ(a[i], float(i + 1));
+  }
+
+  const vfloat16 b = make_vfloat16(make_float4(0.0f, 1.0f, 2.0f, 3.0f),
+                                   make_float4(4.0f, 5.0f, 6.0f, 7.0f),
+                                   make_float4(8.0f, 9.0f, 10.0f, 11.0f),
+                                   make_float4(12.0f, 13.0f, 14.0f, 15.0f));
+  compare_vector_vector(b, values);
+  EXPECT_TRUE(make_vfloat16(2.0f) == make_vfloat16(make_vfloat8(2.0f), make_vfloat8(2.0f)));
+}
+
+TEST(TEST_CATEGORY_NAME, float16_sqrt)
+{
+  INIT_FLOAT16_TEST
+  compare_vector_vector(sqrt(float16_b() * float16_b()), float16_b());
+}
+
+TEST(TEST_CATEGORY_NAME, float16_min_max)
+{
+  INIT_FLOAT16_TEST
+  compare_vector_vector(min(float16_a(), float16_b()), float16_a());
+  compare_vector_vector(max(float16_a(), float16_b()), float16_b());
+}
+
+TEST(TEST_CATEGORY_NAME, float16_reduce)
+{
+  INIT_FLOAT16_TEST
+  EXPECT_FLOAT_EQ(reduce_add(float16_b()), 136.0f);
+  EXPECT_FLOAT_EQ(reduce_min(float16_b()), 1.0f);
+  EXPECT_FLOAT_EQ(reduce_max(float16_b()), 16.0f);
+}
+
+TEST(TEST_CATEGORY_NAME, float16_compare_mask)
+{
+  INIT_FLOAT16_TEST
+  EXPECT_EQ(compare_le_mask(float16_b(), make_vfloat16(4.0f)), 0xf);
+  EXPECT_EQ(compare_le_mask(float16_a(), float16_b()), 0xffff);
+  EXPECT_EQ(compare_le_mask(float16_b(), float16_a()), 0);
+}
+
+TEST(TEST_CATEGORY_NAME, float16_extract)
+{
+  INIT_FLOAT16_TEST
+  const vfloat16 b = float16_b();
+  const vfloat8 lo = low(b);
+  const vfloat8 hi = high(b);
+  for (int i = 0; i < 8; i++) {
+    EXPECT_FLOAT_EQ(lo[i], b[i]);
+    EXPECT_FLOAT_EQ(hi[i], b[i + 8]);
+  }
+
+  const float4 q0 = extract_float4<0>(b);
+  const float4 q3 = extract_float4<3>(b);
+  EXPECT_FLOAT_EQ(q0.x, 1.0f);
+  EXPECT_FLOAT_EQ(q0.w, 4.0f);
+  EXPECT_FLOAT_EQ(q3.x, 13.0f);
+  EXPECT_FLOAT_EQ(q3.w, 16.0f);
+}
+
+CCL_NAMESPACE_END
@@ -12,7 +12,9 @@ CCL_NAMESPACE_BEGIN
 
 static bool validate_cpu_capabilities()
 {
-#if defined(__KERNEL_AVX2__)
+#if defined(__KERNEL_AVX512__)
+  return system_cpu_support_avx512();
+#elif defined(__KERNEL_AVX2__)
   return system_cpu_support_avx2();
 #elif defined(__KERNEL_AVX__)
   return system_cpu_support_avx();
@@ -42,4 +42,17 @@ TEST(util_task, multiple_times)
   }
 }
 
+TEST(util_task, numa_nodes)
+{
+  /* Either no topology is known, or every node can run threads. */
+  const vector<int> nodes = TaskScheduler::numa_nodes();
+  int total_concurrency = 0;
+  for (const int node : nodes) {
+    const int concurrency = TaskScheduler::numa_node_concurrency(node);
+    EXPECT_GT(concurrency, 0);
+    total_concurrency += concurrency;
+  }
+  EXPECT_LE(total_concurrency, (nodes.empty()) ? 0 : tbb::this_task_arena::max_concurrency());
+}
+
 CCL_NAMESPACE_END
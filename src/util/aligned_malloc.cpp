@@ -11,6 +11,12 @@
 
 #include <cassert>
 
+#if defined(__linux__) && !defined(WITH_BLENDER_GUARDEDALLOC)
+#  include <cstdlib>
+#  include <sys/mman.h>
+#  define WITH_HUGE_PAGES
+#endif
+
 /* Adopted from Libmv. */
 
 #if !defined(__APPLE__) && !defined(__FreeBSD__) && !defined(__NetBSD__) && !defined(__OpenBSD__)
@@ -54,6 +60,36 @@ void *util_aligned_malloc(const size_t size, const int alignment)
   return mem;
 }
 
+void *util_aligned_malloc_huge(const size_t size, const int alignment, bool *r_huge_pages)
+{
+  if (r_huge_pages) {
+    *r_huge_pages = false;
+  }
+
+#ifdef WITH_HUGE_PAGES
+  if (size >= HUGE_PAGE_MIN_SIZE && alignment <= HUGE_PAGE_SIZE) {
+    /* Align and round up to whole pages, so the kernel can back the entire block with huge
+     * pages instead of leaving the first and last partial pages as regular pages. */
+    const size_t huge_size = (size + HUGE_PAGE_SIZE - 1) & ~size_t(HUGE_PAGE_SIZE - 1);
+    void *mem = nullptr;
+    if (posix_memalign(&mem, HUGE_PAGE_SIZE, huge_size)) {
+      return nullptr;
+    }
+
+    /* This is only a hint, and fails when transparent huge pages are disabled in the kernel. In
+     * that case the memory is still usable with regular pages. */
+    if (madvise(mem, huge_size, MADV_HUGEPAGE) == 0 && r_huge_pages) {
+      *r_huge_pages = true;
+    }
+
+    util_guarded_mem_alloc(size);
+    return mem;
+  }
+#endif
+
+  return util_aligned_malloc(size, alignment);
+}
+
 void util_aligned_free(void *ptr, const size_t size)
 {
   if (ptr) {
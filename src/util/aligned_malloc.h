@@ -12,10 +12,22 @@ CCL_NAMESPACE_BEGIN
 #define MIN_ALIGNMENT_CPU_DATA_TYPES 16  // NOLINT
 /* NanoVDB needs at least 32 byte alignment. */
 #define MIN_ALIGNMENT_DEVICE_MEMORY 32  // NOLINT
+/* Size of transparent huge pages, and the minimum allocation size to request them for. Smaller
+ * allocations would waste too much memory rounding up to whole pages. */
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)         // NOLINT
+#define HUGE_PAGE_MIN_SIZE (4 * HUGE_PAGE_SIZE)  // NOLINT
 
 /* Allocate block of size bytes at least aligned to a given value. */
 void *util_aligned_malloc(const size_t size, const int alignment);
 
+/* Allocate block of size bytes at least aligned to a given value, backed by transparent huge
+ * pages when the size is at least HUGE_PAGE_MIN_SIZE and the platform supports it. This reduces
+ * TLB misses for large arrays accessed randomly. Returns whether huge pages were requested in
+ * r_huge_pages. Memory is freed with util_aligned_free. */
+void *util_aligned_malloc_huge(const size_t size,
+                               const int alignment,
+                               bool *r_huge_pages = nullptr);
+
 /* Free memory allocated by util_aligned_malloc. */
 void util_aligned_free(void *ptr, const size_t size);
 
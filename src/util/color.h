@@ -324,6 +324,20 @@ ccl_device float4 color_srgb_to_linear_sse2(const float4 &c)
   const float4 gte = fastpow24_sse2(gtebase);
   return select(cmp, lt, gte);
 }
+
+/* Approximate color_linear_to_srgb() for values in 0..1, with a weighted sum of square roots
+ * in place of the power function. Error is less than a quarter of an 8-bit step. */
+ccl_device float4 color_linear_to_srgb_sse2(const float4 &c)
+{
+  const int4 cmp = c < make_float4(0.0031308f);
+  const float4 lt = max(c * make_float4(12.92f), make_float4(0.0f));
+  const float4 s1 = sqrt(clamp(c, make_float4(0.0f), make_float4(1.0f)));
+  const float4 s2 = sqrt(s1);
+  const float4 s3 = sqrt(s2);
+  const float4 gte = madd(make_float4(0.662002687f), s1, make_float4(-0.0225411470f) * c) +
+                     madd(make_float4(0.684122060f), s2, make_float4(-0.323583601f) * s3);
+  return select(cmp, lt, gte);
+}
 #endif /* __KERNEL_SSE2__ */
 
 ccl_device float3 color_srgb_to_linear_v3(const float3 c)
@@ -344,6 +358,18 @@ ccl_device float4 color_linear_to_srgb_v4(const float4 c)
       color_linear_to_srgb(c.x), color_linear_to_srgb(c.y), color_linear_to_srgb(c.z), c.w);
 }
 
+/* Faster version of color_linear_to_srgb_v4() for display, only accurate for values in 0..1. */
+ccl_device float4 color_linear_to_srgb_display_v4(const float4 c)
+{
+#ifdef __KERNEL_SSE2__
+  float4 r = color_linear_to_srgb_sse2(c);
+  r.w = c.w;
+  return r;
+#else
+  return color_linear_to_srgb_v4(c);
+#endif
+}
+
 ccl_device float4 color_srgb_to_linear_v4(const float4 c)
 {
 #ifdef __KERNEL_SSE2__
@@ -26,12 +26,17 @@ void DebugFlags::CPU::reset()
     } \
   } while (0)
 
+  CHECK_CPU_FLAGS(avx512, "CYCLES_CPU_NO_AVX512");
   CHECK_CPU_FLAGS(avx2, "CYCLES_CPU_NO_AVX2");
 
 #undef STRINGIFY
 #undef CHECK_CPU_FLAGS
 
   bvh_layout = BVH_LAYOUT_AUTO;
+  numa = (getenv("CYCLES_CPU_NUMA") != nullptr);
+  huge_pages = (getenv("CYCLES_CPU_NO_HUGE_PAGES") == nullptr);
+  share_scene_data = (getenv("CYCLES_CPU_SHARE_SCENE_DATA") != nullptr);
+  specialized_megakernels = (getenv("CYCLES_CPU_NO_SPECIALIZED_MEGAKERNELS") == nullptr);
 }
 
 DebugFlags::CUDA::CUDA()
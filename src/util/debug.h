@@ -24,12 +24,17 @@ class DebugFlags {
     void reset();
 
     /* Flags describing which instructions sets are allowed for use. */
+    bool avx512 = true;
     bool avx2 = true;
     bool sse42 = true;
 
     /* Check functions to see whether instructions up to the given one
      * are allowed for use.
      */
+    bool has_avx512()
+    {
+      return has_avx2() && avx512;
+    }
     bool has_avx2()
     {
       return has_sse42() && avx2;
@@ -45,6 +50,18 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout = BVH_LAYOUT_AUTO;
+
+    /* Pin render threads to NUMA nodes and replicate read-only scene data on each of them. */
+    bool numa = false;
+
+    /* Back large global arrays and images with transparent huge pages. */
+    bool huge_pages = true;
+
+    /* Share identical images, geometry and BVH arrays between CPU devices of all sessions. */
+    bool share_scene_data = false;
+
+    /* Use megakernels with the features not used by the scene compiled out. */
+    bool specialized_megakernels = true;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
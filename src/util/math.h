@@ -16,6 +16,7 @@
 #include "util/math_float2.h"  // IWYU pragma: export
 #include "util/math_float4.h"  // IWYU pragma: export
 #include "util/math_float8.h"  // IWYU pragma: export
+#include "util/math_float16.h"  // IWYU pragma: export
 
 #include "util/math_float3.h"  // IWYU pragma: export
 
@@ -0,0 +1,194 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/math_base.h"
+#include "util/math_float8.h"
+#include "util/types_float16.h"
+
+CCL_NAMESPACE_BEGIN
+
+#ifdef __KERNEL_AVX512__
+#  define VFLOAT16_BINARY_OP(intrinsic, op) return vfloat16(intrinsic(a.m512, b.m512));
+#else
+#  define VFLOAT16_BINARY_OP(intrinsic, op) \
+    vfloat16 r; \
+    for (int i = 0; i < 16; i++) { \
+      r.f[i] = op; \
+    } \
+    return r;
+#endif
+
+ccl_device_inline vfloat16 zero_vfloat16()
+{
+#ifdef __KERNEL_AVX512__
+  return vfloat16(_mm512_setzero_ps());
+#else
+  return make_vfloat16(0.0f);
+#endif
+}
+
+ccl_device_inline vfloat16 operator+(const vfloat16 a, const vfloat16 b)
+{
+  VFLOAT16_BINARY_OP(_mm512_add_ps, a.f[i] + b.f[i])
+}
+
+ccl_device_inline vfloat16 operator-(const vfloat16 a, const vfloat16 b)
+{
+  VFLOAT16_BINARY_OP(_mm512_sub_ps, a.f[i] - b.f[i])
+}
+
+ccl_device_inline vfloat16 operator*(const vfloat16 a, const vfloat16 b)
+{
+  VFLOAT16_BINARY_OP(_mm512_mul_ps, a.f[i] * b.f[i])
+}
+
+ccl_device_inline vfloat16 operator/(const vfloat16 a, const vfloat16 b)
+{
+  VFLOAT16_BINARY_OP(_mm512_div_ps, a.f[i] / b.f[i])
+}
+
+ccl_device_inline vfloat16 min(const vfloat16 a, const vfloat16 b)
+{
+  VFLOAT16_BINARY_OP(_mm512_min_ps, min(a.f[i], b.f[i]))
+}
+
+ccl_device_inline vfloat16 max(const vfloat16 a, const vfloat16 b)
+{
+  VFLOAT16_BINARY_OP(_mm512_max_ps, max(a.f[i], b.f[i]))
+}
+
+#undef VFLOAT16_BINARY_OP
+
+ccl_device_inline vfloat16 operator+(const vfloat16 a, const float f)
+{
+  return a + make_vfloat16(f);
+}
+
+ccl_device_inline vfloat16 operator-(const vfloat16 a, const float f)
+{
+  return a - make_vfloat16(f);
+}
+
+ccl_device_inline vfloat16 operator*(const vfloat16 a, const float f)
+{
+  return a * make_vfloat16(f);
+}
+
+ccl_device_inline vfloat16 operator/(const vfloat16 a, const float f)
+{
+  return a / make_vfloat16(f);
+}
+
+ccl_device_inline vfloat16 sqrt(const vfloat16 a)
+{
+#ifdef __KERNEL_AVX512__
+  return vfloat16(_mm512_sqrt_ps(a.m512));
+#else
+  vfloat16 r;
+  for (int i = 0; i < 16; i++) {
+    r.f[i] = sqrtf(a.f[i]);
+  }
+  return r;
+#endif
+}
+
+/* Mask with a bit set for every element of a that is less than or equal to b. */
+ccl_device_inline int compare_le_mask(const vfloat16 a, const vfloat16 b)
+{
+#ifdef __KERNEL_AVX512__
+  return _mm512_cmp_ps_mask(a.m512, b.m512, _CMP_LE_OQ);
+#else
+  int mask = 0;
+  for (int i = 0; i < 16; i++) {
+    mask |= (a.f[i] <= b.f[i]) ? (1 << i) : 0;
+  }
+  return mask;
+#endif
+}
+
+ccl_device_inline bool operator==(const vfloat16 a, const vfloat16 b)
+{
+#ifdef __KERNEL_AVX512__
+  return _mm512_cmp_ps_mask(a.m512, b.m512, _CMP_EQ_OQ) == 0xffff;
+#else
+  for (int i = 0; i < 16; i++) {
+    if (a.f[i] != b.f[i]) {
+      return false;
+    }
+  }
+  return true;
+#endif
+}
+
+ccl_device_inline float reduce_add(const vfloat16 a)
+{
+#ifdef __KERNEL_AVX512__
+  return _mm512_reduce_add_ps(a.m512);
+#else
+  float r = 0.0f;
+  for (int i = 0; i < 16; i++) {
+    r += a.f[i];
+  }
+  return r;
+#endif
+}
+
+ccl_device_inline float reduce_min(const vfloat16 a)
+{
+#ifdef __KERNEL_AVX512__
+  return _mm512_reduce_min_ps(a.m512);
+#else
+  float r = a.f[0];
+  for (int i = 1; i < 16; i++) {
+    r = min(r, a.f[i]);
+  }
+  return r;
+#endif
+}
+
+ccl_device_inline float reduce_max(const vfloat16 a)
+{
+#ifdef __KERNEL_AVX512__
+  return _mm512_reduce_max_ps(a.m512);
+#else
+  float r = a.f[0];
+  for (int i = 1; i < 16; i++) {
+    r = max(r, a.f[i]);
+  }
+  return r;
+#endif
+}
+
+/* First and second half. */
+ccl_device_inline vfloat8 low(const vfloat16 a)
+{
+#ifdef __KERNEL_AVX512__
+  return vfloat8(_mm512_castps512_ps256(a.m512));
+#else
+  return make_vfloat8(a.f[0], a.f[1], a.f[2], a.f[3], a.f[4], a.f[5], a.f[6], a.f[7]);
+#endif
+}
+
+ccl_device_inline vfloat8 high(const vfloat16 a)
+{
+#ifdef __KERNEL_AVX512__
+  return vfloat8(_mm512_extractf32x8_ps(a.m512, 1));
+#else
+  return make_vfloat8(a.f[8], a.f[9], a.f[10], a.f[11], a.f[12], a.f[13], a.f[14], a.f[15]);
+#endif
+}
+
+/* Quarter i, as a float4. */
+template<int i> ccl_device_inline float4 extract_float4(const vfloat16 a)
+{
+#ifdef __KERNEL_AVX512__
+  return float4(_mm512_extractf32x4_ps(a.m512, i));
+#else
+  return make_float4(a.f[i * 4 + 0], a.f[i * 4 + 1], a.f[i * 4 + 2], a.f[i * 4 + 3]);
+#endif
+}
+
+CCL_NAMESPACE_END
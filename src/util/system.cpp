@@ -143,6 +143,7 @@ int system_cpu_bits()
 struct CPUCapabilities {
   bool sse42;
   bool avx2;
+  bool avx512;
   bool f16c;
 };
 
@@ -199,6 +200,17 @@ static CPUCapabilities &system_cpu_capabilities()
 
         caps.avx2 = sse && sse2 && sse3 && ssse3 && sse41 && sse42 && avx && f16c && avx2 &&
                     fma3 && bmi1 && bmi2;
+
+        /* The OS must also save the opmask and upper ZMM registers. */
+        const bool avx512_os = (xcr_feature_mask & 0xe6) == 0xe6;
+        const bool avx512f = (result[1] & ((int)1 << 16)) != 0;
+        const bool avx512dq = (result[1] & ((int)1 << 17)) != 0;
+        const bool avx512cd = (result[1] & ((int)1 << 28)) != 0;
+        const bool avx512bw = (result[1] & ((int)1 << 30)) != 0;
+        const bool avx512vl = (result[1] & ((int)1 << 31)) != 0;
+
+        caps.avx512 = caps.avx2 && avx512_os && avx512f && avx512dq && avx512cd && avx512bw &&
+                      avx512vl;
       }
     }
 
@@ -225,6 +237,14 @@ bool system_cpu_support_avx2()
   return caps.avx2 && caps.f16c;
 }
 
+bool system_cpu_support_avx512()
+{
+  /* Only the F, CD, DQ, BW and VL subsets are used, which all CPUs with AVX-512 since
+   * Skylake-X support. */
+  CPUCapabilities &caps = system_cpu_capabilities();
+  return caps.avx512 && caps.f16c;
+}
+
 #else
 
 bool system_cpu_support_sse42()
@@ -237,6 +257,11 @@ bool system_cpu_support_avx2()
   return false;
 }
 
+bool system_cpu_support_avx512()
+{
+  return false;
+}
+
 #endif
 
 size_t system_physical_ram()
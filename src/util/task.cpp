@@ -99,6 +99,28 @@ int TaskScheduler::max_concurrency()
   return (users > 0) ? active_num_threads : tbb::this_task_arena::max_concurrency();
 }
 
+vector<int> TaskScheduler::numa_nodes()
+{
+#if TBB_INTERFACE_VERSION_MAJOR >= 12
+  /* Without topology information a single automatic node is returned. */
+  const std::vector<tbb::numa_node_id> nodes = tbb::info::numa_nodes();
+  if (nodes.size() > 1 || (nodes.size() == 1 && nodes[0] != tbb::task_arena::automatic)) {
+    return vector<int>(nodes.begin(), nodes.end());
+  }
+#endif
+  return vector<int>();
+}
+
+int TaskScheduler::numa_node_concurrency(const int numa_node)
+{
+#if TBB_INTERFACE_VERSION_MAJOR >= 12
+  return tbb::info::default_concurrency(numa_node);
+#else
+  (void)numa_node;
+  return max_concurrency();
+#endif
+}
+
 /* Dedicated Task Pool */
 
 DedicatedTaskPool::DedicatedTaskPool()
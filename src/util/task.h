@@ -9,6 +9,7 @@
 #include "util/tbb.h"
 #include "util/thread.h"
 #include "util/unique_ptr.h"
+#include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -78,6 +79,12 @@ class TaskScheduler {
    * possible and leave scheduling and splitting up tasks to the scheduler. */
   static int max_concurrency();
 
+  /* NUMA nodes of the system, as identifiers to constrain task arenas to. Empty when the
+   * topology is not known, for example when TBB was built without hwloc support. */
+  static vector<int> numa_nodes();
+  /* Number of threads that can run on the given NUMA node. */
+  static int numa_node_concurrency(const int numa_node);
+
  protected:
   static thread_mutex mutex;
   static int users;
@@ -19,6 +19,10 @@
 #include <tbb/task_arena.h>
 #include <tbb/task_group.h>
 
+#if TBB_INTERFACE_VERSION_MAJOR >= 12
+#  include <tbb/info.h>
+#endif
+
 #if TBB_INTERFACE_VERSION_MAJOR >= 10
 #  define WITH_TBB_GLOBAL_CONTROL
 #  define TBB_PREVIEW_GLOBAL_CONTROL 1
@@ -25,6 +25,7 @@
 #include "util/types_float3.h"  // IWYU pragma: export
 #include "util/types_float4.h"  // IWYU pragma: export
 #include "util/types_float8.h"  // IWYU pragma: export
+#include "util/types_float16.h"  // IWYU pragma: export
 
 #include "util/types_normal.h"  // IWYU pragma: export
 
@@ -0,0 +1,116 @@
+/* SPDX-FileCopyrightText: 2011-2025 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "util/types_base.h"
+#include "util/types_float4.h"
+#include "util/types_float8.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Sixteen floats, filling one AVX-512 register. Named vfloat16 like vfloat8, to not be confused
+ * with the half precision float16 type. */
+
+#ifdef __KERNEL_GPU__
+struct vfloat16
+#else
+struct ccl_try_align(64) vfloat16
+#endif
+{
+#ifdef __KERNEL_AVX512__
+  union {
+    __m512 m512;
+    float f[16];
+  };
+
+  __forceinline vfloat16() = default;
+  __forceinline vfloat16(const vfloat16 &a) = default;
+  __forceinline explicit vfloat16(const __m512 &a) : m512(a) {}
+
+  __forceinline operator const __m512 &() const
+  {
+    return m512;
+  }
+  __forceinline operator __m512 &()
+  {
+    return m512;
+  }
+
+  __forceinline vfloat16 &operator=(const vfloat16 &a)
+  {
+    m512 = a.m512;
+    return *this;
+  }
+
+#else  /* __KERNEL_AVX512__ */
+  float f[16];
+#endif /* __KERNEL_AVX512__ */
+
+#ifndef __KERNEL_GPU__
+  __forceinline float operator[](int i) const
+  {
+    util_assert(i >= 0);
+    util_assert(i < 16);
+    return f[i];
+  }
+  __forceinline float &operator[](int i)
+  {
+    util_assert(i >= 0);
+    util_assert(i < 16);
+    return f[i];
+  }
+#endif
+};
+
+ccl_device_inline vfloat16 make_vfloat16(const float f)
+{
+#ifdef __KERNEL_AVX512__
+  return vfloat16(_mm512_set1_ps(f));
+#else
+  vfloat16 r;
+  for (int i = 0; i < 16; i++) {
+    r.f[i] = f;
+  }
+  return r;
+#endif
+}
+
+ccl_device_inline vfloat16 make_vfloat16(const vfloat8 a, const vfloat8 b)
+{
+#ifdef __KERNEL_AVX512__
+  return vfloat16(_mm512_insertf32x8(_mm512_castps256_ps512(a), b, 1));
+#else
+  vfloat16 r;
+  for (int i = 0; i < 8; i++) {
+    r.f[i] = a[i];
+    r.f[i + 8] = b[i];
+  }
+  return r;
+#endif
+}
+
+ccl_device_inline vfloat16 make_vfloat16(const float4 a,
+                                         const float4 b,
+                                         const float4 c,
+                                         const float4 d)
+{
+  return make_vfloat16(make_vfloat8(a, b), make_vfloat8(c, d));
+}
+
+/* Load from memory without alignment requirements. */
+ccl_device_inline vfloat16 load_vfloat16(const ccl_private float *v)
+{
+#ifdef __KERNEL_AVX512__
+  return vfloat16(_mm512_loadu_ps(v));
+#else
+  vfloat16 r;
+  for (int i = 0; i < 16; i++) {
+    r.f[i] = v[i];
+  }
+  return r;
+#endif
+}
+
+CCL_NAMESPACE_END